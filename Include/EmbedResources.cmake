@@ -0,0 +1,68 @@
+# Embeds a directory of resources into a generated C source file, as a
+# table of static byte arrays keyed by their path relative to the
+# resource root. This file is both a module (providing embed_resources())
+# and the script that module runs at build time.
+
+# Script mode: called as
+#   cmake -DRESOURCE_ROOT=<dir> -DRESOURCE_SUBDIR=<subdir>
+#         -DOUTPUT=<file.c> -P EmbedResources.cmake
+if(CMAKE_SCRIPT_MODE_FILE)
+    file(GLOB_RECURSE resource_files RELATIVE "${RESOURCE_ROOT}"
+        "${RESOURCE_ROOT}/${RESOURCE_SUBDIR}/*")
+    # Lookups binary search the table, so it must be sorted.
+    list(SORT resource_files)
+
+    set(arrays "")
+    set(entries "")
+    set(index 0)
+    foreach(resource ${resource_files})
+        file(READ "${RESOURCE_ROOT}/${resource}" contents HEX)
+        string(LENGTH "${contents}" hex_length)
+        math(EXPR byte_count "${hex_length} / 2")
+
+        # Sixteen bytes to a line, then every byte as a hex literal.
+        string(REPEAT "[0-9a-f]" 32 line_pattern)
+        string(REGEX REPLACE "(${line_pattern})" "\\1\n    " contents
+            "${contents}")
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1, " contents
+            "${contents}")
+        string(REPLACE " \n" "\n" contents "${contents}")
+
+        # A terminating NUL is appended so text resources can be handed
+        # straight to APIs expecting C strings; it isn't counted in size.
+        string(APPEND arrays
+            "static const unsigned char resource_${index}[] = {\n"
+            "    ${contents}0x00};\n\n")
+        string(APPEND entries "    {\"${resource}\", resource_${index}, "
+            "${byte_count}},\n")
+        math(EXPR index "${index} + 1")
+    endforeach()
+
+    # An empty initializer isn't valid C, so keep a sentinel entry around
+    # and leave it out of the count.
+    file(WRITE "${OUTPUT}.tmp"
+        "/* Generated by EmbedResources.cmake. Do not edit. */\n\n"
+        "#include <Input/Embedded.h>\n\n"
+        "${arrays}"
+        "const leto_embedded_file_t leto_embedded_files[] = {\n"
+        "${entries}    {NULL, NULL, 0}};\n\n"
+        "const size_t leto_embedded_file_count = ${index};\n")
+    # Only touch the output if it changed, so nothing rebuilds needlessly.
+    file(COPY_FILE "${OUTPUT}.tmp" "${OUTPUT}" ONLY_IF_DIFFERENT)
+    file(REMOVE "${OUTPUT}.tmp")
+    return()
+endif()
+
+# Adds a build step generating <output> from every file under
+# <root>/<subdir>. The step reruns whenever one of those files changes.
+function(embed_resources root subdir output)
+    file(GLOB_RECURSE resource_files CONFIGURE_DEPENDS "${root}/${subdir}/*")
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND ${CMAKE_COMMAND} -DRESOURCE_ROOT=${root}
+            -DRESOURCE_SUBDIR=${subdir} -DOUTPUT=${output}
+            -P "${CMAKE_CURRENT_FUNCTION_LIST_FILE}"
+        DEPENDS ${resource_files} "${CMAKE_CURRENT_FUNCTION_LIST_FILE}"
+        COMMENT "Embedding ${subdir} resources"
+        VERBATIM)
+endfunction()
@@ -1,13 +1,43 @@
 #version 460 core
 layout(location = 0) out vec4 fragmentColor;
+// How far the fragment moved since last frame, in texture coordinates.
+layout(location = 1) out vec2 fragmentVelocity;
 
-// in vec2 tc;
+in vec2 tc;
 in vec3 pos;
+in vec3 normal;
+in vec3 world_position;
+in vec4 clip_position;
+in vec4 previous_clip_position;
+flat in uint material_index;
+
+// The offset the projection is jittered by, in normalized device
+// coordinates; taken back out of the velocity, so still surfaces read
+// as still.
+uniform vec2 projection_jitter;
 
 // uniform sampler2D texture_diffuse1;
 
+#include "common/lighting.glsl"
+
 void main()
 {
-    fragmentColor = vec4(pos.x, pos.y, pos.z, 1.0);
+    vec4 albedo = materials[material_index].color;
+    vec3 surface_normal = normalize(normal);
+    if (!gl_FrontFacing) surface_normal = -surface_normal;
+
+    // Only the lights binned into this fragment's cluster can reach it.
+    uvec2 cluster = clusters[FindCluster(clip_position)];
+    vec3 lighting = vec3(ambient);
+    lighting += sun_color * SunVisibility(surface_normal) *
+                max(dot(surface_normal, -sun_direction), 0.0);
+    for (uint i = 0u; i < cluster.y; i++)
+        lighting += Shade(lights[light_indices[cluster.x + i]],
+                          surface_normal);
+
+    fragmentColor = vec4(albedo.rgb * lighting, albedo.a);
+    vec2 position = clip_position.xy / clip_position.w - projection_jitter;
+    vec2 previous = previous_clip_position.xy / previous_clip_position.w;
+    fragmentVelocity = (position - previous) * 0.5;
     // FragColor = texture(texture_diffuse1, tc);
 }
\ No newline at end of file
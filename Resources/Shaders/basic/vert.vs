@@ -1,20 +1,86 @@
 #version 460 core
+// Positions may be normalized to the bounding box; the model matrix takes
+// them back out.
 layout(location = 0) in vec3 position;
-// layout (location = 1) in vec3 normals;
-// layout (location = 2) in vec2 texture_coordinates;
+// Octahedral-encoded unit normals.
+layout(location = 1) in vec2 normals;
+layout(location = 2) in vec2 texture_coordinates;
 
-// out vec2 tc;
+out vec2 tc;
 out vec3 pos;
+out vec3 normal;
+// Where the fragment is in the world, for lighting, and on screen, to
+// find its light cluster.
+out vec3 world_position;
+out vec4 clip_position;
+// Where the fragment was on screen last frame, for the velocity buffer.
+out vec4 previous_clip_position;
+// The material's slot in the parameter buffer.
+flat out uint material_index;
 
 uniform mat4 projection_matrix;
 uniform mat4 camera_view;
+// Last frame's view and projection, without jitter.
+uniform mat4 previous_view_projection;
 
-uniform mat4 model;
+// Matches leto_instance_t. The model matrix already holds the mesh's
+// dequantization.
+struct instance_data
+{
+    mat4 model;
+    // Without the dequantization, for normals.
+    mat3 normal_matrix;
+    // The material, then one past the instance's motion slot, or zero.
+    uvec4 material;
+};
+
+layout(std430, binding = 2) readonly buffer instance_buffer
+{
+    instance_data instances[];
+};
+
+// Last frame's model matrices of the instances that moved.
+layout(std430, binding = 12) readonly buffer motion_buffer
+{
+    mat4 previous_models[];
+};
+
+// Matches leto_draw_data_t. gl_DrawID restarts with every multi-draw, and
+// the engine binds each one's records to start at its first.
+struct draw_data
+{
+    uint first_instance;
+    uint instance_count;
+    uint material;
+    uint padding;
+};
+
+layout(std430, binding = 3) readonly buffer draw_buffer
+{
+    draw_data draws[];
+};
+
+#include "common/octahedral.glsl"
 
 void main()
 {
-    // tc = texture_coordinates;
+    draw_data draw = draws[gl_DrawID];
+    instance_data instance = instances[draw.first_instance + gl_InstanceID];
+    mat4 model = instance.model;
+
+    tc = texture_coordinates;
     pos = position;
-    gl_Position =
-        projection_matrix * camera_view * model * vec4(position, 1.0);
+    normal = instance.normal_matrix * DecodeOctahedral(normals);
+    material_index = draw.material;
+
+    vec4 world = model * vec4(position, 1.0);
+    world_position = world.xyz;
+    clip_position = projection_matrix * camera_view * world;
+    gl_Position = clip_position;
+
+    mat4 previous_model = model;
+    if (instance.material.y != 0u)
+        previous_model = previous_models[instance.material.y - 1u];
+    previous_clip_position =
+        previous_view_projection * previous_model * vec4(position, 1.0);
 }
\ No newline at end of file
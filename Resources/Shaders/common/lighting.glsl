@@ -0,0 +1,159 @@
+// Clustered lighting: the material, light, and shadow bindings, and the
+// functions shading a surface with them. Whatever includes this has to
+// declare the surface's world_position and clip_position first.
+
+// Matches leto_material_parameters_t.
+struct material_parameters
+{
+    vec4 color;
+    // Roughness, metallic, emission, and alpha cutoff.
+    vec4 surface;
+    vec4 user[2];
+};
+
+layout(std430, binding = 1) readonly buffer material_buffer
+{
+    material_parameters materials[];
+};
+
+// Matches leto_light_data_t.
+struct light_data
+{
+    // Position, then range.
+    vec4 position;
+    // Color times intensity.
+    vec4 color;
+    // Spot direction, then the cosine of the outer angle.
+    vec4 direction;
+    float inner_cosine;
+    // Zero for point lights, one for spot lights.
+    uint type;
+    // One past the light's slot in the shadow atlas, or zero.
+    uint shadow;
+    uint padding;
+};
+
+layout(std430, binding = 8) readonly buffer light_buffer
+{
+    light_data lights[];
+};
+
+// The first of each cluster's light indices, then how many it has.
+layout(std430, binding = 9) readonly buffer cluster_buffer
+{
+    uvec2 clusters[];
+};
+
+layout(std430, binding = 10) readonly buffer light_index_buffer
+{
+    uint light_indices[];
+};
+
+// Matches LETO_CLUSTERS_X, LETO_CLUSTERS_Y, and LETO_CLUSTERS_Z.
+const uvec3 cluster_grid = uvec3(16, 9, 24);
+// Take the log of a view depth to its depth slice.
+uniform float cluster_scale;
+uniform float cluster_bias;
+
+// Light every surface gets, so nothing is ever entirely black.
+const float ambient = 0.05;
+
+// Matches LETO_SHADOW_CASCADES.
+const int cascade_count = 4;
+layout(binding = 4) uniform sampler2DArrayShadow cascade_maps;
+uniform mat4 cascade_matrices[cascade_count];
+// The view depth each cascade ends at.
+uniform vec4 cascade_splits;
+// The direction the sun shines in, and its color.
+uniform vec3 sun_direction;
+uniform vec3 sun_color;
+
+layout(binding = 5) uniform sampler2DShadow shadow_atlas;
+// Every shadowed spot light's world-to-atlas matrix.
+layout(std430, binding = 11) readonly buffer shadow_matrix_buffer
+{
+    mat4 shadow_matrices[];
+};
+
+// The cluster a fragment falls in, from its clip-space position.
+uint FindCluster(vec4 clip)
+{
+    vec2 screen = clamp(clip.xy / clip.w * 0.5 + 0.5, 0.0, 1.0);
+    uvec2 tile = min(uvec2(screen * vec2(cluster_grid.xy)),
+                     cluster_grid.xy - 1u);
+    // A perspective projection's w is the view depth.
+    float slice = log(max(clip.w, 1e-4)) * cluster_scale + cluster_bias;
+    uint depth = uint(clamp(slice, 0.0, float(cluster_grid.z - 1u)));
+    return (depth * cluster_grid.y + tile.y) * cluster_grid.x + tile.x;
+}
+
+// How much of the sun reaches a fragment, from the first cascade that
+// covers it; four taps, filtered by the hardware.
+float SunVisibility(vec3 surface_normal)
+{
+    int cascade = 0;
+    while (cascade < cascade_count &&
+           clip_position.w > cascade_splits[cascade])
+        cascade++;
+    if (cascade == cascade_count) return 1.0;
+
+    // Pushing the lookup out along the normal hides most acne.
+    vec3 offset = world_position + surface_normal * 0.02;
+    vec4 shadow = cascade_matrices[cascade] * vec4(offset, 1.0);
+    vec3 coordinates = shadow.xyz / shadow.w * 0.5 + 0.5;
+
+    vec2 texel = 1.0 / vec2(textureSize(cascade_maps, 0).xy);
+    float visibility = 0.0;
+    for (int i = 0; i < 4; i++)
+    {
+        vec2 tap = vec2((i & 1) != 0 ? 0.5 : -0.5,
+                        (i & 2) != 0 ? 0.5 : -0.5);
+        visibility += texture(cascade_maps,
+                              vec4(coordinates.xy + tap * texel,
+                                   float(cascade), coordinates.z));
+    }
+    return visibility * 0.25;
+}
+
+// How much of a spot light reaches a fragment, from its tile of the
+// atlas; four taps, filtered by the hardware.
+float SpotVisibility(uint shadow, vec3 surface_normal)
+{
+    vec3 offset = world_position + surface_normal * 0.02;
+    vec4 projected = shadow_matrices[shadow - 1u] * vec4(offset, 1.0);
+    vec3 coordinates = projected.xyz / projected.w;
+
+    vec2 texel = 1.0 / vec2(textureSize(shadow_atlas, 0));
+    float visibility = 0.0;
+    for (int i = 0; i < 4; i++)
+    {
+        vec2 tap = vec2((i & 1) != 0 ? 0.5 : -0.5,
+                        (i & 2) != 0 ? 0.5 : -0.5);
+        visibility += texture(shadow_atlas,
+                              vec3(coordinates.xy + tap * texel,
+                                   coordinates.z));
+    }
+    return visibility * 0.25;
+}
+
+// How much of a light reaches a point, and from where.
+vec3 Shade(light_data light, vec3 surface_normal)
+{
+    vec3 to_light = light.position.xyz - world_position;
+    float distance_squared = dot(to_light, to_light);
+    vec3 direction = to_light * inversesqrt(max(distance_squared, 1e-8));
+
+    // Inverse-square falloff, windowed to reach zero at the range.
+    float ratio = distance_squared / (light.position.w * light.position.w);
+    float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+    float attenuation = window * window / (distance_squared + 1.0);
+
+    if (light.type == 1u)
+        attenuation *= smoothstep(light.direction.w, light.inner_cosine,
+                                  dot(-direction, light.direction.xyz));
+    if (light.type == 1u && light.shadow != 0u && attenuation > 0.0)
+        attenuation *= SpotVisibility(light.shadow, surface_normal);
+
+    return light.color.rgb * attenuation *
+           max(dot(surface_normal, direction), 0.0);
+}
\ No newline at end of file
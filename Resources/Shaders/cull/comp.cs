@@ -0,0 +1,202 @@
+#version 460 core
+// One invocation per object: cull it against the frustum and, if given,
+// a depth pyramid, pick its level of detail, and append a draw for it.
+// Two-phase culling draws last frame's visible objects first, then tests
+// everything against a pyramid built from them. Nothing here needs
+// subgroups or other optional features, so it runs the same on software
+// rasterizers.
+layout(local_size_x = 64) in;
+
+// Matches leto_gpu_bounds_t.
+struct bounds_data
+{
+    vec3 center;
+    uint mesh;
+    vec3 extent;
+    float scale;
+};
+
+// Matches leto_gpu_mesh_t. Each level holds its first index, its index
+// count, and its error as float bits.
+struct mesh_data
+{
+    uint lod_count;
+    int base_vertex;
+    uint padding[2];
+    uvec4 lods[4];
+};
+
+// Matches leto_instance_t.
+struct instance_data
+{
+    mat4 model;
+    // Without the dequantization, for normals.
+    mat3 normal_matrix;
+    uvec4 material;
+};
+
+// Matches leto_draw_command_t, and so DrawElementsIndirectCommand.
+struct draw_command
+{
+    uint index_count;
+    uint instance_count;
+    uint first_index;
+    int base_vertex;
+    uint base_instance;
+};
+
+// Matches leto_draw_data_t.
+struct draw_data
+{
+    uint first_instance;
+    uint instance_count;
+    uint material;
+    uint padding;
+};
+
+// Whether each object was visible when the second phase last saw it.
+layout(std430, binding = 0) buffer visibility_buffer
+{
+    uint visibility[];
+};
+
+layout(std430, binding = 2) readonly buffer instance_buffer
+{
+    instance_data instances[];
+};
+
+layout(std430, binding = 3) writeonly buffer draw_buffer
+{
+    draw_data draws[];
+};
+
+layout(std430, binding = 4) readonly buffer bounds_buffer
+{
+    bounds_data bounds[];
+};
+
+layout(std430, binding = 5) readonly buffer mesh_buffer
+{
+    mesh_data meshes[];
+};
+
+layout(std430, binding = 6) writeonly buffer command_buffer
+{
+    draw_command commands[];
+};
+
+layout(std430, binding = 7) buffer count_buffer
+{
+    uint draw_count;
+};
+
+uniform uint object_count;
+// Zero for a single phase, otherwise the phase being run.
+uniform uint phase;
+uniform vec4 frustum_planes[6];
+uniform vec3 camera_position;
+// Pixels per world unit at a distance of one, over the pixel error.
+uniform float lod_scale;
+
+uniform bool occlusion;
+uniform mat4 occlusion_view_projection;
+// The farthest depth under every texel, one level per halving.
+layout(binding = 0) uniform sampler2D depth_pyramid;
+
+bool InsideFrustum(vec3 center, vec3 extent)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        vec4 plane = frustum_planes[i];
+        float radius = dot(abs(plane.xyz), extent);
+        if (dot(plane.xyz, center) + plane.w < -radius) return false;
+    }
+    return true;
+}
+
+bool Occluded(vec3 center, vec3 extent)
+{
+    vec3 minimum = vec3(1.0);
+    vec3 maximum = vec3(0.0);
+    for (int i = 0; i < 8; i++)
+    {
+        vec3 corner = vec3((i & 1) != 0 ? 1.0 : -1.0,
+                           (i & 2) != 0 ? 1.0 : -1.0,
+                           (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 corner_position = vec4(center + extent * corner, 1.0);
+        vec4 clip = occlusion_view_projection * corner_position;
+        // Boxes crossing the near plane can't be judged; draw them.
+        if (clip.w <= 0.0) return false;
+
+        vec3 window = clip.xyz / clip.w * 0.5 + 0.5;
+        minimum = min(minimum, window);
+        maximum = max(maximum, window);
+    }
+    minimum.xy = clamp(minimum.xy, 0.0, 1.0);
+    maximum.xy = clamp(maximum.xy, 0.0, 1.0);
+
+    // Pick the level where the box covers at most two texels a side.
+    vec2 size = (maximum.xy - minimum.xy) *
+                vec2(textureSize(depth_pyramid, 0));
+    int levels = textureQueryLevels(depth_pyramid);
+    int level = int(ceil(log2(max(max(size.x, size.y), 1.0))));
+    level = min(level, levels - 1);
+
+    ivec2 texels = textureSize(depth_pyramid, level);
+    ivec2 low = clamp(ivec2(minimum.xy * vec2(texels)), ivec2(0),
+                      texels - 1);
+    ivec2 high = clamp(ivec2(maximum.xy * vec2(texels)), ivec2(0),
+                       texels - 1);
+    float farthest =
+        max(max(texelFetch(depth_pyramid, low, level).r,
+                texelFetch(depth_pyramid, ivec2(high.x, low.y), level).r),
+            max(texelFetch(depth_pyramid, ivec2(low.x, high.y), level).r,
+                texelFetch(depth_pyramid, high, level).r));
+    return minimum.z > farthest;
+}
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= object_count) return;
+
+    // The first phase only redraws what was seen last time, and can't
+    // test occlusion; the pyramid is what it's drawing.
+    bool was_visible = visibility[index] != 0u;
+    if (phase == 1u && !was_visible) return;
+
+    bounds_data object = bounds[index];
+    bool visible = InsideFrustum(object.center, object.extent);
+    if (visible && occlusion && phase != 1u)
+        visible = !Occluded(object.center, object.extent);
+    if (phase == 2u)
+    {
+        visibility[index] = visible ? 1u : 0u;
+        // Whatever the first phase drew stays drawn.
+        if (was_visible) return;
+    }
+    if (!visible) return;
+
+    // The coarsest level whose error stays under a pixel's worth, taken
+    // from the near side of the box's bounding sphere.
+    mesh_data mesh = meshes[object.mesh];
+    float distance =
+        length(object.center - camera_position) - length(object.extent);
+    uint lod = 0u;
+    if (distance > 1e-3)
+    {
+        float pixels_per_unit = object.scale * lod_scale / distance;
+        for (uint i = 1u; i < mesh.lod_count; i++)
+        {
+            if (uintBitsToFloat(mesh.lods[i].z) * pixels_per_unit > 1.0)
+                break;
+            lod = i;
+        }
+    }
+    if (mesh.lods[lod].y == 0u) return;
+
+    uint slot = atomicAdd(draw_count, 1u);
+    commands[slot] = draw_command(mesh.lods[lod].y, 1u, mesh.lods[lod].x,
+                                  mesh.base_vertex, index);
+    draws[slot] = draw_data(index, 1u, instances[index].material.x, 0u);
+}
\ No newline at end of file
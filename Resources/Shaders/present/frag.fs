@@ -0,0 +1,12 @@
+#version 460 core
+// Copies the lit scene onto the window.
+layout(location = 0) out vec4 fragmentColor;
+
+in vec2 uv;
+
+layout(binding = 0) uniform sampler2D scene;
+
+void main()
+{
+    fragmentColor = vec4(texture(scene, uv).rgb, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#version 460 core
+// Build one level of the depth pyramid, one invocation per texel. Every
+// texel holds the farthest depth of everything beneath it; level zero
+// reads the depth buffer itself, which is never more than twice its size
+// a side, and every other level reduces the one above it.
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(r32f, binding = 0) writeonly uniform image2D destination;
+layout(r32f, binding = 1) readonly uniform image2D source;
+layout(binding = 0) uniform sampler2D depth_buffer;
+
+// Whether this is level zero, read from the depth buffer.
+uniform bool first_level;
+uniform ivec2 destination_size;
+uniform ivec2 source_size;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(texel, destination_size))) return;
+
+    // Every source texel this one covers any part of, so nothing behind
+    // an edge is ever reported as hidden.
+    ivec2 low = texel * source_size / destination_size;
+    ivec2 high = ((texel + 1) * source_size + destination_size - 1) /
+                 destination_size;
+
+    float farthest = 0.0;
+    for (int y = low.y; y < high.y; y++)
+    {
+        for (int x = low.x; x < high.x; x++)
+        {
+            float depth = first_level
+                              ? texelFetch(depth_buffer, ivec2(x, y), 0).r
+                              : imageLoad(source, ivec2(x, y)).r;
+            farthest = max(farthest, depth);
+        }
+    }
+    imageStore(destination, texel, vec4(farthest));
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#version 460 core
+layout(location = 0) out vec4 fragmentColor;
+// How far the pixel moved since last frame, in texture coordinates.
+layout(location = 1) out vec2 fragmentVelocity;
+
+in vec2 uv;
+
+// The triangle covering each pixel, as a running count over the frame's
+// draws; zero where nothing was drawn.
+layout(binding = 6) uniform usampler2D visibility_buffer;
+
+uniform mat4 projection_matrix;
+uniform mat4 camera_view;
+// Last frame's view and projection, without jitter.
+uniform mat4 previous_view_projection;
+// The offset the projection is jittered by, in normalized device
+// coordinates; taken back out of the velocity, so still surfaces read
+// as still.
+uniform vec2 projection_jitter;
+
+// The size of a vertex of the bound arena, in bytes, and each of its
+// attributes as its leto_mesh_attribute_format_t, its components, and
+// its offset in bytes.
+uniform uint vertex_stride;
+uniform uvec3 vertex_attributes[4];
+// The first of the arena's draws, then how many it has.
+uniform uvec2 draw_range;
+
+// Matches leto_instance_t. The model matrix already holds the mesh's
+// dequantization.
+struct instance_data
+{
+    mat4 model;
+    // Without the dequantization, for normals.
+    mat3 normal_matrix;
+    // The material, then one past the instance's motion slot, or zero.
+    uvec4 material;
+};
+
+layout(std430, binding = 2) readonly buffer instance_buffer
+{
+    instance_data instances[];
+};
+
+// Last frame's model matrices of the instances that moved.
+layout(std430, binding = 12) readonly buffer motion_buffer
+{
+    mat4 previous_models[];
+};
+
+// Matches leto_visibility_draw_t. A draw's instance has its index.
+struct draw_data
+{
+    uint first_triangle;
+    uint triangle_count;
+    uint first_index;
+    int base_vertex;
+    uint material;
+    uint padding[3];
+};
+
+layout(std430, binding = 13) readonly buffer draw_buffer
+{
+    draw_data draws[];
+};
+
+// The bound arena's vertices and indices, as 32-bit words.
+layout(std430, binding = 14) readonly buffer vertex_buffer
+{
+    uint vertex_words[];
+};
+
+layout(std430, binding = 15) readonly buffer index_buffer
+{
+    uint indices[];
+};
+
+// Where the pixel is in the world and on screen, rebuilt from its
+// triangle; basic/frag.fs gets these as inputs instead.
+vec3 world_position;
+vec4 clip_position;
+
+#include "common/lighting.glsl"
+#include "common/octahedral.glsl"
+
+// The 32 bits of the vertex buffer from a byte on; attributes are only
+// promised 2-byte alignment.
+uint ReadWord(uint byte)
+{
+    uint word = vertex_words[byte >> 2u];
+    if ((byte & 2u) == 0u) return word;
+    return (word >> 16u) | (vertex_words[(byte >> 2u) + 1u] << 16u);
+}
+
+// One component of an attribute, as the vertex array would hand it to a
+// vertex shader.
+float ReadComponent(uint format, uint byte)
+{
+    // Matches leto_mesh_attribute_format_t.
+    if (format == 1u) return uintBitsToFloat(ReadWord(byte));
+    uint bits = ReadWord(byte) & 0xFFFFu;
+    if (format == 2u) return unpackHalf2x16(bits).x;
+    if (format == 3u) return float(bits) / 65535.0;
+    return max(float(int(bits << 16u) >> 16) / 32767.0, -1.0);
+}
+
+// An attribute of a vertex of the bound arena; missing components are
+// filled in the same way a vertex array would.
+vec4 ReadAttribute(uint vertex, uint slot)
+{
+    uvec3 attribute = vertex_attributes[slot];
+    vec4 value = vec4(0.0, 0.0, 0.0, 1.0);
+    if (attribute.x == 0u) return value;
+
+    uint byte = vertex * vertex_stride + attribute.z;
+    uint size = attribute.x == 1u ? 4u : 2u;
+    for (uint i = 0u; i < min(attribute.y, 4u); i++)
+        value[i] = ReadComponent(attribute.x, byte + i * size);
+    return value;
+}
+
+// The normal of a vertex, unfolded if it has to be.
+vec3 ReadNormal(uint vertex)
+{
+    vec4 normal = ReadAttribute(vertex, 1u);
+    if (vertex_attributes[1].x == 5u) return DecodeOctahedral(normal.xy);
+    return normal.xyz;
+}
+
+// The draw of the bound arena a triangle belongs to, or -1 if it's
+// another arena's.
+int FindDraw(uint triangle)
+{
+    // The last draw starting at or before the triangle.
+    int low = int(draw_range.x), high = low + int(draw_range.y) - 1;
+    int found = -1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        if (draws[middle].first_triangle <= triangle)
+        {
+            found = middle;
+            low = middle + 1;
+        }
+        else high = middle - 1;
+    }
+    if (found < 0) return -1;
+
+    draw_data draw = draws[found];
+    if (triangle - draw.first_triangle >= draw.triangle_count) return -1;
+    return found;
+}
+
+void main()
+{
+    uint triangle = texelFetch(visibility_buffer,
+                               ivec2(gl_FragCoord.xy), 0).r;
+    if (triangle == 0u) discard;
+    int index = FindDraw(triangle);
+    if (index < 0) discard;
+
+    draw_data draw = draws[index];
+    instance_data instance = instances[index];
+    mat4 model = instance.model;
+    mat4 previous_model = model;
+    if (instance.material.y != 0u)
+        previous_model = previous_models[instance.material.y - 1u];
+
+    uint first = draw.first_index +
+                 (triangle - draw.first_triangle) * 3u;
+    mat4 view_projection = projection_matrix * camera_view;
+    vec3 positions[3], normals[3];
+    vec4 clips[3], previous_clips[3];
+    for (int i = 0; i < 3; i++)
+    {
+        uint vertex = uint(int(indices[first + uint(i)]) +
+                           draw.base_vertex);
+        vec4 position = vec4(ReadAttribute(vertex, 0u).xyz, 1.0);
+        positions[i] = (model * position).xyz;
+        normals[i] = instance.normal_matrix * ReadNormal(vertex);
+        clips[i] = view_projection * vec4(positions[i], 1.0);
+        previous_clips[i] =
+            previous_view_projection * previous_model * position;
+    }
+
+    // Perspective-correct barycentrics, straight from the clip-space
+    // corners; each weight is the area the pixel spans with the other
+    // two, which stays well behaved even behind the camera.
+    vec2 pixel = gl_FragCoord.xy /
+                 vec2(textureSize(visibility_buffer, 0)) * 2.0 - 1.0;
+    vec2 d0 = clips[0].xy - pixel * clips[0].w;
+    vec2 d1 = clips[1].xy - pixel * clips[1].w;
+    vec2 d2 = clips[2].xy - pixel * clips[2].w;
+    vec3 weights = vec3(d1.x * d2.y - d1.y * d2.x,
+                        d2.x * d0.y - d2.y * d0.x,
+                        d0.x * d1.y - d0.y * d1.x);
+    weights /= weights.x + weights.y + weights.z;
+
+    world_position = mat3(positions[0], positions[1], positions[2]) *
+                     weights;
+    clip_position = mat3x4(clips[0], clips[1], clips[2]) * weights;
+    vec4 previous_clip_position =
+        mat3x4(previous_clips[0], previous_clips[1], previous_clips[2]) *
+        weights;
+    vec3 surface_normal = normalize(
+        mat3(normals[0], normals[1], normals[2]) * weights);
+
+    // Counter-clockwise on screen is the front, as with the rasterizer.
+    float winding = determinant(
+        mat3(clips[0].xyw, clips[1].xyw, clips[2].xyw));
+    if (winding < 0.0) surface_normal = -surface_normal;
+
+    // Only the lights binned into this pixel's cluster can reach it.
+    vec4 albedo = materials[draw.material].color;
+    uvec2 cluster = clusters[FindCluster(clip_position)];
+    vec3 lighting = vec3(ambient);
+    lighting += sun_color * SunVisibility(surface_normal) *
+                max(dot(surface_normal, -sun_direction), 0.0);
+    for (uint i = 0u; i < cluster.y; i++)
+        lighting += Shade(lights[light_indices[cluster.x + i]],
+                          surface_normal);
+
+    fragmentColor = vec4(albedo.rgb * lighting, albedo.a);
+    vec2 position = clip_position.xy / clip_position.w - projection_jitter;
+    vec2 previous = previous_clip_position.xy / previous_clip_position.w;
+    fragmentVelocity = (position - previous) * 0.5;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#version 460 core
+// Covers the screen with one triangle, made from the vertex index alone.
+out vec2 uv;
+
+void main()
+{
+    uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
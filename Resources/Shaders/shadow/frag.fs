@@ -0,0 +1,3 @@
+#version 460 core
+// Depth is all a shadow map holds, so there's nothing to write.
+void main() {}
\ No newline at end of file
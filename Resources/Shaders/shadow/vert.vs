@@ -0,0 +1,41 @@
+#version 460 core
+// Draws casters into a shadow map; only depth is written.
+layout(location = 0) in vec3 position;
+
+uniform mat4 shadow_matrix;
+
+// Matches leto_instance_t. The model matrix already holds the mesh's
+// dequantization.
+struct instance_data
+{
+    mat4 model;
+    // Without the dequantization, for normals.
+    mat3 normal_matrix;
+    uvec4 material;
+};
+
+layout(std430, binding = 2) readonly buffer instance_buffer
+{
+    instance_data instances[];
+};
+
+// Matches leto_draw_data_t.
+struct draw_data
+{
+    uint first_instance;
+    uint instance_count;
+    uint material;
+    uint padding;
+};
+
+layout(std430, binding = 3) readonly buffer draw_buffer
+{
+    draw_data draws[];
+};
+
+void main()
+{
+    draw_data draw = draws[gl_DrawID];
+    mat4 model = instances[draw.first_instance + gl_InstanceID].model;
+    gl_Position = shadow_matrix * model * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#version 460 core
+// Blend the frame into the history, one invocation per history texel.
+// The history is looked up where the texel was last frame and clamped to
+// the colors around it now, so whatever has since been uncovered can't
+// smear. Colors are blended tonemapped, so a single bright sample can't
+// flicker through the whole history.
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(rgba16f, binding = 0) writeonly uniform image2D resolved;
+layout(binding = 0) uniform sampler2D scene_color;
+layout(binding = 1) uniform sampler2D scene_velocity;
+layout(binding = 2) uniform sampler2D scene_depth;
+layout(binding = 3) uniform sampler2D history;
+
+// The frame's jitter, in normalized device coordinates.
+uniform vec2 jitter;
+// From this frame's normalized device coordinates to last frame's.
+uniform mat4 reprojection;
+// How much of the frame goes into the history; one to start over.
+uniform float blend;
+
+vec3 Tonemap(vec3 color)
+{
+    return color / (1.0 + max(color.r, max(color.g, color.b)));
+}
+
+vec3 Untonemap(vec3 color)
+{
+    return color / max(1.0 - max(color.r, max(color.g, color.b)), 1e-4);
+}
+
+vec3 ToYCoCg(vec3 color)
+{
+    return vec3(dot(color, vec3(0.25, 0.5, 0.25)),
+                dot(color, vec3(0.5, 0.0, -0.5)),
+                dot(color, vec3(-0.25, 0.5, -0.25)));
+}
+
+vec3 FromYCoCg(vec3 color)
+{
+    return vec3(color.x + color.y - color.z, color.x + color.z,
+                color.x - color.y - color.z);
+}
+
+// Pull a color towards the center of a box until it's inside it.
+vec3 ClipToBox(vec3 color, vec3 center, vec3 extent)
+{
+    vec3 offset = color - center;
+    vec3 units = abs(offset / max(extent, vec3(1e-4)));
+    float largest = max(units.x, max(units.y, units.z));
+    return largest > 1.0 ? center + offset / largest : color;
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 size = imageSize(resolved);
+    if (any(greaterThanEqual(texel, size))) return;
+
+    // The scene was drawn shifted by the jitter; look where it went.
+    vec2 uv = (vec2(texel) + 0.5) / vec2(size);
+    vec2 scene_uv = uv + jitter * 0.5;
+    ivec2 scene_size = textureSize(scene_color, 0);
+    ivec2 center = ivec2(scene_uv * vec2(scene_size));
+
+    // The mean and spread of the colors around the texel, and the one
+    // nearest the camera; edges take their motion from the foreground.
+    vec3 sum = vec3(0.0), squares = vec3(0.0);
+    float nearest = 1.0;
+    ivec2 nearest_texel = center;
+    for (int y = -1; y <= 1; y++)
+        for (int x = -1; x <= 1; x++)
+        {
+            ivec2 neighbour =
+                clamp(center + ivec2(x, y), ivec2(0), scene_size - 1);
+            vec3 color = ToYCoCg(
+                Tonemap(texelFetch(scene_color, neighbour, 0).rgb));
+            sum += color;
+            squares += color * color;
+
+            float depth = texelFetch(scene_depth, neighbour, 0).r;
+            if (depth < nearest)
+            {
+                nearest = depth;
+                nearest_texel = neighbour;
+            }
+        }
+    vec3 mean = sum / 9.0;
+    vec3 deviation = sqrt(max(squares / 9.0 - mean * mean, vec3(0.0)));
+
+    vec3 current =
+        ToYCoCg(Tonemap(textureLod(scene_color, scene_uv, 0.0).rgb));
+
+    // Nothing drawn nearby means nothing moved but the camera.
+    vec2 velocity;
+    if (nearest < 1.0)
+        velocity = texelFetch(scene_velocity, nearest_texel, 0).xy;
+    else
+    {
+        vec4 previous =
+            reprojection * vec4(uv * 2.0 - 1.0, nearest * 2.0 - 1.0, 1.0);
+        velocity = uv - (previous.xy / previous.w * 0.5 + 0.5);
+    }
+
+    // A history that's just been made holds nothing worth reading, and
+    // neither does anywhere off its edge.
+    vec2 history_uv = uv - velocity;
+    vec3 color = current;
+    if (blend < 1.0 && all(greaterThanEqual(history_uv, vec2(0.0))) &&
+        all(lessThanEqual(history_uv, vec2(1.0))))
+    {
+        vec3 previous_color =
+            ToYCoCg(Tonemap(textureLod(history, history_uv, 0.0).rgb));
+        previous_color =
+            ClipToBox(previous_color, mean, deviation * 1.25);
+        color = mix(previous_color, current, blend);
+    }
+    imageStore(resolved, texel, vec4(Untonemap(FromYCoCg(color)), 1.0));
+}
\ No newline at end of file
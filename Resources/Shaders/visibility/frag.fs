@@ -0,0 +1,10 @@
+#version 460 core
+// The ID of the triangle covering the pixel; zero is left for nothing.
+layout(location = 0) out uint visibility;
+
+flat in uint first_triangle;
+
+void main()
+{
+    visibility = first_triangle + uint(gl_PrimitiveID);
+}
\ No newline at end of file
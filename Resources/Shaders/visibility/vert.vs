@@ -0,0 +1,50 @@
+#version 460 core
+// Positions may be normalized to the bounding box; the model matrix takes
+// them back out. Nothing else is needed to find what covers a pixel.
+layout(location = 0) in vec3 position;
+
+// The ID of the draw's first triangle.
+flat out uint first_triangle;
+
+uniform mat4 projection_matrix;
+uniform mat4 camera_view;
+
+// Matches leto_instance_t. The model matrix already holds the mesh's
+// dequantization.
+struct instance_data
+{
+    mat4 model;
+    // Without the dequantization, for normals.
+    mat3 normal_matrix;
+    // The material, then one past the instance's motion slot, or zero.
+    uvec4 material;
+};
+
+layout(std430, binding = 2) readonly buffer instance_buffer
+{
+    instance_data instances[];
+};
+
+// Matches leto_visibility_draw_t. Every draw is its own command, and its
+// base instance is its index, so both arrays are read with it.
+struct draw_data
+{
+    uint first_triangle;
+    uint triangle_count;
+    uint first_index;
+    int base_vertex;
+    uint material;
+    uint padding[3];
+};
+
+layout(std430, binding = 13) readonly buffer draw_buffer
+{
+    draw_data draws[];
+};
+
+void main()
+{
+    first_triangle = draws[gl_BaseInstance].first_triangle;
+    gl_Position = projection_matrix * camera_view *
+                  instances[gl_BaseInstance].model * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -16,7 +16,12 @@
 
 #include <Diagnostic/Platform.h> // Platform information
 #include <Diagnostic/Version.h>  // Version information
+#include <Rendering/Geometry.h>  // Geometry arena
+#include <Rendering/Materials.h> // Material system
+#include <Rendering/Release.h>   // Deferred object release
+#include <Rendering/State.h>     // OpenGL state cache
 #include <Utilities/Macros.h>    // Utility macros
+#include <Utilities/Threads.h>   // Worker pool
 
 /**
  * FramebufferCallback
@@ -102,6 +107,11 @@ leto_application_t *LetoInitApplication(bool paused, bool muted,
     int glad_initialized = gladLoadGL(glfwGetProcAddress);
     if (glad_initialized == 0)
         LetoReportError(true, failed_glad_init, LETO_FILE_CONTEXT);
+    // The context is fresh, so the state cache can't know anything yet.
+    LetoResetState();
+    if (!LetoInitReleases()) return NULL;
+    if (!LetoInitMaterials()) return NULL;
+    if (!LetoInitGeometry()) return NULL;
 
     // Initialize the camera with an FOV of 45, a movement speed of 2.5,
     // and a sensitivity of 0.1.
@@ -114,6 +124,11 @@ void LetoTerminateApplication(leto_application_t *application)
 {
     if (application == NULL) return;
 
+    LetoStopWorkers();
+    // This needs the context, so it has to go before the window.
+    LetoTerminateGeometry();
+    LetoTerminateMaterials();
+    LetoTerminateReleases();
     LetoDestroyWindow(&application->window);
 
     glfwTerminate();
@@ -153,6 +168,9 @@ bool LetoRunApplication(leto_application_t *application)
 
         glfwPollEvents();
         glfwSwapBuffers(application->window._);
+        // Let go of whatever the GPU's done with, now that this frame's
+        // work has all been submitted.
+        LetoAdvanceReleases();
     }
 
     if (application->display_functions.kill._ != NULL)
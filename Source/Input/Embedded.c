@@ -0,0 +1,56 @@
+/**
+ * @file Embedded.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements lookups into the embedded resource table. The table
+ * itself is generated at build time by EmbedResources.cmake.
+ * @implements Embedded.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Embedded.h" // Public interface parent
+
+#include <stdlib.h> // Standard binary search
+#include <string.h> // Standard string utilities
+
+#if defined(LETO_EMBED_SHADERS)
+/**
+ * @brief The generated resource table, sorted by path.
+ */
+extern const leto_embedded_file_t leto_embedded_files[];
+
+/**
+ * @brief The amount of resources in @ref leto_embedded_files.
+ */
+extern const size_t leto_embedded_file_count;
+
+/**
+ * CompareFiles
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Compare a path against a table entry, for @ref bsearch.
+ *
+ * @param key The path being searched for.
+ * @param entry The table entry being compared against.
+ * @return int -- The result of @ref strcmp.
+ */
+static int CompareFiles_(const void *key, const void *entry)
+{
+    return strcmp((const char *)key,
+                  ((const leto_embedded_file_t *)entry)->path);
+}
+#endif
+
+const leto_embedded_file_t *LetoFindEmbeddedFile(const char *path)
+{
+#if defined(LETO_EMBED_SHADERS)
+    if (path == NULL) return NULL;
+    return bsearch(path, leto_embedded_files, leto_embedded_file_count,
+                   sizeof(leto_embedded_file_t), CompareFiles_);
+#else
+    (void)path;
+    return NULL;
+#endif
+}
@@ -0,0 +1,55 @@
+/**
+ * @file Embedded.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides access to the resources compiled into the executable at
+ * build time. Currently, this is only the shader directory, and only when
+ * the LETO_EMBED_SHADERS build option is on.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__EMBEDDED_H
+#define LETO__EMBEDDED_H
+
+// Standard size type.
+#include <stddef.h>
+
+/**
+ * @brief A single resource baked into the executable.
+ */
+typedef struct leto_embedded_file
+{
+    /**
+     * @brief The path of the resource, relative to the resource
+     * directory, i.e "Shaders/basic/vert.vs".
+     */
+    const char *path;
+    /**
+     * @brief The contents of the resource. This is always followed by a
+     * NUL byte, so text resources can be used as strings directly.
+     */
+    const unsigned char *data;
+    /**
+     * @brief The size of the resource in bytes, not counting the
+     * terminating NUL.
+     */
+    size_t size;
+} leto_embedded_file_t;
+
+/**
+ * FindEmbeddedFile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Look up an embedded resource by its path. This does no file I/O
+ * and no allocation.
+ *
+ * @param path The path of the resource, relative to the resource
+ * directory.
+ * @return const leto_embedded_file_t* -- The resource, or NULL if nothing
+ * was embedded under that path.
+ */
+const leto_embedded_file_t *LetoFindEmbeddedFile(const char *path);
+
+#endif // LETO__EMBEDDED_H
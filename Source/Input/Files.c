@@ -19,28 +19,10 @@
 void LetoToggleFile(FILE **file, const char *mode, const char *path_format,
                     ...)
 {
-    if (*file != NULL)
-    {
-        fclose(*file);
-        return;
-    }
-
-    char *full_format = NULL, *path = NULL;
-    LETO_ALLOC_OR_FAIL(full_format, 14 + strlen(path_format));
-    snprintf(full_format, LETO_MAX_PATH_LENGTH, ASSET_DIR "/%s",
-             path_format);
-
-    LETO_ALLOC_OR_FAIL(path, LETO_MAX_PATH_LENGTH);
     va_list args;
     va_start(args, path_format);
-    vsnprintf(path, LETO_MAX_PATH_LENGTH, full_format, args);
-
-    *file = fopen(path_format, mode);
-    if (*file == NULL)
-        LetoReportError(false, failed_file_open, LETO_FILE_CONTEXT);
-
-    free(full_format);
-    free(path);
+    LetoToggleFileV(file, mode, path_format, args);
+    va_end(args);
 }
 
 void LetoToggleFileV(FILE **file, const char *mode,
@@ -0,0 +1,239 @@
+/**
+ * @file MeshFormat.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Describes Leto's binary mesh format. This header is shared
+ * between the engine and the offline tools, so it must not depend on
+ * anything but the standard library. Every value is little-endian.
+ *
+ * A mesh file is laid out as follows; the header, the submesh table, the
+ * interleaved vertex stream (aligned to 16 bytes), and the index stream
+ * (aligned to 4 bytes). The vertex and index streams are contiguous, so
+ * they can be read into a single buffer in one go.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__MESH_FORMAT_H
+#define LETO__MESH_FORMAT_H
+
+// Fixed-width integer types.
+#include <stdint.h>
+
+/**
+ * @brief The first four bytes of every mesh file, "LMSH".
+ */
+#define LETO_MESH_MAGIC 0x48534D4Cu
+
+/**
+ * @brief The version of the format described here. Files of any other
+ * version are refused.
+ */
+#define LETO_MESH_VERSION 1
+
+/**
+ * @brief The maximum amount of levels of detail a mesh can carry.
+ */
+#define LETO_MESH_MAX_LODS 4
+
+/**
+ * @brief The amount of attribute slots in the vertex layout. Slot N is
+ * fed to vertex attribute location N.
+ */
+#define LETO_MESH_ATTRIBUTES 4
+
+/**
+ * @brief The alignment of the vertex stream within the file.
+ */
+#define LETO_MESH_VERTEX_ALIGNMENT 16
+
+/**
+ * @brief The meaning of each attribute slot.
+ */
+typedef enum leto_mesh_attribute_slot
+{
+    /**
+     * @brief The position of the vertex. When stored normalized, this is
+     * relative to the mesh's bounding box.
+     */
+    attribute_position,
+    /**
+     * @brief The normal of the vertex.
+     */
+    attribute_normal,
+    /**
+     * @brief The texture coordinates of the vertex.
+     */
+    attribute_texture_coordinates,
+    /**
+     * @brief The tangent of the vertex, if any.
+     */
+    attribute_tangent
+} leto_mesh_attribute_slot_t;
+
+/**
+ * @brief The formats an attribute can be stored in.
+ */
+typedef enum leto_mesh_attribute_format
+{
+    /**
+     * @brief The slot is unused.
+     */
+    attribute_none,
+    /**
+     * @brief 32-bit floats.
+     */
+    attribute_float,
+    /**
+     * @brief 16-bit floats.
+     */
+    attribute_half,
+    /**
+     * @brief 16-bit unsigned integers normalized to [0, 1].
+     */
+    attribute_unorm16,
+    /**
+     * @brief 16-bit signed integers normalized to [-1, 1].
+     */
+    attribute_snorm16,
+    /**
+     * @brief A unit vector folded onto an octahedron, stored as two
+     * normalized 16-bit signed integers. Shaders have to unfold it.
+     */
+    attribute_octahedral
+} leto_mesh_attribute_format_t;
+
+/**
+ * @brief A single entry of the vertex layout.
+ */
+typedef struct leto_mesh_attribute
+{
+    /**
+     * @brief The @ref leto_mesh_attribute_format_t of the attribute.
+     */
+    uint8_t format;
+    /**
+     * @brief The amount of components of the attribute, one to four.
+     */
+    uint8_t components;
+    /**
+     * @brief The offset of the attribute within a vertex, in bytes.
+     */
+    uint16_t offset;
+} leto_mesh_attribute_t;
+
+/**
+ * @brief A range of the index stream.
+ */
+typedef struct leto_mesh_range
+{
+    /**
+     * @brief The first index of the range.
+     */
+    uint32_t first_index;
+    /**
+     * @brief The amount of indices in the range.
+     */
+    uint32_t index_count;
+} leto_mesh_range_t;
+
+/**
+ * @brief A part of a mesh drawn with a single material.
+ */
+typedef struct leto_mesh_submesh
+{
+    /**
+     * @brief The index of the submesh's material, as ordered in the
+     * source file.
+     */
+    uint32_t material;
+    /**
+     * @brief The indices of the submesh at each level of detail. Levels
+     * past the mesh's LOD count are empty.
+     */
+    leto_mesh_range_t lods[LETO_MESH_MAX_LODS];
+} leto_mesh_submesh_t;
+
+/**
+ * @brief The header at the very start of a mesh file.
+ */
+typedef struct leto_mesh_header
+{
+    /**
+     * @brief Always @ref LETO_MESH_MAGIC.
+     */
+    uint32_t magic;
+    /**
+     * @brief Always @ref LETO_MESH_VERSION.
+     */
+    uint16_t version;
+    /**
+     * @brief The size of a single vertex, in bytes.
+     */
+    uint16_t vertex_stride;
+    /**
+     * @brief The amount of vertices in the vertex stream.
+     */
+    uint32_t vertex_count;
+    /**
+     * @brief The amount of indices in the index stream, over every
+     * submesh and level of detail.
+     */
+    uint32_t index_count;
+    /**
+     * @brief The size of a single index; 2 or 4 bytes.
+     */
+    uint8_t index_size;
+    /**
+     * @brief The amount of levels of detail, at least one.
+     */
+    uint8_t lod_count;
+    /**
+     * @brief The amount of entries in the submesh table.
+     */
+    uint16_t submesh_count;
+    /**
+     * @brief The layout of a single vertex.
+     */
+    leto_mesh_attribute_t attributes[LETO_MESH_ATTRIBUTES];
+    /**
+     * @brief The lowest corner of the mesh's bounding box.
+     */
+    float minimum[3];
+    /**
+     * @brief The highest corner of the mesh's bounding box.
+     */
+    float maximum[3];
+    /**
+     * @brief The mesh's bounding sphere; center, then radius.
+     */
+    float sphere[4];
+    /**
+     * @brief The largest distance, in model units, any level of detail
+     * moves the surface away from the original. The first level is
+     * always 0.
+     */
+    float lod_errors[LETO_MESH_MAX_LODS];
+    /**
+     * @brief The offset of the vertex stream from the start of the file.
+     */
+    uint32_t vertex_offset;
+    /**
+     * @brief The offset of the index stream from the start of the file.
+     */
+    uint32_t index_offset;
+    /**
+     * @brief Reserved for later versions; always 0.
+     */
+    uint32_t flags;
+} leto_mesh_header_t;
+
+// The header is read and written as-is, so it mustn't be padded.
+_Static_assert(sizeof(leto_mesh_header_t) == 104,
+               "The mesh header must be 104 bytes.");
+_Static_assert(sizeof(leto_mesh_submesh_t) == 36,
+               "A submesh entry must be 36 bytes.");
+
+#endif // LETO__MESH_FORMAT_H
@@ -0,0 +1,290 @@
+/**
+ * @file Meshes.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's mesh loader.
+ * @implements Meshes.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Meshes.h"           // Public interface parent
+#include <Input/Files.h>      // File utilities
+#include <Output/Errors.h>    // Error reporting
+#include <Utilities/Macros.h> // Utility macros
+
+#include <CGLM/affine.h> // GLM transformations
+
+#include <math.h>   // Standard math functions
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * ValidateHeader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure a mesh header is something we can actually load.
+ *
+ * @param header The header to check.
+ * @return bool -- True if the header is valid, false if not.
+ */
+static bool ValidateHeader_(const leto_mesh_header_t *header)
+{
+    if (header->magic != LETO_MESH_MAGIC) return false;
+    if (header->version != LETO_MESH_VERSION) return false;
+    if (header->index_size != 2 && header->index_size != 4) return false;
+    if (header->lod_count == 0 || header->lod_count > LETO_MESH_MAX_LODS)
+        return false;
+    if (header->vertex_stride == 0 || header->submesh_count == 0)
+        return false;
+
+    // Every attribute has to fit within a vertex.
+    for (size_t i = 0; i < LETO_MESH_ATTRIBUTES; i++)
+    {
+        const leto_mesh_attribute_t *attribute = &header->attributes[i];
+        if (attribute->format == attribute_none) continue;
+        if (attribute->format > attribute_octahedral) return false;
+        if (attribute->components == 0 || attribute->components > 4)
+            return false;
+        const size_t size = attribute->format == attribute_float ? 4 : 2;
+        if (attribute->offset + attribute->components * size >
+            header->vertex_stride)
+            return false;
+    }
+
+    // The streams have to follow the submesh table, in order.
+    size_t table_end = sizeof(leto_mesh_header_t) +
+                       header->submesh_count * sizeof(leto_mesh_submesh_t);
+    size_t vertex_end =
+        header->vertex_offset +
+        (size_t)header->vertex_count * header->vertex_stride;
+    return header->vertex_offset >= table_end &&
+           header->index_offset >= vertex_end &&
+           header->attributes[attribute_position].format != attribute_none;
+}
+
+/**
+ * ValidateSubmeshes
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure every range of a mesh's submesh table lies within its
+ * index stream.
+ *
+ * @param mesh The mesh, with its header and submesh table read.
+ * @return bool -- True if the table is valid, false if not.
+ */
+static bool ValidateSubmeshes_(const leto_mesh_t *mesh)
+{
+    const leto_mesh_header_t *header = &mesh->header;
+    for (size_t i = 0; i < header->submesh_count; i++)
+        for (size_t j = 0; j < header->lod_count; j++)
+        {
+            const leto_mesh_range_t *range = &mesh->submeshes[i].lods[j];
+            if (range->index_count % 3 != 0) return false;
+            if ((uint64_t)range->first_index + range->index_count >
+                header->index_count)
+                return false;
+        }
+    return true;
+}
+
+/**
+ * ReadIndices
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Read a mesh's index stream into its place in the arena. Indices
+ * are read into a scratch buffer first, so each can be checked against
+ * the vertex stream; the arena only holds 32-bit indices, so 16-bit ones
+ * are widened on the way.
+ *
+ * @param mesh The mesh whose geometry to fill.
+ * @param file The mesh file, at the start of the index stream.
+ * @return bool -- True for success, false for failure or if an index is
+ * out of range.
+ */
+static bool ReadIndices_(leto_mesh_t *mesh, FILE *file)
+{
+    const size_t count = mesh->header.index_count;
+    const size_t size = mesh->header.index_size;
+    unsigned char *scratch = NULL;
+    LETO_ALLOC_OR_FAIL(scratch, count * size);
+    if (fread(scratch, size, count, file) != count)
+    {
+        free(scratch);
+        return false;
+    }
+
+    uint32_t *mapping = LetoMapGeometry(&mesh->geometry, geometry_indices);
+    if (mapping == NULL)
+    {
+        free(scratch);
+        return false;
+    }
+
+    bool valid = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t index;
+        if (size == 2)
+        {
+            uint16_t narrow;
+            memcpy(&narrow, scratch + i * size, sizeof(narrow));
+            index = narrow;
+        }
+        else memcpy(&index, scratch + i * size, sizeof(index));
+        // Out of range indices would read past the mesh in the arena.
+        if (index >= mesh->header.vertex_count) valid = false;
+        mapping[i] = valid ? index : 0;
+    }
+    LetoUnmapGeometry(&mesh->geometry, geometry_indices);
+    free(scratch);
+    return valid;
+}
+
+bool LetoLoadMesh(leto_mesh_t *mesh, const char *name)
+{
+    if (mesh == NULL || name == NULL) return false;
+    memset(mesh, 0, sizeof(leto_mesh_t));
+    mesh->geometry.format = LETO_GEOMETRY_NONE;
+
+    FILE *file = NULL;
+    LetoToggleFile(&file, "rb", "Meshes/%s.mesh", name);
+    if (file == NULL) return false;
+
+    if (fread(&mesh->header, sizeof(leto_mesh_header_t), 1, file) != 1 ||
+        !ValidateHeader_(&mesh->header))
+    {
+        LetoReportError(false, invalid_mesh, LETO_FILE_CONTEXT);
+        fclose(file);
+        return false;
+    }
+
+    const leto_mesh_header_t *header = &mesh->header;
+    size_t table_size =
+        header->submesh_count * sizeof(leto_mesh_submesh_t);
+    LETO_ALLOC_OR_FAIL(mesh->submeshes, table_size);
+    if (fread(mesh->submeshes, table_size, 1, file) != 1 ||
+        fseek(file, (long)header->vertex_offset, SEEK_SET) != 0)
+    {
+        LetoReportError(false, failed_file_read, LETO_FILE_CONTEXT);
+        LetoDestroyMesh(mesh);
+        fclose(file);
+        return false;
+    }
+    if (!ValidateSubmeshes_(mesh))
+    {
+        LetoReportError(false, invalid_mesh, LETO_FILE_CONTEXT);
+        LetoDestroyMesh(mesh);
+        fclose(file);
+        return false;
+    }
+
+    uint32_t format =
+        LetoFindVertexFormat(header->vertex_stride, header->attributes);
+    if (format == LETO_GEOMETRY_NONE ||
+        !LetoAllocateGeometry(&mesh->geometry, format,
+                              header->vertex_count, header->index_count))
+    {
+        LetoDestroyMesh(mesh);
+        fclose(file);
+        return false;
+    }
+
+    // The file's vertex layout already is the arena's layout.
+    void *mapping = LetoMapGeometry(&mesh->geometry, geometry_vertices);
+    if (mapping == NULL)
+    {
+        LetoDestroyMesh(mesh);
+        fclose(file);
+        return false;
+    }
+    bool read = fread(mapping, header->vertex_stride, header->vertex_count,
+                      file) == header->vertex_count;
+    LetoUnmapGeometry(&mesh->geometry, geometry_vertices);
+
+    read = read &&
+           fseek(file, (long)header->index_offset, SEEK_SET) == 0 &&
+           ReadIndices_(mesh, file);
+    fclose(file);
+    if (!read)
+    {
+        LetoReportError(false, failed_file_read, LETO_FILE_CONTEXT);
+        LetoDestroyMesh(mesh);
+        return false;
+    }
+
+    // Normalized positions are relative to the bounding box. A flat axis
+    // keeps a scale of one, so the matrix can still be inverted.
+    glm_mat4_identity(mesh->dequantize);
+    if (header->attributes[attribute_position].format == attribute_unorm16)
+    {
+        vec3 minimum, extent;
+        glm_vec3_copy((float *)header->minimum, minimum);
+        glm_vec3_sub((float *)header->maximum, minimum, extent);
+        for (size_t i = 0; i < 3; i++)
+            if (extent[i] <= 0.0f) extent[i] = 1.0f;
+        glm_translate(mesh->dequantize, minimum);
+        glm_scale(mesh->dequantize, extent);
+    }
+
+    return true;
+}
+
+void LetoDestroyMesh(leto_mesh_t *mesh)
+{
+    if (mesh == NULL) return;
+
+    LetoFreeGeometry(&mesh->geometry);
+    free(mesh->submeshes);
+    memset(mesh, 0, sizeof(leto_mesh_t));
+}
+
+bool LetoGetSubmeshCommand(const leto_mesh_t *mesh, size_t submesh,
+                           size_t lod, leto_draw_command_t *command)
+{
+    if (mesh == NULL || command == NULL) return false;
+    if (submesh >= mesh->header.submesh_count) return false;
+    if (lod >= mesh->header.lod_count) lod = mesh->header.lod_count - 1;
+
+    const leto_mesh_range_t *range = &mesh->submeshes[submesh].lods[lod];
+    if (range->index_count == 0) return false;
+
+    command->index_count = range->index_count;
+    command->first_index = mesh->geometry.first_index + range->first_index;
+    command->base_vertex = (int32_t)mesh->geometry.first_vertex;
+    return true;
+}
+
+size_t LetoSelectMeshLod(const leto_mesh_t *mesh,
+                         const leto_camera_t *camera, mat4 model,
+                         float viewport_height, float pixel_error)
+{
+    if (mesh == NULL || camera == NULL || mesh->header.lod_count < 2)
+        return 0;
+
+    // Errors and the bounding sphere both scale with the model; assume
+    // the worst if the scale isn't uniform.
+    float scale = 0.0f;
+    for (size_t i = 0; i < 3; i++)
+        scale = fmaxf(scale, glm_vec3_norm(model[i]));
+
+    vec3 center;
+    glm_mat4_mulv3(model, (float *)mesh->header.sphere, 1.0f, center);
+    float distance = glm_vec3_distance(center, (float *)camera->position) -
+                     mesh->header.sphere[3] * scale;
+    // Inside the sphere (or nearly), anything but the full mesh shows.
+    if (distance <= 1e-3f) return 0;
+
+    // Pixels per world unit at that distance.
+    const float projection =
+        viewport_height / (2.0f * tanf(glm_rad(camera->fov) * 0.5f));
+    const float pixels_per_unit = scale * projection / distance;
+
+    size_t lod = 0;
+    for (size_t i = 1; i < mesh->header.lod_count; i++)
+    {
+        if (mesh->header.lod_errors[i] * pixels_per_unit > pixel_error)
+            break;
+        lod = i;
+    }
+    return lod;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file Meshes.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's mesh loader. Meshes are read from the binary
+ * format described in MeshFormat.h, straight into the geometry arena of
+ * their vertex format.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__MESHES_H
+#define LETO__MESHES_H
+
+// The binary mesh format.
+#include <Input/MeshFormat.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size type.
+#include <stddef.h>
+// GLM 4x4 matrices.
+#include <CGLM/mat4.h>
+// The engine's camera interface.
+#include <Rendering/Camera.h>
+// The engine's geometry arena.
+#include <Rendering/Geometry.h>
+
+/**
+ * @brief A mesh loaded onto the GPU.
+ */
+typedef struct leto_mesh
+{
+    /**
+     * @brief The mesh's vertices and indices within the geometry arena.
+     */
+    leto_geometry_t geometry;
+    /**
+     * @brief The header the mesh was loaded from.
+     */
+    leto_mesh_header_t header;
+    /**
+     * @brief The submesh table, @ref header.submesh_count entries long.
+     */
+    leto_mesh_submesh_t *submeshes;
+    /**
+     * @brief The matrix taking stored positions back to model space. For
+     * normalized positions this maps [0, 1] onto the bounding box; for
+     * anything else it's the identity. Fold this into the model matrix.
+     */
+    mat4 dequantize;
+} leto_mesh_t;
+
+/**
+ * LoadMesh
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Load a mesh from the resource directory. The vertex stream, and
+ * 32-bit index streams, are read directly into the mapped arena without
+ * passing through any intermediate allocation; 16-bit indices are
+ * widened on the way in.
+ *
+ * @param mesh The mesh to initialize.
+ * @param name The name of the mesh, i.e "car" for Meshes/car.mesh.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoLoadMesh(leto_mesh_t *mesh, const char *name);
+
+/**
+ * DestroyMesh
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Release the GPU and CPU resources of a mesh.
+ *
+ * @param mesh The mesh to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyMesh(leto_mesh_t *mesh);
+
+/**
+ * GetSubmeshCommand
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fill in the geometry of an indirect draw of one level of detail
+ * of a submesh. Levels past the mesh's last are clamped to it. The
+ * instance fields are left for the caller.
+ *
+ * @param mesh The mesh to draw.
+ * @param submesh The index of the submesh to draw.
+ * @param lod The level of detail to draw.
+ * @param command The command to fill in.
+ * @return bool -- True if there is anything to draw, false if not.
+ */
+bool LetoGetSubmeshCommand(const leto_mesh_t *mesh, size_t submesh,
+                           size_t lod, leto_draw_command_t *command);
+
+/**
+ * SelectMeshLod
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Pick the coarsest level of detail whose error, projected onto
+ * the screen from the camera's position and field of view, stays within
+ * the given amount of pixels. The distance is taken to the near side of
+ * the mesh's bounding sphere, so the pick is conservative.
+ *
+ * @param mesh The mesh to pick a level for.
+ * @param camera The camera the mesh is seen through.
+ * @param model The object-to-world matrix of the mesh, without the
+ * dequantization matrix.
+ * @param viewport_height The height of the viewport, in pixels.
+ * @param pixel_error The largest error allowed on screen, in pixels.
+ * @return size_t -- The level of detail to draw.
+ */
+size_t LetoSelectMeshLod(const leto_mesh_t *mesh,
+                         const leto_camera_t *camera, mat4 model,
+                         float viewport_height, float pixel_error);
+
+#endif // LETO__MESHES_H
@@ -12,19 +12,54 @@
  * entails, please see the attached @file LICENSE.md file.
  */
 
-#include "Shaders.h" // Public interface parent
-#include "Files.h"   // File operations
+#include "Shaders.h"  // Public interface parent
+#include "Embedded.h" // Embedded shader sources
+#include "Files.h"    // File operations
 
-#include <Output/Errors.h>    // Error reporting
-#include <Utilities/Macros.h> // Utility macros
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Deferred object release
+#include <Utilities/Macros.h>  // Utility macros
 
-#include <CGLM/cam.h>  // GLM camera-related functions
-#include <CGLM/mat4.h> // GLM matrix 4x4
-#include <GLAD2/gl.h>  // OpenGL function pointers
+#include <CGLM/cam.h>   // GLM camera-related functions
+#include <CGLM/mat4.h>  // GLM matrix 4x4
+#include <GLAD2/gl.h>   // OpenGL function pointers
+#include <GLFW/glfw3.h> // Extension function loading
 
 #include <stdio.h>  // Standard I/O functions
 #include <string.h> // String-related functionality
 
+/**
+ * @brief The offset every projection is jittered by, in normalized device
+ * coordinates.
+ */
+static vec2 projection_jitter = {0.0f, 0.0f};
+
+/**
+ * @brief The most programs whose uniform locations are cached at once.
+ * Any past this are looked up every time instead.
+ */
+#define LETO_MAX_CACHED_PROGRAMS 32
+
+/**
+ * @brief The names of the engine's uniforms, in the order of @ref
+ * leto_uniform_t.
+ */
+static const char *const uniform_names[uniform_count] = {
+    "projection_matrix", "projection_jitter",  "camera_view",
+    "shadow_matrix",     "cascade_matrices",   "cascade_splits",
+    "sun_direction",     "sun_color",          "cluster_scale",
+    "cluster_bias",      "previous_view_projection"};
+
+/**
+ * @brief The uniform locations of every program loaded here, found when
+ * each one linked. A program of 0 marks an empty slot.
+ */
+static struct
+{
+    unsigned int program;
+    int locations[uniform_count];
+} uniform_cache[LETO_MAX_CACHED_PROGRAMS];
+
 /**
  * CheckShaderError
  * @author Israfiel (https://github.com/israfiel-a)
@@ -35,7 +70,7 @@
  *
  * @param piece The item we're trying to get an error report from.
  * @param type The type of item; @ref GL_VERTEX_SHADER, @ref
- * GL_FRAGMENT_SHADER, or @ref GL_PROGRAM.
+ * GL_FRAGMENT_SHADER, @ref GL_COMPUTE_SHADER, or @ref GL_PROGRAM.
  * @return bool -- True for no error, false for an error occurred.
  */
 static bool CheckShaderError_(unsigned int piece, unsigned int type)
@@ -43,7 +78,8 @@ static bool CheckShaderError_(unsigned int piece, unsigned int type)
     int success_flag = false; // OpenGL reports into an integer.
     char error_info[1024];
 
-    if (type == GL_VERTEX_SHADER || type == GL_FRAGMENT_SHADER)
+    if (type == GL_VERTEX_SHADER || type == GL_FRAGMENT_SHADER ||
+        type == GL_COMPUTE_SHADER)
     {
         glGetShaderiv(piece, GL_COMPILE_STATUS, &success_flag);
         if (!success_flag)
@@ -65,65 +101,583 @@ static bool CheckShaderError_(unsigned int piece, unsigned int type)
     return success_flag;
 }
 
+/**
+ * @brief The status enum used to query whether the driver has finished
+ * compiling/linking an object. GLAD was generated without
+ * KHR_parallel_shader_compile, so we define the values ourselves.
+ */
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
+/**
+ * @brief The value passed to glMaxShaderCompilerThreadsKHR to let the
+ * driver pick however many compiler threads it sees fit.
+ */
+#define LETO_DRIVER_THREAD_COUNT 0xFFFFFFFF
+
+/**
+ * @brief The function signature of glMaxShaderCompilerThreadsKHR, which
+ * we have to load ourselves for the same reason as above.
+ */
+typedef void (*max_compiler_threads_t)(unsigned int count);
+
+/**
+ * @brief The source of the built-in fallback program. This mirrors the
+ * interface of the basic shader, but draws everything in flat magenta so
+ * it's obvious when something isn't ready.
+ */
+static const char *const fallback_sources[2] = {
+    "#version 460 core\n"
+    "layout(location = 0) in vec3 position;\n"
+    "uniform mat4 projection_matrix;\n"
+    "uniform mat4 camera_view;\n"
+    "struct instance_data\n"
+    "{\n"
+    "    mat4 model;\n"
+    "    mat3 normal_matrix;\n"
+    "    uvec4 material;\n"
+    "};\n"
+    "layout(std430, binding = 2) readonly buffer instance_buffer\n"
+    "{\n"
+    "    instance_data instances[];\n"
+    "};\n"
+    "layout(std430, binding = 3) readonly buffer draw_buffer\n"
+    "{\n"
+    "    uvec4 draws[];\n"
+    "};\n"
+    "void main()\n"
+    "{\n"
+    "    uint instance = draws[gl_DrawID].x + gl_InstanceID;\n"
+    "    mat4 model = instances[instance].model;\n"
+    "    gl_Position = projection_matrix * camera_view * model *\n"
+    "                  vec4(position, 1.0);\n"
+    "}\n",
+    "#version 460 core\n"
+    "layout(location = 0) out vec4 fragmentColor;\n"
+    "void main() { fragmentColor = vec4(1.0, 0.0, 1.0, 1.0); }\n"};
+
+/**
+ * ParallelCompileSupported
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check (once) whether the driver exposes the KHR or ARB
+ * parallel shader compile extension. If it does, the driver is also told
+ * to use as many compiler threads as it likes.
+ *
+ * @return bool -- True if @ref GL_COMPLETION_STATUS_KHR can be queried.
+ */
+static bool ParallelCompileSupported_(void)
+{
+    // -1 means we have not yet checked.
+    static int supported = -1;
+    if (supported != -1) return supported;
+    supported = false;
+
+    int extension_count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+    for (int i = 0; i < extension_count; i++)
+    {
+        const char *extension =
+            (const char *)glGetStringi(GL_EXTENSIONS, (unsigned int)i);
+        if (strcmp(extension, "GL_KHR_parallel_shader_compile") == 0 ||
+            strcmp(extension, "GL_ARB_parallel_shader_compile") == 0)
+        {
+            supported = true;
+            break;
+        }
+    }
+    if (!supported) return false;
+
+    max_compiler_threads_t max_threads = (max_compiler_threads_t)
+        glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    if (max_threads == NULL)
+        max_threads = (max_compiler_threads_t)glfwGetProcAddress(
+            "glMaxShaderCompilerThreadsARB");
+    if (max_threads != NULL) max_threads(LETO_DRIVER_THREAD_COUNT);
+
+    return true;
+}
+
 /**
  * CompileShader
  * @author Israfiel (https://github.com/israfiel-a)
- * @brief Compile the given type of shader within the given shader folder.
+ * @brief Submit the given source for compilation. This does not wait for
+ * or check the result of the compilation.
  *
- * @param shader A storage position for the OpenGL ID of the shader object.
- * @param name The name of the shader's containing folder.
+ * @param source The GLSL source of the stage.
  * @param type The OpenGL type of the shader, i.e @ref GL_VERTEX_SHADER,
  * @ref GL_FRAGMENT_SHADER, etc.
- * @return void -- Nothing.
+ * @return unsigned int -- The OpenGL ID of the shader object.
  */
-static void CompileShader_(unsigned int *shader, const char *name,
-                           unsigned int type)
+static unsigned int CompileShader_(const char *source, unsigned int type)
 {
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    return shader;
+}
+
+/**
+ * @brief The deepest includes can be nested. This also stops a file that
+ * includes itself from recursing forever.
+ */
+#define LETO_MAX_INCLUDE_DEPTH 8
+
+/**
+ * ReadSource
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find a source file under the shader directory. When shaders are
+ * embedded, the source comes straight out of the executable; otherwise,
+ * it's read from disk.
+ *
+ * @param path The path of the file, relative to the shader directory.
+ * @return char* -- A copy of the source, which must be freed, or NULL if
+ * it couldn't be found.
+ */
+static char *ReadSource_(const char *path)
+{
+#if defined(LETO_EMBED_SHADERS)
+    char full_path[LETO_MAX_PATH_LENGTH];
+    const leto_embedded_file_t *source = NULL;
+    if (snprintf(full_path, LETO_MAX_PATH_LENGTH, LETO_SHADER_PATH "/%s",
+                 path) < LETO_MAX_PATH_LENGTH)
+        source = LetoFindEmbeddedFile(full_path);
+    if (source == NULL)
+    {
+        LetoReportError(false, missing_embedded_file, LETO_FILE_CONTEXT);
+        return NULL;
+    }
+    return strdup((const char *)source->data);
+#else
     char *buffer = NULL;
-    LetoReadFile(&buffer, 0, LETO_SHADER_PATH "/%s/%s", name,
-                 (type == GL_VERTEX_SHADER ? "vert.vs" : "frag.fs"));
-    if (buffer == NULL) *shader = 0;
+    LetoReadFile(&buffer, 0, LETO_SHADER_PATH "/%s", path);
+    return buffer;
+#endif
+}
+
+/**
+ * FindInclude
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the next line of the form '#include "file"' in a source.
+ *
+ * @param source Where to start looking. This must be the start of a line.
+ * @param name Filled with the start of the included file's name.
+ * @param length Filled with the length of the included file's name.
+ * @return char* -- The start of the line, or NULL if there are no more.
+ */
+static char *FindInclude_(char *source, const char **name, size_t *length)
+{
+    for (char *line = source; *line != '\0';)
+    {
+        const char *start = line + strspn(line, " \t");
+        if (strncmp(start, "#include", 8) == 0)
+        {
+            start += 8 + strspn(start + 8, " \t");
+            const char *end = strchr(start + 1, '"');
+            const char *newline = strchr(start, '\n');
+            if (*start == '"' && end != NULL &&
+                (newline == NULL || end < newline))
+            {
+                *name = start + 1;
+                *length = (size_t)(end - *name);
+                return line;
+            }
+        }
+
+        char *next = strchr(line, '\n');
+        if (next == NULL) break;
+        line = next + 1;
+    }
+    return NULL;
+}
 
-    const char *code = buffer;
-    *shader = glCreateShader(type);
-    glShaderSource(*shader, 1, &code, NULL);
-    glCompileShader(*shader);
+/**
+ * ExpandIncludes
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Replace every '#include "file"' line of a source with the
+ * contents of that file, relative to the shader directory. GLSL has no
+ * include directive of its own, so this is how stages share code.
+ *
+ * @param source The source to expand, which is freed. If NULL, this does
+ * nothing.
+ * @param depth How deeply nested the source is; zero for a stage.
+ * @return char* -- The expanded source, which must be freed, or NULL if
+ * an included file couldn't be found or includes nest too deeply.
+ */
+static char *ExpandIncludes_(char *source, size_t depth)
+{
+    if (source == NULL) return NULL;
 
-    if (CheckShaderError_(*shader, type) == false)
+    const char *name = NULL;
+    size_t length = 0, searched = 0;
+    char *line;
+    while ((line = FindInclude_(source + searched, &name, &length)) !=
+           NULL)
     {
-        LetoReportError(false, failed_shader, LETO_FILE_CONTEXT);
-        *shader = 0;
+        char path[LETO_MAX_PATH_LENGTH];
+        snprintf(path, LETO_MAX_PATH_LENGTH, "%.*s", (int)length, name);
+        if (depth == LETO_MAX_INCLUDE_DEPTH)
+        {
+            LetoReportError(false, failed_shader, LETO_FILE_CONTEXT);
+            free(source);
+            return NULL;
+        }
+
+        char *included = ExpandIncludes_(ReadSource_(path), depth + 1);
+        if (included == NULL)
+        {
+            free(source);
+            return NULL;
+        }
+
+        // Splice the file in where the line was; whatever it includes is
+        // already expanded, so the search picks up after it.
+        const char *rest = strchr(line, '\n');
+        rest = (rest != NULL ? rest + 1 : line + strlen(line));
+        const size_t before = (size_t)(line - source);
+        const size_t size = strlen(included);
+        const size_t after = strlen(rest);
+
+        char *expanded = NULL;
+        LETO_ALLOC_OR_FAIL(expanded, before + size + after + 2);
+        memcpy(expanded, source, before);
+        memcpy(expanded + before, included, size);
+        expanded[before + size] = '\n';
+        memcpy(expanded + before + size + 1, rest, after + 1);
+
+        free(included);
+        free(source);
+        source = expanded;
+        searched = before + size + 1;
+    }
+    return source;
+}
+
+/**
+ * SubmitStage
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the source of one stage of the given shader, expand its
+ * includes, and submit it for compilation.
+ *
+ * @param name The name of the shader's folder.
+ * @param file The name of the stage's source file.
+ * @param type The OpenGL type of the stage.
+ * @return unsigned int -- The OpenGL ID of the stage, or 0 if its source
+ * couldn't be found.
+ */
+static unsigned int SubmitStage_(const char *name, const char *file,
+                                 unsigned int type)
+{
+    char path[LETO_MAX_PATH_LENGTH];
+    if (snprintf(path, LETO_MAX_PATH_LENGTH, "%s/%s", name, file) >=
+        LETO_MAX_PATH_LENGTH)
+        return 0;
+
+    char *source = ExpandIncludes_(ReadSource_(path), 0);
+    if (source == NULL) return 0;
+
+    unsigned int stage = CompileShader_(source, type);
+    free(source);
+    return stage;
+}
+
+/**
+ * SubmitStages
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Submit the vertex and fragment stages of the given shader for
+ * compilation.
+ *
+ * @param shader The shader whose stages we're compiling. Its name must
+ * already be set.
+ * @return bool -- True on success, false if a source couldn't be found.
+ */
+static bool SubmitStages_(leto_shader_t *shader)
+{
+    const char *files[2] = {"vert.vs", "frag.fs"};
+    const unsigned int types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        shader->stages[i] = SubmitStage_(shader->name, files[i], types[i]);
+        if (shader->stages[i] == 0)
+        {
+            if (i == 1) glDeleteShader(shader->stages[0]);
+            shader->stages[0] = 0;
+            shader->state = shader_failed;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * SubmitLink
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Attach the compiled stages of the given shader to a new program
+ * and submit it for linking. Like the compile step, this does not wait.
+ *
+ * @param shader The shader whose stages have been submitted.
+ * @return void -- Nothing.
+ */
+static void SubmitLink_(leto_shader_t *shader)
+{
+    shader->pending = glCreateProgram();
+    glAttachShader(shader->pending, shader->stages[0]);
+    glAttachShader(shader->pending, shader->stages[1]);
+    glLinkProgram(shader->pending);
+    shader->state = shader_pending;
+}
+
+/**
+ * CacheUniforms
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Look up and keep the location of each of the engine's uniforms
+ * in a newly linked program.
+ *
+ * @param program The OpenGL ID of the program.
+ * @return void -- Nothing.
+ */
+static void CacheUniforms_(unsigned int program)
+{
+    for (size_t i = 0; i < LETO_MAX_CACHED_PROGRAMS; i++)
+    {
+        if (uniform_cache[i].program != 0) continue;
+        uniform_cache[i].program = program;
+        for (size_t j = 0; j < uniform_count; j++)
+            uniform_cache[i].locations[j] =
+                glGetUniformLocation(program, uniform_names[j]);
         return;
     }
+}
+
+/**
+ * FinishShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Collect the result of the in-flight program. This blocks if the
+ * driver has not finished yet, so should only be called once it has (or
+ * the driver cannot tell us). On success, the new program replaces the
+ * current one; on failure, the current one is kept.
+ *
+ * @param shader The shader to finish.
+ * @return leto_shader_state_t -- The resulting state of the shader.
+ */
+static leto_shader_state_t FinishShader_(leto_shader_t *shader)
+{
+    // Only query the stages if linking failed; the logs are only
+    // useful then, and querying them on success is wasted round-trips.
+    bool linked = CheckShaderError_(shader->pending, GL_PROGRAM);
+    if (!linked)
+    {
+        CheckShaderError_(shader->stages[0], GL_VERTEX_SHADER);
+        CheckShaderError_(shader->stages[1], GL_FRAGMENT_SHADER);
+        LetoReportError(false, failed_shader, LETO_FILE_CONTEXT);
+        glDeleteProgram(shader->pending);
+    }
+    else
+    {
+        if (shader->id != 0) LetoUnloadShader(shader->id);
+        shader->id = shader->pending;
+        CacheUniforms_(shader->id);
+    }
+
+    glDeleteShader(shader->stages[0]), glDeleteShader(shader->stages[1]);
+    shader->stages[0] = shader->stages[1] = 0;
+    shader->pending = 0;
 
-    free(buffer);
+    shader->state = (linked ? shader_ready : shader_failed);
+    return shader->state;
+}
+
+/**
+ * InitShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Zero out the given shader and give it its name and fallback.
+ *
+ * @param shader The shader to initialize.
+ * @param name The name of the shader's folder.
+ * @param fallback The program to use until the shader is ready.
+ * @return void -- Nothing.
+ */
+static void InitShader_(leto_shader_t *shader, const char *name,
+                        unsigned int fallback)
+{
+    shader->name = (name != NULL ? strdup(name) : NULL);
+    shader->id = shader->pending = 0;
+    shader->stages[0] = shader->stages[1] = 0;
+    shader->fallback = fallback;
+    shader->state = shader_failed;
 }
 
 unsigned int LetoLoadShader(const char *name)
 {
-    if (name == 0) return 0;
+    leto_shader_t shader;
+    if (!LetoQueueShader(&shader, name, 0))
+    {
+        LetoDestroyShader(&shader);
+        return 0;
+    }
 
-    unsigned int vertex, fragment;
-    CompileShader_(&vertex, name, GL_VERTEX_SHADER);
-    CompileShader_(&fragment, name, GL_FRAGMENT_SHADER);
-    if (vertex == 0 || fragment == 0) return 0;
+    // We want the program regardless of what the driver has to say, so
+    // skip the completion query and just collect the result.
+    FinishShader_(&shader);
+    unsigned int created_shader = shader.id;
+    free(shader.name);
+
+    return created_shader;
+}
+
+unsigned int LetoLoadFallbackShader(void)
+{
+    unsigned int vertex =
+        CompileShader_(fallback_sources[0], GL_VERTEX_SHADER);
+    unsigned int fragment =
+        CompileShader_(fallback_sources[1], GL_FRAGMENT_SHADER);
 
     unsigned int created_shader = glCreateProgram();
     glAttachShader(created_shader, vertex);
     glAttachShader(created_shader, fragment);
     glLinkProgram(created_shader);
+    glDeleteShader(vertex), glDeleteShader(fragment);
 
     if (CheckShaderError_(created_shader, GL_PROGRAM) == false)
     {
         LetoReportError(false, failed_shader, LETO_FILE_CONTEXT);
+        glDeleteProgram(created_shader);
         return 0;
     }
+    CacheUniforms_(created_shader);
+    return created_shader;
+}
 
-    glDeleteShader(vertex), glDeleteShader(fragment);
+bool LetoQueueShader(leto_shader_t *shader, const char *name,
+                     unsigned int fallback)
+{
+    return LetoQueueShaders(shader, &name, 1, fallback);
+}
+
+bool LetoQueueShaders(leto_shader_t *shaders, const char **names,
+                      size_t count, unsigned int fallback)
+{
+    if (shaders == NULL || names == NULL) return false;
+    // Make sure the driver has been told to spin up its compiler threads
+    // before we hand it anything.
+    ParallelCompileSupported_();
+
+    // Submit every stage before any link, so that the driver isn't
+    // forced to finish one program's compiles before seeing the next.
+    bool success = true;
+    for (size_t i = 0; i < count; i++)
+    {
+        InitShader_(&shaders[i], names[i], fallback);
+        if (names[i] == NULL || !SubmitStages_(&shaders[i]))
+            success = false;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        if (shaders[i].stages[0] != 0) SubmitLink_(&shaders[i]);
+
+    return success;
+}
+
+bool LetoReloadShader(leto_shader_t *shader)
+{
+    if (shader == NULL || shader->name == NULL) return false;
+
+    // Anything in flight was built from stale source.
+    if (shader->pending != 0) glDeleteProgram(shader->pending);
+    if (shader->stages[0] != 0) glDeleteShader(shader->stages[0]);
+    if (shader->stages[1] != 0) glDeleteShader(shader->stages[1]);
+    shader->pending = shader->stages[0] = shader->stages[1] = 0;
+
+    ParallelCompileSupported_();
+    if (!SubmitStages_(shader)) return false;
+    SubmitLink_(shader);
+    return true;
+}
+
+leto_shader_state_t LetoPollShader(leto_shader_t *shader)
+{
+    if (shader == NULL) return shader_failed;
+    if (shader->pending == 0) return shader->state;
+
+    if (ParallelCompileSupported_())
+    {
+        int completed = 0;
+        glGetProgramiv(shader->pending, GL_COMPLETION_STATUS_KHR,
+                       &completed);
+        if (!completed) return shader_pending;
+    }
+
+    return FinishShader_(shader);
+}
+
+size_t LetoPollShaders(leto_shader_t *shaders, size_t count)
+{
+    size_t pending = 0;
+    for (size_t i = 0; i < count; i++)
+        if (LetoPollShader(&shaders[i]) == shader_pending) pending++;
+    return pending;
+}
+
+unsigned int LetoLoadComputeShader(const char *name)
+{
+    if (name == NULL) return 0;
+
+    unsigned int stage = SubmitStage_(name, "comp.cs", GL_COMPUTE_SHADER);
+    if (stage == 0) return 0;
+
+    unsigned int created_shader = glCreateProgram();
+    glAttachShader(created_shader, stage);
+    glLinkProgram(created_shader);
+
+    if (CheckShaderError_(created_shader, GL_PROGRAM) == false)
+    {
+        CheckShaderError_(stage, GL_COMPUTE_SHADER);
+        LetoReportError(false, failed_shader, LETO_FILE_CONTEXT);
+        glDeleteShader(stage);
+        glDeleteProgram(created_shader);
+        return 0;
+    }
+    glDeleteShader(stage);
     return created_shader;
 }
 
-void LetoUnloadShader(unsigned int id) { glDeleteProgram(id); }
+unsigned int LetoGetShaderProgram(const leto_shader_t *shader)
+{
+    if (shader == NULL) return 0;
+    return (shader->id != 0 ? shader->id : shader->fallback);
+}
+
+void LetoDestroyShader(leto_shader_t *shader)
+{
+    if (shader == NULL) return;
+
+    if (shader->pending != 0) glDeleteProgram(shader->pending);
+    if (shader->stages[0] != 0) glDeleteShader(shader->stages[0]);
+    if (shader->stages[1] != 0) glDeleteShader(shader->stages[1]);
+    if (shader->id != 0) LetoUnloadShader(shader->id);
+    if (shader->name != NULL) free(shader->name);
+
+    shader->name = NULL;
+    shader->id = shader->pending = 0;
+    shader->stages[0] = shader->stages[1] = 0;
+    shader->state = shader_failed;
+}
+
+void LetoUnloadShader(unsigned int id)
+{
+    // Draws already queued may still be using the program.
+    LetoReleaseObject(program_object, id);
+    for (size_t i = 0; i < LETO_MAX_CACHED_PROGRAMS; i++)
+        if (uniform_cache[i].program == id) uniform_cache[i].program = 0;
+}
+
+int LetoGetUniformLocation(unsigned int program, leto_uniform_t uniform)
+{
+    if (program == 0 || uniform >= uniform_count) return -1;
+    for (size_t i = 0; i < LETO_MAX_CACHED_PROGRAMS; i++)
+        if (uniform_cache[i].program == program)
+            return uniform_cache[i].locations[uniform];
+    return glGetUniformLocation(program, uniform_names[uniform]);
+}
 
 bool LetoSetProjectionMatrix(unsigned int id, float fov, float ratio,
                              float znear, float zfar)
@@ -132,9 +686,10 @@ bool LetoSetProjectionMatrix(unsigned int id, float fov, float ratio,
     static float ratio_storage;
     if (ratio != 0) ratio_storage = ratio;
 
-    // Check to make sure the shader is valid.
-    glUseProgram(id);
-    if (glGetError() != GL_NO_ERROR)
+    // Check to make sure the shader is valid. We set the uniform through
+    // direct state access, so there's no need to make the program
+    // current.
+    if (glIsProgram(id) == GL_FALSE)
     {
         LetoReportError(false, invalid_shader, LETO_FILE_CONTEXT);
         return false;
@@ -142,10 +697,24 @@ bool LetoSetProjectionMatrix(unsigned int id, float fov, float ratio,
 
     mat4 projection = GLM_MAT4_IDENTITY_INIT;
     glm_perspective(glm_rad(fov), ratio_storage, znear, zfar, projection);
+    // Clip-space w is the negated view depth, so this shifts everything
+    // on screen by exactly the jitter.
+    projection[2][0] -= projection_jitter[0];
+    projection[2][1] -= projection_jitter[1];
     // This assumes the variable is named "projection_matrix" in the
     // shader code.
-    glUniformMatrix4fv(glGetUniformLocation(id, "projection_matrix"), 1,
-                       GL_FALSE, &projection[0][0]);
+    int location = LetoGetUniformLocation(id, uniform_projection_matrix);
+    glProgramUniformMatrix4fv(id, location, 1, GL_FALSE,
+                              &projection[0][0]);
+    location = LetoGetUniformLocation(id, uniform_projection_jitter);
+    if (location != -1)
+        glProgramUniform2fv(id, location, 1, projection_jitter);
 
     return true;
 }
+
+void LetoSetProjectionJitter(float x, float y)
+{
+    projection_jitter[0] = x;
+    projection_jitter[1] = y;
+}
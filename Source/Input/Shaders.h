@@ -16,6 +16,8 @@
 
 // Standard boolean definitions.
 #include <stdbool.h>
+// Standard size type.
+#include <stddef.h>
 
 /**
  * @brief The directory in which all shaders should be placed, and that
@@ -23,13 +25,87 @@
  */
 #define LETO_SHADER_PATH "Shaders"
 
+/**
+ * @brief An enumerator describing the states an asynchronously loaded
+ * shader can be in. They are all self-explanatory.
+ */
+typedef enum leto_shader_state
+{
+    shader_pending,
+    shader_ready,
+    shader_failed
+} leto_shader_state_t;
+
+/**
+ * @brief The uniforms the engine sets on programs it was handed rather
+ * than owns. Their locations are looked up once, when a program links,
+ * instead of every time they're set.
+ */
+typedef enum leto_uniform
+{
+    uniform_projection_matrix,
+    uniform_projection_jitter,
+    uniform_camera_view,
+    uniform_shadow_matrix,
+    uniform_cascade_matrices,
+    uniform_cascade_splits,
+    uniform_sun_direction,
+    uniform_sun_color,
+    uniform_cluster_scale,
+    uniform_cluster_bias,
+    uniform_previous_view_projection,
+    uniform_count
+} leto_uniform_t;
+
+/**
+ * @brief A shader program that is compiled and linked in the background.
+ * Until the driver reports the program as complete, the fallback program
+ * is handed out in its place. This struct should only be modified through
+ * the functions below.
+ */
+typedef struct leto_shader
+{
+    /**
+     * @brief The name of the shader's folder under the shader directory.
+     */
+    char *name;
+    /**
+     * @brief The OpenGL ID of the linked, usable program. This is 0 until
+     * the first successful link.
+     */
+    unsigned int id;
+    /**
+     * @brief The OpenGL ID of the program currently being compiled and
+     * linked by the driver, or 0 if nothing is in flight.
+     */
+    unsigned int pending;
+    /**
+     * @brief The OpenGL IDs of the vertex and fragment stages of the
+     * in-flight program. These are kept so their compile logs can be
+     * reported once the driver is finished with them.
+     */
+    unsigned int stages[2];
+    /**
+     * @brief The program handed out while the real one is not ready. This
+     * is not owned by the shader, and is never deleted by it.
+     */
+    unsigned int fallback;
+    /**
+     * @brief The current state of the in-flight program.
+     */
+    leto_shader_state_t state;
+} leto_shader_t;
+
 /**
  * LoadShader
  * @author Israfiel (https://github.com/israfiel-a)
  * @brief Load a full shader from its file within the provided directory.
  * This is not the name of an individual shader file, but rather the
  * subdirectory under the Leto shader directory that the shader's file(s)
- * reside in.
+ * reside in. This function blocks until the program is linked; prefer
+ * @ref LetoQueueShader for anything loaded while the game is running.
+ * Any stage may pull in shared code with an '#include "file"' line, the
+ * file's path being relative to the shader directory.
  *
  * @param name The name of the Leto shader directory subfolder that the
  * shader resides in.
@@ -37,6 +113,125 @@
  */
 unsigned int LetoLoadShader(const char *name);
 
+/**
+ * LoadFallbackShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Load the engine's built-in fallback program. This is a tiny
+ * program compiled from source baked into the executable that draws
+ * everything in a flat color, meant to be used while real programs are
+ * still compiling. It shares the attribute and uniform layout of the
+ * basic shader.
+ *
+ * @return unsigned int -- The OpenGL ID of the program, or 0 on failure.
+ */
+unsigned int LetoLoadFallbackShader(void);
+
+/**
+ * LoadComputeShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Load a compute program from the "comp.cs" file within the
+ * provided directory. Like @ref LetoLoadShader, this blocks until the
+ * program is linked.
+ *
+ * @param name The name of the Leto shader directory subfolder that the
+ * shader resides in.
+ * @return unsigned int -- The OpenGL ID of the program, or 0 on failure.
+ */
+unsigned int LetoLoadComputeShader(const char *name);
+
+/**
+ * QueueShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Submit a shader for compilation and linking without waiting on
+ * the result. On drivers that support KHR_parallel_shader_compile, the
+ * work happens on the driver's own threads; the result should be polled
+ * once per frame with @ref LetoPollShader.
+ *
+ * @param shader The shader object to initialize.
+ * @param name The name of the Leto shader directory subfolder that the
+ * shader resides in.
+ * @param fallback The program to hand out until this one is ready. This
+ * can be 0.
+ * @return bool -- True if the shader was submitted, false if its source
+ * could not be read.
+ */
+bool LetoQueueShader(leto_shader_t *shader, const char *name,
+                     unsigned int fallback);
+
+/**
+ * QueueShaders
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Submit a whole set of shaders at once. Every stage is compiled
+ * before any program is linked, so the driver has the most work possible
+ * to spread over its compiler threads.
+ *
+ * @param shaders The array of shader objects to initialize.
+ * @param names The names of each shader's folder, in the same order.
+ * @param count The amount of shaders in both arrays.
+ * @param fallback The program to hand out until each one is ready.
+ * @return bool -- True if every shader was submitted, false otherwise.
+ */
+bool LetoQueueShaders(leto_shader_t *shaders, const char **names,
+                      size_t count, unsigned int fallback);
+
+/**
+ * ReloadShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Re-read the given shader's source and submit it for compilation
+ * again. The current program stays in use until the new one links, and
+ * is kept if the new one fails to.
+ *
+ * @param shader The shader to reload. Anything already in flight for it
+ * is thrown away.
+ * @return bool -- True if the new source was submitted, false otherwise.
+ */
+bool LetoReloadShader(leto_shader_t *shader);
+
+/**
+ * PollShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether the driver has finished with the given shader. If
+ * the driver does not support non-blocking status queries, this blocks
+ * until the shader has been linked.
+ *
+ * @param shader The shader to poll.
+ * @return leto_shader_state_t -- The state of the shader after polling.
+ */
+leto_shader_state_t LetoPollShader(leto_shader_t *shader);
+
+/**
+ * PollShaders
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Poll each of the given shaders once.
+ *
+ * @param shaders The array of shaders to poll.
+ * @param count The amount of shaders in the array.
+ * @return size_t -- The amount of shaders still pending.
+ */
+size_t LetoPollShaders(leto_shader_t *shaders, size_t count);
+
+/**
+ * GetShaderProgram
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the program that should be used to draw with the given
+ * shader; the real program if it has been linked, the fallback if not.
+ *
+ * @param shader The shader to check.
+ * @return unsigned int -- The OpenGL ID of the program to use.
+ */
+unsigned int LetoGetShaderProgram(const leto_shader_t *shader);
+
+/**
+ * DestroyShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Delete every OpenGL object owned by the given shader, including
+ * anything still in flight. The fallback program is left alone.
+ *
+ * @param shader The shader to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyShader(leto_shader_t *shader);
+
 /**
  * UnloadShader
  * @author Israfiel (https://github.com/israfiel-a)
@@ -48,6 +243,19 @@ unsigned int LetoLoadShader(const char *name);
  */
 void LetoUnloadShader(unsigned int id);
 
+/**
+ * GetUniformLocation
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the location of one of the engine's uniforms within a
+ * program. Programs loaded through this file have theirs cached when
+ * they link; anything else is asked of the driver.
+ *
+ * @param program The OpenGL ID of the program.
+ * @param uniform The uniform.
+ * @return int -- The location, or -1 if the program doesn't use it.
+ */
+int LetoGetUniformLocation(unsigned int program, leto_uniform_t uniform);
+
 /**
  * SetProjectionMatrix
  * @author Israfiel (https://github.com/israfiel-a)
@@ -69,4 +277,18 @@ void LetoUnloadShader(unsigned int id);
 bool LetoSetProjectionMatrix(unsigned int id, float fov, float ratio,
                              float znear, float zfar);
 
+/**
+ * SetProjectionJitter
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Offset every projection matrix set from here on by a fraction
+ * of a pixel, so that frames can be accumulated over time. The offset is
+ * also handed to shaders, as "projection_jitter", so they can take it
+ * back out of their positions.
+ *
+ * @param x The horizontal offset, in normalized device coordinates.
+ * @param y The vertical offset, in normalized device coordinates.
+ * @return void -- Nothing.
+ */
+void LetoSetProjectionJitter(float x, float y);
+
 #endif // LETO__SHADERS_H
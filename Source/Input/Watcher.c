@@ -0,0 +1,270 @@
+/**
+ * @file Watcher.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the shader source watcher. Linux gets a non-blocking
+ * inotify descriptor; other platforms fall back to polling modification
+ * times every so often.
+ * @implements Watcher.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Watcher.h" // Public interface parent
+
+#include <Diagnostic/Platform.h> // Platform macros
+#include <Output/Errors.h>       // Error reporting
+#include <Utilities/Macros.h>    // LETO_MAX_PATH_LENGTH
+
+#include <stdio.h> // Standard I/O functionality
+
+#if defined(LETO_LINUX)
+    #include <errno.h>       // Non-blocking read results
+    #include <sys/inotify.h> // Directory change notifications
+    #include <unistd.h>      // Descriptor reads and closing
+#else
+    #include <sys/stat.h> // File modification times
+    #include <time.h>     // The modification time type
+#endif
+
+/**
+ * @brief The amount of @ref LetoPollWatcher calls between each scan of
+ * modification times, on platforms without inotify. At 60 frames a
+ * second, this is roughly a quarter of a second.
+ */
+#define STAT_POLL_INTERVAL 15
+
+/**
+ * @brief A shader being watched, and what we need to know to tell when
+ * its files change.
+ */
+typedef struct watched_shader
+{
+    /**
+     * @brief The shader to reload.
+     */
+    leto_shader_t *shader;
+    /**
+     * @brief Whether a change was seen since the last reload.
+     */
+    bool dirty;
+#if defined(LETO_LINUX)
+    /**
+     * @brief The inotify watch descriptor of the shader's directory.
+     */
+    int descriptor;
+#else
+    /**
+     * @brief The last seen modification times of the vertex and fragment
+     * source files.
+     */
+    time_t modified[2];
+#endif
+} watched_shader_t;
+
+/**
+ * @brief Every shader currently being watched.
+ */
+static watched_shader_t watched[LETO_MAX_WATCHED_SHADERS];
+
+/**
+ * @brief The amount of valid entries in @ref watched.
+ */
+static size_t watched_count = 0;
+
+#if defined(LETO_LINUX)
+/**
+ * @brief The inotify instance all watches belong to, or -1 if it hasn't
+ * been created yet.
+ */
+static int notify_descriptor = -1;
+#endif
+
+/**
+ * GetShaderDirectory
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Build the on-disk path of the given shader's directory.
+ *
+ * @param shader The shader whose directory we want.
+ * @param path The buffer to write into, at least @ref
+ * LETO_MAX_PATH_LENGTH characters long.
+ * @return void -- Nothing.
+ */
+static void GetShaderDirectory_(const leto_shader_t *shader, char *path)
+{
+    snprintf(path, LETO_MAX_PATH_LENGTH,
+             ASSET_DIR "/" LETO_SHADER_PATH "/%s", shader->name);
+}
+
+#if defined(LETO_LINUX)
+/**
+ * ReadEvents
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Drain every pending inotify event and mark the shaders they
+ * belong to as dirty.
+ *
+ * @return void -- Nothing.
+ */
+static void ReadEvents_(void)
+{
+    // Aligned as the inotify manual asks, so the events can be read in
+    // place.
+    _Alignas(struct inotify_event) char buffer[4096];
+
+    for (;;)
+    {
+        ssize_t length = read(notify_descriptor, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            if (length == -1 && errno != EAGAIN)
+                LetoReportError(false, failed_file_watch,
+                                LETO_FILE_CONTEXT);
+            return;
+        }
+
+        for (char *position = buffer; position < buffer + length;)
+        {
+            const struct inotify_event *event =
+                (const struct inotify_event *)position;
+            for (size_t i = 0; i < watched_count; i++)
+                if (watched[i].descriptor == event->wd)
+                    watched[i].dirty = true;
+            position += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+#else
+/**
+ * GetModifiedTimes
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the modification times of the given shader's source files.
+ *
+ * @param shader The shader whose files to check.
+ * @param times Where to store the vertex and fragment times. A file that
+ * can't be checked gets a time of 0.
+ * @return void -- Nothing.
+ */
+static void GetModifiedTimes_(const leto_shader_t *shader, time_t times[2])
+{
+    const char *files[2] = {"vert.vs", "frag.fs"};
+    char directory[LETO_MAX_PATH_LENGTH], path[LETO_MAX_PATH_LENGTH * 2];
+    GetShaderDirectory_(shader, directory);
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        struct stat info;
+        snprintf(path, sizeof(path), "%s/%s", directory, files[i]);
+        times[i] = (stat(path, &info) == 0 ? info.st_mtime : 0);
+    }
+}
+
+/**
+ * ScanModifiedTimes
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Compare every watched shader's modification times against the
+ * last seen ones, and mark the shaders that changed as dirty.
+ *
+ * @return void -- Nothing.
+ */
+static void ScanModifiedTimes_(void)
+{
+    static size_t calls = 0;
+    if (calls++ % STAT_POLL_INTERVAL != 0) return;
+
+    for (size_t i = 0; i < watched_count; i++)
+    {
+        time_t times[2];
+        GetModifiedTimes_(watched[i].shader, times);
+        if (times[0] == watched[i].modified[0] &&
+            times[1] == watched[i].modified[1])
+            continue;
+
+        watched[i].modified[0] = times[0];
+        watched[i].modified[1] = times[1];
+        watched[i].dirty = true;
+    }
+}
+#endif
+
+bool LetoWatchShader(leto_shader_t *shader)
+{
+    if (shader == NULL || shader->name == NULL) return false;
+#if defined(LETO_EMBED_SHADERS)
+    // Shaders are read out of the executable, so changes on disk would
+    // never be picked up anyway.
+    return false;
+#endif
+    if (watched_count == LETO_MAX_WATCHED_SHADERS)
+    {
+        LetoReportError(false, failed_file_watch, LETO_FILE_CONTEXT);
+        return false;
+    }
+
+    watched_shader_t *entry = &watched[watched_count];
+    entry->shader = shader;
+    entry->dirty = false;
+
+#if defined(LETO_LINUX)
+    if (notify_descriptor == -1)
+    {
+        notify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (notify_descriptor == -1)
+        {
+            LetoReportError(false, failed_file_watch, LETO_FILE_CONTEXT);
+            return false;
+        }
+    }
+
+    // Editors either write files in place or write a temporary and move
+    // it over the original, so listen for both.
+    char path[LETO_MAX_PATH_LENGTH];
+    GetShaderDirectory_(shader, path);
+    entry->descriptor = inotify_add_watch(notify_descriptor, path,
+                                          IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (entry->descriptor == -1)
+    {
+        LetoReportError(false, failed_file_watch, LETO_FILE_CONTEXT);
+        return false;
+    }
+#else
+    GetModifiedTimes_(shader, entry->modified);
+#endif
+
+    watched_count++;
+    return true;
+}
+
+size_t LetoPollWatcher(void)
+{
+    if (watched_count == 0) return 0;
+
+#if defined(LETO_LINUX)
+    ReadEvents_();
+#else
+    ScanModifiedTimes_();
+#endif
+
+    // A single save can produce several events, so reloads are only
+    // issued once all of them have been collected.
+    size_t reloaded = 0;
+    for (size_t i = 0; i < watched_count; i++)
+    {
+        if (!watched[i].dirty) continue;
+        watched[i].dirty = false;
+
+        if (LetoReloadShader(watched[i].shader)) reloaded++;
+    }
+    return reloaded;
+}
+
+void LetoUnwatchShaders(void)
+{
+#if defined(LETO_LINUX)
+    // Closing the instance removes every watch it owns.
+    if (notify_descriptor != -1) close(notify_descriptor);
+    notify_descriptor = -1;
+#endif
+    watched_count = 0;
+}
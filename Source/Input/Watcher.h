@@ -0,0 +1,60 @@
+/**
+ * @file Watcher.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides a shader source watcher, which recompiles shaders in
+ * the background whenever their files change on disk. This is meant for
+ * developer mode only.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__WATCHER_H
+#define LETO__WATCHER_H
+
+// The engine's shader interface.
+#include <Input/Shaders.h>
+
+/**
+ * @brief The maximum amount of shaders that can be watched at once.
+ */
+#define LETO_MAX_WATCHED_SHADERS 64
+
+/**
+ * WatchShader
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Start watching the source directory of the given shader. When
+ * any file within it is written, the shader is queued for recompilation
+ * during the next @ref LetoPollWatcher call. On Linux this is backed by
+ * inotify; elsewhere, file modification times are polled. Builds with
+ * embedded shaders can't watch anything, and always return false.
+ *
+ * @param shader The shader to watch. This pointer must stay valid until
+ * @ref LetoUnwatchShaders is called.
+ * @return bool -- True if the shader is being watched, false otherwise.
+ */
+bool LetoWatchShader(leto_shader_t *shader);
+
+/**
+ * PollWatcher
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Collect every file change since the last call, and resubmit the
+ * shaders that were touched. This never blocks; it should be called once
+ * a frame, before the shaders themselves are polled.
+ *
+ * @return size_t -- The amount of shaders that were resubmitted.
+ */
+size_t LetoPollWatcher(void);
+
+/**
+ * UnwatchShaders
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Stop watching every shader and release the watcher's resources.
+ *
+ * @return void -- Nothing.
+ */
+void LetoUnwatchShaders(void);
+
+#endif // LETO__WATCHER_H
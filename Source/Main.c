@@ -1,16 +1,84 @@
 #include <CGLM/affine.h>
+#include <CGLM/box.h>
 #include <Initialization/Application.h>
+#include <Input/Meshes.h>
 #include <Input/Shaders.h>
+#include <Input/Watcher.h>
+#include <Output/Errors.h>
+#include <Rendering/Cascades.h>
+#include <Rendering/Commands.h>
+#include <Rendering/Culling.h>
+#include <Rendering/GpuCulling.h>
+#include <Rendering/Lights.h>
+#include <Rendering/Materials.h>
+#include <Rendering/Occlusion.h>
+#include <Rendering/Pyramid.h>
+#include <Rendering/Queue.h>
+#include <Rendering/RenderGraph.h>
+#include <Rendering/Resolution.h>
+#include <Rendering/ShadowAtlas.h>
+#include <Rendering/State.h>
+#include <Rendering/Temporal.h>
+#include <Rendering/Visibility.h>
+#include <Utilities/Octree.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-unsigned int basic_shader;
-unsigned int vao, vbo;
+leto_shader_t basic_shader;
+unsigned int fallback_shader;
+leto_material_t basic_material;
+leto_shader_t shadow_shader;
+leto_material_t shadow_material;
+leto_shader_t present_shader;
+leto_mesh_t triangle;
+leto_bounds_t scene_bounds;
+leto_render_queue_t render_queue;
+leto_lights_t scene_lights;
+leto_cascades_t sun_cascades;
+leto_shadow_atlas_t spot_shadows;
+leto_render_graph_t frame_graph;
+uint32_t scene_color;
+leto_frustum_t camera_frustum;
+leto_resolution_t scene_resolution;
+leto_temporal_t scene_temporal;
+uint32_t scene_velocity, scene_depth, scene_output;
+// The scene can be drawn into a visibility buffer and shaded afterwards,
+// instead of shading as it's drawn; V switches between the two.
+leto_visibility_t scene_visibility;
+bool visibility_mode, visibility_key;
+uint32_t scene_ids;
+// Or culled and drawn entirely on the GPU, in two phases around a depth
+// pyramid; G switches to and from that.
+leto_gpu_culler_t scene_culler;
+leto_depth_pyramid_t scene_pyramid;
+bool gpu_mode, gpu_key;
 
-float vertices[] = {-1.0f, -1.0f, 0.0f, 1.0f, -1.0f,
-                    0.0f,  0.0f,  1.0f, 0.0f};
+// Automated runs quit after this many frames, instead of waiting for the
+// window to close, and fail if OpenGL raised any errors along the way.
+unsigned long frame_limit, frame_count;
+bool gl_failed;
 
-mat4 mod = GLM_MAT4_IDENTITY_INIT;
+// A big triangle standing in front of a grid of small ones, most of
+// which it hides. The first object is the big one.
+#define SCENE_OBJECTS 17
+mat4 scene_models[SCENE_OBJECTS];
+leto_octree_t scene_octree;
+leto_occlusion_t scene_occlusion;
+mat4 scene_view_projection;
+
+// The big triangle occludes for itself; a little inside its edges and
+// just behind it, so it never hides itself.
+const float occluder_positions[9] = {-0.9f, -0.9f, -0.05f, 0.9f, -0.9f,
+                                     -0.05f, 0.0f,  0.9f,  -0.05f};
+const uint32_t occluder_indices[3] = {0, 1, 2};
+
+// The scene is batched and recorded across this many threads.
+#define SCENE_JOBS 2
+leto_render_queue_t scene_queues[SCENE_JOBS];
+leto_command_buffer_t scene_commands[SCENE_JOBS];
+uint32_t scene_visible[SCENE_OBJECTS];
+size_t scene_visible_count;
 
 static void ProcessKeyboard_(leto_application_t *application)
 {
@@ -39,45 +107,349 @@ static void ProcessKeyboard_(leto_application_t *application)
         LetoMoveCameraPosition(&application->camera,
                                application->render_benchmarks.deltatime,
                                down);
+
+    bool toggle =
+        glfwGetKey(application->window._, GLFW_KEY_V) == GLFW_PRESS;
+    if (toggle && !visibility_key) visibility_mode = !visibility_mode;
+    visibility_key = toggle;
+
+    toggle = glfwGetKey(application->window._, GLFW_KEY_G) == GLFW_PRESS;
+    if (toggle && !gpu_key) gpu_mode = !gpu_mode;
+    gpu_key = toggle;
 }
 
-static bool init(int width, int height, void *ptr)
+static void CheckErrors_(void)
+{
+    for (unsigned int error = glGetError(); error != GL_NO_ERROR;
+         error = glGetError())
+    {
+        fprintf(stderr, "OpenGL error 0x%04X by frame %lu.\n", error,
+                frame_count);
+        gl_failed = true;
+    }
+}
+
+static size_t CullScene_(const leto_frustum_t *frustum, bool occlusion,
+                         uint32_t *visible)
+{
+    size_t count = LetoQueryOctreeFrustum(&scene_octree, frustum, visible,
+                                          SCENE_OBJECTS);
+    if (count > SCENE_OBJECTS) count = SCENE_OBJECTS;
+    // The occluders were drawn from the camera, so only its view can
+    // use them.
+    if (occlusion)
+        count = LetoCullOccluded(&scene_occlusion, &scene_bounds, visible,
+                                 count);
+    return count;
+}
+
+static void SetupProgram_(unsigned int program, void *ptr)
+{
+    leto_application_t *application = (leto_application_t *)ptr;
+    const leto_window_t *window = &application->window;
+    // The same projection the velocity buffer and culling are built
+    // from, besides its jitter.
+    LetoSetProjectionMatrix(program, application->camera.fov,
+                            (float)window->width / window->height, 0.1f,
+                            100.0f);
+    LetoSetCameraMatrix(&application->camera, program);
+    LetoSetTemporalUniforms(&scene_temporal, program);
+    LetoSetLightUniforms(&scene_lights, program);
+    LetoSetCascadeUniforms(&sun_cascades, program);
+    LetoBindShadowAtlas(&spot_shadows);
+}
+
+static void SetupShadowProgram_(unsigned int program, void *ptr)
+{
+    (void)ptr;
+    LetoSetShadowMatrix(&sun_cascades, program);
+}
+
+static void SetupSpotShadowProgram_(unsigned int program, void *ptr)
+{
+    (void)ptr;
+    LetoSetShadowTileMatrix(&spot_shadows, program);
+}
+
+static void DrawShadows_(void)
+{
+    for (size_t i = 0; i < LETO_SHADOW_CASCADES; i++)
+    {
+        // Nothing in the scene moves, so it's only ever drawn into the
+        // caches; the dynamic pass still refreshes the maps from them.
+        if (LetoBeginCascade(&sun_cascades, i, cascade_pass_static))
+        {
+            uint32_t visible[SCENE_OBJECTS];
+            size_t visible_count = CullScene_(
+                &sun_cascades.cascades[i].frustum, false, visible);
+            for (size_t j = 0; j < visible_count; j++)
+                LetoSubmitDraw(&render_queue, render_pass_opaque,
+                               &shadow_material, &triangle, 0, 0,
+                               scene_models[visible[j]], 0.0f);
+            LetoFlushRenderQueue(&render_queue, SetupShadowProgram_,
+                                 NULL);
+            LetoEndCascade(&sun_cascades);
+        }
+        if (LetoBeginCascade(&sun_cascades, i, cascade_pass_dynamic))
+            LetoEndCascade(&sun_cascades);
+    }
+
+    // Only the spot shadows scheduled this frame are redrawn.
+    for (size_t i = 0; LetoBeginShadowTile(&spot_shadows, i); i++)
+    {
+        const uint32_t slot = spot_shadows.scheduled[i];
+        uint32_t visible[SCENE_OBJECTS];
+        size_t visible_count = CullScene_(
+            &spot_shadows.lights[slot].frustum, false, visible);
+        for (size_t j = 0; j < visible_count; j++)
+            LetoSubmitDraw(&render_queue, render_pass_opaque,
+                           &shadow_material, &triangle, 0, 0,
+                           scene_models[visible[j]], 0.0f);
+        LetoFlushRenderQueue(&render_queue, SetupSpotShadowProgram_, NULL);
+        LetoEndShadowTile(&spot_shadows);
+    }
+}
+
+static void ShadowPass_(const leto_render_graph_t *graph, void *ptr)
+{
+    (void)graph, (void)ptr;
+    DrawShadows_();
+}
+
+static void RecordScene_(leto_command_buffer_t *buffer, size_t index,
+                         void *ptr)
+{
+    leto_application_t *application = (leto_application_t *)ptr;
+
+    size_t slice = (scene_visible_count + SCENE_JOBS - 1) / SCENE_JOBS;
+    size_t first = index * slice, last = first + slice;
+    if (last > scene_visible_count) last = scene_visible_count;
+    for (size_t i = first; i < last; i++)
+    {
+        // Drop detail the camera wouldn't see anyway; a pixel's worth,
+        // at the resolution the scene is actually drawn at.
+        const uint32_t object = scene_visible[i];
+        size_t lod = LetoSelectMeshLod(&triangle, &application->camera,
+                                       scene_models[object],
+                                       (float)scene_resolution.height,
+                                       1.0f);
+
+        vec3 center = {scene_bounds.center[0][object],
+                       scene_bounds.center[1][object],
+                       scene_bounds.center[2][object]};
+        float depth =
+            glm_vec3_distance(application->camera.position, center) /
+            100.0f;
+        LetoSubmitDraw(&scene_queues[index], render_pass_opaque,
+                       &basic_material, &triangle, 0, lod,
+                       scene_models[object], depth);
+    }
+    LetoRecordRenderQueue(&scene_queues[index], buffer, SetupProgram_,
+                          application);
+}
+
+static void ScenePass_(const leto_render_graph_t *graph, void *ptr)
+{
+    (void)graph;
+
+    // Skip everything the camera can't see, or that's hidden.
+    LetoSetDepthTest(true);
+    scene_visible_count =
+        CullScene_(&camera_frustum, true, scene_visible);
+
+    // Each job batches its share of the scene into its own queue and
+    // records the draws; only the replay touches OpenGL.
+    LetoRecordCommands(scene_commands, SCENE_JOBS, RecordScene_, ptr);
+    LetoExecuteCommandBuffers(scene_commands, SCENE_JOBS);
+}
+
+static void VisibilityPass_(const leto_render_graph_t *graph, void *ptr)
+{
+    (void)graph;
+    leto_application_t *application = (leto_application_t *)ptr;
+
+    LetoSetDepthTest(true);
+    scene_visible_count =
+        CullScene_(&camera_frustum, true, scene_visible);
+    for (size_t i = 0; i < scene_visible_count; i++)
+    {
+        const uint32_t object = scene_visible[i];
+        size_t lod = LetoSelectMeshLod(&triangle, &application->camera,
+                                       scene_models[object],
+                                       (float)scene_resolution.height,
+                                       1.0f);
+        LetoSubmitVisibility(&scene_visibility, &basic_material,
+                             &triangle, 0, lod, scene_models[object],
+                             NULL);
+    }
+    LetoDrawVisibility(&scene_visibility, SetupProgram_, application);
+}
+
+static void GpuScenePass_(const leto_render_graph_t *graph, void *ptr)
+{
+    leto_application_t *application = (leto_application_t *)ptr;
+    const float height = (float)scene_resolution.height;
+
+    // Draw what was visible last frame, build a pyramid from its depth,
+    // and then draw whatever else that pyramid doesn't hide.
+    LetoSetDepthTest(true);
+    LetoDispatchGpuCulling(&scene_culler, cull_phase_first,
+                           &application->camera, scene_view_projection,
+                           height, 1.0f);
+    LetoDrawGpuCulled(&scene_culler, &basic_material, SetupProgram_,
+                      application);
+
+    LetoBuildDepthPyramid(&scene_pyramid,
+                          LetoGetGraphTexture(graph, scene_depth),
+                          scene_resolution.width, scene_resolution.height,
+                          scene_view_projection);
+    LetoSetGpuOcclusion(&scene_culler, scene_pyramid.texture,
+                        scene_view_projection);
+    LetoDispatchGpuCulling(&scene_culler, cull_phase_second,
+                           &application->camera, scene_view_projection,
+                           height, 1.0f);
+    LetoDrawGpuCulled(&scene_culler, &basic_material, SetupProgram_,
+                      application);
+}
+
+static void ShadePass_(const leto_render_graph_t *graph, void *ptr)
+{
+    LetoShadeVisibility(&scene_visibility,
+                        LetoGetGraphTexture(graph, scene_ids),
+                        SetupProgram_, ptr);
+}
+
+static void TemporalPass_(const leto_render_graph_t *graph, void *ptr)
+{
+    (void)ptr;
+    LetoResolveTemporal(&scene_temporal,
+                        LetoGetGraphTexture(graph, scene_color),
+                        LetoGetGraphTexture(graph, scene_velocity),
+                        LetoGetGraphTexture(graph, scene_depth));
+}
+
+static void PresentPass_(const leto_render_graph_t *graph, void *ptr)
 {
     (void)ptr;
+    if (LetoPollShader(&present_shader) != shader_ready) return;
 
-    basic_shader = LetoLoadShader("basic");
-    if (basic_shader == 0) return false;
-
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-
-    glBindVertexArray(vao);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices,
-                 GL_STATIC_DRAW);
-
-    // position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float),
-                          (void *)0);
-    glEnableVertexAttribArray(0);
-    // normals
-    // glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float),
-    //                       (void *)(3 * sizeof(float)));
-    // glEnableVertexAttribArray(1);
-    // // texture coord attribute
-    // glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 3 * sizeof(float),
-    //                       (void *)(6 * sizeof(float)));
-    // glEnableVertexAttribArray(2);
-
-    LetoSetProjectionMatrix(basic_shader, 45.0f, (float)width / height,
-                            0.1f, 100.0f);
-    glUseProgram(basic_shader);
-    glUniformMatrix4fv(glGetUniformLocation(basic_shader, "model"), 1,
-                       GL_FALSE, &mod[0][0]);
-
-    glEnable(GL_DEPTH_TEST);
-    // glEnable(GL_CULL_FACE);
+    // The history is already the window's size when it's upscaling, and
+    // is stretched over it, filtered, otherwise. Anything drawn after
+    // this, like the HUD, is drawn at the window's own resolution.
+    LetoSetDepthTest(false);
+    LetoUseProgram(LetoGetShaderProgram(&present_shader));
+    LetoBindTextureUnit(0, LetoGetGraphTexture(graph, scene_output));
+    LetoDrawGraphFullscreen(graph);
+}
+
+static bool init(int width, int height, void *ptr)
+{
+    leto_application_t *application = (leto_application_t *)ptr;
+
+    fallback_shader = LetoLoadFallbackShader();
+    if (fallback_shader == 0) return false;
+    if (!LetoQueueShader(&basic_shader, "basic", fallback_shader))
+        return false;
+    if (!LetoCreateMaterial(&basic_material, &basic_shader)) return false;
+    if (!LetoQueueShader(&shadow_shader, "shadow", fallback_shader))
+        return false;
+    if (!LetoCreateMaterial(&shadow_material, &shadow_shader))
+        return false;
+    if (!LetoQueueShader(&present_shader, "present", fallback_shader))
+        return false;
+    // Developers get their shaders recompiled as soon as they're saved.
+    if (application->flags.developer)
+    {
+        LetoWatchShader(&basic_shader);
+        LetoWatchShader(&shadow_shader);
+        LetoWatchShader(&present_shader);
+    }
+
+    if (!LetoLoadMesh(&triangle, "triangle")) return false;
+
+    if (!LetoCreateRenderQueue(&render_queue, 64)) return false;
+    if (!LetoCreateRenderGraph(&frame_graph)) return false;
+    // The scene gets about 16ms of GPU time a frame, 60 frames a second.
+    if (!LetoCreateResolution(&scene_resolution, 16.0f)) return false;
+    if (!LetoCreateTemporal(&scene_temporal)) return false;
+    if (!LetoCreateVisibility(&scene_visibility, 64)) return false;
+    for (size_t i = 0; i < SCENE_JOBS; i++)
+        if (!LetoCreateRenderQueue(&scene_queues[i], 64) ||
+            !LetoCreateCommandBuffer(&scene_commands[i], 4096))
+            return false;
+
+    // A warm lamp beside the mesh, and a spot shining on it from above.
+    if (!LetoCreateLights(&scene_lights, 16)) return false;
+    LetoAddLight(&scene_lights,
+                 &(leto_light_t){.type = light_point,
+                                 .position = {1.5f, 0.5f, 1.0f},
+                                 .range = 6.0f,
+                                 .color = {1.0f, 0.8f, 0.6f},
+                                 .intensity = 4.0f});
+    size_t spot = LetoAddLight(
+        &scene_lights, &(leto_light_t){.type = light_spot,
+                                       .position = {0.0f, 3.0f, 1.0f},
+                                       .range = 10.0f,
+                                       .color = {0.6f, 0.8f, 1.0f},
+                                       .intensity = 8.0f,
+                                       .direction = {0.0f, -1.0f, -0.3f},
+                                       .inner_angle = 0.3f,
+                                       .outer_angle = 0.5f});
+
+    // The spot casts its shadow into an atlas shared by every spot.
+    if (!LetoCreateShadowAtlas(&spot_shadows, 4096)) return false;
+    LetoAddShadowedLight(&spot_shadows, spot);
+
+    // A late afternoon sun, shadowing everything within 100 units.
+    if (!LetoCreateCascades(&sun_cascades, 2048, 100.0f)) return false;
+    LetoSetSun(&sun_cascades, (vec3){-0.4f, -1.0f, -0.3f},
+               (vec3){1.0f, 0.95f, 0.85f});
+
+    // Culling works on world-space boxes, found through the octree.
+    if (!LetoCreateBounds(&scene_bounds, SCENE_OBJECTS)) return false;
+    if (!LetoCreateOctree(&scene_octree, (vec3){0.0f, 0.0f, 0.0f}, 64.0f))
+        return false;
+    if (!LetoCreateOcclusion(&scene_occlusion, 256, 144)) return false;
+    if (!LetoCreateGpuCuller(&scene_culler, SCENE_OBJECTS)) return false;
+    if (!LetoCreateDepthPyramid(&scene_pyramid)) return false;
+    uint32_t gpu_mesh = LetoAddGpuMesh(&scene_culler, &triangle, 0);
+
+    for (size_t i = 0; i < SCENE_OBJECTS; i++)
+    {
+        mat4 *model = &scene_models[i];
+        glm_mat4_identity(*model);
+        if (i == 0)
+        {
+            glm_translate(*model, (vec3){0.0f, 0.0f, -2.0f});
+            glm_scale_uni(*model, 2.0f);
+        }
+        else
+        {
+            const float column = (float)((i - 1) % 4) - 1.5f;
+            const float row = (float)((i - 1) / 4);
+            glm_translate(*model,
+                          (vec3){column * 1.5f, 0.0f, -6.0f - row * 3.0f});
+            glm_scale_uni(*model, 0.5f);
+        }
+
+        vec3 box[2], center, extent;
+        glm_vec3_copy(triangle.header.minimum, box[0]);
+        glm_vec3_copy(triangle.header.maximum, box[1]);
+        glm_aabb_transform(box, *model, box);
+        glm_aabb_center(box, center);
+        glm_vec3_sub(box[1], center, extent);
+        size_t index = LetoAddBounds(&scene_bounds, center, extent);
+        LetoInsertOctreeObject(&scene_octree, center, extent,
+                               (uint32_t)index);
+        LetoAddGpuObject(&scene_culler, gpu_mesh, &basic_material,
+                         *model);
+    }
+
+    LetoSetProjectionMatrix(fallback_shader, 45.0f,
+                            (float)width / height, 0.1f, 100.0f);
+
+    LetoSetDepthTest(true);
+    // LetoSetCulling(true);
     return true;
 }
 
@@ -89,34 +461,196 @@ static void run(float deltatime, void *ptr)
 
     //! this needs a better location desperately
     ProcessKeyboard_(application);
+    if (frame_limit != 0)
+    {
+        CheckErrors_();
+        // This frame still gets drawn before the loop notices.
+        if (++frame_count == frame_limit)
+            glfwSetWindowShouldClose(application->window._, GLFW_TRUE);
+    }
+
+    // Until the basic shader is done compiling, this hands back the
+    // fallback program. A reload keeps the old program until the new one
+    // links.
+    LetoPollWatcher();
+    LetoPollShader(&basic_shader);
+    LetoPollShader(&shadow_shader);
+    LetoPollShader(&present_shader);
+    // Send any parameter changes before anything draws.
+    LetoFlushMaterials();
+
+    const leto_window_t *window = &application->window;
+    if (window->height <= 0) return;
+    mat4 view, projection, view_projection;
+    LetoGetCameraView(&application->camera, view);
+    LetoGetCameraProjection(&application->camera,
+                            (float)window->width / window->height, 0.1f,
+                            100.0f, projection);
+    glm_mat4_mul(projection, view, view_projection);
+    LetoScheduleShadows(&spot_shadows, &scene_lights, view, projection,
+                        (float)window->height);
+    LetoBinLights(&scene_lights, view, projection);
+    LetoUpdateCascades(&sun_cascades, view, projection);
+    LetoExtractFrustum(&camera_frustum, view_projection);
+    glm_mat4_copy(view_projection, scene_view_projection);
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    // The big triangle hides most of the scene behind it.
+    LetoBeginOcclusion(&scene_occlusion, view_projection);
+    LetoAddOccluder(&scene_occlusion, occluder_positions, 3,
+                    occluder_indices, 3, scene_models[0]);
+    LetoRasterizeOcclusion(&scene_occlusion);
 
-    LetoSetProjectionMatrix(basic_shader, 45.0f, 0, 0.1f, 100.0f);
-    LetoSetCameraMatrix(&application->camera, basic_shader);
+    // Shadows draw into their own maps, so nothing in the graph reads
+    // them; the scene is lit into a float target the window is shown
+    // through. That target shrinks while the GPU runs over budget.
+    LetoUpdateResolution(&scene_resolution, window->width, window->height);
+    LetoBeginTemporalFrame(&scene_temporal, view_projection,
+                           scene_resolution.width, scene_resolution.height,
+                           window->width, window->height);
+    LetoResetRenderGraph(&frame_graph, window->width, window->height);
+    uint32_t shadows =
+        LetoAddGraphPass(&frame_graph, "shadows", ShadowPass_, NULL);
+    LetoKeepGraphPass(&frame_graph, shadows);
 
-    glUseProgram(basic_shader);
-    glBindVertexArray(vao);
-    glDrawArrays(GL_TRIANGLES, 0, 9);
+    scene_color = LetoCreateGraphTexture(
+        &frame_graph, "scene color", GL_RGBA16F, scene_resolution.width,
+        scene_resolution.height);
+    scene_velocity = LetoCreateGraphTexture(
+        &frame_graph, "scene velocity", GL_RG16F, scene_resolution.width,
+        scene_resolution.height);
+    scene_depth = LetoCreateGraphTexture(
+        &frame_graph, "scene depth", GL_DEPTH_COMPONENT32F,
+        scene_resolution.width, scene_resolution.height);
+    if (visibility_mode)
+    {
+        // The IDs are only needed until the scene's been shaded, so
+        // their memory goes back to the graph straight after.
+        scene_ids = LetoCreateGraphTexture(
+            &frame_graph, "scene visibility", GL_R32UI,
+            scene_resolution.width, scene_resolution.height);
+        uint32_t visibility = LetoAddGraphPass(
+            &frame_graph, "visibility", VisibilityPass_, application);
+        LetoGraphWrite(&frame_graph, visibility, scene_ids);
+        LetoGraphWrite(&frame_graph, visibility, scene_depth);
+        LetoClearGraphPass(&frame_graph, visibility,
+                           (vec4){0.0f, 0.0f, 0.0f, 0.0f});
+
+        uint32_t shade = LetoAddGraphPass(&frame_graph, "shade",
+                                          ShadePass_, application);
+        LetoGraphRead(&frame_graph, shade, scene_ids);
+        LetoGraphWrite(&frame_graph, shade, scene_color);
+        LetoGraphWrite(&frame_graph, shade, scene_velocity);
+        LetoClearGraphPass(&frame_graph, shade,
+                           (vec4){1.0f, 1.0f, 1.0f, 1.0f});
+    }
+    else
+    {
+        uint32_t scene = LetoAddGraphPass(
+            &frame_graph, "scene", gpu_mode ? GpuScenePass_ : ScenePass_,
+            application);
+        LetoGraphWrite(&frame_graph, scene, scene_color);
+        LetoGraphWrite(&frame_graph, scene, scene_velocity);
+        LetoGraphWrite(&frame_graph, scene, scene_depth);
+        LetoClearGraphPass(&frame_graph, scene,
+                           (vec4){1.0f, 1.0f, 1.0f, 1.0f});
+    }
+
+    // The scene is accumulated into a history that outlives the frame,
+    // so the graph only borrows it; the resolve writes it as an image.
+    uint32_t temporal =
+        LetoAddGraphPass(&frame_graph, "temporal", TemporalPass_, NULL);
+    LetoGraphRead(&frame_graph, temporal, scene_color);
+    LetoGraphRead(&frame_graph, temporal, scene_velocity);
+    LetoGraphRead(&frame_graph, temporal, scene_depth);
+    LetoKeepGraphPass(&frame_graph, temporal);
+    scene_output = LetoImportGraphTexture(
+        &frame_graph, "temporal output",
+        LetoGetTemporalOutput(&scene_temporal), GL_RGBA16F,
+        scene_temporal.width, scene_temporal.height);
+
+    uint32_t present =
+        LetoAddGraphPass(&frame_graph, "present", PresentPass_, NULL);
+    LetoGraphRead(&frame_graph, present, scene_output);
+    LetoGraphWrite(&frame_graph, present, LETO_GRAPH_BACKBUFFER);
+
+    LetoCompileRenderGraph(&frame_graph);
+    LetoBeginResolutionTiming(&scene_resolution);
+    LetoExecuteRenderGraph(&frame_graph);
+    LetoEndResolutionTiming(&scene_resolution);
 }
 
 static void dkill(void *ptr)
 {
     (void)ptr;
-    LetoUnloadShader(basic_shader);
+    LetoUnwatchShaders();
+    LetoDestroyMaterial(&basic_material);
+    LetoDestroyMaterial(&shadow_material);
+    LetoDestroyRenderQueue(&render_queue);
+    LetoDestroyRenderGraph(&frame_graph);
+    LetoDestroyResolution(&scene_resolution);
+    LetoDestroyTemporal(&scene_temporal);
+    LetoDestroyVisibility(&scene_visibility);
+    for (size_t i = 0; i < SCENE_JOBS; i++)
+    {
+        LetoDestroyRenderQueue(&scene_queues[i]);
+        LetoDestroyCommandBuffer(&scene_commands[i]);
+    }
+    LetoDestroyLights(&scene_lights);
+    LetoDestroyCascades(&sun_cascades);
+    LetoDestroyShadowAtlas(&spot_shadows);
+    LetoDestroyBounds(&scene_bounds);
+    LetoDestroyOctree(&scene_octree);
+    LetoDestroyOcclusion(&scene_occlusion);
+    LetoDestroyGpuCuller(&scene_culler);
+    LetoDestroyDepthPyramid(&scene_pyramid);
+    LetoDestroyMesh(&triangle);
+    LetoDestroyShader(&basic_shader);
+    LetoDestroyShader(&shadow_shader);
+    LetoDestroyShader(&present_shader);
+    LetoUnloadShader(fallback_shader);
 }
 
-int main(void)
+int main(int argc, char **argv)
 {
+    // "--gpu" starts out culling on the GPU, and "--frames" quits after
+    // the given amount of frames, so either path can be run unattended.
+    // "--no-draw-count" draws GPU-culled objects as if the driver had no
+    // indirect draw count, so the fallback gets run too.
+    bool draw_count = true;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--gpu") == 0) gpu_mode = true;
+        else if (strcmp(argv[i], "--no-draw-count") == 0)
+            draw_count = false;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frame_limit = strtoul(argv[++i], NULL, 10);
+        else
+        {
+            fprintf(stderr,
+                    "usage: %s [--gpu] [--no-draw-count] "
+                    "[--frames count]\n",
+                    argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
     leto_application_t *leto = LetoInitApplication(false, false, true);
     if (leto == NULL) exit(EXIT_FAILURE);
+    if (!draw_count) glMultiDrawElementsIndirectCount = NULL;
 
     LetoBindDisplayInitFunc(leto, init, leto);
     LetoBindDisplayKillFunc(leto, dkill, leto);
     LetoBindDisplayRunFunc(leto, run, leto);
 
-    LetoRunApplication(leto);
+    bool succeeded = LetoRunApplication(leto);
+    // An unattended run also fails on anything the engine reported, like
+    // a shader that didn't compile.
+    if (frame_limit != 0)
+    {
+        CheckErrors_();
+        succeeded = succeeded && !gl_failed && LetoGetError() == no_error;
+    }
 
     LetoTerminateApplication(leto);
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
 }
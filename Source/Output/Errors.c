@@ -42,7 +42,14 @@ static leto_error_context_t error_contexts[error_count] = {
     {"failed_window_create", "failed to create window", glfw},
     {"no_display_func", "no display function bound", leto},
     {"failed_shader", "failed to compile shader", glad},
-    {"invalid_shader", "invalid shader value", glad}};
+    {"invalid_shader", "invalid shader value", glad},
+    {"failed_file_watch", "failed to watch file", stdc},
+    {"missing_embedded_file", "no such embedded file", leto},
+    {"failed_buffer_map", "failed to map buffer", glad},
+    {"no_material_slots", "out of material slots", leto},
+    {"invalid_mesh", "invalid mesh file", leto},
+    {"no_vertex_formats", "out of vertex formats", leto},
+    {"invalid_render_graph", "invalid render graph", leto}};
 
 /**
  * OpenGLErrorString
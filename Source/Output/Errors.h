@@ -33,6 +33,13 @@ typedef enum leto_error_code
     no_display_func,
     failed_shader,
     invalid_shader,
+    failed_file_watch,
+    missing_embedded_file,
+    failed_buffer_map,
+    no_material_slots,
+    invalid_mesh,
+    no_vertex_formats,
+    invalid_render_graph,
     error_count
 } leto_error_code_t;
 
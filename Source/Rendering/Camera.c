@@ -11,7 +11,8 @@
  * entails, please see the attached @file LICENSE.md file.
  */
 
-#include "Camera.h" // Public interface parent
+#include "Camera.h"       // Public interface parent
+#include <Input/Shaders.h> // Uniform locations
 
 #include <CGLM/cam.h> // GLM camera functions (lookat, etc.)
 #include <GLAD2/gl.h> // OpenGL function pointers
@@ -47,14 +48,27 @@ bool LetoCreateCamera(leto_camera_t *camera, float fov, float speed,
 
 void LetoSetCameraMatrix(leto_camera_t *camera, unsigned int shader)
 {
-    vec3 center_vec;
-    glm_vec3_add(camera->position, camera->front, center_vec);
     mat4 matrix;
-    glm_lookat(camera->position, center_vec, camera->up, matrix);
+    LetoGetCameraView(camera, matrix);
+
+    int location = LetoGetUniformLocation(shader, uniform_camera_view);
+    glProgramUniformMatrix4fv(shader, location, 1, GL_FALSE,
+                              &matrix[0][0]);
+}
+
+void LetoGetCameraView(const leto_camera_t *camera, mat4 view)
+{
+    vec3 center_vec;
+    glm_vec3_add((float *)camera->position, (float *)camera->front,
+                 center_vec);
+    glm_lookat((float *)camera->position, center_vec,
+               (float *)camera->up, view);
+}
 
-    glUseProgram(shader);
-    glUniformMatrix4fv(glGetUniformLocation(shader, "camera_view"), 1,
-                       GL_FALSE, &matrix[0][0]);
+void LetoGetCameraProjection(const leto_camera_t *camera, float ratio,
+                             float znear, float zfar, mat4 projection)
+{
+    glm_perspective(glm_rad(camera->fov), ratio, znear, zfar, projection);
 }
 
 void LetoMoveCameraPosition(leto_camera_t *camera, float deltatime,
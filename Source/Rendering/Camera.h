@@ -15,6 +15,8 @@
 
 // GLM 3D vectors.
 #include <CGLM/vec3.h>
+// GLM 4x4 matrices.
+#include <CGLM/mat4.h>
 
 /**
  * @brief A container around the various positions and scalars that make up
@@ -113,6 +115,34 @@ bool LetoCreateCamera(leto_camera_t *camera, float fov, float speed,
  */
 void LetoSetCameraMatrix(leto_camera_t *camera, unsigned int shader);
 
+/**
+ * GetCameraView
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Calculate the view matrix of the given camera, the same one
+ * @ref LetoSetCameraMatrix hands to shaders.
+ *
+ * @param camera The camera whose view to calculate.
+ * @param view The matrix to fill.
+ * @return void -- Nothing.
+ */
+void LetoGetCameraView(const leto_camera_t *camera, mat4 view);
+
+/**
+ * GetCameraProjection
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Calculate the perspective projection of the given camera from
+ * its field of view.
+ *
+ * @param camera The camera whose projection to calculate.
+ * @param ratio The ratio of width to height of the viewport.
+ * @param znear The distance of the near plane.
+ * @param zfar The distance of the far plane.
+ * @param projection The matrix to fill.
+ * @return void -- Nothing.
+ */
+void LetoGetCameraProjection(const leto_camera_t *camera, float ratio,
+                             float znear, float zfar, mat4 projection);
+
 /**
  * MoveCameraPosition
  * @author Israfiel (https://github.com/israfiel-a)
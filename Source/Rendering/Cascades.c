@@ -0,0 +1,364 @@
+/**
+ * @file Cascades.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's cascaded sun shadows. Each cascade covers the
+ * bounding sphere of its slice, whose size doesn't change as the camera
+ * turns, and its center is snapped to the map's texel grid as seen from
+ * the sun; a cascade's matrix only ever changes when it's refitted, so
+ * whatever was cached for it stays valid until then.
+ * @implements Cascades.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cascades.h"          // Public interface parent
+#include <Input/Shaders.h>     // Uniform locations
+#include <Rendering/Release.h> // Deferred object release
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <CGLM/cam.h> // GLM camera functions (lookat, etc.)
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <math.h>   // Standard math functions
+#include <string.h> // Standard memory utilities
+
+/**
+ * MakeMaps
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make a depth array texture with a layer per cascade.
+ *
+ * @param size The width and height of every layer.
+ * @param compare Whether the texture is sampled with depth comparison.
+ * @return unsigned int -- The OpenGL ID of the texture, or 0.
+ */
+static unsigned int MakeMaps_(int size, bool compare)
+{
+    unsigned int texture =
+        LetoAcquireTexture(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT32F,
+                           size, size, LETO_SHADOW_CASCADES);
+    if (texture == 0) return 0;
+
+    // Anything outside a map is lit.
+    const float border[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTextureParameterfv(texture, GL_TEXTURE_BORDER_COLOR, border);
+    glTextureParameteri(texture, GL_TEXTURE_COMPARE_MODE,
+                        compare ? GL_COMPARE_REF_TO_TEXTURE : GL_NONE);
+    glTextureParameteri(texture, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    return texture;
+}
+
+/**
+ * FitSlice
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the world-space bounding sphere of a slice of the view.
+ *
+ * @param inverse_view The camera's view matrix, inverted.
+ * @param projection The camera's projection.
+ * @param near The view depth the slice starts at.
+ * @param far The view depth the slice ends at.
+ * @param center Filled with the center of the sphere.
+ * @return float -- The radius of the sphere.
+ */
+static float FitSlice_(mat4 inverse_view, mat4 projection, float near,
+                       float far, vec3 center)
+{
+    // At a depth of d, a normalized device x lands at
+    // d * (x + p[2][0]) / p[0][0] in view space; likewise for y.
+    vec3 corners[8];
+    glm_vec3_zero(center);
+    for (size_t i = 0; i < 8; i++)
+    {
+        const float depth = (i & 4) != 0 ? far : near;
+        const float x = (i & 1) != 0 ? 1.0f : -1.0f;
+        const float y = (i & 2) != 0 ? 1.0f : -1.0f;
+        vec3 corner = {depth * (x + projection[2][0]) / projection[0][0],
+                       depth * (y + projection[2][1]) / projection[1][1],
+                       -depth};
+        glm_mat4_mulv3(inverse_view, corner, 1.0f, corners[i]);
+        glm_vec3_muladds(corners[i], 1.0f / 8.0f, center);
+    }
+
+    float radius = 0.0f;
+    for (size_t i = 0; i < 8; i++)
+        radius = fmaxf(radius, glm_vec3_distance(center, corners[i]));
+    // Rounding keeps float noise from resizing the cascade every frame.
+    return ceilf(radius * 16.0f) / 16.0f;
+}
+
+/**
+ * PlaceCascade
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fit a cascade around a sphere, snapping it to its map's texels,
+ * and work out its matrix and frustum.
+ *
+ * @param cascades The cascades.
+ * @param cascade The cascade to place.
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @return void -- Nothing.
+ */
+static void PlaceCascade_(const leto_cascades_t *cascades,
+                          leto_cascade_t *cascade, vec3 center,
+                          float radius)
+{
+    vec3 up = {0.0f, 1.0f, 0.0f};
+    if (fabsf(cascades->direction[1]) > 0.99f) glm_vec3_copy(GLM_XUP, up);
+
+    // Snap the center to whole texels across the sun's view, so the map
+    // moves in steps its texels cover exactly.
+    mat4 rotation;
+    glm_lookat(GLM_VEC3_ZERO, (float *)cascades->direction, up, rotation);
+    vec3 snapped;
+    glm_mat4_mulv3(rotation, center, 1.0f, snapped);
+    const float texel = 2.0f * radius / (float)cascades->size;
+    snapped[0] = floorf(snapped[0] / texel) * texel;
+    snapped[1] = floorf(snapped[1] / texel) * texel;
+    glm_mat4_transpose(rotation);
+    glm_mat4_mulv3(rotation, snapped, 1.0f, cascade->center);
+    cascade->radius = radius;
+
+    // The sun's eye sits far enough back to see casters outside the
+    // sphere.
+    const float back = radius + LETO_CASCADE_CASTER_DISTANCE;
+    vec3 eye;
+    glm_vec3_copy(cascade->center, eye);
+    glm_vec3_mulsubs((float *)cascades->direction, back, eye);
+
+    mat4 view, projection;
+    glm_lookat(eye, cascade->center, up, view);
+    glm_ortho(-radius, radius, -radius, radius, 0.0f, back + radius,
+              projection);
+    glm_mat4_mul(projection, view, cascade->view_projection);
+    LetoExtractFrustum(&cascade->frustum, cascade->view_projection);
+}
+
+bool LetoCreateCascades(leto_cascades_t *cascades, int size,
+                        float distance)
+{
+    if (cascades == NULL || size <= 0) return false;
+    memset(cascades, 0, sizeof(leto_cascades_t));
+    cascades->size = size;
+    cascades->distance = distance;
+    cascades->current = -1;
+    for (size_t i = 0; i < LETO_SHADOW_CASCADES; i++)
+    {
+        glm_mat4_identity(cascades->cascades[i].view_projection);
+        cascades->cascades[i].period = i < 2 ? 1 : 1u << (i - 1);
+    }
+    glm_vec3_copy((vec3){0.0f, -1.0f, 0.0f}, cascades->direction);
+    glm_vec3_one(cascades->color);
+
+    cascades->texture = MakeMaps_(size, true);
+    cascades->cache = MakeMaps_(size, false);
+    glCreateFramebuffers(1, &cascades->framebuffer);
+    glNamedFramebufferDrawBuffer(cascades->framebuffer, GL_NONE);
+    glNamedFramebufferReadBuffer(cascades->framebuffer, GL_NONE);
+    if (cascades->texture == 0 || cascades->cache == 0)
+    {
+        LetoDestroyCascades(cascades);
+        return false;
+    }
+    return true;
+}
+
+void LetoDestroyCascades(leto_cascades_t *cascades)
+{
+    if (cascades == NULL) return;
+
+    LetoReleaseObject(texture_object, cascades->texture);
+    LetoReleaseObject(texture_object, cascades->cache);
+    // Framebuffers only point at their attachments; OpenGL holds on to
+    // anything still in use by itself.
+    if (cascades->framebuffer != 0)
+        glDeleteFramebuffers(1, &cascades->framebuffer);
+    memset(cascades, 0, sizeof(leto_cascades_t));
+    cascades->current = -1;
+}
+
+void LetoSetSun(leto_cascades_t *cascades, vec3 direction, vec3 color)
+{
+    if (cascades == NULL) return;
+
+    vec3 normalized;
+    glm_vec3_normalize_to(direction, normalized);
+    glm_vec3_copy(color, cascades->color);
+    if (glm_vec3_eqv_eps(normalized, cascades->direction)) return;
+
+    // Every fit is made looking down the old direction.
+    glm_vec3_copy(normalized, cascades->direction);
+    for (size_t i = 0; i < LETO_SHADOW_CASCADES; i++)
+        cascades->cascades[i].radius = 0.0f;
+    LetoInvalidateCascades(cascades);
+}
+
+void LetoInvalidateCascades(leto_cascades_t *cascades)
+{
+    if (cascades == NULL) return;
+    for (size_t i = 0; i < LETO_SHADOW_CASCADES; i++)
+        cascades->cascades[i].cached = false;
+}
+
+void LetoUpdateCascades(leto_cascades_t *cascades, mat4 view,
+                        mat4 projection)
+{
+    if (cascades == NULL) return;
+
+    // The planes of a perspective projection, as OpenGL lays it out.
+    const float near = projection[3][2] / (projection[2][2] - 1.0f);
+    float far = projection[3][2] / (projection[2][2] + 1.0f);
+    if (!(near > 0.0f && far > near)) return;
+    if (far > cascades->distance) far = cascades->distance;
+
+    mat4 inverse_view;
+    glm_mat4_inv(view, inverse_view);
+    cascades->frame++;
+
+    float start = near;
+    for (size_t i = 0; i < LETO_SHADOW_CASCADES; i++)
+    {
+        leto_cascade_t *cascade = &cascades->cascades[i];
+        const float step = (float)(i + 1) / LETO_SHADOW_CASCADES;
+        const float even = near + (far - near) * step;
+        const float logarithmic = near * powf(far / near, step);
+        cascade->far = even + (logarithmic - even) *
+                                  LETO_CASCADE_SPLIT_BLEND;
+
+        vec3 center;
+        const float radius =
+            FitSlice_(inverse_view, projection, start, cascade->far,
+                      center);
+        start = cascade->far;
+
+        // The old fit is kept while it still holds the whole slice, and
+        // isn't needlessly coarse.
+        const float largest = radius * (1.0f + 2.0f * LETO_CASCADE_MARGIN);
+        const bool holds =
+            cascade->radius != 0.0f && cascade->radius <= largest &&
+            glm_vec3_distance(center, cascade->center) + radius <=
+                cascade->radius;
+        if (!holds)
+        {
+            PlaceCascade_(cascades, cascade, center,
+                          radius * (1.0f + LETO_CASCADE_MARGIN));
+            cascade->cached = false;
+        }
+
+        // Staggered, so the far cascades don't all land on one frame.
+        const unsigned int period =
+            cascade->period == 0 ? 1 : cascade->period;
+        cascade->scheduled = !holds || !cascade->cached ||
+                             (cascades->frame + i) % period == 0;
+    }
+}
+
+bool LetoBeginCascade(leto_cascades_t *cascades, size_t index,
+                      leto_cascade_pass_t pass)
+{
+    if (cascades == NULL || index >= LETO_SHADOW_CASCADES) return false;
+    leto_cascade_t *cascade = &cascades->cascades[index];
+    if (!cascade->scheduled) return false;
+    if (pass == cascade_pass_static && cascade->cached) return false;
+
+    const float clear = 1.0f;
+    const unsigned int framebuffer = cascades->framebuffer;
+    if (pass == cascade_pass_static)
+    {
+        glNamedFramebufferTextureLayer(framebuffer, GL_DEPTH_ATTACHMENT,
+                                       cascades->cache, 0, (int)index);
+        glClearNamedFramebufferfv(framebuffer, GL_DEPTH, 0, &clear);
+        cascade->cached = true;
+    }
+    else
+    {
+        // Skipping the static pass means there's nothing static to cast.
+        if (!cascade->cached)
+        {
+            glNamedFramebufferTextureLayer(framebuffer,
+                                           GL_DEPTH_ATTACHMENT,
+                                           cascades->cache, 0, (int)index);
+            glClearNamedFramebufferfv(framebuffer, GL_DEPTH, 0, &clear);
+            cascade->cached = true;
+        }
+        glCopyImageSubData(cascades->cache, GL_TEXTURE_2D_ARRAY, 0, 0, 0,
+                           (int)index, cascades->texture,
+                           GL_TEXTURE_2D_ARRAY, 0, 0, 0, (int)index,
+                           cascades->size, cascades->size, 1);
+        glNamedFramebufferTextureLayer(framebuffer, GL_DEPTH_ATTACHMENT,
+                                       cascades->texture, 0, (int)index);
+        cascade->scheduled = false;
+    }
+
+    LetoBeginShadowDepth(framebuffer, 0, 0, cascades->size);
+    cascades->current = (int)index;
+    return true;
+}
+
+void LetoEndCascade(leto_cascades_t *cascades)
+{
+    if (cascades == NULL || cascades->current < 0) return;
+
+    LetoEndShadowDepth();
+    cascades->current = -1;
+}
+
+void LetoBeginShadowDepth(unsigned int framebuffer, int x, int y,
+                          int size)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(x, y, size, size);
+    LetoSetDepthTest(true);
+    LetoSetDepthWrite(true);
+    LetoSetPolygonOffset(true);
+    glPolygonOffset(LETO_SHADOW_BIAS_SLOPE, LETO_SHADOW_BIAS_CONSTANT);
+}
+
+void LetoEndShadowDepth(void)
+{
+    LetoSetPolygonOffset(false);
+}
+
+void LetoSetShadowMatrix(const leto_cascades_t *cascades,
+                         unsigned int shader)
+{
+    if (cascades == NULL || cascades->current < 0) return;
+
+    const leto_cascade_t *cascade =
+        &cascades->cascades[cascades->current];
+    int location = LetoGetUniformLocation(shader, uniform_shadow_matrix);
+    glProgramUniformMatrix4fv(shader, location, 1, GL_FALSE,
+                              &cascade->view_projection[0][0]);
+}
+
+void LetoSetCascadeUniforms(const leto_cascades_t *cascades,
+                            unsigned int shader)
+{
+    if (cascades == NULL) return;
+
+    float matrices[LETO_SHADOW_CASCADES][16];
+    float splits[LETO_SHADOW_CASCADES];
+    for (size_t i = 0; i < LETO_SHADOW_CASCADES; i++)
+    {
+        memcpy(matrices[i], cascades->cascades[i].view_projection,
+               sizeof(matrices[i]));
+        splits[i] = cascades->cascades[i].far;
+    }
+
+    LetoBindTextureUnit(LETO_CASCADE_TEXTURE_UNIT, cascades->texture);
+    int location =
+        LetoGetUniformLocation(shader, uniform_cascade_matrices);
+    glProgramUniformMatrix4fv(shader, location, LETO_SHADOW_CASCADES,
+                              GL_FALSE, &matrices[0][0]);
+    location = LetoGetUniformLocation(shader, uniform_cascade_splits);
+    glProgramUniform4fv(shader, location, 1, splits);
+    location = LetoGetUniformLocation(shader, uniform_sun_direction);
+    glProgramUniform3fv(shader, location, 1, cascades->direction);
+    location = LetoGetUniformLocation(shader, uniform_sun_color);
+    glProgramUniform3fv(shader, location, 1, cascades->color);
+}
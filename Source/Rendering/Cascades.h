@@ -0,0 +1,324 @@
+/**
+ * @file Cascades.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's cascaded sun shadows. The view is cut into a few
+ * slices by depth, and each gets its own shadow map fitted around it.
+ * Maps are snapped to whole texels so they don't shimmer as the camera
+ * moves, distant cascades are redrawn less often, and the static casters
+ * of every cascade are cached until its fit has to change.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__CASCADES_H
+#define LETO__CASCADES_H
+
+// The engine's frustum culler.
+#include <Rendering/Culling.h>
+// Fixed-width integer types.
+#include <stdint.h>
+
+/**
+ * @brief The amount of cascades the view is cut into.
+ */
+#define LETO_SHADOW_CASCADES 4
+
+/**
+ * @brief The texture unit the cascades' shadow maps are bound to, just
+ * past the material textures. Shaders declare them with
+ * "layout(binding = 4) uniform sampler2DArrayShadow".
+ */
+#define LETO_CASCADE_TEXTURE_UNIT 4
+
+/**
+ * @brief How far between an even and a logarithmic split of the view the
+ * cascades are cut; zero is even, one logarithmic.
+ */
+#define LETO_CASCADE_SPLIT_BLEND 0.8f
+
+/**
+ * @brief How much bigger than its slice a cascade is fitted, as a
+ * fraction of the slice's radius. The slack lets a cascade stay put, and
+ * its cache valid, while the camera moves within it.
+ */
+#define LETO_CASCADE_MARGIN 0.25f
+
+/**
+ * @brief The slope-scaled part of the depth bias shadow casters are drawn
+ * with, so surfaces don't shadow themselves.
+ */
+#define LETO_SHADOW_BIAS_SLOPE 1.5f
+
+/**
+ * @brief The constant part of the depth bias shadow casters are drawn
+ * with, in units of the smallest resolvable depth difference.
+ */
+#define LETO_SHADOW_BIAS_CONSTANT 4.0f
+
+/**
+ * @brief How far towards the sun past a cascade's slice casters are still
+ * drawn, in world units.
+ */
+#define LETO_CASCADE_CASTER_DISTANCE 200.0f
+
+/**
+ * @brief The passes each cascade is drawn in.
+ */
+typedef enum leto_cascade_pass
+{
+    /**
+     * @brief Geometry that never moves, drawn into the cascade's cache
+     * only when the cache is out of date.
+     */
+    cascade_pass_static,
+    /**
+     * @brief Everything else, drawn over a copy of the cache whenever the
+     * cascade is redrawn.
+     */
+    cascade_pass_dynamic
+} leto_cascade_pass_t;
+
+/**
+ * @brief A single cascade.
+ */
+typedef struct leto_cascade
+{
+    /**
+     * @brief The world-to-shadow-clip matrix of the cascade's map.
+     */
+    mat4 view_projection;
+    /**
+     * @brief The frustum of the cascade's map, for culling its casters.
+     */
+    leto_frustum_t frustum;
+    /**
+     * @brief The world-space center of the sphere the cascade covers.
+     */
+    vec3 center;
+    /**
+     * @brief The radius of the sphere the cascade covers, or 0 if the
+     * cascade has never been fitted.
+     */
+    float radius;
+    /**
+     * @brief The view depth the cascade's slice ends at.
+     */
+    float far;
+    /**
+     * @brief The cascade is redrawn once every this many frames, unless
+     * its fit changes.
+     */
+    unsigned int period;
+    /**
+     * @brief Whether the cascade's cache of static casters is up to date.
+     */
+    bool cached;
+    /**
+     * @brief Whether the cascade is being redrawn this frame.
+     */
+    bool scheduled;
+} leto_cascade_t;
+
+/**
+ * @brief A set of cascades and the sun casting them. This struct should
+ * only be modified through the functions below, besides each cascade's
+ * @ref period.
+ */
+typedef struct leto_cascades
+{
+    /**
+     * @brief The cascades, nearest first.
+     */
+    leto_cascade_t cascades[LETO_SHADOW_CASCADES];
+    /**
+     * @brief The OpenGL ID of the shadow maps, a depth array texture with
+     * a layer per cascade.
+     */
+    unsigned int texture;
+    /**
+     * @brief The OpenGL ID of the static caster caches, laid out like
+     * @ref texture.
+     */
+    unsigned int cache;
+    /**
+     * @brief The OpenGL ID of the framebuffer cascades are drawn through.
+     */
+    unsigned int framebuffer;
+    /**
+     * @brief The width and height of every map, in texels.
+     */
+    int size;
+    /**
+     * @brief The view depth past which nothing is shadowed.
+     */
+    float distance;
+    /**
+     * @brief The direction the sun shines in, normalized.
+     */
+    vec3 direction;
+    /**
+     * @brief The color of the sun times its intensity.
+     */
+    vec3 color;
+    /**
+     * @brief The amount of times the cascades have been updated.
+     */
+    uint64_t frame;
+    /**
+     * @brief The cascade being drawn, or -1.
+     */
+    int current;
+} leto_cascades_t;
+
+/**
+ * CreateCascades
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create a set of cascades. Nearer cascades are redrawn every
+ * frame, and each farther one half as often. This must be called after
+ * the OpenGL context is current.
+ *
+ * @param cascades The cascades to initialize.
+ * @param size The width and height of every shadow map, in texels.
+ * @param distance The view depth past which nothing is shadowed.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateCascades(leto_cascades_t *cascades, int size,
+                        float distance);
+
+/**
+ * DestroyCascades
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a set of cascades owns.
+ *
+ * @param cascades The cascades to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyCascades(leto_cascades_t *cascades);
+
+/**
+ * SetSun
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set the sun the cascades are cast by. Changing its direction
+ * refits, and so redraws, every cascade.
+ *
+ * @param cascades The cascades.
+ * @param direction The direction the sun shines in. This needn't be
+ * normalized.
+ * @param color The color of the sun times its intensity.
+ * @return void -- Nothing.
+ */
+void LetoSetSun(leto_cascades_t *cascades, vec3 direction, vec3 color);
+
+/**
+ * InvalidateCascades
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Throw away every cascade's cache of static casters, should the
+ * static world change.
+ *
+ * @param cascades The cascades.
+ * @return void -- Nothing.
+ */
+void LetoInvalidateCascades(leto_cascades_t *cascades);
+
+/**
+ * UpdateCascades
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fit the cascades to a view, and pick which are redrawn this
+ * frame. A cascade keeps its fit while its slice stays inside it, and is
+ * refitted and redrawn at once when it doesn't. This should be called
+ * once a frame, before any cascade is drawn.
+ *
+ * @param cascades The cascades.
+ * @param view The camera's view matrix.
+ * @param projection The camera's perspective projection, as made by
+ * @ref LetoGetCameraProjection. The near and far planes are taken from
+ * it.
+ * @return void -- Nothing.
+ */
+void LetoUpdateCascades(leto_cascades_t *cascades, mat4 view,
+                        mat4 projection);
+
+/**
+ * BeginCascade
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Start drawing a pass of a cascade, if it needs drawing this
+ * frame. Both passes of every cascade should be offered each frame,
+ * static first; the casters drawn in between should be culled against
+ * the cascade's @ref frustum.
+ *
+ * @param cascades The cascades.
+ * @param index The cascade to draw.
+ * @param pass The pass to draw.
+ * @return bool -- True if the pass should be drawn now, and ended with
+ * @ref LetoEndCascade, false if it can be skipped.
+ */
+bool LetoBeginCascade(leto_cascades_t *cascades, size_t index,
+                      leto_cascade_pass_t pass);
+
+/**
+ * EndCascade
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Finish drawing a cascade. The framebuffer stays bound; the next
+ * render graph pass binds its own.
+ *
+ * @param cascades The cascades.
+ * @return void -- Nothing.
+ */
+void LetoEndCascade(leto_cascades_t *cascades);
+
+/**
+ * BeginShadowDepth
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set up the state every shadow map is drawn with: bind the given
+ * framebuffer, point the viewport at the square being drawn, and turn on
+ * depth writes and the shadow bias.
+ *
+ * @param framebuffer The framebuffer holding the shadow map.
+ * @param x The left edge of the square being drawn.
+ * @param y The bottom edge of the square being drawn.
+ * @param size The width and height of the square being drawn.
+ * @return void -- Nothing.
+ */
+void LetoBeginShadowDepth(unsigned int framebuffer, int x, int y,
+                          int size);
+
+/**
+ * EndShadowDepth
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Turn off the shadow bias @ref LetoBeginShadowDepth turned on.
+ *
+ * @return void -- Nothing.
+ */
+void LetoEndShadowDepth(void);
+
+/**
+ * SetShadowMatrix
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set the given shader's "shadow_matrix" uniform to the matrix of
+ * the cascade being drawn.
+ *
+ * @param cascades The cascades.
+ * @param shader The shader whose matrix we are trying to set.
+ * @return void -- Nothing.
+ */
+void LetoSetShadowMatrix(const leto_cascades_t *cascades,
+                         unsigned int shader);
+
+/**
+ * SetCascadeUniforms
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the shadow maps and set the given shader's
+ * "cascade_matrices", "cascade_splits", "sun_direction", and "sun_color"
+ * uniforms, for shading with the cascades.
+ *
+ * @param cascades The cascades.
+ * @param shader The shader whose uniforms to set.
+ * @return void -- Nothing.
+ */
+void LetoSetCascadeUniforms(const leto_cascades_t *cascades,
+                            unsigned int shader);
+
+#endif // LETO__CASCADES_H
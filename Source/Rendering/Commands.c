@@ -0,0 +1,571 @@
+/**
+ * @file Commands.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's command buffers. Every command is a header
+ * giving its type and full size, then its body, then any inline data;
+ * each piece starts on an eight-byte boundary, so a buffer can be walked
+ * and read in place.
+ * @implements Commands.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Commands.h"          // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Frame counter
+#include <Rendering/State.h>   // OpenGL state cache
+#include <Utilities/Threads.h> // Threading utilities
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <stdlib.h> // Standard memory management
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The boundary every piece of a command starts on.
+ */
+#define COMMAND_ALIGNMENT 8
+
+/**
+ * @brief The kinds of command there are.
+ */
+typedef enum command_type
+{
+    command_use_program,
+    command_bind_material,
+    command_bind_geometry,
+    command_bind_vertex_array,
+    command_bind_buffer_range,
+    command_bind_data,
+    command_bind_texture,
+    command_set_depth,
+    command_draw_arrays,
+    command_draw_elements,
+    command_draw_indirect
+} command_type_t;
+
+/**
+ * @brief The start of every command.
+ */
+typedef struct command_header
+{
+    /**
+     * @brief The @ref command_type_t of the command.
+     */
+    uint32_t type;
+    /**
+     * @brief The size of the whole command, header and inline data
+     * included, in bytes.
+     */
+    uint32_t size;
+} command_header_t;
+
+/**
+ * @brief The body of a @ref command_bind_material.
+ */
+typedef struct bind_material_command
+{
+    const leto_material_t *material;
+    leto_program_function_t function;
+    void *argument;
+} bind_material_command_t;
+
+/**
+ * @brief The body of a @ref command_bind_buffer_range, or of a @ref
+ * command_bind_data, whose buffer and offset come from its upload.
+ */
+typedef struct bind_range_command
+{
+    unsigned int target, index, buffer;
+    ptrdiff_t offset, size;
+} bind_range_command_t;
+
+/**
+ * @brief The body of a @ref command_bind_texture or @ref
+ * command_set_depth; a unit and texture, or a test and write flag.
+ */
+typedef struct pair_command
+{
+    unsigned int first, second;
+} pair_command_t;
+
+/**
+ * @brief The body of a @ref command_draw_arrays.
+ */
+typedef struct draw_arrays_command
+{
+    unsigned int mode;
+    int first, count, instances;
+} draw_arrays_command_t;
+
+/**
+ * @brief The body of a @ref command_use_program, @ref
+ * command_bind_geometry, @ref command_bind_vertex_array, or @ref
+ * command_draw_indirect; an ID, a format, or a draw count.
+ */
+typedef struct value_command
+{
+    unsigned int value;
+} value_command_t;
+
+/**
+ * @brief A job recording some of a set of buffers; every buffer from
+ * @ref first on, @ref stride apart.
+ */
+typedef struct record_job
+{
+    /**
+     * @brief The buffers, and how many there are.
+     */
+    leto_command_buffer_t *buffers;
+    size_t count;
+    /**
+     * @brief The first buffer of the job, and the step to the next.
+     */
+    size_t first, stride;
+    /**
+     * @brief The function recording a buffer, and what it's given.
+     */
+    leto_record_function_t function;
+    void *argument;
+} record_job_t;
+
+/**
+ * Align
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Round a size up to a multiple of an alignment.
+ *
+ * @param size The size.
+ * @param alignment The alignment.
+ * @return size_t -- The rounded size.
+ */
+static size_t Align_(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Push
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add a command to a buffer, growing it if it's full.
+ *
+ * @param buffer The buffer.
+ * @param type The type of command.
+ * @param body The size of the command's body.
+ * @param data The size of the command's inline data, or 0.
+ * @return void* -- The command's body, its inline data just after at the
+ * next boundary, or NULL on failure.
+ */
+static void *Push_(leto_command_buffer_t *buffer, command_type_t type,
+                   size_t body, size_t data)
+{
+    if (buffer == NULL || buffer->failed) return NULL;
+
+    const size_t size = sizeof(command_header_t) +
+                        Align_(body, COMMAND_ALIGNMENT) +
+                        Align_(data, COMMAND_ALIGNMENT);
+    if (size > UINT32_MAX)
+    {
+        buffer->failed = true;
+        return NULL;
+    }
+
+    if (buffer->size + size > buffer->capacity)
+    {
+        size_t capacity = buffer->capacity * 2;
+        while (capacity < buffer->size + size) capacity *= 2;
+        void *grown = realloc(buffer->data, capacity);
+        if (grown == NULL)
+        {
+            LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+            buffer->failed = true;
+            return NULL;
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+
+    command_header_t *header =
+        (command_header_t *)(buffer->data + buffer->size);
+    header->type = (uint32_t)type;
+    header->size = (uint32_t)size;
+    buffer->size += size;
+    buffer->count++;
+    if (data > 0) buffer->upload += Align_(data, buffer->ring.alignment);
+    return header + 1;
+}
+
+/**
+ * InlineData
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the inline data of a command.
+ *
+ * @param body The command's body.
+ * @param size The size of the body.
+ * @return void* -- The inline data.
+ */
+static void *InlineData_(const void *body, size_t size)
+{
+    return (unsigned char *)body + Align_(size, COMMAND_ALIGNMENT);
+}
+
+/**
+ * Upload
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Copy a command's inline data into the replay's allocation.
+ *
+ * @param buffer The buffer being replayed.
+ * @param allocation The replay's allocation.
+ * @param used The bytes of the allocation used so far.
+ * @param data The inline data.
+ * @param size The size of the data.
+ * @return ptrdiff_t -- The offset of the copy within the ring's buffer.
+ */
+static ptrdiff_t Upload_(const leto_command_buffer_t *buffer,
+                         const leto_ring_allocation_t *allocation,
+                         size_t *used, const void *data, size_t size)
+{
+    memcpy((unsigned char *)allocation->data + *used, data, size);
+    const ptrdiff_t offset = allocation->offset + (ptrdiff_t)*used;
+    *used += Align_(size, buffer->ring.alignment);
+    return offset;
+}
+
+/**
+ * Replay
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Replay a single buffer.
+ *
+ * @param buffer The buffer.
+ * @param program The program in use, kept across buffers.
+ * @return bool -- True if the buffer was replayed, false if its inline
+ * data couldn't be uploaded.
+ */
+static bool Replay_(leto_command_buffer_t *buffer, unsigned int *program)
+{
+    // Inline data is uploaded in one piece, taken from this frame's
+    // region of the ring.
+    if (buffer->frame != LetoGetFrame())
+        LetoAdvanceRingBuffer(&buffer->ring);
+    buffer->frame = LetoGetFrame();
+    leto_ring_allocation_t allocation = {0};
+    if (buffer->upload > 0 &&
+        !LetoAllocateRing(&buffer->ring, buffer->upload, &allocation))
+        return false;
+    size_t used = 0;
+
+    for (size_t offset = 0; offset < buffer->size;)
+    {
+        const command_header_t *header =
+            (const command_header_t *)(buffer->data + offset);
+        const void *body = header + 1;
+        offset += header->size;
+
+        switch ((command_type_t)header->type)
+        {
+            case command_use_program:
+                *program = ((const value_command_t *)body)->value;
+                LetoUseProgram(*program);
+                break;
+            case command_bind_material:
+            {
+                const bind_material_command_t *command = body;
+                unsigned int bound = LetoBindMaterial(command->material);
+                if (bound != *program && command->function != NULL)
+                    command->function(bound, command->argument);
+                *program = bound;
+                break;
+            }
+            case command_bind_geometry:
+                LetoBindGeometry(((const value_command_t *)body)->value);
+                break;
+            case command_bind_vertex_array:
+                LetoBindVertexArray(
+                    ((const value_command_t *)body)->value);
+                break;
+            case command_bind_buffer_range:
+            {
+                const bind_range_command_t *command = body;
+                LetoBindBufferRange(command->target, command->index,
+                                    command->buffer, command->offset,
+                                    command->size);
+                break;
+            }
+            case command_bind_data:
+            {
+                const bind_range_command_t *command = body;
+                ptrdiff_t at = Upload_(
+                    buffer, &allocation, &used,
+                    InlineData_(body, sizeof(bind_range_command_t)),
+                    (size_t)command->size);
+                LetoBindBufferRange(command->target, command->index,
+                                    allocation.buffer, at,
+                                    command->size);
+                break;
+            }
+            case command_bind_texture:
+            {
+                const pair_command_t *command = body;
+                LetoBindTextureUnit(command->first, command->second);
+                break;
+            }
+            case command_set_depth:
+            {
+                const pair_command_t *command = body;
+                LetoSetDepthTest(command->first != 0);
+                LetoSetDepthWrite(command->second != 0);
+                break;
+            }
+            case command_draw_arrays:
+            {
+                const draw_arrays_command_t *command = body;
+                glDrawArraysInstanced(command->mode, command->first,
+                                      command->count, command->instances);
+                break;
+            }
+            case command_draw_elements:
+            {
+                const leto_draw_command_t *command = body;
+                glDrawElementsInstancedBaseVertexBaseInstance(
+                    GL_TRIANGLES, (int)command->index_count,
+                    GL_UNSIGNED_INT,
+                    (const void *)(command->first_index *
+                                   sizeof(uint32_t)),
+                    (int)command->instance_count, command->base_vertex,
+                    command->base_instance);
+                break;
+            }
+            case command_draw_indirect:
+            {
+                const unsigned int count =
+                    ((const value_command_t *)body)->value;
+                ptrdiff_t at = Upload_(
+                    buffer, &allocation, &used,
+                    InlineData_(body, sizeof(value_command_t)),
+                    count * sizeof(leto_draw_command_t));
+                LetoBindBuffer(GL_DRAW_INDIRECT_BUFFER, allocation.buffer);
+                glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                            (const void *)at, (int)count,
+                                            0);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * RunJob
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a job's buffers.
+ *
+ * @param argument The @ref record_job_t to run.
+ * @return void -- Nothing.
+ */
+static void RunJob_(void *argument)
+{
+    record_job_t *job = argument;
+    for (size_t i = job->first; i < job->count; i += job->stride)
+    {
+        LetoResetCommandBuffer(&job->buffers[i]);
+        job->function(&job->buffers[i], i, job->argument);
+    }
+}
+
+bool LetoCreateCommandBuffer(leto_command_buffer_t *buffer,
+                             size_t capacity)
+{
+    if (buffer == NULL) return false;
+    memset(buffer, 0, sizeof(leto_command_buffer_t));
+    if (capacity < 256) capacity = 256;
+
+    buffer->data = malloc(capacity);
+    if (buffer->data == NULL)
+    {
+        LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+        return false;
+    }
+    buffer->capacity = capacity;
+
+    if (!LetoCreateRingBuffer(&buffer->ring, capacity))
+    {
+        LetoDestroyCommandBuffer(buffer);
+        return false;
+    }
+    return true;
+}
+
+void LetoDestroyCommandBuffer(leto_command_buffer_t *buffer)
+{
+    if (buffer == NULL) return;
+
+    LetoDestroyRingBuffer(&buffer->ring);
+    free(buffer->data);
+    memset(buffer, 0, sizeof(leto_command_buffer_t));
+}
+
+void LetoResetCommandBuffer(leto_command_buffer_t *buffer)
+{
+    if (buffer == NULL) return;
+    buffer->size = 0;
+    buffer->count = 0;
+    buffer->upload = 0;
+    buffer->failed = false;
+}
+
+void LetoRecordUseProgram(leto_command_buffer_t *buffer,
+                          unsigned int program)
+{
+    value_command_t *command =
+        Push_(buffer, command_use_program, sizeof(value_command_t), 0);
+    if (command != NULL) command->value = program;
+}
+
+void LetoRecordBindMaterial(leto_command_buffer_t *buffer,
+                            const leto_material_t *material,
+                            leto_program_function_t function,
+                            void *argument)
+{
+    bind_material_command_t *command =
+        Push_(buffer, command_bind_material,
+              sizeof(bind_material_command_t), 0);
+    if (command == NULL) return;
+    *command = (bind_material_command_t){
+        .material = material, .function = function, .argument = argument};
+}
+
+void LetoRecordBindGeometry(leto_command_buffer_t *buffer,
+                            uint32_t format)
+{
+    value_command_t *command =
+        Push_(buffer, command_bind_geometry, sizeof(value_command_t), 0);
+    if (command != NULL) command->value = format;
+}
+
+void LetoRecordBindVertexArray(leto_command_buffer_t *buffer,
+                               unsigned int vertex_array)
+{
+    value_command_t *command = Push_(buffer, command_bind_vertex_array,
+                                     sizeof(value_command_t), 0);
+    if (command != NULL) command->value = vertex_array;
+}
+
+void LetoRecordBindBufferRange(leto_command_buffer_t *buffer,
+                               unsigned int target, unsigned int index,
+                               unsigned int id, ptrdiff_t offset,
+                               ptrdiff_t size)
+{
+    bind_range_command_t *command =
+        Push_(buffer, command_bind_buffer_range,
+              sizeof(bind_range_command_t), 0);
+    if (command == NULL) return;
+    *command = (bind_range_command_t){.target = target,
+                                      .index = index,
+                                      .buffer = id,
+                                      .offset = offset,
+                                      .size = size};
+}
+
+void *LetoRecordBindData(leto_command_buffer_t *buffer,
+                         unsigned int target, unsigned int index,
+                         size_t size)
+{
+    if (size == 0) return NULL;
+    bind_range_command_t *command =
+        Push_(buffer, command_bind_data, sizeof(bind_range_command_t),
+              size);
+    if (command == NULL) return NULL;
+    *command = (bind_range_command_t){
+        .target = target, .index = index, .size = (ptrdiff_t)size};
+    return InlineData_(command, sizeof(bind_range_command_t));
+}
+
+void LetoRecordBindTexture(leto_command_buffer_t *buffer,
+                           unsigned int unit, unsigned int texture)
+{
+    pair_command_t *command =
+        Push_(buffer, command_bind_texture, sizeof(pair_command_t), 0);
+    if (command != NULL)
+        *command = (pair_command_t){.first = unit, .second = texture};
+}
+
+void LetoRecordSetDepth(leto_command_buffer_t *buffer, bool test,
+                        bool write)
+{
+    pair_command_t *command =
+        Push_(buffer, command_set_depth, sizeof(pair_command_t), 0);
+    if (command != NULL)
+        *command = (pair_command_t){.first = test, .second = write};
+}
+
+void LetoRecordDrawArrays(leto_command_buffer_t *buffer,
+                          unsigned int mode, int first, int count,
+                          int instances)
+{
+    draw_arrays_command_t *command = Push_(
+        buffer, command_draw_arrays, sizeof(draw_arrays_command_t), 0);
+    if (command == NULL) return;
+    *command = (draw_arrays_command_t){.mode = mode,
+                                       .first = first,
+                                       .count = count,
+                                       .instances = instances};
+}
+
+void LetoRecordDrawElements(leto_command_buffer_t *buffer,
+                            const leto_draw_command_t *command)
+{
+    if (command == NULL || command->instance_count == 0) return;
+    leto_draw_command_t *copy = Push_(buffer, command_draw_elements,
+                                      sizeof(leto_draw_command_t), 0);
+    if (copy != NULL) *copy = *command;
+}
+
+leto_draw_command_t *LetoRecordDrawIndirect(leto_command_buffer_t *buffer,
+                                            size_t count)
+{
+    if (count == 0 || count > UINT32_MAX) return NULL;
+    value_command_t *command =
+        Push_(buffer, command_draw_indirect, sizeof(value_command_t),
+              count * sizeof(leto_draw_command_t));
+    if (command == NULL) return NULL;
+    command->value = (unsigned int)count;
+    return InlineData_(command, sizeof(value_command_t));
+}
+
+void LetoRecordCommands(leto_command_buffer_t *buffers, size_t count,
+                        leto_record_function_t function, void *argument)
+{
+    if (buffers == NULL || count == 0 || function == NULL) return;
+
+    size_t job_count = count;
+    if (job_count > LetoGetWorkerCount()) job_count = LetoGetWorkerCount();
+
+    record_job_t jobs[LETO_MAX_WORKERS];
+    for (size_t j = 0; j < job_count; j++)
+        jobs[j] = (record_job_t){.buffers = buffers,
+                                 .count = count,
+                                 .first = j,
+                                 .stride = job_count,
+                                 .function = function,
+                                 .argument = argument};
+    LetoRunJobs(RunJob_, jobs, sizeof(record_job_t), job_count);
+}
+
+size_t LetoExecuteCommandBuffers(leto_command_buffer_t *buffers,
+                                 size_t count)
+{
+    if (buffers == NULL) return 0;
+
+    unsigned int program = 0;
+    size_t executed = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        leto_command_buffer_t *buffer = &buffers[i];
+        if (buffer->failed || buffer->count == 0) continue;
+        if (Replay_(buffer, &program)) executed += buffer->count;
+    }
+    return executed;
+}
@@ -0,0 +1,305 @@
+/**
+ * @file Commands.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's command buffers. Only the thread owning the
+ * OpenGL context can make calls into it, so work that ends in draws is
+ * instead recorded as a stream of small plain-data commands, which any
+ * thread can do without locking so long as each has its own buffer. The
+ * context's thread then replays every buffer in order. Data the commands
+ * need on the GPU is carried inline, and copied into a ring on replay.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__COMMANDS_H
+#define LETO__COMMANDS_H
+
+// The engine's geometry arenas.
+#include <Rendering/Geometry.h>
+// The engine's material interface.
+#include <Rendering/Materials.h>
+// The engine's ring buffers.
+#include <Rendering/Ring.h>
+
+/**
+ * @brief The signature of the function called whenever the program in
+ * use changes, so that per-program uniforms (cameras, for example) can be
+ * set.
+ */
+typedef void (*leto_program_function_t)(unsigned int program,
+                                        void *argument);
+
+/**
+ * @brief A command buffer. This struct should only be modified through
+ * the functions below.
+ */
+typedef struct leto_command_buffer
+{
+    /**
+     * @brief The recorded commands, back to back.
+     */
+    unsigned char *data;
+    /**
+     * @brief The bytes recorded, and the bytes there's room for.
+     */
+    size_t size, capacity;
+    /**
+     * @brief The amount of commands recorded.
+     */
+    size_t count;
+    /**
+     * @brief The bytes of inline data to be copied into @ref ring on
+     * replay, each piece padded to its alignment.
+     */
+    size_t upload;
+    /**
+     * @brief Whether a command couldn't be recorded. A buffer missing
+     * commands isn't replayed.
+     */
+    bool failed;
+    /**
+     * @brief The ring inline data is copied into on replay.
+     */
+    leto_ring_buffer_t ring;
+    /**
+     * @brief The frame the buffer was last replayed in.
+     */
+    uint64_t frame;
+} leto_command_buffer_t;
+
+/**
+ * @brief The signature of the function @ref LetoRecordCommands runs for
+ * each buffer.
+ */
+typedef void (*leto_record_function_t)(leto_command_buffer_t *buffer,
+                                       size_t index, void *argument);
+
+/**
+ * CreateCommandBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty command buffer. This must be called after the
+ * OpenGL context is current.
+ *
+ * @param buffer The buffer to initialize.
+ * @param capacity The bytes of commands, and of inline data per frame,
+ * the buffer should have room for before growing.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateCommandBuffer(leto_command_buffer_t *buffer,
+                             size_t capacity);
+
+/**
+ * DestroyCommandBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a command buffer owns.
+ *
+ * @param buffer The buffer to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyCommandBuffer(leto_command_buffer_t *buffer);
+
+/**
+ * ResetCommandBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Throw away everything recorded into a buffer. This can be
+ * called from any thread.
+ *
+ * @param buffer The buffer to reset.
+ * @return void -- Nothing.
+ */
+void LetoResetCommandBuffer(leto_command_buffer_t *buffer);
+
+/**
+ * RecordUseProgram
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a program being made current. This, like every record
+ * function, can be called from any thread that owns the buffer.
+ *
+ * @param buffer The buffer.
+ * @param program The OpenGL ID of the program.
+ * @return void -- Nothing.
+ */
+void LetoRecordUseProgram(leto_command_buffer_t *buffer,
+                          unsigned int program);
+
+/**
+ * RecordBindMaterial
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a material being bound, as by @ref LetoBindMaterial.
+ *
+ * @param buffer The buffer.
+ * @param material The material. It must outlive the replay.
+ * @param function Called on replay if this changes the program in use,
+ * or NULL.
+ * @param argument What the function is given.
+ * @return void -- Nothing.
+ */
+void LetoRecordBindMaterial(leto_command_buffer_t *buffer,
+                            const leto_material_t *material,
+                            leto_program_function_t function,
+                            void *argument);
+
+/**
+ * RecordBindGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a vertex format's arena being bound, as by @ref
+ * LetoBindGeometry.
+ *
+ * @param buffer The buffer.
+ * @param format The vertex format.
+ * @return void -- Nothing.
+ */
+void LetoRecordBindGeometry(leto_command_buffer_t *buffer,
+                            uint32_t format);
+
+/**
+ * RecordBindVertexArray
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a vertex array being bound.
+ *
+ * @param buffer The buffer.
+ * @param vertex_array The OpenGL ID of the vertex array.
+ * @return void -- Nothing.
+ */
+void LetoRecordBindVertexArray(leto_command_buffer_t *buffer,
+                               unsigned int vertex_array);
+
+/**
+ * RecordBindBufferRange
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a range of an existing buffer being bound to an indexed
+ * binding point.
+ *
+ * @param buffer The command buffer.
+ * @param target The indexed target, like GL_UNIFORM_BUFFER.
+ * @param index The binding point.
+ * @param id The OpenGL ID of the buffer to bind.
+ * @param offset The offset of the range, in bytes.
+ * @param size The size of the range, in bytes.
+ * @return void -- Nothing.
+ */
+void LetoRecordBindBufferRange(leto_command_buffer_t *buffer,
+                               unsigned int target, unsigned int index,
+                               unsigned int id, ptrdiff_t offset,
+                               ptrdiff_t size);
+
+/**
+ * RecordBindData
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a block of data being bound to an indexed binding point.
+ * The data is carried in the buffer, and uploaded on replay.
+ *
+ * @param buffer The command buffer.
+ * @param target The indexed target, like GL_UNIFORM_BUFFER.
+ * @param index The binding point.
+ * @param size The size of the data, in bytes.
+ * @return void* -- Where to write the data, or NULL on failure. This is
+ * only valid until the next command is recorded.
+ */
+void *LetoRecordBindData(leto_command_buffer_t *buffer,
+                         unsigned int target, unsigned int index,
+                         size_t size);
+
+/**
+ * RecordBindTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a texture being bound to a texture unit.
+ *
+ * @param buffer The buffer.
+ * @param unit The texture unit.
+ * @param texture The OpenGL ID of the texture.
+ * @return void -- Nothing.
+ */
+void LetoRecordBindTexture(leto_command_buffer_t *buffer,
+                           unsigned int unit, unsigned int texture);
+
+/**
+ * RecordSetDepth
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record the depth test and depth writes being turned on or off.
+ *
+ * @param buffer The buffer.
+ * @param test Whether to test depth.
+ * @param write Whether to write depth.
+ * @return void -- Nothing.
+ */
+void LetoRecordSetDepth(leto_command_buffer_t *buffer, bool test,
+                        bool write);
+
+/**
+ * RecordDrawArrays
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record an instanced, non-indexed draw.
+ *
+ * @param buffer The buffer.
+ * @param mode The primitive mode, like GL_TRIANGLES.
+ * @param first The first vertex.
+ * @param count The amount of vertices.
+ * @param instances The amount of instances.
+ * @return void -- Nothing.
+ */
+void LetoRecordDrawArrays(leto_command_buffer_t *buffer,
+                          unsigned int mode, int first, int count,
+                          int instances);
+
+/**
+ * RecordDrawElements
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record an instanced draw of triangles out of the bound 32-bit
+ * index buffer.
+ *
+ * @param buffer The buffer.
+ * @param command The draw; its instance count may be 0 to skip it.
+ * @return void -- Nothing.
+ */
+void LetoRecordDrawElements(leto_command_buffer_t *buffer,
+                            const leto_draw_command_t *command);
+
+/**
+ * RecordDrawIndirect
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Record a multi-draw indirect call of triangles out of the bound
+ * 32-bit index buffer. The draws are carried in the buffer, and uploaded
+ * on replay.
+ *
+ * @param buffer The command buffer.
+ * @param count The amount of draws.
+ * @return leto_draw_command_t* -- Where to write the draws, or NULL on
+ * failure. This is only valid until the next command is recorded.
+ */
+leto_draw_command_t *LetoRecordDrawIndirect(leto_command_buffer_t *buffer,
+                                            size_t count);
+
+/**
+ * RecordCommands
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Reset a set of buffers, and fill them across the worker pool;
+ * the function is called once for each buffer, each call on one thread
+ * only. This returns once every buffer is recorded.
+ *
+ * @param buffers The buffers.
+ * @param count The amount of buffers.
+ * @param function The function recording a buffer.
+ * @param argument What the function is given.
+ * @return void -- Nothing.
+ */
+void LetoRecordCommands(leto_command_buffer_t *buffers, size_t count,
+                        leto_record_function_t function, void *argument);
+
+/**
+ * ExecuteCommandBuffers
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Replay a set of buffers, in order, on the context's thread. The
+ * buffers are left as they are, and can be replayed again.
+ *
+ * @param buffers The buffers.
+ * @param count The amount of buffers.
+ * @return size_t -- The amount of commands replayed.
+ */
+size_t LetoExecuteCommandBuffers(leto_command_buffer_t *buffers,
+                                 size_t count);
+
+#endif // LETO__COMMANDS_H
@@ -0,0 +1,309 @@
+/**
+ * @file Culling.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's frustum culler. Each box is tested against each
+ * plane by its center's distance plus its projected radius, a lane per
+ * box, written against @ref Simd.h; AVX2 builds test eight boxes at
+ * once, SSE2 and NEON builds four, and anything else one.
+ * @implements Culling.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Culling.h"           // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Utilities/Macros.h>  // Utility macros
+#include <Utilities/Simd.h>    // Vector operations
+#include <Utilities/Threads.h> // Threading
+
+#include <CGLM/frustum.h> // GLM frustum plane extraction
+
+#include <math.h>   // Standard math functions
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The granularity of a bounds set's capacity, so whole vectors can
+ * always be read.
+ */
+#define BOUNDS_GRANULARITY 8
+
+/**
+ * @brief A frustum unpacked for testing; each plane's normal, the
+ * absolute value of its normal, and its distance.
+ */
+typedef struct cull_planes
+{
+    float normal[6][3];
+    float absolute[6][3];
+    float distance[6];
+} cull_planes_t;
+
+/**
+ * @brief A slice of a cull, run on the worker pool.
+ */
+typedef struct cull_job
+{
+    /**
+     * @brief The set being culled.
+     */
+    const leto_bounds_t *bounds;
+    /**
+     * @brief The planes being culled against.
+     */
+    const cull_planes_t *planes;
+    /**
+     * @brief The first box of the slice, a multiple of @ref
+     * LETO_SIMD_WIDTH.
+     */
+    size_t first;
+    /**
+     * @brief One past the last box of the slice.
+     */
+    size_t last;
+    /**
+     * @brief Where the slice's visible indices are written.
+     */
+    uint32_t *visible;
+    /**
+     * @brief The amount of indices written to @ref visible.
+     */
+    size_t written;
+} cull_job_t;
+
+/**
+ * WriteVisible
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Append the indices of a vector's visible lanes to the output.
+ *
+ * @param mask One bit per lane, set if the lane's box is visible.
+ * @param base The index of the box in the first lane.
+ * @param last One past the last valid box.
+ * @param visible The output.
+ * @return size_t -- The amount of indices written.
+ */
+static size_t WriteVisible_(unsigned int mask, size_t base, size_t last,
+                            uint32_t *visible)
+{
+    // Writing every lane and only advancing past the visible ones keeps
+    // this free of unpredictable branches.
+    size_t written = 0;
+    for (size_t k = 0; k < LETO_SIMD_WIDTH && base + k < last; k++)
+    {
+        visible[written] = (uint32_t)(base + k);
+        written += (mask >> k) & 1;
+    }
+    return written;
+}
+
+/**
+ * CullRange
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Cull a range of boxes, a vector's worth at a time.
+ *
+ * @param bounds The set being culled.
+ * @param planes The planes to cull against.
+ * @param first The first box, a multiple of @ref LETO_SIMD_WIDTH.
+ * @param last One past the last box.
+ * @param visible Filled with the visible indices.
+ * @return size_t -- The amount of indices written.
+ */
+static size_t CullRange_(const leto_bounds_t *bounds,
+                         const cull_planes_t *planes, size_t first,
+                         size_t last, uint32_t *visible)
+{
+    const leto_simd_t zero = LetoSimdSet(0.0f);
+
+    size_t written = 0;
+    for (size_t i = first; i < last; i += LETO_SIMD_WIDTH)
+    {
+        // A box is inside if it's on the inner side of every plane, so
+        // only its nearest plane matters.
+        leto_simd_t nearest = LetoSimdSet(INFINITY);
+        for (size_t p = 0; p < 6; p++)
+        {
+            leto_simd_t distance = LetoSimdSet(planes->distance[p]);
+            for (size_t a = 0; a < 3; a++)
+            {
+                leto_simd_t center = LetoSimdLoad(&bounds->center[a][i]);
+                leto_simd_t extent = LetoSimdLoad(&bounds->extent[a][i]);
+                leto_simd_t normal = LetoSimdSet(planes->normal[p][a]);
+                leto_simd_t absolute =
+                    LetoSimdSet(planes->absolute[p][a]);
+                distance =
+                    LetoSimdAdd(distance, LetoSimdMul(center, normal));
+                distance =
+                    LetoSimdAdd(distance, LetoSimdMul(extent, absolute));
+            }
+            nearest = LetoSimdMin(nearest, distance);
+        }
+
+        const unsigned int mask =
+            LetoSimdBits(LetoSimdAtLeast(nearest, zero));
+        written += WriteVisible_(mask, i, last, visible + written);
+    }
+    return written;
+}
+
+/**
+ * RunJob
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Cull a job's slice of the set.
+ *
+ * @param argument The @ref cull_job_t to run.
+ * @return void -- Nothing.
+ */
+static void RunJob_(void *argument)
+{
+    cull_job_t *job = argument;
+    job->written = CullRange_(job->bounds, job->planes, job->first,
+                              job->last, job->visible);
+}
+
+/**
+ * Reallocate
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move a set of bounds into a new allocation of the given
+ * capacity, keeping its contents.
+ *
+ * @param bounds The set to move.
+ * @param capacity The new capacity, a multiple of @ref
+ * BOUNDS_GRANULARITY.
+ * @return bool -- True for success, false for failure.
+ */
+static bool Reallocate_(leto_bounds_t *bounds, size_t capacity)
+{
+    void *allocation;
+    LETO_ALLOC_OR_FAIL(allocation,
+                       capacity * 6 * sizeof(float) + LETO_SIMD_ALIGNMENT);
+    if (allocation == NULL) return false;
+
+    // Every array is a multiple of eight floats long, so aligning the
+    // first aligns them all.
+    uintptr_t address = (uintptr_t)allocation;
+    address = (address + LETO_SIMD_ALIGNMENT - 1) &
+              ~(uintptr_t)(LETO_SIMD_ALIGNMENT - 1);
+    float *arrays = (float *)address;
+    // Padding boxes sit at the origin with no size; they're never
+    // reported, but should still be real numbers.
+    memset(arrays, 0, capacity * 6 * sizeof(float));
+
+    for (size_t a = 0; a < 3; a++)
+    {
+        float *center = arrays + capacity * a;
+        float *extent = arrays + capacity * (a + 3);
+        if (bounds->count != 0)
+        {
+            memcpy(center, bounds->center[a],
+                   bounds->count * sizeof(float));
+            memcpy(extent, bounds->extent[a],
+                   bounds->count * sizeof(float));
+        }
+        bounds->center[a] = center;
+        bounds->extent[a] = extent;
+    }
+
+    free(bounds->_);
+    bounds->_ = allocation;
+    bounds->capacity = capacity;
+    return true;
+}
+
+void LetoExtractFrustum(leto_frustum_t *frustum, mat4 view_projection)
+{
+    if (frustum == NULL) return;
+    glm_frustum_planes(view_projection, frustum->planes);
+}
+
+bool LetoCreateBounds(leto_bounds_t *bounds, size_t capacity)
+{
+    if (bounds == NULL) return false;
+    memset(bounds, 0, sizeof(leto_bounds_t));
+
+    if (capacity < BOUNDS_GRANULARITY) capacity = BOUNDS_GRANULARITY;
+    capacity = (capacity + BOUNDS_GRANULARITY - 1) /
+               BOUNDS_GRANULARITY * BOUNDS_GRANULARITY;
+    return Reallocate_(bounds, capacity);
+}
+
+void LetoDestroyBounds(leto_bounds_t *bounds)
+{
+    if (bounds == NULL) return;
+    free(bounds->_);
+    memset(bounds, 0, sizeof(leto_bounds_t));
+}
+
+size_t LetoAddBounds(leto_bounds_t *bounds, vec3 center, vec3 extent)
+{
+    if (bounds->count == bounds->capacity &&
+        !Reallocate_(bounds, bounds->capacity * 2))
+        return bounds->count;
+
+    LetoSetBounds(bounds, bounds->count, center, extent);
+    return bounds->count++;
+}
+
+void LetoSetBounds(leto_bounds_t *bounds, size_t index, vec3 center,
+                   vec3 extent)
+{
+    if (bounds == NULL || index >= bounds->capacity) return;
+    for (size_t a = 0; a < 3; a++)
+    {
+        bounds->center[a][index] = center[a];
+        bounds->extent[a][index] = fabsf(extent[a]);
+    }
+}
+
+size_t LetoCullBounds(const leto_bounds_t *bounds,
+                      const leto_frustum_t *frustum, uint32_t *visible)
+{
+    if (bounds == NULL || frustum == NULL || visible == NULL) return 0;
+
+    cull_planes_t planes;
+    for (size_t p = 0; p < 6; p++)
+    {
+        for (size_t a = 0; a < 3; a++)
+        {
+            planes.normal[p][a] = frustum->planes[p][a];
+            planes.absolute[p][a] = fabsf(frustum->planes[p][a]);
+        }
+        planes.distance[p] = frustum->planes[p][3];
+    }
+
+    size_t job_count = bounds->count / LETO_CULL_THREAD_BATCH;
+    if (job_count > LetoGetWorkerCount()) job_count = LetoGetWorkerCount();
+    if (job_count < 2)
+        return CullRange_(bounds, &planes, 0, bounds->count, visible);
+
+    // Slices start on vector boundaries, and each writes its indices
+    // where its boxes start, so no two threads touch the same memory.
+    size_t slice = (bounds->count + job_count - 1) / job_count;
+    slice = (slice + LETO_SIMD_WIDTH - 1) / LETO_SIMD_WIDTH *
+            LETO_SIMD_WIDTH;
+
+    cull_job_t jobs[LETO_MAX_WORKERS];
+    for (size_t j = 0; j < job_count; j++)
+    {
+        size_t first = j * slice;
+        size_t last = first + slice;
+        if (first > bounds->count) first = bounds->count;
+        if (last > bounds->count) last = bounds->count;
+        jobs[j] = (cull_job_t){.bounds = bounds,
+                               .planes = &planes,
+                               .first = first,
+                               .last = last,
+                               .visible = visible + first};
+    }
+    LetoRunJobs(RunJob_, jobs, sizeof(cull_job_t), job_count);
+
+    size_t written = jobs[0].written;
+    for (size_t j = 1; j < job_count; j++)
+    {
+        memmove(visible + written, jobs[j].visible,
+                jobs[j].written * sizeof(uint32_t));
+        written += jobs[j].written;
+    }
+    return written;
+}
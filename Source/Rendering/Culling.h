@@ -0,0 +1,151 @@
+/**
+ * @file Culling.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's frustum culler. Object bounds are kept as
+ * structure-of-arrays boxes, so they can be tested against the camera's
+ * frustum four or eight at a time, and large sets are split over
+ * threads. What comes out is a compact list of the visible indices.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__CULLING_H
+#define LETO__CULLING_H
+
+// GLM 3D vectors.
+#include <CGLM/vec3.h>
+// GLM 4x4 matrices.
+#include <CGLM/mat4.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Fixed-width integer types.
+#include <stdint.h>
+
+/**
+ * @brief The least amount of bounds each culling thread is given. Sets
+ * smaller than twice this are culled entirely on the calling thread.
+ */
+#define LETO_CULL_THREAD_BATCH 16384
+
+/**
+ * @brief The six planes of a view frustum, in world space, normalized
+ * and facing inwards.
+ */
+typedef struct leto_frustum
+{
+    /**
+     * @brief The planes, as (normal, distance); left, right, bottom,
+     * top, near, then far.
+     */
+    vec4 planes[6];
+} leto_frustum_t;
+
+/**
+ * @brief A set of axis-aligned boxes, stored as one array per component
+ * so they can be loaded straight into vector registers. This struct
+ * should only be modified through the functions below.
+ */
+typedef struct leto_bounds
+{
+    /**
+     * @brief The allocation every array below lives in.
+     */
+    void *_;
+    /**
+     * @brief The center of every box, one array per axis.
+     */
+    float *center[3];
+    /**
+     * @brief The half-size of every box, one array per axis.
+     */
+    float *extent[3];
+    /**
+     * @brief The amount of boxes in the set.
+     */
+    size_t count;
+    /**
+     * @brief The amount of boxes the set has room for. This is always a
+     * multiple of eight, so whole vectors can be read past @ref count.
+     */
+    size_t capacity;
+} leto_bounds_t;
+
+/**
+ * ExtractFrustum
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the frustum planes of a view-projection matrix.
+ *
+ * @param frustum The frustum to fill.
+ * @param view_projection The projection matrix times the view matrix.
+ * @return void -- Nothing.
+ */
+void LetoExtractFrustum(leto_frustum_t *frustum, mat4 view_projection);
+
+/**
+ * CreateBounds
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty set of bounds.
+ *
+ * @param bounds The set to initialize.
+ * @param capacity The amount of boxes the set should have room for.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateBounds(leto_bounds_t *bounds, size_t capacity);
+
+/**
+ * DestroyBounds
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free a set of bounds.
+ *
+ * @param bounds The set to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyBounds(leto_bounds_t *bounds);
+
+/**
+ * AddBounds
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add a box to a set, growing it if it's full.
+ *
+ * @param bounds The set to add to.
+ * @param center The center of the box.
+ * @param extent The half-size of the box along each axis.
+ * @return size_t -- The index of the new box, which is what culling
+ * reports it as.
+ */
+size_t LetoAddBounds(leto_bounds_t *bounds, vec3 center, vec3 extent);
+
+/**
+ * SetBounds
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move or resize a box already in a set.
+ *
+ * @param bounds The set holding the box.
+ * @param index The index of the box.
+ * @param center The new center of the box.
+ * @param extent The new half-size of the box along each axis.
+ * @return void -- Nothing.
+ */
+void LetoSetBounds(leto_bounds_t *bounds, size_t index, vec3 center,
+                   vec3 extent);
+
+/**
+ * CullBounds
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Test every box of a set against a frustum. Boxes are kept if
+ * they're at least partially inside every plane, which is conservative;
+ * boxes near the frustum's corners may be kept without being visible.
+ *
+ * @param bounds The set to cull.
+ * @param frustum The frustum to cull against.
+ * @param visible Filled with the indices of the kept boxes, in ascending
+ * order. This must have room for the set's whole @ref count.
+ * @return size_t -- The amount of indices written to @ref visible.
+ */
+size_t LetoCullBounds(const leto_bounds_t *bounds,
+                      const leto_frustum_t *frustum, uint32_t *visible);
+
+#endif // LETO__CULLING_H
@@ -0,0 +1,608 @@
+/**
+ * @file Geometry.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's geometry arena. Each stream of an arena is a
+ * buffer carved up by a first-fit allocator over a sorted list of free
+ * ranges; freed ranges are merged with their neighbours, and a stream
+ * that runs out of room doubles, copying itself on the GPU. Uploads are
+ * written into a ring and copied into their stream on the GPU, so a
+ * stream is never mapped while it may be drawn from.
+ * @implements Geometry.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Geometry.h"          // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Deferred object release
+#include <Rendering/Ring.h>    // Ring buffers
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The amount of vertices a new arena has room for.
+ */
+#define INITIAL_VERTICES (1u << 16)
+
+/**
+ * @brief The amount of indices a new arena has room for.
+ */
+#define INITIAL_INDICES (1u << 18)
+
+/**
+ * @brief The bytes of uploads to make room for each frame. The staging
+ * ring grows past this if a frame uploads more.
+ */
+#define STAGING_SIZE (1u << 20)
+
+// Shaders index the draw array with a 16-byte stride, and OpenGL reads
+// commands five words at a time.
+_Static_assert(sizeof(leto_draw_data_t) == 16,
+               "Draw data must match the std430 layout.");
+_Static_assert(sizeof(leto_draw_command_t) == 20,
+               "Draw commands must match DrawElementsIndirectCommand.");
+
+/**
+ * @brief A run of free elements within a stream.
+ */
+typedef struct geometry_range
+{
+    uint32_t first;
+    uint32_t count;
+} geometry_range_t;
+
+/**
+ * @brief One buffer of an arena, and the allocator carving it up.
+ */
+typedef struct geometry_stream
+{
+    /**
+     * @brief The OpenGL ID of the buffer.
+     */
+    unsigned int buffer;
+    /**
+     * @brief The size of one element of the stream, in bytes.
+     */
+    size_t element_size;
+    /**
+     * @brief The amount of elements the buffer has room for.
+     */
+    uint32_t capacity;
+    /**
+     * @brief The free ranges of the buffer, sorted by their first element
+     * and never touching one another.
+     */
+    geometry_range_t *free;
+    /**
+     * @brief The amount of ranges in @ref free.
+     */
+    size_t free_count;
+    /**
+     * @brief The amount of ranges @ref free has room for.
+     */
+    size_t free_capacity;
+    /**
+     * @brief Where the upload being written to the stream is staged, if
+     * it's mapped.
+     */
+    leto_ring_allocation_t staged;
+} geometry_stream_t;
+
+/**
+ * @brief The arena of a single vertex format.
+ */
+typedef struct geometry_arena
+{
+    /**
+     * @brief The size of a vertex, in bytes.
+     */
+    uint32_t stride;
+    /**
+     * @brief The attributes of a vertex.
+     */
+    leto_mesh_attribute_t attributes[LETO_MESH_ATTRIBUTES];
+    /**
+     * @brief The OpenGL ID of the vertex array describing the arena.
+     */
+    unsigned int vertex_array;
+    /**
+     * @brief The vertex and index streams.
+     */
+    geometry_stream_t streams[geometry_stream_count];
+} geometry_arena_t;
+
+/**
+ * @brief The state of the geometry arenas. There is only ever one.
+ */
+static struct
+{
+    /**
+     * @brief Every arena, indexed by vertex format.
+     */
+    geometry_arena_t list[LETO_MAX_VERTEX_FORMATS];
+    /**
+     * @brief The amount of arenas in use.
+     */
+    size_t count;
+    /**
+     * @brief The ring uploads are staged in.
+     */
+    leto_ring_buffer_t staging;
+    /**
+     * @brief The frame the staging ring was last moved on in.
+     */
+    uint64_t frame;
+} arenas;
+
+/**
+ * FreeRange
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give a range of elements back to a stream, merging it with any
+ * free range it touches.
+ *
+ * @param stream The stream.
+ * @param first The first element of the range.
+ * @param count The amount of elements in the range.
+ * @return void -- Nothing.
+ */
+static void FreeRange_(geometry_stream_t *stream, uint32_t first,
+                       uint32_t count)
+{
+    if (count == 0) return;
+
+    size_t index = 0;
+    while (index < stream->free_count && stream->free[index].first < first)
+        index++;
+
+    geometry_range_t *before = index > 0 ? &stream->free[index - 1] : NULL;
+    geometry_range_t *after =
+        index < stream->free_count ? &stream->free[index] : NULL;
+    const bool joins_before =
+        before != NULL && before->first + before->count == first;
+    const bool joins_after =
+        after != NULL && first + count == after->first;
+
+    if (joins_before && joins_after)
+    {
+        before->count += count + after->count;
+        memmove(after, after + 1,
+                (stream->free_count - index - 1) *
+                    sizeof(geometry_range_t));
+        stream->free_count--;
+        return;
+    }
+    if (joins_before)
+    {
+        before->count += count;
+        return;
+    }
+    if (joins_after)
+    {
+        after->first = first;
+        after->count += count;
+        return;
+    }
+
+    if (stream->free_count == stream->free_capacity)
+    {
+        size_t capacity =
+            stream->free_capacity == 0 ? 16 : stream->free_capacity * 2;
+        void *grown =
+            realloc(stream->free, capacity * sizeof(geometry_range_t));
+        if (grown == NULL)
+        {
+            LetoReportError(true, failed_allocation, LETO_FILE_CONTEXT);
+            return;
+        }
+        stream->free = grown;
+        stream->free_capacity = capacity;
+    }
+
+    memmove(&stream->free[index + 1], &stream->free[index],
+            (stream->free_count - index) * sizeof(geometry_range_t));
+    stream->free[index] = (geometry_range_t){first, count};
+    stream->free_count++;
+}
+
+/**
+ * TakeRange
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take the first free range of a stream that's large enough.
+ *
+ * @param stream The stream.
+ * @param count The amount of elements needed.
+ * @param first Set to the first element of the range taken.
+ * @return bool -- True if a range was taken, false if none was large
+ * enough.
+ */
+static bool TakeRange_(geometry_stream_t *stream, uint32_t count,
+                       uint32_t *first)
+{
+    for (size_t i = 0; i < stream->free_count; i++)
+    {
+        geometry_range_t *range = &stream->free[i];
+        if (range->count < count) continue;
+
+        *first = range->first;
+        range->first += count;
+        range->count -= count;
+        if (range->count == 0)
+        {
+            memmove(range, range + 1,
+                    (stream->free_count - i - 1) *
+                        sizeof(geometry_range_t));
+            stream->free_count--;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * CreateBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create the immutable storage of a stream.
+ *
+ * @param stream The stream.
+ * @param capacity The amount of elements to make room for.
+ * @return unsigned int -- The OpenGL ID of the buffer, or 0 if the
+ * storage couldn't be made.
+ */
+static unsigned int CreateBuffer_(const geometry_stream_t *stream,
+                                  uint32_t capacity)
+{
+    // Only ever written by copies, so the CPU needs no access at all.
+    const size_t size = (size_t)capacity * stream->element_size;
+    unsigned int buffer = LetoAcquireBuffer(size, 0);
+    if (buffer == 0) return 0;
+
+    // A driver out of memory leaves the buffer without storage rather
+    // than failing to make it.
+    GLint64 made = 0;
+    glGetNamedBufferParameteri64v(buffer, GL_BUFFER_SIZE, &made);
+    if ((size_t)made != size)
+    {
+        LetoReleaseObject(buffer_object, buffer);
+        LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+        return 0;
+    }
+    return buffer;
+}
+
+/**
+ * AttachBuffers
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Point an arena's vertex array at its current buffers.
+ *
+ * @param arena The arena.
+ * @return void -- Nothing.
+ */
+static void AttachBuffers_(geometry_arena_t *arena)
+{
+    glVertexArrayVertexBuffer(arena->vertex_array, 0,
+                              arena->streams[geometry_vertices].buffer, 0,
+                              (GLsizei)arena->stride);
+    glVertexArrayElementBuffer(arena->vertex_array,
+                               arena->streams[geometry_indices].buffer);
+}
+
+/**
+ * GrowStream
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Double a stream until it can fit the given amount of elements,
+ * copying its contents across on the GPU.
+ *
+ * @param arena The arena owning the stream.
+ * @param stream The stream.
+ * @param count The amount of elements that has to fit.
+ * @return bool -- True for success, false if the stream would outgrow
+ * 32-bit offsets or its new storage couldn't be made. The stream is left
+ * as it was on failure.
+ */
+static bool GrowStream_(geometry_arena_t *arena, geometry_stream_t *stream,
+                        uint32_t count)
+{
+    // A free range running up to the end of the buffer counts too.
+    uint32_t tail = 0;
+    if (stream->free_count != 0)
+    {
+        const geometry_range_t *last =
+            &stream->free[stream->free_count - 1];
+        if (last->first + last->count == stream->capacity)
+            tail = last->count;
+    }
+
+    // Offsets into the stream are 32-bit, so it can't grow past that.
+    size_t capacity = stream->capacity;
+    while (capacity - stream->capacity + tail < count) capacity *= 2;
+    if (capacity > UINT32_MAX)
+    {
+        LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+        return false;
+    }
+
+    unsigned int buffer = CreateBuffer_(stream, (uint32_t)capacity);
+    if (buffer == 0) return false;
+    glCopyNamedBufferSubData(
+        stream->buffer, buffer, 0, 0,
+        (GLsizeiptr)(stream->capacity * stream->element_size));
+    LetoReleaseObject(buffer_object, stream->buffer);
+
+    stream->buffer = buffer;
+    FreeRange_(stream, stream->capacity,
+               (uint32_t)capacity - stream->capacity);
+    stream->capacity = (uint32_t)capacity;
+    AttachBuffers_(arena);
+    return true;
+}
+
+/**
+ * CreateVertexArray
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Describe an arena's vertex layout to OpenGL.
+ *
+ * @param arena The arena whose format to describe.
+ * @return void -- Nothing.
+ */
+static void CreateVertexArray_(geometry_arena_t *arena)
+{
+    glCreateVertexArrays(1, &arena->vertex_array);
+    AttachBuffers_(arena);
+
+    for (unsigned int i = 0; i < LETO_MESH_ATTRIBUTES; i++)
+    {
+        const leto_mesh_attribute_t *attribute = &arena->attributes[i];
+
+        unsigned int type = GL_FLOAT;
+        bool normalized = false;
+        switch (attribute->format)
+        {
+            case attribute_float: break;
+            case attribute_half:
+                type = GL_HALF_FLOAT;
+                break;
+            case attribute_unorm16:
+                type = GL_UNSIGNED_SHORT;
+                normalized = true;
+                break;
+            case attribute_snorm16:
+            case attribute_octahedral:
+                type = GL_SHORT;
+                normalized = true;
+                break;
+            default: continue; // unused slot
+        }
+
+        glEnableVertexArrayAttrib(arena->vertex_array, i);
+        glVertexArrayAttribFormat(arena->vertex_array, i,
+                                  attribute->components, type, normalized,
+                                  attribute->offset);
+        glVertexArrayAttribBinding(arena->vertex_array, i, 0);
+    }
+}
+
+/**
+ * GetRange
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find where one stream of some geometry lies within its buffer.
+ *
+ * @param geometry The geometry.
+ * @param stream The stream.
+ * @param offset Filled with the offset of the range, in bytes.
+ * @param size Filled with the size of the range, in bytes.
+ * @return geometry_stream_t* -- The stream of the geometry's arena.
+ */
+static geometry_stream_t *GetRange_(const leto_geometry_t *geometry,
+                                    leto_geometry_stream_t stream,
+                                    size_t *offset, size_t *size)
+{
+    geometry_stream_t *target =
+        &arenas.list[geometry->format].streams[stream];
+    const size_t first = stream == geometry_vertices
+                             ? geometry->first_vertex
+                             : geometry->first_index;
+    const size_t count = stream == geometry_vertices
+                             ? geometry->vertex_count
+                             : geometry->index_count;
+    *offset = first * target->element_size;
+    *size = count * target->element_size;
+    return target;
+}
+
+bool LetoInitGeometry(void)
+{
+    memset(&arenas, 0, sizeof(arenas));
+    return LetoCreateRingBuffer(&arenas.staging, STAGING_SIZE);
+}
+
+void LetoTerminateGeometry(void)
+{
+    for (size_t i = 0; i < arenas.count; i++)
+    {
+        geometry_arena_t *arena = &arenas.list[i];
+        LetoReleaseObject(vertex_array_object, arena->vertex_array);
+        for (size_t j = 0; j < geometry_stream_count; j++)
+        {
+            LetoReleaseObject(buffer_object, arena->streams[j].buffer);
+            free(arena->streams[j].free);
+        }
+    }
+    LetoDestroyRingBuffer(&arenas.staging);
+    memset(&arenas, 0, sizeof(arenas));
+}
+
+uint32_t LetoFindVertexFormat(uint32_t stride,
+                              const leto_mesh_attribute_t *attributes)
+{
+    if (attributes == NULL || stride == 0) return LETO_GEOMETRY_NONE;
+
+    const size_t size =
+        LETO_MESH_ATTRIBUTES * sizeof(leto_mesh_attribute_t);
+    for (size_t i = 0; i < arenas.count; i++)
+    {
+        const geometry_arena_t *arena = &arenas.list[i];
+        if (arena->stride == stride &&
+            memcmp(arena->attributes, attributes, size) == 0)
+            return (uint32_t)i;
+    }
+
+    if (arenas.count == LETO_MAX_VERTEX_FORMATS)
+    {
+        LetoReportError(false, no_vertex_formats, LETO_FILE_CONTEXT);
+        return LETO_GEOMETRY_NONE;
+    }
+
+    geometry_arena_t *arena = &arenas.list[arenas.count];
+    memset(arena, 0, sizeof(geometry_arena_t));
+    arena->stride = stride;
+    memcpy(arena->attributes, attributes, size);
+
+    const uint32_t capacities[geometry_stream_count] = {INITIAL_VERTICES,
+                                                        INITIAL_INDICES};
+    arena->streams[geometry_vertices].element_size = stride;
+    arena->streams[geometry_indices].element_size = sizeof(uint32_t);
+    for (size_t i = 0; i < geometry_stream_count; i++)
+    {
+        geometry_stream_t *stream = &arena->streams[i];
+        stream->buffer = CreateBuffer_(stream, capacities[i]);
+        if (stream->buffer != 0) continue;
+
+        LetoReleaseObject(buffer_object,
+                          arena->streams[geometry_vertices].buffer);
+        return LETO_GEOMETRY_NONE;
+    }
+    for (size_t i = 0; i < geometry_stream_count; i++)
+    {
+        arena->streams[i].capacity = capacities[i];
+        FreeRange_(&arena->streams[i], 0, capacities[i]);
+    }
+    CreateVertexArray_(arena);
+
+    return (uint32_t)arenas.count++;
+}
+
+bool LetoAllocateGeometry(leto_geometry_t *geometry, uint32_t format,
+                          size_t vertex_count, size_t index_count)
+{
+    if (geometry == NULL) return false;
+    geometry->format = LETO_GEOMETRY_NONE;
+    if (format >= arenas.count || vertex_count == 0 || index_count == 0)
+        return false;
+    if (vertex_count > INT32_MAX || index_count > INT32_MAX) return false;
+
+    geometry_arena_t *arena = &arenas.list[format];
+    const uint32_t counts[geometry_stream_count] = {(uint32_t)vertex_count,
+                                                    (uint32_t)index_count};
+    uint32_t firsts[geometry_stream_count];
+    for (size_t i = 0; i < geometry_stream_count; i++)
+    {
+        geometry_stream_t *stream = &arena->streams[i];
+        if (TakeRange_(stream, counts[i], &firsts[i])) continue;
+        if (GrowStream_(arena, stream, counts[i]) &&
+            TakeRange_(stream, counts[i], &firsts[i]))
+            continue;
+
+        // Give back whatever the earlier streams already took.
+        for (size_t j = 0; j < i; j++)
+            FreeRange_(&arena->streams[j], firsts[j], counts[j]);
+        return false;
+    }
+
+    *geometry = (leto_geometry_t){.format = format,
+                                      .first_vertex = firsts[0],
+                                      .vertex_count = counts[0],
+                                      .first_index = firsts[1],
+                                      .index_count = counts[1]};
+    return true;
+}
+
+void LetoFreeGeometry(leto_geometry_t *geometry)
+{
+    if (geometry == NULL || geometry->format >= arenas.count)
+        return;
+
+    geometry_arena_t *arena = &arenas.list[geometry->format];
+    FreeRange_(&arena->streams[geometry_vertices],
+               geometry->first_vertex, geometry->vertex_count);
+    FreeRange_(&arena->streams[geometry_indices], geometry->first_index,
+               geometry->index_count);
+    memset(geometry, 0, sizeof(leto_geometry_t));
+    geometry->format = LETO_GEOMETRY_NONE;
+}
+
+void *LetoMapGeometry(const leto_geometry_t *geometry,
+                      leto_geometry_stream_t stream)
+{
+    if (geometry == NULL || geometry->format >= arenas.count ||
+        stream >= geometry_stream_count)
+        return NULL;
+
+    size_t offset, size;
+    geometry_stream_t *target =
+        GetRange_(geometry, stream, &offset, &size);
+    if (target->staged.size != 0) return NULL;
+
+    // Every upload of a frame shares the frame's region.
+    if (arenas.frame != LetoGetFrame())
+        LetoAdvanceRingBuffer(&arenas.staging);
+    arenas.frame = LetoGetFrame();
+    if (!LetoAllocateRing(&arenas.staging, size, &target->staged))
+        return NULL;
+    return target->staged.data;
+}
+
+void LetoUnmapGeometry(const leto_geometry_t *geometry,
+                       leto_geometry_stream_t stream)
+{
+    if (geometry == NULL || geometry->format >= arenas.count ||
+        stream >= geometry_stream_count)
+        return;
+
+    size_t offset, size;
+    geometry_stream_t *target =
+        GetRange_(geometry, stream, &offset, &size);
+    if (target->staged.size == 0) return;
+
+    // The copy is ordered after every draw already submitted, so nothing
+    // reading the old contents has to be waited on.
+    glCopyNamedBufferSubData(target->staged.buffer, target->buffer,
+                             (GLintptr)target->staged.offset,
+                             (GLintptr)offset, (GLsizeiptr)size);
+    memset(&target->staged, 0, sizeof(leto_ring_allocation_t));
+}
+
+void LetoBindGeometry(uint32_t format)
+{
+    if (format >= arenas.count) return;
+    LetoBindVertexArray(arenas.list[format].vertex_array);
+}
+
+const leto_mesh_attribute_t *LetoGetVertexFormat(uint32_t format,
+                                                 uint32_t *stride)
+{
+    if (format >= arenas.count) return NULL;
+    if (stride != NULL) *stride = arenas.list[format].stride;
+    return arenas.list[format].attributes;
+}
+
+void LetoBindGeometryStorage(uint32_t format, unsigned int vertices,
+                             unsigned int indices)
+{
+    if (format >= arenas.count) return;
+
+    const unsigned int points[geometry_stream_count] = {vertices, indices};
+    for (size_t i = 0; i < geometry_stream_count; i++)
+    {
+        const geometry_stream_t *stream = &arenas.list[format].streams[i];
+        LetoBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER, points[i], stream->buffer, 0,
+            (ptrdiff_t)(stream->capacity * stream->element_size));
+    }
+}
@@ -0,0 +1,266 @@
+/**
+ * @file Geometry.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's geometry arena. Every mesh sharing a vertex
+ * format lives in the same pair of vertex and index buffers, described by
+ * a single vertex array, so whole passes can be drawn with a handful of
+ * multi-draw indirect calls instead of one call per mesh.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__GEOMETRY_H
+#define LETO__GEOMETRY_H
+
+// The binary mesh format.
+#include <Input/MeshFormat.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size type.
+#include <stddef.h>
+
+/**
+ * @brief The maximum amount of distinct vertex formats, and so of arenas,
+ * that can exist at once.
+ */
+#define LETO_MAX_VERTEX_FORMATS 8
+
+/**
+ * @brief The shader storage binding point per-draw data is bound to.
+ * Shaders declare the block with "layout(std430, binding = 3)", and find
+ * their draw's record at gl_DrawID.
+ */
+#define LETO_DRAW_BINDING 3
+
+/**
+ * @brief The value of a vertex format index that refers to nothing.
+ */
+#define LETO_GEOMETRY_NONE UINT32_MAX
+
+/**
+ * @brief The streams of an arena.
+ */
+typedef enum leto_geometry_stream
+{
+    geometry_vertices,
+    geometry_indices,
+    geometry_stream_count
+} leto_geometry_stream_t;
+
+/**
+ * @brief A single indexed draw, laid out exactly as OpenGL reads it from
+ * an indirect buffer.
+ */
+typedef struct leto_draw_command
+{
+    /**
+     * @brief The amount of indices to draw.
+     */
+    uint32_t index_count;
+    /**
+     * @brief The amount of instances to draw.
+     */
+    uint32_t instance_count;
+    /**
+     * @brief The first index within the arena's index buffer.
+     */
+    uint32_t first_index;
+    /**
+     * @brief The value added to every index, the first vertex of the mesh
+     * within the arena's vertex buffer.
+     */
+    int32_t base_vertex;
+    /**
+     * @brief The base instance of the draw.
+     */
+    uint32_t base_instance;
+} leto_draw_command_t;
+
+/**
+ * @brief The data of a single draw as shaders see it. This is laid out to
+ * match std430, and is exactly 16 bytes long.
+ */
+typedef struct leto_draw_data
+{
+    /**
+     * @brief The index of the draw's first instance in the instance
+     * buffer.
+     */
+    uint32_t first_instance;
+    /**
+     * @brief The amount of instances the draw covers.
+     */
+    uint32_t instance_count;
+    /**
+     * @brief The material slot of the draw.
+     */
+    uint32_t material;
+    /**
+     * @brief Padding to a 16-byte multiple.
+     */
+    uint32_t _;
+} leto_draw_data_t;
+
+/**
+ * @brief A block of geometry allocated from an arena. Indices are always
+ * stored 32 bits wide, and are relative to @ref first_vertex.
+ */
+typedef struct leto_geometry
+{
+    /**
+     * @brief The vertex format of the geometry, or @ref
+     * LETO_GEOMETRY_NONE if it holds nothing.
+     */
+    uint32_t format;
+    /**
+     * @brief The first vertex of the geometry within its arena.
+     */
+    uint32_t first_vertex;
+    /**
+     * @brief The amount of vertices of the geometry.
+     */
+    uint32_t vertex_count;
+    /**
+     * @brief The first index of the geometry within its arena.
+     */
+    uint32_t first_index;
+    /**
+     * @brief The amount of indices of the geometry.
+     */
+    uint32_t index_count;
+} leto_geometry_t;
+
+/**
+ * InitGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Initialize the geometry arenas. This must be called after the
+ * OpenGL context is current, and before any geometry is allocated.
+ *
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoInitGeometry(void);
+
+/**
+ * TerminateGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Release every arena. Any geometry still allocated is invalid
+ * afterwards.
+ *
+ * @return void -- Nothing.
+ */
+void LetoTerminateGeometry(void);
+
+/**
+ * FindVertexFormat
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the arena of the given vertex layout, creating it if it
+ * doesn't exist yet.
+ *
+ * @param stride The size of a vertex, in bytes.
+ * @param attributes The @ref LETO_MESH_ATTRIBUTES attributes of a vertex.
+ * @return uint32_t -- The index of the format, or @ref LETO_GEOMETRY_NONE
+ * if every format is taken.
+ */
+uint32_t LetoFindVertexFormat(uint32_t stride,
+                              const leto_mesh_attribute_t *attributes);
+
+/**
+ * AllocateGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Reserve room for some geometry in the arena of a vertex format.
+ * The arena grows if it has to, which must not happen while anything in
+ * it is mapped.
+ *
+ * @param geometry The geometry to initialize.
+ * @param format The vertex format of the geometry.
+ * @param vertex_count The amount of vertices to make room for.
+ * @param index_count The amount of indices to make room for.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoAllocateGeometry(leto_geometry_t *geometry, uint32_t format,
+                          size_t vertex_count, size_t index_count);
+
+/**
+ * FreeGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give the room of some geometry back to its arena. The GPU must
+ * be done drawing it.
+ *
+ * @param geometry The geometry to free.
+ * @return void -- Nothing.
+ */
+void LetoFreeGeometry(leto_geometry_t *geometry);
+
+/**
+ * MapGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get somewhere to write one stream of some geometry. The writes
+ * are staged, and copied into the arena by @ref LetoUnmapGeometry, so
+ * nothing drawn from the arena is waited on. Whatever was there before is
+ * discarded.
+ *
+ * @param geometry The geometry to map.
+ * @param stream The stream to map.
+ * @return void* -- The mapping, or NULL on failure.
+ */
+void *LetoMapGeometry(const leto_geometry_t *geometry,
+                      leto_geometry_stream_t stream);
+
+/**
+ * UnmapGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Copy a stream written through @ref LetoMapGeometry into its
+ * arena.
+ *
+ * @param geometry The mapped geometry.
+ * @param stream The mapped stream.
+ * @return void -- Nothing.
+ */
+void LetoUnmapGeometry(const leto_geometry_t *geometry,
+                       leto_geometry_stream_t stream);
+
+/**
+ * BindGeometry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the vertex array of a vertex format's arena. Draws made
+ * afterwards take 32-bit indices, offset by @ref
+ * leto_draw_command_t.first_index.
+ *
+ * @param format The vertex format.
+ * @return void -- Nothing.
+ */
+void LetoBindGeometry(uint32_t format);
+
+/**
+ * GetVertexFormat
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the layout of a vertex format, for shaders that fetch an
+ * arena's vertices themselves.
+ *
+ * @param format The vertex format.
+ * @param stride Filled in with the size of a vertex, in bytes.
+ * @return const leto_mesh_attribute_t* -- The @ref LETO_MESH_ATTRIBUTES
+ * attributes of a vertex, or NULL if the format doesn't exist.
+ */
+const leto_mesh_attribute_t *LetoGetVertexFormat(uint32_t format,
+                                                 uint32_t *stride);
+
+/**
+ * BindGeometryStorage
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the vertex and index buffers of a vertex format's arena to
+ * shader storage binding points, so shaders can fetch vertices without a
+ * vertex array. Shaders see both as arrays of 32-bit words.
+ *
+ * @param format The vertex format.
+ * @param vertices The binding point of the vertex buffer.
+ * @param indices The binding point of the index buffer.
+ * @return void -- Nothing.
+ */
+void LetoBindGeometryStorage(uint32_t format, unsigned int vertices,
+                             unsigned int indices);
+
+#endif // LETO__GEOMETRY_H
@@ -0,0 +1,573 @@
+/**
+ * @file GpuCulling.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's GPU-driven culling. Objects are kept in
+ * CPU-side arrays, and only the runs of them that changed are written
+ * into a ring and copied up on the GPU; the culling pass appends a
+ * command and draw record for every survivor with an atomic counter,
+ * which the draw then reads its draw count from.
+ * @implements GpuCulling.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "GpuCulling.h"        // Public interface parent
+#include <Input/Shaders.h>     // Compute program loading
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Deferred object release, frames
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <CGLM/box.h> // GLM bounding boxes
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <math.h>   // Standard math functions
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The amount of invocations in one of the culling pass's work
+ * groups. This must match the shader's local size.
+ */
+#define GROUP_SIZE 64
+
+/**
+ * @brief The indices of the culler's buffers.
+ */
+#define INSTANCE_BUFFER 0
+#define DRAW_BUFFER 1
+#define BOUNDS_BUFFER 2
+#define MESH_BUFFER 3
+#define COMMAND_BUFFER 4
+#define COUNT_BUFFER 5
+#define VISIBILITY_BUFFER 6
+#define MOTION_BUFFER 7
+
+/**
+ * @brief The indices of the culling program's uniform locations.
+ */
+#define OBJECT_COUNT_UNIFORM 0
+#define PLANES_UNIFORM 1
+#define CAMERA_UNIFORM 2
+#define LOD_SCALE_UNIFORM 3
+#define OCCLUSION_UNIFORM 4
+#define OCCLUSION_MATRIX_UNIFORM 5
+#define PHASE_UNIFORM 6
+
+// The culling pass indexes both arrays with these strides.
+_Static_assert(sizeof(leto_gpu_bounds_t) == 32,
+               "Bounds must match the std430 layout.");
+_Static_assert(sizeof(leto_gpu_mesh_t) == 80,
+               "Mesh records must match the std430 layout.");
+
+/**
+ * Resize
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Resize an array, keeping its contents.
+ *
+ * @param array The array to resize.
+ * @param count The new amount of elements.
+ * @param size The size of an element.
+ * @return void -- Nothing.
+ */
+static void Resize_(void **array, size_t count, size_t size)
+{
+    void *grown = realloc(*array, count * size);
+    if (grown == NULL)
+    {
+        LetoReportError(true, failed_allocation, LETO_FILE_CONTEXT);
+        return;
+    }
+    *array = grown;
+}
+
+/**
+ * Reserve
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure the culler has room for the given amount of objects.
+ *
+ * @param culler The culler.
+ * @param needed The amount of objects needed.
+ * @return void -- Nothing.
+ */
+static void Reserve_(leto_gpu_culler_t *culler, size_t needed)
+{
+    if (needed <= culler->capacity) return;
+
+    size_t capacity = culler->capacity == 0 ? 64 : culler->capacity;
+    while (capacity < needed) capacity *= 2;
+    Resize_((void **)&culler->instances, capacity,
+            sizeof(leto_instance_t));
+    Resize_((void **)&culler->bounds, capacity, sizeof(leto_gpu_bounds_t));
+    Resize_((void **)&culler->motions, capacity, sizeof(leto_motion_t));
+    // Capacities are whole words of dirty and moving bits.
+    Resize_((void **)&culler->dirty_objects, capacity / 64,
+            sizeof(uint64_t));
+    memset(culler->dirty_objects + culler->capacity / 64, 0,
+           (capacity - culler->capacity) / 64 * sizeof(uint64_t));
+    Resize_((void **)&culler->moving_objects, capacity / 64,
+            sizeof(uint64_t));
+    memset(culler->moving_objects + culler->capacity / 64, 0,
+           (capacity - culler->capacity) / 64 * sizeof(uint64_t));
+    culler->capacity = capacity;
+}
+
+/**
+ * IsDirty
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether an object changed since the last dispatch.
+ *
+ * @param culler The culler.
+ * @param object The index of the object.
+ * @return bool -- True if it did.
+ */
+static bool IsDirty_(const leto_gpu_culler_t *culler, size_t object)
+{
+    return (culler->dirty_objects[object / 64] >> (object % 64)) & 1;
+}
+
+/**
+ * SettleObjects
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Once a new frame starts, give back the motion slots of the
+ * objects that moved last frame; those that move again this frame take
+ * theirs back.
+ *
+ * @param culler The culler.
+ * @return void -- Nothing.
+ */
+static void SettleObjects_(leto_gpu_culler_t *culler)
+{
+    if (culler->motion_frame == LetoGetFrame()) return;
+    culler->motion_frame = LetoGetFrame();
+
+    for (size_t word = 0; word < culler->capacity / 64; word++)
+    {
+        uint64_t moving = culler->moving_objects[word];
+        if (moving == 0) continue;
+        for (size_t bit = 0; bit < 64; bit++)
+            if ((moving >> bit) & 1)
+                culler->instances[word * 64 + bit].motion = 0;
+        culler->dirty_objects[word] |= moving;
+        culler->moving_objects[word] = 0;
+        culler->dirty = true;
+    }
+}
+
+/**
+ * PlaceObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Work out an object's instance matrix and world-space bounds.
+ *
+ * @param culler The culler.
+ * @param object The index of the object.
+ * @param model The object-to-world matrix, without the mesh's
+ * dequantization.
+ * @return void -- Nothing.
+ */
+static void PlaceObject_(leto_gpu_culler_t *culler, uint32_t object,
+                         mat4 model)
+{
+    leto_gpu_bounds_t *bounds = &culler->bounds[object];
+    const leto_mesh_t *mesh = culler->sources[bounds->mesh];
+
+    LetoSetInstanceTransform(&culler->instances[object], mesh, model);
+
+    vec3 box[2], center, extent;
+    glm_vec3_copy((float *)mesh->header.minimum, box[0]);
+    glm_vec3_copy((float *)mesh->header.maximum, box[1]);
+    glm_aabb_transform(box, model, box);
+    glm_aabb_center(box, center);
+    glm_vec3_sub(box[1], center, extent);
+    glm_vec3_copy(center, bounds->center);
+    glm_vec3_copy(extent, bounds->extent);
+
+    // Errors scale with the model; assume the worst if the scale isn't
+    // uniform.
+    bounds->scale = 0.0f;
+    for (size_t i = 0; i < 3; i++)
+        bounds->scale = fmaxf(bounds->scale, glm_vec3_norm(model[i]));
+
+    culler->dirty_objects[object / 64] |= 1ull << (object % 64);
+    culler->dirty = true;
+}
+
+/**
+ * ResizeBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give one of the culler's buffers new, empty storage.
+ *
+ * @param culler The culler.
+ * @param buffer The index of the buffer.
+ * @param size The new size of the buffer, in bytes.
+ * @return void -- Nothing.
+ */
+static void ResizeBuffer_(leto_gpu_culler_t *culler, size_t buffer,
+                          size_t size)
+{
+    glNamedBufferData(culler->buffers[buffer], (GLsizeiptr)size, NULL,
+                      GL_DYNAMIC_DRAW);
+}
+
+/**
+ * Copy
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Write a run of elements into the ring, and have the GPU copy
+ * them into their place in one of the culler's buffers. The copy is
+ * ordered after every dispatch and draw already submitted, so nothing
+ * reading the old contents has to be waited on.
+ *
+ * @param culler The culler.
+ * @param buffer The index of the buffer.
+ * @param array The CPU-side array the elements are in.
+ * @param stride The size of an element.
+ * @param first The index of the first element.
+ * @param last The index one past the last element.
+ * @return void -- Nothing.
+ */
+static void Copy_(leto_gpu_culler_t *culler, size_t buffer,
+                  const void *array, size_t stride, size_t first,
+                  size_t last)
+{
+    const size_t size = (last - first) * stride;
+    leto_ring_allocation_t staged;
+    if (!LetoAllocateRing(&culler->ring, size, &staged)) return;
+
+    memcpy(staged.data, (const unsigned char *)array + first * stride,
+           size);
+    glCopyNamedBufferSubData(staged.buffer, culler->buffers[buffer],
+                             (GLintptr)staged.offset,
+                             (GLintptr)(first * stride),
+                             (GLsizeiptr)size);
+}
+
+/**
+ * Upload
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Copy whatever objects and meshes changed up to the GPU, growing
+ * its buffers first if they've outgrown them.
+ *
+ * @param culler The culler.
+ * @return void -- Nothing.
+ */
+static void Upload_(leto_gpu_culler_t *culler)
+{
+    if (culler->buffer_capacity < culler->capacity)
+    {
+        const size_t capacity = culler->capacity;
+        ResizeBuffer_(culler, INSTANCE_BUFFER,
+                      capacity * sizeof(leto_instance_t));
+        ResizeBuffer_(culler, DRAW_BUFFER,
+                      capacity * sizeof(leto_draw_data_t));
+        ResizeBuffer_(culler, BOUNDS_BUFFER,
+                      capacity * sizeof(leto_gpu_bounds_t));
+        ResizeBuffer_(culler, COMMAND_BUFFER,
+                      capacity * sizeof(leto_draw_command_t));
+        ResizeBuffer_(culler, VISIBILITY_BUFFER,
+                      capacity * sizeof(uint32_t));
+        ResizeBuffer_(culler, MOTION_BUFFER,
+                      capacity * sizeof(leto_motion_t));
+        culler->buffer_capacity = capacity;
+        culler->visibility_count = 0;
+        // New storage starts out empty, so everything goes up again.
+        memset(culler->dirty_objects, 0xFF,
+               capacity / 64 * sizeof(uint64_t));
+    }
+    if (culler->buffer_mesh_capacity < culler->mesh_capacity)
+    {
+        ResizeBuffer_(culler, MESH_BUFFER,
+                      culler->mesh_capacity * sizeof(leto_gpu_mesh_t));
+        culler->buffer_mesh_capacity = culler->mesh_capacity;
+        culler->mesh_upload_count = 0;
+    }
+
+    if (culler->frame != LetoGetFrame())
+        LetoAdvanceRingBuffer(&culler->ring);
+    culler->frame = LetoGetFrame();
+
+    if (culler->mesh_upload_count < culler->mesh_count)
+        Copy_(culler, MESH_BUFFER, culler->meshes, sizeof(leto_gpu_mesh_t),
+              culler->mesh_upload_count, culler->mesh_count);
+    culler->mesh_upload_count = culler->mesh_count;
+
+    // Write each run of changed objects as a single range.
+    for (size_t object = 0; object < culler->count;)
+    {
+        if (culler->dirty_objects[object / 64] == 0)
+        {
+            object += 64 - object % 64;
+            continue;
+        }
+        if (!IsDirty_(culler, object))
+        {
+            object++;
+            continue;
+        }
+
+        const size_t first = object;
+        while (object < culler->count && IsDirty_(culler, object))
+            object++;
+        Copy_(culler, INSTANCE_BUFFER, culler->instances,
+              sizeof(leto_instance_t), first, object);
+        Copy_(culler, BOUNDS_BUFFER, culler->bounds,
+              sizeof(leto_gpu_bounds_t), first, object);
+        Copy_(culler, MOTION_BUFFER, culler->motions,
+              sizeof(leto_motion_t), first, object);
+    }
+    memset(culler->dirty_objects, 0,
+           culler->capacity / 64 * sizeof(uint64_t));
+
+    // New objects are drawn by the first phase until the second has
+    // had a look at them.
+    if (culler->visibility_count < culler->count)
+    {
+        const uint32_t visible = 1;
+        glClearNamedBufferSubData(
+            culler->buffers[VISIBILITY_BUFFER], GL_R32UI,
+            (GLintptr)(culler->visibility_count * sizeof(uint32_t)),
+            (GLsizeiptr)((culler->count - culler->visibility_count) *
+                         sizeof(uint32_t)),
+            GL_RED_INTEGER, GL_UNSIGNED_INT, &visible);
+        culler->visibility_count = culler->count;
+    }
+    culler->dirty = false;
+}
+
+bool LetoCreateGpuCuller(leto_gpu_culler_t *culler, size_t capacity)
+{
+    if (culler == NULL) return false;
+    memset(culler, 0, sizeof(leto_gpu_culler_t));
+    culler->format = LETO_GEOMETRY_NONE;
+
+    culler->program = LetoLoadComputeShader("cull");
+    if (culler->program == 0) return false;
+
+    const char *names[7] = {"object_count", "frustum_planes",
+                            "camera_position", "lod_scale", "occlusion",
+                            "occlusion_view_projection", "phase"};
+    for (size_t i = 0; i < 7; i++)
+        culler->uniforms[i] =
+            glGetUniformLocation(culler->program, names[i]);
+
+    Reserve_(culler, capacity);
+    if (!LetoCreateRingBuffer(&culler->ring,
+                              culler->capacity *
+                                  (sizeof(leto_instance_t) +
+                                   sizeof(leto_gpu_bounds_t) +
+                                   sizeof(leto_motion_t))))
+    {
+        LetoDestroyGpuCuller(culler);
+        return false;
+    }
+    glCreateBuffers(8, culler->buffers);
+    ResizeBuffer_(culler, COUNT_BUFFER, sizeof(uint32_t));
+    return true;
+}
+
+void LetoDestroyGpuCuller(leto_gpu_culler_t *culler)
+{
+    if (culler == NULL) return;
+
+    for (size_t i = 0; i < 8; i++)
+        LetoReleaseObject(buffer_object, culler->buffers[i]);
+    LetoDestroyRingBuffer(&culler->ring);
+    if (culler->program != 0) LetoUnloadShader(culler->program);
+
+    free(culler->sources);
+    free(culler->meshes);
+    free(culler->instances);
+    free(culler->bounds);
+    free(culler->motions);
+    free(culler->dirty_objects);
+    free(culler->moving_objects);
+    memset(culler, 0, sizeof(leto_gpu_culler_t));
+}
+
+uint32_t LetoAddGpuMesh(leto_gpu_culler_t *culler, const leto_mesh_t *mesh,
+                        size_t submesh)
+{
+    if (culler == NULL || mesh == NULL) return LETO_GEOMETRY_NONE;
+    if (submesh >= mesh->header.submesh_count) return LETO_GEOMETRY_NONE;
+    // One draw covers every object, so they have to share a vertex array.
+    if (culler->format != LETO_GEOMETRY_NONE &&
+        culler->format != mesh->geometry.format)
+        return LETO_GEOMETRY_NONE;
+    culler->format = mesh->geometry.format;
+
+    if (culler->mesh_count == culler->mesh_capacity)
+    {
+        size_t capacity =
+            culler->mesh_capacity == 0 ? 16 : culler->mesh_capacity * 2;
+        Resize_((void **)&culler->sources, capacity,
+                sizeof(const leto_mesh_t *));
+        Resize_((void **)&culler->meshes, capacity,
+                sizeof(leto_gpu_mesh_t));
+        culler->mesh_capacity = capacity;
+    }
+
+    const size_t index = culler->mesh_count++;
+    culler->sources[index] = mesh;
+    leto_gpu_mesh_t *record = &culler->meshes[index];
+    memset(record, 0, sizeof(leto_gpu_mesh_t));
+    record->lod_count = mesh->header.lod_count;
+    record->base_vertex = (int32_t)mesh->geometry.first_vertex;
+
+    for (size_t i = 0; i < mesh->header.lod_count; i++)
+    {
+        const leto_mesh_range_t *range =
+            &mesh->submeshes[submesh].lods[i];
+        record->lods[i][0] =
+            mesh->geometry.first_index + range->first_index;
+        record->lods[i][1] = range->index_count;
+        memcpy(&record->lods[i][2], &mesh->header.lod_errors[i],
+               sizeof(float));
+    }
+
+    culler->dirty = true;
+    return (uint32_t)index;
+}
+
+uint32_t LetoAddGpuObject(leto_gpu_culler_t *culler, uint32_t mesh,
+                          const leto_material_t *material, mat4 model)
+{
+    if (culler == NULL || material == NULL) return LETO_GEOMETRY_NONE;
+    if (mesh >= culler->mesh_count) return LETO_GEOMETRY_NONE;
+
+    Reserve_(culler, culler->count + 1);
+    const uint32_t object = (uint32_t)culler->count++;
+    memset(&culler->instances[object], 0, sizeof(leto_instance_t));
+    memset(&culler->motions[object], 0, sizeof(leto_motion_t));
+    culler->instances[object].material = material->slot;
+    culler->bounds[object].mesh = mesh;
+    PlaceObject_(culler, object, model);
+    return object;
+}
+
+void LetoSetGpuObject(leto_gpu_culler_t *culler, uint32_t object,
+                      mat4 model)
+{
+    if (culler == NULL || object >= culler->count) return;
+    SettleObjects_(culler);
+
+    // Only the first move of a frame knows where the object was last
+    // frame; the slot is one past the object, as in the render queue.
+    const size_t word = object / 64;
+    const uint64_t bit = 1ull << (object % 64);
+    if (!(culler->moving_objects[word] & bit))
+    {
+        leto_instance_t *instance = &culler->instances[object];
+        memcpy(culler->motions[object].model, instance->model,
+               sizeof(instance->model));
+        instance->motion = object + 1;
+        culler->moving_objects[word] |= bit;
+    }
+    PlaceObject_(culler, object, model);
+}
+
+void LetoSetGpuOcclusion(leto_gpu_culler_t *culler, unsigned int pyramid,
+                         mat4 view_projection)
+{
+    if (culler == NULL) return;
+    culler->depth_pyramid = pyramid;
+    if (view_projection != NULL)
+        glm_mat4_copy(view_projection, culler->pyramid_view_projection);
+}
+
+void LetoDispatchGpuCulling(leto_gpu_culler_t *culler,
+                            leto_gpu_cull_phase_t phase,
+                            const leto_camera_t *camera,
+                            mat4 view_projection, float viewport_height,
+                            float pixel_error)
+{
+    if (culler == NULL || camera == NULL || culler->count == 0) return;
+    SettleObjects_(culler);
+    if (culler->dirty) Upload_(culler);
+
+    // Without the count, the draw goes through every command, so those
+    // past the survivors have to draw nothing.
+    const uint32_t zero = 0;
+    glClearNamedBufferData(culler->buffers[COUNT_BUFFER], GL_R32UI,
+                           GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    if (glMultiDrawElementsIndirectCount == NULL)
+        glClearNamedBufferSubData(
+            culler->buffers[COMMAND_BUFFER], GL_R32UI, 0,
+            (GLsizeiptr)(culler->count * sizeof(leto_draw_command_t)),
+            GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+    leto_frustum_t frustum;
+    LetoExtractFrustum(&frustum, view_projection);
+    const float projection =
+        viewport_height / (2.0f * tanf(glm_rad(camera->fov) * 0.5f));
+
+    const unsigned int program = culler->program;
+    const int *uniforms = culler->uniforms;
+    glProgramUniform1ui(program, uniforms[OBJECT_COUNT_UNIFORM],
+                        (unsigned int)culler->count);
+    glProgramUniform4fv(program, uniforms[PLANES_UNIFORM], 6,
+                        &frustum.planes[0][0]);
+    glProgramUniform3fv(program, uniforms[CAMERA_UNIFORM], 1,
+                        camera->position);
+    glProgramUniform1f(program, uniforms[LOD_SCALE_UNIFORM],
+                       projection / fmaxf(pixel_error, 1e-3f));
+    glProgramUniform1ui(program, uniforms[PHASE_UNIFORM],
+                        (unsigned int)phase);
+    glProgramUniform1i(program, uniforms[OCCLUSION_UNIFORM],
+                       culler->depth_pyramid != 0);
+    if (culler->depth_pyramid != 0)
+    {
+        glProgramUniformMatrix4fv(
+            program, uniforms[OCCLUSION_MATRIX_UNIFORM], 1, GL_FALSE,
+            &culler->pyramid_view_projection[0][0]);
+        LetoBindTextureUnit(0, culler->depth_pyramid);
+    }
+
+    const unsigned int bindings[7] = {
+        LETO_INSTANCE_BINDING,     LETO_DRAW_BINDING,
+        LETO_CULL_BOUNDS_BINDING,  LETO_CULL_MESH_BINDING,
+        LETO_CULL_COMMAND_BINDING, LETO_CULL_COUNT_BINDING,
+        LETO_CULL_VISIBILITY_BINDING};
+    for (size_t i = 0; i < 7; i++)
+        LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindings[i],
+                            culler->buffers[i], 0, 0);
+
+    LetoUseProgram(program);
+    glDispatchCompute(
+        (unsigned int)((culler->count + GROUP_SIZE - 1) / GROUP_SIZE), 1,
+        1);
+    // The draw reads the commands and count as indirect arguments, and
+    // the draw records from its vertex shader.
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT |
+                    GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void LetoDrawGpuCulled(leto_gpu_culler_t *culler,
+                       const leto_material_t *material,
+                       leto_program_function_t function, void *argument)
+{
+    if (culler == NULL || material == NULL || culler->count == 0) return;
+
+    unsigned int program = LetoBindMaterial(material);
+    if (function != NULL) function(program, argument);
+
+    LetoBindGeometry(culler->format);
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_INSTANCE_BINDING,
+                        culler->buffers[INSTANCE_BUFFER], 0, 0);
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_DRAW_BINDING,
+                        culler->buffers[DRAW_BUFFER], 0, 0);
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_MOTION_BINDING,
+                        culler->buffers[MOTION_BUFFER], 0, 0);
+    LetoBindBuffer(GL_DRAW_INDIRECT_BUFFER,
+                   culler->buffers[COMMAND_BUFFER]);
+
+    if (glMultiDrawElementsIndirectCount != NULL)
+    {
+        LetoBindBuffer(GL_PARAMETER_BUFFER, culler->buffers[COUNT_BUFFER]);
+        glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                         NULL, 0, (int)culler->count, 0);
+    }
+    else
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, NULL,
+                                    (int)culler->count, 0);
+}
@@ -0,0 +1,356 @@
+/**
+ * @file GpuCulling.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's GPU-driven culling. Objects live on the GPU, and
+ * every frame a compute pass culls them against the frustum (and, if
+ * given, a depth pyramid), picks their level of detail, and writes a
+ * compacted list of indirect draws that's drawn with a single
+ * glMultiDrawElementsIndirectCount. The CPU never sees which objects
+ * survived. Culling can also be split into two phases around building
+ * the pyramid, so occlusion never lags a frame behind.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__GPU_CULLING_H
+#define LETO__GPU_CULLING_H
+
+// The engine's frustum type.
+#include <Rendering/Culling.h>
+// The engine's render queue, and with it meshes and materials.
+#include <Rendering/Queue.h>
+
+/**
+ * @brief The shader storage binding points the culling pass reads object
+ * bounds and mesh records from, writes commands and their count to, and
+ * keeps each object's visibility in. Instances and draw records use @ref
+ * LETO_INSTANCE_BINDING and @ref LETO_DRAW_BINDING, as they do when
+ * drawing.
+ */
+#define LETO_CULL_VISIBILITY_BINDING 0
+#define LETO_CULL_BOUNDS_BINDING 4
+#define LETO_CULL_MESH_BINDING 5
+#define LETO_CULL_COMMAND_BINDING 6
+#define LETO_CULL_COUNT_BINDING 7
+
+/**
+ * @brief The ways a dispatch can cull. A two-phase frame dispatches and
+ * draws the first phase, builds a depth pyramid from what it drew, gives
+ * the culler that pyramid, then dispatches and draws the second phase.
+ */
+typedef enum leto_gpu_cull_phase
+{
+    /**
+     * @brief Cull every object once, against the given pyramid if any.
+     */
+    cull_phase_single,
+    /**
+     * @brief Draw only the objects visible last frame, culled against
+     * the frustum but not the pyramid.
+     */
+    cull_phase_first,
+    /**
+     * @brief Cull every object against the frustum and this frame's
+     * pyramid, remember which are visible, and draw only those the first
+     * phase didn't.
+     */
+    cull_phase_second
+} leto_gpu_cull_phase_t;
+
+/**
+ * @brief The bounds of a single object as the culling pass sees them.
+ * This is laid out to match std430, and is exactly 32 bytes long.
+ */
+typedef struct leto_gpu_bounds
+{
+    /**
+     * @brief The center of the object's world-space box.
+     */
+    float center[3];
+    /**
+     * @brief The index of the object's mesh record.
+     */
+    uint32_t mesh;
+    /**
+     * @brief The half-size of the object's world-space box.
+     */
+    float extent[3];
+    /**
+     * @brief The largest scale of the object's model matrix, which its
+     * mesh's errors are multiplied by.
+     */
+    float scale;
+} leto_gpu_bounds_t;
+
+/**
+ * @brief A submesh as the culling pass sees it. This is laid out to match
+ * std430, and is exactly 80 bytes long.
+ */
+typedef struct leto_gpu_mesh
+{
+    /**
+     * @brief The amount of levels of detail of the submesh.
+     */
+    uint32_t lod_count;
+    /**
+     * @brief The first vertex of the mesh within its arena.
+     */
+    int32_t base_vertex;
+    /**
+     * @brief Padding to a 16-byte multiple.
+     */
+    uint32_t _[2];
+    /**
+     * @brief The first index within the arena, the index count, the
+     * error as the bits of a float, and padding, for every level.
+     */
+    uint32_t lods[LETO_MESH_MAX_LODS][4];
+} leto_gpu_mesh_t;
+
+/**
+ * @brief A set of objects culled and drawn together on the GPU. They all
+ * share one vertex format, and are drawn with one material's shader and
+ * textures; each keeps its own material parameters. This struct should
+ * only be modified through the functions below.
+ */
+typedef struct leto_gpu_culler
+{
+    /**
+     * @brief The OpenGL ID of the culling program.
+     */
+    unsigned int program;
+    /**
+     * @brief The meshes every record was made from, parallel to @ref
+     * meshes.
+     */
+    const leto_mesh_t **sources;
+    /**
+     * @brief The mesh records.
+     */
+    leto_gpu_mesh_t *meshes;
+    /**
+     * @brief The amount of mesh records.
+     */
+    size_t mesh_count;
+    /**
+     * @brief The amount of mesh records there is room for.
+     */
+    size_t mesh_capacity;
+    /**
+     * @brief The instance data of every object.
+     */
+    leto_instance_t *instances;
+    /**
+     * @brief The bounds of every object.
+     */
+    leto_gpu_bounds_t *bounds;
+    /**
+     * @brief Last frame's matrix of every object, read through an
+     * instance's motion slot while it's moving.
+     */
+    leto_motion_t *motions;
+    /**
+     * @brief The amount of objects.
+     */
+    size_t count;
+    /**
+     * @brief The amount of objects there is room for.
+     */
+    size_t capacity;
+    /**
+     * @brief The vertex format every mesh shares, or @ref
+     * LETO_GEOMETRY_NONE before the first is added.
+     */
+    uint32_t format;
+    /**
+     * @brief Whether the objects or meshes changed since the last
+     * dispatch.
+     */
+    bool dirty;
+    /**
+     * @brief One bit per object, set for every object changed since the
+     * last dispatch.
+     */
+    uint64_t *dirty_objects;
+    /**
+     * @brief One bit per object, set for every object whose motion slot
+     * is in use.
+     */
+    uint64_t *moving_objects;
+    /**
+     * @brief The frame the motion slots in use were set in.
+     */
+    uint64_t motion_frame;
+    /**
+     * @brief The amount of mesh records already on the GPU. Records never
+     * change once added, so only those past this are uploaded.
+     */
+    size_t mesh_upload_count;
+    /**
+     * @brief The ring changes are written into before being copied to the
+     * GPU buffers.
+     */
+    leto_ring_buffer_t ring;
+    /**
+     * @brief The frame the ring was last moved on in.
+     */
+    uint64_t frame;
+    /**
+     * @brief The OpenGL IDs of the instance, draw record, bounds, mesh,
+     * command, count, visibility, and motion buffers, in that order.
+     */
+    unsigned int buffers[8];
+    /**
+     * @brief The amount of objects the GPU buffers have room for.
+     */
+    size_t buffer_capacity;
+    /**
+     * @brief The amount of mesh records the GPU buffer has room for.
+     */
+    size_t buffer_mesh_capacity;
+    /**
+     * @brief The amount of objects whose visibility has been set up;
+     * objects past this start out visible.
+     */
+    size_t visibility_count;
+    /**
+     * @brief The depth pyramid to test against, or 0 for none.
+     */
+    unsigned int depth_pyramid;
+    /**
+     * @brief The view-projection matrix the depth pyramid was drawn with.
+     */
+    mat4 pyramid_view_projection;
+    /**
+     * @brief The locations of the culling program's uniforms.
+     */
+    int uniforms[7];
+} leto_gpu_culler_t;
+
+/**
+ * CreateGpuCuller
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty culler, loading the "cull" compute program. This
+ * must be called after the OpenGL context is current.
+ *
+ * @param culler The culler to initialize.
+ * @param capacity The amount of objects to make room for up front. The
+ * culler grows past this if it has to.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateGpuCuller(leto_gpu_culler_t *culler, size_t capacity);
+
+/**
+ * DestroyGpuCuller
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a culler owns.
+ *
+ * @param culler The culler to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyGpuCuller(leto_gpu_culler_t *culler);
+
+/**
+ * AddGpuMesh
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give the culler a submesh objects can be drawn with.
+ *
+ * @param culler The culler.
+ * @param mesh The mesh. This must outlive the culler.
+ * @param submesh The submesh of the mesh.
+ * @return uint32_t -- The index of the mesh record, or @ref
+ * LETO_GEOMETRY_NONE if the mesh's vertex format differs from the rest.
+ */
+uint32_t LetoAddGpuMesh(leto_gpu_culler_t *culler, const leto_mesh_t *mesh,
+                        size_t submesh);
+
+/**
+ * AddGpuObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add an object to the culler.
+ *
+ * @param culler The culler.
+ * @param mesh The index of the object's mesh record.
+ * @param material The material whose parameters the object uses.
+ * @param model The object-to-world matrix, without the mesh's
+ * dequantization.
+ * @return uint32_t -- The index of the object, or @ref
+ * LETO_GEOMETRY_NONE on failure.
+ */
+uint32_t LetoAddGpuObject(leto_gpu_culler_t *culler, uint32_t mesh,
+                          const leto_material_t *material, mat4 model);
+
+/**
+ * SetGpuObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move an object. Where it was last frame is kept, so its
+ * motion can be found.
+ *
+ * @param culler The culler.
+ * @param object The index of the object.
+ * @param model The new object-to-world matrix, without the mesh's
+ * dequantization.
+ * @return void -- Nothing.
+ */
+void LetoSetGpuObject(leto_gpu_culler_t *culler, uint32_t object,
+                      mat4 model);
+
+/**
+ * SetGpuOcclusion
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give the culler a depth pyramid to test objects against. The
+ * pyramid is a single-channel float texture with a full mip chain, every
+ * texel holding the farthest depth beneath it, as built by @ref
+ * LetoBuildDepthPyramid.
+ *
+ * @param culler The culler.
+ * @param pyramid The OpenGL ID of the pyramid, or 0 to stop testing.
+ * @param view_projection The view-projection matrix the depth the pyramid
+ * was built from was drawn with; last frame's for a single phase, or
+ * this frame's for the second.
+ * @return void -- Nothing.
+ */
+void LetoSetGpuOcclusion(leto_gpu_culler_t *culler, unsigned int pyramid,
+                         mat4 view_projection);
+
+/**
+ * DispatchGpuCulling
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Upload whatever changed, then cull every object and write the
+ * draws of the survivors.
+ *
+ * @param culler The culler.
+ * @param phase Which phase of culling to run.
+ * @param camera The camera the objects are seen through.
+ * @param view_projection The camera's view-projection matrix.
+ * @param viewport_height The height of the viewport, in pixels.
+ * @param pixel_error The largest level of detail error allowed on screen,
+ * in pixels.
+ * @return void -- Nothing.
+ */
+void LetoDispatchGpuCulling(leto_gpu_culler_t *culler,
+                            leto_gpu_cull_phase_t phase,
+                            const leto_camera_t *camera,
+                            mat4 view_projection, float viewport_height,
+                            float pixel_error);
+
+/**
+ * DrawGpuCulled
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Draw whatever the last dispatch let through.
+ *
+ * @param culler The culler.
+ * @param material The material whose shader and textures to draw with.
+ * @param function Called with the program after it's bound. This may be
+ * NULL.
+ * @param argument The argument passed to @ref function.
+ * @return void -- Nothing.
+ */
+void LetoDrawGpuCulled(leto_gpu_culler_t *culler,
+                       const leto_material_t *material,
+                       leto_program_function_t function, void *argument);
+
+#endif // LETO__GPU_CULLING_H
@@ -0,0 +1,639 @@
+/**
+ * @file Lights.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's clustered light lists. Each depth slice first
+ * gathers the lights reaching its depth range, then tests them against
+ * every cluster of the slice a lane per light; each light's sphere is
+ * tested against the cluster's view-space box, and spot lights' cones
+ * against the box's bounding sphere. Slices are split over threads.
+ * @implements Lights.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Lights.h"            // Public interface parent
+#include <Input/Shaders.h>     // Uniform locations
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/State.h>   // OpenGL state cache
+#include <Utilities/Macros.h>  // Utility macros
+#include <Utilities/Simd.h>    // Vector operations
+#include <Utilities/Threads.h> // Threading
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <math.h>   // Standard math functions
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The granularity of the scratch space's capacity, so whole
+ * vectors can always be read.
+ */
+#define LIGHT_GRANULARITY 8
+
+/**
+ * @brief The amount of float and index arrays making up a light set.
+ */
+#define LIGHT_ARRAYS 10
+
+/**
+ * @brief The amount of light sets in the scratch space; every light in
+ * view space, then the candidates of each binning thread.
+ */
+#define LIGHT_SETS (LETO_MAX_WORKERS + 1)
+
+/**
+ * @brief The amount of light indices each cluster has room for.
+ */
+#define CLUSTER_STRIDE (LETO_MAX_CLUSTER_LIGHTS + 1)
+
+/**
+ * @brief Lights in view space, stored as one array per component so they
+ * can be loaded straight into vector registers.
+ */
+typedef struct light_set
+{
+    /**
+     * @brief The view-space position of every light, one array per axis.
+     */
+    float *position[3];
+    /**
+     * @brief The range of every light.
+     */
+    float *range;
+    /**
+     * @brief The view-space direction of every light, one array per axis.
+     * Point lights have none, so their cone never culls anything.
+     */
+    float *direction[3];
+    /**
+     * @brief The cosine and sine of every light's outer angle; minus one
+     * and zero for point lights.
+     */
+    float *cosine, *sine;
+    /**
+     * @brief The index of every light in the set it was added to.
+     */
+    uint32_t *index;
+    /**
+     * @brief The amount of lights in the set.
+     */
+    size_t count;
+} light_set_t;
+
+/**
+ * @brief The shape of a view's clusters. Tile edges are kept as the
+ * view-space offset per unit of depth, so a cluster's box is just each
+ * edge times each of its slice's depths.
+ */
+typedef struct light_grid
+{
+    float x_edges[LETO_CLUSTERS_X + 1];
+    float y_edges[LETO_CLUSTERS_Y + 1];
+    float depths[LETO_CLUSTERS_Z + 1];
+} light_grid_t;
+
+/**
+ * @brief A range of depth slices, binned on the worker pool.
+ */
+typedef struct light_job
+{
+    /**
+     * @brief The set being binned.
+     */
+    leto_lights_t *lights;
+    /**
+     * @brief Every light of the set, in view space.
+     */
+    const light_set_t *all;
+    /**
+     * @brief The lights reaching the slice being binned.
+     */
+    light_set_t candidates;
+    /**
+     * @brief The clusters being binned into.
+     */
+    const light_grid_t *grid;
+    /**
+     * @brief The first depth slice of the range.
+     */
+    size_t first;
+    /**
+     * @brief One past the last depth slice of the range.
+     */
+    size_t last;
+} light_job_t;
+
+/**
+ * GetSet
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the arrays of one of the light sets in the scratch space.
+ *
+ * @param lights The lights owning the scratch space.
+ * @param which The set to find; zero for every light, otherwise a
+ * thread's candidates.
+ * @param set The set to fill. Its count is zeroed.
+ * @return void -- Nothing.
+ */
+static void GetSet_(const leto_lights_t *lights, size_t which,
+                    light_set_t *set)
+{
+    uintptr_t address = (uintptr_t)lights->_;
+    address = (address + LETO_SIMD_ALIGNMENT - 1) &
+              ~(uintptr_t)(LETO_SIMD_ALIGNMENT - 1);
+    float *arrays = (float *)address +
+                    which * LIGHT_ARRAYS * lights->scratch_capacity;
+
+    const size_t capacity = lights->scratch_capacity;
+    for (size_t a = 0; a < 3; a++)
+    {
+        set->position[a] = arrays + capacity * a;
+        set->direction[a] = arrays + capacity * (a + 4);
+    }
+    set->range = arrays + capacity * 3;
+    set->cosine = arrays + capacity * 7;
+    set->sine = arrays + capacity * 8;
+    set->index = (uint32_t *)(arrays + capacity * 9);
+    set->count = 0;
+}
+
+/**
+ * ReserveScratch
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure the scratch space has room for every light of the set.
+ * Its contents aren't kept.
+ *
+ * @param lights The lights owning the scratch space.
+ * @return bool -- True for success, false for failure.
+ */
+static bool ReserveScratch_(leto_lights_t *lights)
+{
+    if (lights->count <= lights->scratch_capacity) return true;
+
+    size_t capacity = (lights->count + LIGHT_GRANULARITY - 1) /
+                      LIGHT_GRANULARITY * LIGHT_GRANULARITY;
+    const size_t size = capacity * LIGHT_ARRAYS * LIGHT_SETS * 4;
+    void *allocation;
+    LETO_ALLOC_OR_FAIL(allocation, size + LETO_SIMD_ALIGNMENT);
+    if (allocation == NULL) return false;
+
+    free(lights->_);
+    lights->_ = allocation;
+    lights->scratch_capacity = capacity;
+    // Lanes past the end of a set are read, though never reported; they
+    // should still be real numbers.
+    memset(allocation, 0, size + LETO_SIMD_ALIGNMENT);
+    return true;
+}
+
+/**
+ * TransformLights
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fill a light set with every light of the lights, in view space.
+ *
+ * @param lights The lights.
+ * @param view The view matrix.
+ * @param set The set to fill.
+ * @return void -- Nothing.
+ */
+static void TransformLights_(const leto_lights_t *lights, mat4 view,
+                             light_set_t *set)
+{
+    for (size_t i = 0; i < lights->count; i++)
+    {
+        const leto_light_t *light = &lights->lights[i];
+        vec3 position, direction = {0.0f, 0.0f, 0.0f};
+        glm_mat4_mulv3(view, (float *)light->position, 1.0f, position);
+
+        float cosine = -1.0f, sine = 0.0f;
+        if (light->type == light_spot)
+        {
+            glm_mat4_mulv3(view, (float *)light->direction, 0.0f,
+                           direction);
+            glm_vec3_normalize(direction);
+            float angle = glm_clamp(light->outer_angle, 0.0f, GLM_PIf);
+            cosine = cosf(angle);
+            sine = sinf(angle);
+        }
+
+        for (size_t a = 0; a < 3; a++)
+        {
+            set->position[a][i] = position[a];
+            set->direction[a][i] = direction[a];
+        }
+        set->range[i] = light->range;
+        set->cosine[i] = cosine;
+        set->sine[i] = sine;
+        set->index[i] = (uint32_t)i;
+    }
+    set->count = lights->count;
+}
+
+/**
+ * GatherCandidates
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Copy every light reaching a depth range into another set.
+ *
+ * @param all Every light, in view space.
+ * @param near The nearest depth of the range.
+ * @param far The farthest depth of the range.
+ * @param candidates The set to fill.
+ * @return void -- Nothing.
+ */
+static void GatherCandidates_(const light_set_t *all, float near,
+                              float far, light_set_t *candidates)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < all->count; i++)
+    {
+        // The view looks down negative z.
+        const float depth = -all->position[2][i];
+        const float range = all->range[i];
+        if (depth + range < near || depth - range > far) continue;
+
+        for (size_t a = 0; a < 3; a++)
+        {
+            candidates->position[a][count] = all->position[a][i];
+            candidates->direction[a][count] = all->direction[a][i];
+        }
+        candidates->range[count] = range;
+        candidates->cosine[count] = all->cosine[i];
+        candidates->sine[count] = all->sine[i];
+        candidates->index[count] = all->index[i];
+        count++;
+    }
+    candidates->count = count;
+}
+
+/**
+ * TestCluster
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief List every light of a set touching a cluster.
+ *
+ * @param set The lights to test.
+ * @param minimum The view-space corner of the cluster's box nearest
+ * negative infinity.
+ * @param maximum The opposite corner.
+ * @param list Filled with the indices of the lights touching the
+ * cluster. This must have room for @ref CLUSTER_STRIDE indices.
+ * @return uint32_t -- The amount of indices written, at most @ref
+ * LETO_MAX_CLUSTER_LIGHTS.
+ */
+static uint32_t TestCluster_(const light_set_t *set, vec3 minimum,
+                             vec3 maximum, uint32_t *list)
+{
+    const leto_simd_t zero = LetoSimdSet(0.0f);
+    leto_simd_t low[3], high[3], center[3];
+    float radius = 0.0f;
+    for (size_t a = 0; a < 3; a++)
+    {
+        const float half = (maximum[a] - minimum[a]) * 0.5f;
+        low[a] = LetoSimdSet(minimum[a]);
+        high[a] = LetoSimdSet(maximum[a]);
+        center[a] = LetoSimdSet(minimum[a] + half);
+        radius += half * half;
+    }
+    // Cones are tested against the box's bounding sphere.
+    const leto_simd_t sphere = LetoSimdSet(sqrtf(radius));
+    const leto_simd_t behind = LetoSimdSet(-sqrtf(radius));
+
+    uint32_t count = 0;
+    for (size_t i = 0; i < set->count; i += LETO_SIMD_WIDTH)
+    {
+        leto_simd_t outside = zero, length = zero, along = zero;
+        for (size_t a = 0; a < 3; a++)
+        {
+            const leto_simd_t position =
+                LetoSimdLoad(&set->position[a][i]);
+            // The distance from the light to the box along this axis.
+            leto_simd_t gap = LetoSimdMax(LetoSimdSub(low[a], position),
+                                          LetoSimdSub(position, high[a]));
+            gap = LetoSimdMax(gap, zero);
+            outside = LetoSimdAdd(outside, LetoSimdMul(gap, gap));
+
+            // Where the box's center is from the light.
+            const leto_simd_t offset = LetoSimdSub(center[a], position);
+            length = LetoSimdAdd(length, LetoSimdMul(offset, offset));
+            const leto_simd_t direction =
+                LetoSimdLoad(&set->direction[a][i]);
+            along = LetoSimdAdd(along, LetoSimdMul(offset, direction));
+        }
+        const leto_simd_t range = LetoSimdLoad(&set->range[i]);
+        leto_simd_mask_t touching =
+            LetoSimdAtMost(outside, LetoSimdMul(range, range));
+
+        // The distance from the sphere's center to the cone's surface;
+        // it's outside if that's more than its radius, or if it's wholly
+        // behind the light.
+        const leto_simd_t across = LetoSimdSqrt(LetoSimdMax(
+            LetoSimdSub(length, LetoSimdMul(along, along)), zero));
+        const leto_simd_t surface =
+            LetoSimdSub(LetoSimdMul(LetoSimdLoad(&set->cosine[i]), across),
+                        LetoSimdMul(along, LetoSimdLoad(&set->sine[i])));
+        touching = LetoSimdAnd(touching, LetoSimdAtMost(surface, sphere));
+        touching = LetoSimdAnd(touching, LetoSimdAtMost(behind, along));
+
+        // Writing every lane and only advancing past the touching ones
+        // keeps this free of unpredictable branches; once the list is
+        // full, the rest land in its spare slot.
+        const unsigned int bits = LetoSimdBits(touching);
+        for (size_t k = 0; k < LETO_SIMD_WIDTH && i + k < set->count; k++)
+        {
+            list[count < LETO_MAX_CLUSTER_LIGHTS
+                     ? count
+                     : LETO_MAX_CLUSTER_LIGHTS] = set->index[i + k];
+            count += (bits >> k) & 1;
+        }
+    }
+    return count < LETO_MAX_CLUSTER_LIGHTS ? count
+                                           : LETO_MAX_CLUSTER_LIGHTS;
+}
+
+/**
+ * BinSlices
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bin every light into the clusters of a range of depth slices.
+ *
+ * @param argument The @ref light_job_t to run.
+ * @return void -- Nothing.
+ */
+static void BinSlices_(void *argument)
+{
+    light_job_t *job = argument;
+    const light_grid_t *grid = job->grid;
+
+    for (size_t z = job->first; z < job->last; z++)
+    {
+        const float near = grid->depths[z], far = grid->depths[z + 1];
+        GatherCandidates_(job->all, near, far, &job->candidates);
+
+        for (size_t y = 0; y < LETO_CLUSTERS_Y; y++)
+        {
+            for (size_t x = 0; x < LETO_CLUSTERS_X; x++)
+            {
+                // Edges grow with depth, so the box's sides are the
+                // outermost of the slice's two depths.
+                const float left = grid->x_edges[x];
+                const float right = grid->x_edges[x + 1];
+                const float bottom = grid->y_edges[y];
+                const float top = grid->y_edges[y + 1];
+                vec3 minimum = {fminf(left * near, left * far),
+                                fminf(bottom * near, bottom * far), -far};
+                vec3 maximum = {fmaxf(right * near, right * far),
+                                fmaxf(top * near, top * far), -near};
+
+                const size_t cluster =
+                    (z * LETO_CLUSTERS_Y + y) * LETO_CLUSTERS_X + x;
+                job->lights->cluster_counts[cluster] = TestCluster_(
+                    &job->candidates, minimum, maximum,
+                    &job->lights->cluster_lights[cluster *
+                                                 CLUSTER_STRIDE]);
+            }
+        }
+    }
+}
+
+/**
+ * Upload
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Pack the lights and their cluster lists into the next region of
+ * the ring, and bind them.
+ *
+ * @param lights The lights, freshly binned.
+ * @param index_count The amount of indices across every cluster.
+ * @return void -- Nothing.
+ */
+static void Upload_(leto_lights_t *lights, size_t index_count)
+{
+    // Empty ranges can't be bound, so there's always room for one.
+    const size_t light_count = lights->count == 0 ? 1 : lights->count;
+    const size_t align = lights->ring.alignment;
+    const size_t grid = (light_count * sizeof(leto_light_data_t) +
+                         align - 1) /
+                        align * align;
+    const size_t indices =
+        grid + (LETO_CLUSTER_COUNT * 2 * sizeof(uint32_t) + align - 1) /
+                   align * align;
+    const size_t index_size =
+        (index_count == 0 ? 1 : index_count) * sizeof(uint32_t);
+
+    LetoAdvanceRingBuffer(&lights->ring);
+    leto_ring_allocation_t frame;
+    if (!LetoAllocateRing(&lights->ring, indices + index_size, &frame))
+        return;
+
+    unsigned char *data = frame.data;
+    leto_light_data_t *light_data = (leto_light_data_t *)data;
+    for (size_t i = 0; i < lights->count; i++)
+    {
+        const leto_light_t *light = &lights->lights[i];
+        leto_light_data_t *packed = &light_data[i];
+        *packed = (leto_light_data_t){.inner_cosine = -1.0f,
+                                      .type = (uint32_t)light->type,
+                                      .shadow = light->shadow};
+        glm_vec3_copy((float *)light->position, packed->position);
+        packed->position[3] = light->range;
+        glm_vec3_scale((float *)light->color, light->intensity,
+                       packed->color);
+        packed->color[3] = 1.0f;
+        packed->direction[3] = -1.0f;
+        if (light->type == light_spot)
+        {
+            glm_vec3_normalize_to((float *)light->direction,
+                                  packed->direction);
+            packed->direction[3] =
+                cosf(glm_clamp(light->outer_angle, 0.0f, GLM_PIf));
+            packed->inner_cosine =
+                cosf(glm_clamp(light->inner_angle, 0.0f, GLM_PIf));
+        }
+    }
+
+    uint32_t *cells = (uint32_t *)(data + grid);
+    uint32_t *list = (uint32_t *)(data + indices);
+    uint32_t offset = 0;
+    for (size_t c = 0; c < LETO_CLUSTER_COUNT; c++)
+    {
+        const uint32_t count = lights->cluster_counts[c];
+        cells[c * 2] = offset;
+        cells[c * 2 + 1] = count;
+        memcpy(list + offset, &lights->cluster_lights[c * CLUSTER_STRIDE],
+               count * sizeof(uint32_t));
+        offset += count;
+    }
+
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_LIGHT_BINDING,
+                        frame.buffer, frame.offset,
+                        (ptrdiff_t)(light_count *
+                                    sizeof(leto_light_data_t)));
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_CLUSTER_BINDING,
+                        frame.buffer, frame.offset + (ptrdiff_t)grid,
+                        LETO_CLUSTER_COUNT * 2 * sizeof(uint32_t));
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_LIGHT_INDEX_BINDING,
+                        frame.buffer, frame.offset + (ptrdiff_t)indices,
+                        (ptrdiff_t)index_size);
+}
+
+bool LetoCreateLights(leto_lights_t *lights, size_t capacity)
+{
+    if (lights == NULL) return false;
+    memset(lights, 0, sizeof(leto_lights_t));
+    if (capacity < 16) capacity = 16;
+
+    LETO_ALLOC_OR_FAIL(lights->lights, capacity * sizeof(leto_light_t));
+    LETO_ALLOC_OR_FAIL(lights->cluster_lights,
+                       LETO_CLUSTER_COUNT * CLUSTER_STRIDE *
+                           sizeof(uint32_t));
+    LETO_ALLOC_OR_FAIL(lights->cluster_counts,
+                       LETO_CLUSTER_COUNT * sizeof(uint32_t));
+    if (lights->lights == NULL || lights->cluster_lights == NULL ||
+        lights->cluster_counts == NULL)
+    {
+        LetoDestroyLights(lights);
+        return false;
+    }
+    lights->capacity = capacity;
+    memset(lights->cluster_counts, 0,
+           LETO_CLUSTER_COUNT * sizeof(uint32_t));
+
+    // Room for a frame of lights, the grid, and a handful of lights per
+    // cluster.
+    const size_t frame_size =
+        capacity * sizeof(leto_light_data_t) +
+        LETO_CLUSTER_COUNT * 10 * sizeof(uint32_t);
+    if (!LetoCreateRingBuffer(&lights->ring, frame_size))
+    {
+        LetoDestroyLights(lights);
+        return false;
+    }
+    return true;
+}
+
+void LetoDestroyLights(leto_lights_t *lights)
+{
+    if (lights == NULL) return;
+
+    LetoDestroyRingBuffer(&lights->ring);
+    free(lights->lights);
+    free(lights->_);
+    free(lights->cluster_lights);
+    free(lights->cluster_counts);
+    memset(lights, 0, sizeof(leto_lights_t));
+}
+
+size_t LetoAddLight(leto_lights_t *lights, const leto_light_t *light)
+{
+    if (lights->count == lights->capacity)
+    {
+        const size_t capacity = lights->capacity * 2;
+        void *grown =
+            realloc(lights->lights, capacity * sizeof(leto_light_t));
+        if (grown == NULL)
+        {
+            LetoReportError(true, failed_allocation, LETO_FILE_CONTEXT);
+            return lights->count;
+        }
+        lights->lights = grown;
+        lights->capacity = capacity;
+    }
+
+    lights->count++;
+    LetoSetLight(lights, lights->count - 1, light);
+    return lights->count - 1;
+}
+
+void LetoSetLight(leto_lights_t *lights, size_t index,
+                  const leto_light_t *light)
+{
+    // Past the count would write a slot binning never reads.
+    if (lights == NULL || light == NULL || index >= lights->count)
+        return;
+    lights->lights[index] = *light;
+    lights->lights[index].range = fabsf(light->range);
+}
+
+void LetoClearLights(leto_lights_t *lights)
+{
+    if (lights == NULL) return;
+    lights->count = 0;
+}
+
+size_t LetoBinLights(leto_lights_t *lights, mat4 view, mat4 projection)
+{
+    if (lights == NULL || lights->cluster_counts == NULL) return 0;
+    if (!ReserveScratch_(lights)) return 0;
+
+    // The planes of a perspective projection, as OpenGL lays it out.
+    const float near = projection[3][2] / (projection[2][2] - 1.0f);
+    const float far = projection[3][2] / (projection[2][2] + 1.0f);
+    if (!(near > 0.0f && far > near)) return 0;
+
+    // Slices are even steps of the log of depth, so each is about as deep
+    // as it is wide.
+    const float depth_range = logf(far / near);
+    lights->slice_scale = LETO_CLUSTERS_Z / depth_range;
+    lights->slice_bias = -LETO_CLUSTERS_Z * logf(near) / depth_range;
+
+    // At a depth of d, a normalized device x lands at
+    // d * (x + p[2][0]) / p[0][0] in view space; likewise for y.
+    light_grid_t grid;
+    for (size_t x = 0; x <= LETO_CLUSTERS_X; x++)
+        grid.x_edges[x] =
+            (2.0f * x / LETO_CLUSTERS_X - 1.0f + projection[2][0]) /
+            projection[0][0];
+    for (size_t y = 0; y <= LETO_CLUSTERS_Y; y++)
+        grid.y_edges[y] =
+            (2.0f * y / LETO_CLUSTERS_Y - 1.0f + projection[2][1]) /
+            projection[1][1];
+    for (size_t z = 0; z <= LETO_CLUSTERS_Z; z++)
+        grid.depths[z] =
+            near * powf(far / near, (float)z / LETO_CLUSTERS_Z);
+
+    light_set_t all;
+    GetSet_(lights, 0, &all);
+    TransformLights_(lights, view, &all);
+
+    size_t job_count =
+        lights->count * LETO_CLUSTER_COUNT / LETO_LIGHT_THREAD_BATCH;
+    if (job_count > LetoGetWorkerCount()) job_count = LetoGetWorkerCount();
+    if (job_count > LETO_CLUSTERS_Z) job_count = LETO_CLUSTERS_Z;
+    if (job_count < 1) job_count = 1;
+
+    // Every job writes only its own slices' clusters, so no two threads
+    // touch the same memory.
+    const size_t slice = (LETO_CLUSTERS_Z + job_count - 1) / job_count;
+    light_job_t jobs[LETO_MAX_WORKERS];
+    for (size_t j = 0; j < job_count; j++)
+    {
+        size_t first = j * slice;
+        size_t last = first + slice;
+        if (first > LETO_CLUSTERS_Z) first = LETO_CLUSTERS_Z;
+        if (last > LETO_CLUSTERS_Z) last = LETO_CLUSTERS_Z;
+        jobs[j] = (light_job_t){.lights = lights,
+                                .all = &all,
+                                .grid = &grid,
+                                .first = first,
+                                .last = last};
+        GetSet_(lights, j + 1, &jobs[j].candidates);
+    }
+    LetoRunJobs(BinSlices_, jobs, sizeof(light_job_t), job_count);
+
+    size_t index_count = 0;
+    for (size_t c = 0; c < LETO_CLUSTER_COUNT; c++)
+        index_count += lights->cluster_counts[c];
+    Upload_(lights, index_count);
+    return index_count;
+}
+
+void LetoSetLightUniforms(const leto_lights_t *lights,
+                          unsigned int shader)
+{
+    if (lights == NULL) return;
+
+    int location = LetoGetUniformLocation(shader, uniform_cluster_scale);
+    glProgramUniform1f(shader, location, lights->slice_scale);
+    location = LetoGetUniformLocation(shader, uniform_cluster_bias);
+    glProgramUniform1f(shader, location, lights->slice_bias);
+}
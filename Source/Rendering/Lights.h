@@ -0,0 +1,292 @@
+/**
+ * @file Lights.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's clustered light lists. The view frustum is cut
+ * into a grid of clusters, evenly in screen space and exponentially in
+ * depth, and every frame each light is binned into the clusters it
+ * touches. Fragments then only shade the lights of their own cluster, so
+ * their cost follows how many lights are nearby rather than how many
+ * there are.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__LIGHTS_H
+#define LETO__LIGHTS_H
+
+// The engine's ring buffers.
+#include <Rendering/Ring.h>
+// GLM 3D vectors.
+#include <CGLM/vec3.h>
+// GLM 4x4 matrices.
+#include <CGLM/mat4.h>
+// Fixed-width integer types.
+#include <stdint.h>
+
+/**
+ * @brief The shader storage binding points the light data, the cluster
+ * grid, and the packed light indices are bound to. Shaders declare the
+ * blocks with "layout(std430, binding = 8)" and so on.
+ */
+#define LETO_LIGHT_BINDING 8
+#define LETO_CLUSTER_BINDING 9
+#define LETO_LIGHT_INDEX_BINDING 10
+
+/**
+ * @brief The amount of clusters across, down, and deep the view is cut
+ * into. Shaders hardcode these as well.
+ */
+#define LETO_CLUSTERS_X 16
+#define LETO_CLUSTERS_Y 9
+#define LETO_CLUSTERS_Z 24
+#define LETO_CLUSTER_COUNT                                                \
+    (LETO_CLUSTERS_X * LETO_CLUSTERS_Y * LETO_CLUSTERS_Z)
+
+/**
+ * @brief The most lights a single cluster lists. Any more touching it are
+ * dropped, latest added first, which bounds what a fragment can cost.
+ */
+#define LETO_MAX_CLUSTER_LIGHTS 128
+
+/**
+ * @brief The least amount of light-cluster tests each binning thread is
+ * given. Smaller scenes are binned entirely on the calling thread.
+ */
+#define LETO_LIGHT_THREAD_BATCH 65536
+
+/**
+ * @brief The shapes of light there are.
+ */
+typedef enum leto_light_type
+{
+    /**
+     * @brief A light shining equally in every direction.
+     */
+    light_point,
+    /**
+     * @brief A light shining in a cone, like a street lamp or headlight.
+     */
+    light_spot
+} leto_light_type_t;
+
+/**
+ * @brief A light, as it's given to the engine.
+ */
+typedef struct leto_light
+{
+    /**
+     * @brief The shape of the light.
+     */
+    leto_light_type_t type;
+    /**
+     * @brief The position of the light, in world space.
+     */
+    vec3 position;
+    /**
+     * @brief The distance past which the light has no effect at all.
+     */
+    float range;
+    /**
+     * @brief The color of the light, RGB.
+     */
+    vec3 color;
+    /**
+     * @brief The brightness of the light.
+     */
+    float intensity;
+    /**
+     * @brief The direction a spot light shines in, in world space. This
+     * needn't be normalized.
+     */
+    vec3 direction;
+    /**
+     * @brief The angles, in radians, from a spot light's direction at
+     * which it starts to fade and at which it's gone. The outer angle
+     * should stay below half a turn's worth.
+     */
+    float inner_angle, outer_angle;
+    /**
+     * @brief The shadow of a spot light, one past its slot in a shadow
+     * atlas, or 0 if it casts none. Shadow atlases fill this in for the
+     * lights they hold.
+     */
+    uint32_t shadow;
+} leto_light_t;
+
+/**
+ * @brief The data of a single light as shaders see it. This is laid out
+ * to match std430, and is exactly 64 bytes long.
+ */
+typedef struct leto_light_data
+{
+    /**
+     * @brief The world-space position of the light, then its range.
+     */
+    vec4 position;
+    /**
+     * @brief The color of the light times its intensity, then one.
+     */
+    vec4 color;
+    /**
+     * @brief The unit direction of a spot light, then the cosine of its
+     * outer angle. Point lights have no direction.
+     */
+    vec4 direction;
+    /**
+     * @brief The cosine of a spot light's inner angle.
+     */
+    float inner_cosine;
+    /**
+     * @brief The @ref leto_light_type_t of the light.
+     */
+    uint32_t type;
+    /**
+     * @brief The light's shadow, as in @ref leto_light_t.
+     */
+    uint32_t shadow;
+    /**
+     * @brief Padding to a 16-byte multiple.
+     */
+    uint32_t _;
+} leto_light_data_t;
+
+/**
+ * @brief A set of lights and the cluster lists they were last binned
+ * into. This struct should only be modified through the functions below.
+ */
+typedef struct leto_lights
+{
+    /**
+     * @brief Every light of the set.
+     */
+    leto_light_t *lights;
+    /**
+     * @brief The amount of lights in the set.
+     */
+    size_t count;
+    /**
+     * @brief The amount of lights the set has room for.
+     */
+    size_t capacity;
+    /**
+     * @brief The allocation the view-space copies binning tests against
+     * live in.
+     */
+    void *_;
+    /**
+     * @brief The amount of lights @ref _ has room for, a multiple of
+     * eight.
+     */
+    size_t scratch_capacity;
+    /**
+     * @brief The lights binned into every cluster, @ref
+     * LETO_MAX_CLUSTER_LIGHTS and a spare slot apiece.
+     */
+    uint32_t *cluster_lights;
+    /**
+     * @brief The amount of lights binned into every cluster.
+     */
+    uint32_t *cluster_counts;
+    /**
+     * @brief The factor and offset taking the log of a view depth to its
+     * depth slice.
+     */
+    float slice_scale, slice_bias;
+    /**
+     * @brief The ring the light data, cluster grid, and light indices are
+     * uploaded through.
+     */
+    leto_ring_buffer_t ring;
+} leto_lights_t;
+
+/**
+ * CreateLights
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty set of lights. This must be called after the
+ * OpenGL context is current.
+ *
+ * @param lights The set to initialize.
+ * @param capacity The amount of lights the set should have room for.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateLights(leto_lights_t *lights, size_t capacity);
+
+/**
+ * DestroyLights
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a set of lights owns.
+ *
+ * @param lights The set to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyLights(leto_lights_t *lights);
+
+/**
+ * AddLight
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add a light to a set, growing it if it's full.
+ *
+ * @param lights The set to add to.
+ * @param light The light to add.
+ * @return size_t -- The index of the new light.
+ */
+size_t LetoAddLight(leto_lights_t *lights, const leto_light_t *light);
+
+/**
+ * SetLight
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Change a light already in a set; to move a headlight, say.
+ *
+ * @param lights The set holding the light.
+ * @param index The index of the light. Anything past the lights added
+ * since the last clear is ignored.
+ * @param light The new light.
+ * @return void -- Nothing.
+ */
+void LetoSetLight(leto_lights_t *lights, size_t index,
+                  const leto_light_t *light);
+
+/**
+ * ClearLights
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Remove every light from a set.
+ *
+ * @param lights The set to clear.
+ * @return void -- Nothing.
+ */
+void LetoClearLights(leto_lights_t *lights);
+
+/**
+ * BinLights
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bin every light into the clusters of a view, upload the lists,
+ * and bind them for shading. This should be called once a frame, before
+ * anything lit is drawn; large sets are binned over several threads.
+ *
+ * @param lights The set to bin.
+ * @param view The camera's view matrix.
+ * @param projection The camera's perspective projection, as made by
+ * @ref LetoGetCameraProjection. The near and far planes are taken from
+ * it.
+ * @return size_t -- The amount of indices written across every cluster.
+ */
+size_t LetoBinLights(leto_lights_t *lights, mat4 view, mat4 projection);
+
+/**
+ * SetLightUniforms
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set the given shader's "cluster_scale" and "cluster_bias"
+ * uniforms, which it uses to find the depth slice of a fragment, to
+ * those of the last @ref LetoBinLights.
+ *
+ * @param lights The set last binned.
+ * @param shader The shader whose uniforms to set.
+ * @return void -- Nothing.
+ */
+void LetoSetLightUniforms(const leto_lights_t *lights,
+                          unsigned int shader);
+
+#endif // LETO__LIGHTS_H
@@ -0,0 +1,332 @@
+/**
+ * @file Materials.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's material system. The parameter buffer holds
+ * one copy of every material's parameters per frame in flight; edits are
+ * made to a CPU-side shadow and copied into each frame's copy as it comes
+ * around, so the GPU is never reading what we're writing.
+ * @implements Materials.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Materials.h"         // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Deferred object release
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <stdlib.h> // Standard sorting
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The amount of copies of the parameter block kept in the buffer,
+ * one per frame the GPU may still be working on.
+ */
+#define PARAMETER_COPIES 3
+
+/**
+ * @brief The size of a single copy of the parameter block, in bytes.
+ */
+#define COPY_SIZE (LETO_MAX_MATERIALS * sizeof(leto_material_parameters_t))
+
+/**
+ * @brief The amount of 64-bit words needed for one bit per slot.
+ */
+#define DIRTY_WORDS (LETO_MAX_MATERIALS / 64)
+
+// Shaders index the parameter array with a 64-byte stride; make sure the
+// compiler agrees.
+_Static_assert(sizeof(leto_material_parameters_t) == 64,
+               "Material parameters must match the std430 layout.");
+_Static_assert(LETO_MAX_MATERIALS % 64 == 0,
+               "The material count must be a multiple of 64.");
+
+/**
+ * @brief The state of the material system. There is only ever one.
+ */
+static struct
+{
+    /**
+     * @brief The OpenGL ID of the parameter buffer.
+     */
+    unsigned int buffer;
+    /**
+     * @brief The persistent mapping of the whole parameter buffer.
+     */
+    unsigned char *mapping;
+    /**
+     * @brief The copy of the parameter block bound this frame.
+     */
+    unsigned int copy;
+    /**
+     * @brief Whether the current copy has been bound (and so may be in use
+     * by the GPU).
+     */
+    bool in_use;
+    /**
+     * @brief The fence signalled once the GPU is done with each copy.
+     */
+    void *fences[PARAMETER_COPIES];
+    /**
+     * @brief One bit per slot per copy, set if that copy is out of date.
+     */
+    uint64_t dirty[PARAMETER_COPIES][DIRTY_WORDS];
+    /**
+     * @brief The CPU-side, always up to date parameters of every slot.
+     */
+    leto_material_parameters_t shadow[LETO_MAX_MATERIALS];
+    /**
+     * @brief A stack of the slots not taken by any material.
+     */
+    uint32_t free_slots[LETO_MAX_MATERIALS];
+    /**
+     * @brief The amount of slots in @ref free_slots.
+     */
+    size_t free_count;
+} materials;
+
+/**
+ * MarkDirty
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Mark the given slot as out of date in every copy.
+ *
+ * @param slot The slot that changed.
+ * @return void -- Nothing.
+ */
+static void MarkDirty_(uint32_t slot)
+{
+    for (size_t i = 0; i < PARAMETER_COPIES; i++)
+        materials.dirty[i][slot / 64] |= 1ull << (slot % 64);
+}
+
+/**
+ * IsDirty
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether the given slot is out of date in the given copy's
+ * dirty set.
+ *
+ * @param dirty The dirty set of a copy.
+ * @param slot The slot to check.
+ * @return bool -- True if the slot needs to be written.
+ */
+static bool IsDirty_(const uint64_t *dirty, size_t slot)
+{
+    return (dirty[slot / 64] >> (slot % 64)) & 1;
+}
+
+/**
+ * UpdateSortKey
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Recalculate the sort key of the given material. From most to
+ * least significant, the key holds 16 bits identifying the shader, the
+ * low 16 bits of the first texture, 16 bits hashed from the rest of the
+ * textures, and the slot.
+ *
+ * @param material The material whose key to update.
+ * @return void -- Nothing.
+ */
+static void UpdateSortKey_(leto_material_t *material)
+{
+    // The shader's address is used over its program so the key survives
+    // reloads. Mix it so the allocator's alignment doesn't eat the bits.
+    uint64_t shader = (uint64_t)(uintptr_t)material->shader;
+    shader = (shader ^ (shader >> 33)) * 0xff51afd7ed558ccdull;
+    shader ^= shader >> 33;
+
+    uint64_t textures = 0;
+    for (size_t i = 1; i < LETO_MATERIAL_TEXTURES; i++)
+        textures = (textures * 31) + material->textures[i];
+
+    uint64_t first = material->textures[0] & 0xFFFF;
+    material->sort_key = ((shader & 0xFFFF) << 48) | (first << 32) |
+                         ((textures & 0xFFFF) << 16) |
+                         (material->slot & 0xFFFF);
+}
+
+/**
+ * CompareMaterials
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Compare two material pointers by sort key, for @ref qsort.
+ *
+ * @param first The first material pointer.
+ * @param second The second material pointer.
+ * @return int -- Less than, equal to, or greater than zero.
+ */
+static int CompareMaterials_(const void *first, const void *second)
+{
+    uint64_t a = (*(const leto_material_t *const *)first)->sort_key;
+    uint64_t b = (*(const leto_material_t *const *)second)->sort_key;
+    return (a > b) - (a < b);
+}
+
+bool LetoInitMaterials(void)
+{
+    const size_t size = PARAMETER_COPIES * COPY_SIZE;
+    memset(&materials, 0, sizeof(materials));
+
+    glCreateBuffers(1, &materials.buffer);
+    glNamedBufferStorage(materials.buffer, size, NULL,
+                         GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT);
+    // Writes are made visible to the GPU by flushing exactly the ranges
+    // that changed, rather than by coherent mapping.
+    materials.mapping = glMapNamedBufferRange(
+        materials.buffer, 0, size,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+            GL_MAP_FLUSH_EXPLICIT_BIT);
+    if (materials.mapping == NULL)
+    {
+        LetoReportError(false, failed_buffer_map, LETO_FILE_CONTEXT);
+        glDeleteBuffers(1, &materials.buffer);
+        materials.buffer = 0;
+        return false;
+    }
+
+    // Hand out low slots first, so the flushed ranges stay compact.
+    for (size_t i = 0; i < LETO_MAX_MATERIALS; i++)
+        materials.free_slots[i] = LETO_MAX_MATERIALS - 1 - (uint32_t)i;
+    materials.free_count = LETO_MAX_MATERIALS;
+    materials.copy = PARAMETER_COPIES - 1;
+
+    return true;
+}
+
+void LetoTerminateMaterials(void)
+{
+    if (materials.buffer == 0) return;
+
+    for (size_t i = 0; i < PARAMETER_COPIES; i++)
+        if (materials.fences[i] != NULL) glDeleteSync(materials.fences[i]);
+
+    glUnmapNamedBuffer(materials.buffer);
+    LetoForgetStateObject(buffer_object, materials.buffer);
+    glDeleteBuffers(1, &materials.buffer);
+    materials.buffer = 0;
+    materials.mapping = NULL;
+}
+
+bool LetoCreateMaterial(leto_material_t *material, leto_shader_t *shader)
+{
+    if (material == NULL) return false;
+    if (materials.free_count == 0)
+    {
+        LetoReportError(false, no_material_slots, LETO_FILE_CONTEXT);
+        return false;
+    }
+
+    material->shader = shader;
+    memset(material->textures, 0, sizeof(material->textures));
+    material->slot = materials.free_slots[--materials.free_count];
+    UpdateSortKey_(material);
+
+    LetoSetMaterialParameters(
+        material, &(leto_material_parameters_t){.color = {1, 1, 1, 1}});
+    return true;
+}
+
+void LetoDestroyMaterial(leto_material_t *material)
+{
+    if (material == NULL || material->slot >= LETO_MAX_MATERIALS) return;
+
+    materials.free_slots[materials.free_count++] = material->slot;
+    material->slot = LETO_MAX_MATERIALS;
+    material->shader = NULL;
+}
+
+void LetoSetMaterialParameters(
+    leto_material_t *material,
+    const leto_material_parameters_t *parameters)
+{
+    if (material == NULL || parameters == NULL) return;
+
+    materials.shadow[material->slot] = *parameters;
+    MarkDirty_(material->slot);
+}
+
+const leto_material_parameters_t *
+LetoGetMaterialParameters(const leto_material_t *material)
+{
+    if (material == NULL) return NULL;
+    return &materials.shadow[material->slot];
+}
+
+void LetoSetMaterialTexture(leto_material_t *material, unsigned int index,
+                            unsigned int texture)
+{
+    if (material == NULL || index >= LETO_MATERIAL_TEXTURES) return;
+
+    material->textures[index] = texture;
+    UpdateSortKey_(material);
+}
+
+void LetoFlushMaterials(void)
+{
+    if (materials.buffer == 0) return;
+
+    // The copy bound last frame has had all its draws submitted by now,
+    // so this fence tells us when the GPU is done with it.
+    if (materials.in_use)
+        materials.fences[materials.copy] =
+            glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    materials.copy = (materials.copy + 1) % PARAMETER_COPIES;
+    // With three copies in rotation this should practically never wait.
+    (void)LetoWaitFence(&materials.fences[materials.copy], true);
+
+    // Write each run of dirty slots as a single range.
+    const size_t base = materials.copy * COPY_SIZE;
+    uint64_t *dirty = materials.dirty[materials.copy];
+    for (size_t slot = 0; slot < LETO_MAX_MATERIALS;)
+    {
+        if (dirty[slot / 64] == 0)
+        {
+            slot += 64;
+            continue;
+        }
+        if (!IsDirty_(dirty, slot))
+        {
+            slot++;
+            continue;
+        }
+
+        size_t first = slot;
+        while (slot < LETO_MAX_MATERIALS && IsDirty_(dirty, slot)) slot++;
+
+        const size_t stride = sizeof(leto_material_parameters_t);
+        size_t offset = base + first * stride;
+        size_t length = (slot - first) * stride;
+        memcpy(materials.mapping + offset, &materials.shadow[first],
+               length);
+        glFlushMappedNamedBufferRange(materials.buffer, (GLintptr)offset,
+                                      (GLsizeiptr)length);
+    }
+    memset(dirty, 0, sizeof(materials.dirty[0]));
+
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_MATERIAL_BINDING,
+                        materials.buffer, (ptrdiff_t)base,
+                        (ptrdiff_t)COPY_SIZE);
+    materials.in_use = true;
+}
+
+unsigned int LetoBindMaterial(const leto_material_t *material)
+{
+    if (material == NULL) return 0;
+
+    unsigned int program = LetoGetShaderProgram(material->shader);
+    LetoUseProgram(program);
+    for (unsigned int i = 0; i < LETO_MATERIAL_TEXTURES; i++)
+        LetoBindTextureUnit(i, material->textures[i]);
+
+    return program;
+}
+
+void LetoSortMaterials(const leto_material_t **materials, size_t count)
+{
+    if (materials == NULL) return;
+    qsort(materials, count, sizeof(const leto_material_t *),
+          CompareMaterials_);
+}
@@ -0,0 +1,220 @@
+/**
+ * @file Materials.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's material system. Every material owns a slot in a
+ * single, persistently mapped shader storage buffer, so drawing with a
+ * material never needs a uniform call; shaders index the buffer instead.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__MATERIALS_H
+#define LETO__MATERIALS_H
+
+// The engine's shader interface.
+#include <Input/Shaders.h>
+// Fixed-width integer types.
+#include <stdint.h>
+// GLM 4D vectors.
+#include <CGLM/vec4.h>
+
+/**
+ * @brief The maximum amount of materials that can exist at once. This is
+ * the amount of slots in the parameter buffer.
+ */
+#define LETO_MAX_MATERIALS 1024
+
+/**
+ * @brief The amount of textures a material can reference.
+ */
+#define LETO_MATERIAL_TEXTURES 4
+
+/**
+ * @brief The shader storage binding point the parameter buffer is bound
+ * to. Shaders declare the block with "layout(std430, binding = 1)".
+ */
+#define LETO_MATERIAL_BINDING 1
+
+/**
+ * @brief The parameters of a material as shaders see them. This is laid
+ * out to match std430, and is exactly 64 bytes long.
+ */
+typedef struct leto_material_parameters
+{
+    /**
+     * @brief The base color of the material, RGBA.
+     */
+    vec4 color;
+    /**
+     * @brief The roughness of the surface, from 0 to 1.
+     */
+    float roughness;
+    /**
+     * @brief How metallic the surface is, from 0 to 1.
+     */
+    float metallic;
+    /**
+     * @brief The strength of the light the surface emits.
+     */
+    float emission;
+    /**
+     * @brief The alpha below which fragments are discarded.
+     */
+    float alpha_cutoff;
+    /**
+     * @brief Free values for specific shaders to interpret.
+     */
+    vec4 user[2];
+} leto_material_parameters_t;
+
+/**
+ * @brief A material; a program variant, the textures it samples, and a
+ * slot in the parameter buffer. This struct should only be modified
+ * through the functions below.
+ */
+typedef struct leto_material
+{
+    /**
+     * @brief The shader this material draws with. The program it hands
+     * out may change (on hot-reload, for example), the shader may not.
+     */
+    leto_shader_t *shader;
+    /**
+     * @brief The textures bound to units 0 through @ref
+     * LETO_MATERIAL_TEXTURES - 1 when the material is bound.
+     */
+    unsigned int textures[LETO_MATERIAL_TEXTURES];
+    /**
+     * @brief The index of the material's parameters in the parameter
+     * buffer. Shaders receive this through their instance's data.
+     */
+    uint32_t slot;
+    /**
+     * @brief A key that sorts materials sharing a program, then sharing
+     * textures, next to each other.
+     */
+    uint64_t sort_key;
+} leto_material_t;
+
+/**
+ * InitMaterials
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create and map the parameter buffer. This must be called after
+ * the OpenGL context is current, and before any material is created.
+ *
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoInitMaterials(void);
+
+/**
+ * TerminateMaterials
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Unmap and delete the parameter buffer. Every material is invalid
+ * past this call.
+ *
+ * @return void -- Nothing.
+ */
+void LetoTerminateMaterials(void);
+
+/**
+ * CreateMaterial
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create a material with default parameters (opaque white) and no
+ * textures.
+ *
+ * @param material The material to initialize.
+ * @param shader The shader the material draws with.
+ * @return bool -- True for success, false if every slot is taken.
+ */
+bool LetoCreateMaterial(leto_material_t *material, leto_shader_t *shader);
+
+/**
+ * DestroyMaterial
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give the material's slot back. The textures and shader are not
+ * owned by the material, and are left alone.
+ *
+ * @param material The material to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyMaterial(leto_material_t *material);
+
+/**
+ * SetMaterialParameters
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Change the parameters of a material. Nothing is sent to the GPU
+ * until the next @ref LetoFlushMaterials.
+ *
+ * @param material The material to change.
+ * @param parameters The new parameters.
+ * @return void -- Nothing.
+ */
+void LetoSetMaterialParameters(
+    leto_material_t *material,
+    const leto_material_parameters_t *parameters);
+
+/**
+ * GetMaterialParameters
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the current parameters of a material.
+ *
+ * @param material The material to check.
+ * @return const leto_material_parameters_t* -- The parameters.
+ */
+const leto_material_parameters_t *
+LetoGetMaterialParameters(const leto_material_t *material);
+
+/**
+ * SetMaterialTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set one of the textures of a material. This updates the
+ * material's sort key.
+ *
+ * @param material The material to change.
+ * @param index The texture unit, below @ref LETO_MATERIAL_TEXTURES.
+ * @param texture The OpenGL ID of the texture, or 0 for none.
+ * @return void -- Nothing.
+ */
+void LetoSetMaterialTexture(leto_material_t *material, unsigned int index,
+                            unsigned int texture);
+
+/**
+ * FlushMaterials
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Send every parameter change since the last flush to the GPU, in
+ * as few contiguous ranges as possible, and bind the parameter buffer.
+ * This should be called once at the start of every frame, before any
+ * material is drawn with.
+ *
+ * @return void -- Nothing.
+ */
+void LetoFlushMaterials(void);
+
+/**
+ * BindMaterial
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make the material's program current and bind its textures.
+ * Both go through the state cache, so binding materials in sorted order
+ * only ever touches what changed.
+ *
+ * @param material The material to bind.
+ * @return unsigned int -- The OpenGL ID of the program now in use.
+ */
+unsigned int LetoBindMaterial(const leto_material_t *material);
+
+/**
+ * SortMaterials
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Sort an array of materials by their sort keys, so that drawing
+ * them in order switches program and textures as little as possible.
+ *
+ * @param materials The array of material pointers to sort.
+ * @param count The amount of materials in the array.
+ * @return void -- Nothing.
+ */
+void LetoSortMaterials(const leto_material_t **materials, size_t count);
+
+#endif // LETO__MATERIALS_H
@@ -0,0 +1,475 @@
+/**
+ * @file Occlusion.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's software occlusion culler. Triangles are
+ * rasterized with edge functions evaluated a vector of pixels at a time;
+ * AVX2 builds do eight pixels at once, SSE2 and NEON builds four, and
+ * anything else falls back to plain C. Boxes are tested by their screen
+ * rectangle and nearest depth, first against the farthest depth of each
+ * tile they touch, and only then against single pixels.
+ *
+ * This is not masked occlusion in the Intel sense, where each tile keeps
+ * a coverage mask and two depths rather than a depth per pixel. The
+ * buffer here is small enough that full depth costs little, and it keeps
+ * both rasterizing and testing exact instead of conservative by a tile's
+ * depth range. The farthest depth of each tile plays the part of the
+ * mask, letting most tests stop at the tile level. Swapping in masked
+ * tiles would only touch this file, as nothing outside it sees the depth
+ * layout.
+ * @implements Occlusion.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Occlusion.h"         // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Utilities/Macros.h>  // Utility macros
+#include <Utilities/Simd.h>    // Vector operations
+#include <Utilities/Threads.h> // Threading
+
+#include <float.h>  // Floating-point limits
+#include <math.h>   // Standard math functions
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+
+/**
+ * @brief The depth of a pixel nothing has been drawn to.
+ */
+#define OCCLUSION_FAR 1.0f
+
+// Rows are a whole amount of tiles, and tiles a whole amount of vectors.
+_Static_assert(LETO_OCCLUSION_TILE % LETO_SIMD_WIDTH == 0,
+               "Tiles must be a whole amount of vectors wide.");
+
+/**
+ * @brief A band of tile rows, rasterized on the worker pool.
+ */
+typedef struct occlusion_job
+{
+    /**
+     * @brief The occlusion culler being drawn into.
+     */
+    leto_occlusion_t *occlusion;
+    /**
+     * @brief The first tile row of the band.
+     */
+    size_t first;
+    /**
+     * @brief One past the last tile row of the band.
+     */
+    size_t last;
+} occlusion_job_t;
+
+/**
+ * DrawTriangle
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Draw one triangle into the rows of a band. Pixels are covered if
+ * their center is inside the triangle, and keep the nearer of their depth
+ * and the triangle's.
+ *
+ * @param occlusion The occlusion culler.
+ * @param triangle The triangle's nine floats.
+ * @param top The first pixel row of the band.
+ * @param bottom One past the last pixel row of the band.
+ * @return void -- Nothing.
+ */
+static void DrawTriangle_(leto_occlusion_t *occlusion,
+                          const float *triangle, size_t top,
+                          size_t bottom)
+{
+    const float *a = &triangle[0], *b = &triangle[3], *c = &triangle[6];
+
+    // The pixels whose centers the triangle's bounds can reach.
+    float low_y = fminf(a[1], fminf(b[1], c[1]));
+    float high_y = fmaxf(a[1], fmaxf(b[1], c[1]));
+    float low_x = fminf(a[0], fminf(b[0], c[0]));
+    float high_x = fmaxf(a[0], fmaxf(b[0], c[0]));
+    float first_row = fmaxf(ceilf(low_y - 0.5f), (float)top);
+    float last_row = fminf(floorf(high_y - 0.5f), (float)bottom - 1.0f);
+    float first_column = fmaxf(ceilf(low_x - 0.5f), 0.0f);
+    float last_column =
+        fminf(floorf(high_x - 0.5f), (float)occlusion->width - 1.0f);
+    if (first_row > last_row || first_column > last_column) return;
+
+    // Each edge, and the depth, as a plane over x and y.
+    float area = (b[0] - a[0]) * (c[1] - a[1]) -
+                 (c[0] - a[0]) * (b[1] - a[1]);
+    float edge_x[3], edge_y[3], edge_c[3];
+    const float *from[3] = {a, b, c}, *to[3] = {b, c, a};
+    for (size_t e = 0; e < 3; e++)
+    {
+        edge_x[e] = from[e][1] - to[e][1];
+        edge_y[e] = to[e][0] - from[e][0];
+        edge_c[e] = -(edge_x[e] * from[e][0] + edge_y[e] * from[e][1]);
+    }
+    float depth_x = ((b[2] - a[2]) * (c[1] - a[1]) -
+                     (c[2] - a[2]) * (b[1] - a[1])) /
+                    area;
+    float depth_y = ((c[2] - a[2]) * (b[0] - a[0]) -
+                     (b[2] - a[2]) * (c[0] - a[0])) /
+                    area;
+    float depth_c = a[2] - depth_x * a[0] - depth_y * a[1];
+
+    const size_t start =
+        (size_t)first_column / LETO_SIMD_WIDTH * LETO_SIMD_WIDTH;
+    const size_t end = (size_t)last_column;
+    const leto_simd_t zero = LetoSimdSet(0.0f);
+    const leto_simd_t limit = LetoSimdSet(last_column + 0.5f);
+    for (size_t y = (size_t)first_row; y <= (size_t)last_row; y++)
+    {
+        const float center_y = (float)y + 0.5f;
+        float *row = occlusion->depth + y * occlusion->stride;
+        for (size_t x = start; x <= end; x += LETO_SIMD_WIDTH)
+        {
+            leto_simd_t center_x =
+                LetoSimdAdd(LetoSimdRamp(), LetoSimdSet((float)x + 0.5f));
+            leto_simd_mask_t inside = LetoSimdAtLeast(limit, center_x);
+            for (size_t e = 0; e < 3; e++)
+            {
+                leto_simd_t edge = LetoSimdAdd(
+                    LetoSimdMul(center_x, LetoSimdSet(edge_x[e])),
+                    LetoSimdSet(edge_y[e] * center_y + edge_c[e]));
+                inside = LetoSimdAnd(inside, LetoSimdAtLeast(edge, zero));
+            }
+            if (LetoSimdBits(inside) == 0) continue;
+
+            leto_simd_t depth =
+                LetoSimdAdd(LetoSimdMul(center_x, LetoSimdSet(depth_x)),
+                            LetoSimdSet(depth_y * center_y + depth_c));
+            leto_simd_t current = LetoSimdLoad(&row[x]);
+            current = LetoSimdSelect(inside, LetoSimdMin(current, depth),
+                                     current);
+            LetoSimdStore(&row[x], current);
+        }
+    }
+}
+
+/**
+ * ResolveTiles
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Recalculate the farthest depth of every tile in a band.
+ *
+ * @param occlusion The occlusion culler.
+ * @param first The first tile row.
+ * @param last One past the last tile row.
+ * @return void -- Nothing.
+ */
+static void ResolveTiles_(leto_occlusion_t *occlusion, size_t first,
+                          size_t last)
+{
+    const size_t tiles = occlusion->stride / LETO_OCCLUSION_TILE;
+    for (size_t ty = first; ty < last; ty++)
+    {
+        for (size_t tx = 0; tx < tiles; tx++)
+        {
+            leto_simd_t farthest = LetoSimdSet(0.0f);
+            for (size_t y = 0; y < LETO_OCCLUSION_TILE; y++)
+            {
+                const float *row =
+                    occlusion->depth +
+                    (ty * LETO_OCCLUSION_TILE + y) * occlusion->stride +
+                    tx * LETO_OCCLUSION_TILE;
+                for (size_t x = 0; x < LETO_OCCLUSION_TILE;
+                     x += LETO_SIMD_WIDTH)
+                    farthest =
+                        LetoSimdMax(farthest, LetoSimdLoad(&row[x]));
+            }
+
+            float lanes[LETO_SIMD_WIDTH];
+            memcpy(lanes, &farthest, sizeof(lanes));
+            float result = lanes[0];
+            for (size_t k = 1; k < LETO_SIMD_WIDTH; k++)
+                result = fmaxf(result, lanes[k]);
+            occlusion->tile_depth[ty * tiles + tx] = result;
+        }
+    }
+}
+
+/**
+ * RunJob
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Draw every triangle into a job's band, then resolve its tiles.
+ *
+ * @param argument The @ref occlusion_job_t to run.
+ * @return void -- Nothing.
+ */
+static void RunJob_(void *argument)
+{
+    occlusion_job_t *job = argument;
+    leto_occlusion_t *occlusion = job->occlusion;
+
+    const size_t top = job->first * LETO_OCCLUSION_TILE;
+    size_t bottom = job->last * LETO_OCCLUSION_TILE;
+    if (bottom > occlusion->height) bottom = occlusion->height;
+    for (size_t t = 0; t < occlusion->triangle_count; t++)
+        DrawTriangle_(occlusion, &occlusion->triangles[t * 9], top,
+                      bottom);
+    ResolveTiles_(occlusion, job->first, job->last);
+}
+
+/**
+ * Project
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take a world-space point to the buffer's window space.
+ *
+ * @param occlusion The occlusion culler.
+ * @param point The point.
+ * @param window Filled with the point's x and y in pixels, and its depth.
+ * @return bool -- False if the point is on or behind the near plane.
+ */
+static bool Project_(const leto_occlusion_t *occlusion, vec3 point,
+                     vec3 window)
+{
+    vec4 clip;
+    glm_mat4_mulv((vec4 *)occlusion->view_projection,
+                  (vec4){point[0], point[1], point[2], 1.0f}, clip);
+    if (clip[3] <= 1e-5f || clip[2] < -clip[3]) return false;
+
+    window[0] = (clip[0] / clip[3] * 0.5f + 0.5f) * occlusion->width;
+    window[1] = (clip[1] / clip[3] * 0.5f + 0.5f) * occlusion->height;
+    window[2] = clip[2] / clip[3] * 0.5f + 0.5f;
+    return true;
+}
+
+bool LetoCreateOcclusion(leto_occlusion_t *occlusion, size_t width,
+                         size_t height)
+{
+    if (occlusion == NULL || width == 0 || height == 0) return false;
+    memset(occlusion, 0, sizeof(leto_occlusion_t));
+
+    occlusion->width = width;
+    occlusion->height = height;
+    occlusion->stride = (width + LETO_OCCLUSION_TILE - 1) /
+                        LETO_OCCLUSION_TILE * LETO_OCCLUSION_TILE;
+    occlusion->rows = (height + LETO_OCCLUSION_TILE - 1) /
+                      LETO_OCCLUSION_TILE * LETO_OCCLUSION_TILE;
+
+    const size_t pixels = occlusion->stride * occlusion->rows;
+    const size_t tiles =
+        pixels / (LETO_OCCLUSION_TILE * LETO_OCCLUSION_TILE);
+    LETO_ALLOC_OR_FAIL(occlusion->_, (pixels + tiles) * sizeof(float) +
+                                         LETO_SIMD_ALIGNMENT);
+    if (occlusion->_ == NULL) return false;
+
+    uintptr_t address = (uintptr_t)occlusion->_;
+    address = (address + LETO_SIMD_ALIGNMENT - 1) &
+              ~(uintptr_t)(LETO_SIMD_ALIGNMENT - 1);
+    occlusion->depth = (float *)address;
+    occlusion->tile_depth = occlusion->depth + pixels;
+
+    glm_mat4_identity(occlusion->view_projection);
+    LetoBeginOcclusion(occlusion, occlusion->view_projection);
+    return true;
+}
+
+void LetoDestroyOcclusion(leto_occlusion_t *occlusion)
+{
+    if (occlusion == NULL) return;
+    free(occlusion->_);
+    free(occlusion->triangles);
+    memset(occlusion, 0, sizeof(leto_occlusion_t));
+}
+
+void LetoBeginOcclusion(leto_occlusion_t *occlusion,
+                        mat4 view_projection)
+{
+    if (occlusion == NULL || occlusion->_ == NULL) return;
+    glm_mat4_copy(view_projection, occlusion->view_projection);
+    occlusion->triangle_count = 0;
+
+    const size_t pixels = occlusion->stride * occlusion->rows;
+    const size_t tiles =
+        pixels / (LETO_OCCLUSION_TILE * LETO_OCCLUSION_TILE);
+    for (size_t i = 0; i < pixels + tiles; i++)
+        occlusion->depth[i] = OCCLUSION_FAR;
+}
+
+void LetoAddOccluder(leto_occlusion_t *occlusion, const float *positions,
+                     size_t vertex_count, const uint32_t *indices,
+                     size_t index_count, mat4 model)
+{
+    if (occlusion == NULL || positions == NULL || indices == NULL) return;
+
+    mat4 transform;
+    glm_mat4_mul(occlusion->view_projection, model, transform);
+
+    for (size_t i = 0; i + 2 < index_count; i += 3)
+    {
+        float triangle[9];
+        bool kept = true;
+        for (size_t v = 0; v < 3 && kept; v++)
+        {
+            if (indices[i + v] >= vertex_count)
+            {
+                kept = false;
+                break;
+            }
+            const float *position = &positions[indices[i + v] * 3];
+            vec4 clip;
+            glm_mat4_mulv(transform,
+                          (vec4){position[0], position[1], position[2],
+                                 1.0f},
+                          clip);
+            // Clipping isn't worth it for occluders; a triangle crossing
+            // the near plane just doesn't hide anything.
+            if (clip[3] <= 1e-5f || clip[2] < -clip[3])
+            {
+                kept = false;
+                break;
+            }
+            triangle[v * 3 + 0] =
+                (clip[0] / clip[3] * 0.5f + 0.5f) * occlusion->width;
+            triangle[v * 3 + 1] =
+                (clip[1] / clip[3] * 0.5f + 0.5f) * occlusion->height;
+            triangle[v * 3 + 2] = clip[2] / clip[3] * 0.5f + 0.5f;
+        }
+        if (!kept) continue;
+
+        // Back faces are hidden by front faces anyway.
+        float area = (triangle[3] - triangle[0]) *
+                         (triangle[7] - triangle[1]) -
+                     (triangle[6] - triangle[0]) *
+                         (triangle[4] - triangle[1]);
+        if (area <= 0.0f) continue;
+
+        if (occlusion->triangle_count == occlusion->triangle_capacity)
+        {
+            size_t capacity = occlusion->triangle_capacity == 0
+                                  ? 256
+                                  : occlusion->triangle_capacity * 2;
+            void *triangles = realloc(occlusion->triangles,
+                                      capacity * 9 * sizeof(float));
+            if (triangles == NULL)
+            {
+                LetoReportError(true, failed_allocation,
+                                LETO_FILE_CONTEXT);
+                return;
+            }
+            occlusion->triangles = triangles;
+            occlusion->triangle_capacity = capacity;
+        }
+        memcpy(&occlusion->triangles[occlusion->triangle_count++ * 9],
+               triangle, sizeof(triangle));
+    }
+}
+
+void LetoRasterizeOcclusion(leto_occlusion_t *occlusion)
+{
+    if (occlusion == NULL || occlusion->_ == NULL) return;
+
+    const size_t tile_rows = occlusion->rows / LETO_OCCLUSION_TILE;
+    size_t job_count = 1;
+    if (occlusion->triangle_count >= LETO_OCCLUSION_THREAD_BATCH)
+        job_count = LetoGetWorkerCount();
+    if (job_count > tile_rows) job_count = tile_rows;
+    if (job_count == 0) job_count = 1;
+
+    // Bands never share a row, so no two threads touch the same pixels.
+    occlusion_job_t jobs[LETO_MAX_WORKERS];
+    for (size_t j = 0; j < job_count; j++)
+        jobs[j] = (occlusion_job_t){
+            .occlusion = occlusion,
+            .first = j * tile_rows / job_count,
+            .last = (j + 1) * tile_rows / job_count};
+    LetoRunJobs(RunJob_, jobs, sizeof(occlusion_job_t), job_count);
+}
+
+bool LetoTestOcclusion(const leto_occlusion_t *occlusion, vec3 center,
+                       vec3 extent)
+{
+    if (occlusion == NULL || occlusion->_ == NULL) return true;
+
+    // The box's screen rectangle and nearest depth.
+    // Finite sentinels, since release builds assume nothing's infinite.
+    float low[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float high[2] = {-FLT_MAX, -FLT_MAX};
+    for (size_t i = 0; i < 8; i++)
+    {
+        vec3 corner = {center[0] + ((i & 1) ? extent[0] : -extent[0]),
+                       center[1] + ((i & 2) ? extent[1] : -extent[1]),
+                       center[2] + ((i & 4) ? extent[2] : -extent[2])};
+        vec3 window;
+        if (!Project_(occlusion, corner, window)) return true;
+        for (size_t a = 0; a < 3; a++)
+            if (window[a] < low[a]) low[a] = window[a];
+        for (size_t a = 0; a < 2; a++)
+            if (window[a] > high[a]) high[a] = window[a];
+    }
+
+    // Every pixel the rectangle touches at all, clamped to the screen.
+    float first_x = fmaxf(floorf(low[0]), 0.0f);
+    float first_y = fmaxf(floorf(low[1]), 0.0f);
+    float last_x = fminf(ceilf(high[0]) - 1.0f, occlusion->width - 1.0f);
+    float last_y = fminf(ceilf(high[1]) - 1.0f, occlusion->height - 1.0f);
+    if (first_x > last_x || first_y > last_y) return true;
+
+    const size_t x0 = (size_t)first_x, x1 = (size_t)last_x;
+    const size_t y0 = (size_t)first_y, y1 = (size_t)last_y;
+    const size_t tiles = occlusion->stride / LETO_OCCLUSION_TILE;
+    const leto_simd_t nearest = LetoSimdSet(low[2]);
+    for (size_t ty = y0 / LETO_OCCLUSION_TILE;
+         ty <= y1 / LETO_OCCLUSION_TILE; ty++)
+    {
+        for (size_t tx = x0 / LETO_OCCLUSION_TILE;
+             tx <= x1 / LETO_OCCLUSION_TILE; tx++)
+        {
+            // Everything in the tile is nearer than the box.
+            if (occlusion->tile_depth[ty * tiles + tx] < low[2]) continue;
+
+            size_t top = ty * LETO_OCCLUSION_TILE;
+            size_t bottom = top + LETO_OCCLUSION_TILE - 1;
+            size_t left = tx * LETO_OCCLUSION_TILE;
+            size_t right = left + LETO_OCCLUSION_TILE - 1;
+            if (top < y0) top = y0;
+            if (bottom > y1) bottom = y1;
+
+            const leto_simd_t from =
+                LetoSimdSet((float)(left > x0 ? left : x0));
+            const leto_simd_t to =
+                LetoSimdSet((float)(right < x1 ? right : x1));
+            for (size_t y = top; y <= bottom; y++)
+            {
+                const float *row =
+                    occlusion->depth + y * occlusion->stride;
+                for (size_t x = left; x <= right; x += LETO_SIMD_WIDTH)
+                {
+                    leto_simd_t column =
+                        LetoSimdAdd(LetoSimdRamp(), LetoSimdSet((float)x));
+                    leto_simd_mask_t seen =
+                        LetoSimdAnd(LetoSimdAtLeast(column, from),
+                                    LetoSimdAtLeast(to, column));
+                    seen = LetoSimdAnd(
+                        seen,
+                        LetoSimdAtLeast(LetoSimdLoad(&row[x]), nearest));
+                    if (LetoSimdBits(seen) != 0) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+size_t LetoCullOccluded(const leto_occlusion_t *occlusion,
+                        const leto_bounds_t *bounds, uint32_t *visible,
+                        size_t count)
+{
+    if (occlusion == NULL || bounds == NULL || visible == NULL)
+        return count;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t index = visible[i];
+        vec3 center = {bounds->center[0][index], bounds->center[1][index],
+                       bounds->center[2][index]};
+        vec3 extent = {bounds->extent[0][index], bounds->extent[1][index],
+                       bounds->extent[2][index]};
+        if (LetoTestOcclusion(occlusion, center, extent))
+            visible[kept++] = index;
+    }
+    return kept;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file Occlusion.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's software occlusion culler. A handful of simple
+ * occluder meshes are rasterized on the CPU into a small depth buffer,
+ * and object boxes are then tested against it before they're submitted.
+ * Nothing is read back from the GPU, so results are available the same
+ * frame and the whole thing runs without a context. The buffer keeps a
+ * plain depth per pixel, and the farthest depth per tile, rather than the
+ * coverage masks of masked occlusion.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__OCCLUSION_H
+#define LETO__OCCLUSION_H
+
+// The engine's frustum culler, and its bounds sets.
+#include <Rendering/Culling.h>
+
+/**
+ * @brief The size of a tile of the depth buffer, in pixels. The buffer's
+ * dimensions are rounded up to a multiple of this, and the farthest depth
+ * of every tile is kept so most tests never look at single pixels.
+ */
+#define LETO_OCCLUSION_TILE 8
+
+/**
+ * @brief The least amount of occluder triangles worth splitting
+ * rasterization over threads for.
+ */
+#define LETO_OCCLUSION_THREAD_BATCH 512
+
+/**
+ * @brief A software depth buffer and the occluders drawn into it. This
+ * struct should only be modified through the functions below.
+ */
+typedef struct leto_occlusion
+{
+    /**
+     * @brief The allocation the depth buffer and tile depths live in.
+     */
+    void *_;
+    /**
+     * @brief The depth of every pixel, from zero at the near plane to one
+     * at the far plane, @ref stride pixels per row.
+     */
+    float *depth;
+    /**
+     * @brief The farthest depth of every tile, row by row.
+     */
+    float *tile_depth;
+    /**
+     * @brief The width and height the buffer covers, in pixels.
+     */
+    size_t width, height;
+    /**
+     * @brief The amount of pixels per row, and of rows, in the buffer;
+     * the width and height rounded up to whole tiles.
+     */
+    size_t stride, rows;
+    /**
+     * @brief The camera's view-projection matrix.
+     */
+    mat4 view_projection;
+    /**
+     * @brief Every queued occluder triangle, as the window-space x, y,
+     * and depth of its three vertices; nine floats each.
+     */
+    float *triangles;
+    /**
+     * @brief The amount of queued triangles.
+     */
+    size_t triangle_count;
+    /**
+     * @brief The amount of triangles there is room for.
+     */
+    size_t triangle_capacity;
+} leto_occlusion_t;
+
+/**
+ * CreateOcclusion
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create a software depth buffer. A few hundred pixels across is
+ * plenty; occluders only need to be roughly right.
+ *
+ * @param occlusion The occlusion culler to initialize.
+ * @param width The width of the buffer, in pixels.
+ * @param height The height of the buffer, in pixels.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateOcclusion(leto_occlusion_t *occlusion, size_t width,
+                         size_t height);
+
+/**
+ * DestroyOcclusion
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything an occlusion culler owns.
+ *
+ * @param occlusion The occlusion culler to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyOcclusion(leto_occlusion_t *occlusion);
+
+/**
+ * BeginOcclusion
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Start a new frame; clear the buffer and forget every occluder.
+ *
+ * @param occlusion The occlusion culler.
+ * @param view_projection The camera's view-projection matrix.
+ * @return void -- Nothing.
+ */
+void LetoBeginOcclusion(leto_occlusion_t *occlusion,
+                        mat4 view_projection);
+
+/**
+ * AddOccluder
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Queue an occluder mesh. Occluders should be a few dozen
+ * triangles at most, and must sit entirely inside what they stand in
+ * for, or they'll hide things that are really visible. Only triangles
+ * wound counter-clockwise and entirely in front of the camera are kept.
+ *
+ * @param occlusion The occlusion culler.
+ * @param positions The position of every vertex, three floats each.
+ * @param vertex_count The amount of vertices.
+ * @param indices Three indices per triangle.
+ * @param index_count The amount of indices.
+ * @param model The object-to-world matrix of the occluder.
+ * @return void -- Nothing.
+ */
+void LetoAddOccluder(leto_occlusion_t *occlusion, const float *positions,
+                     size_t vertex_count, const uint32_t *indices,
+                     size_t index_count, mat4 model);
+
+/**
+ * RasterizeOcclusion
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Draw every queued occluder into the buffer. The buffer is split
+ * into bands of tile rows, spread over the worker pool if there are
+ * enough triangles to be worth it.
+ *
+ * @param occlusion The occlusion culler.
+ * @return void -- Nothing.
+ */
+void LetoRasterizeOcclusion(leto_occlusion_t *occlusion);
+
+/**
+ * TestOcclusion
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether any part of a box might be seen past the
+ * occluders. Boxes crossing the near plane, or entirely off screen, are
+ * always considered visible; this doesn't replace frustum culling.
+ *
+ * @param occlusion The occlusion culler.
+ * @param center The center of the box.
+ * @param extent The half-size of the box along each axis.
+ * @return bool -- True if the box may be visible, false if it's hidden.
+ */
+bool LetoTestOcclusion(const leto_occlusion_t *occlusion, vec3 center,
+                       vec3 extent);
+
+/**
+ * CullOccluded
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Remove every hidden box from a list of visible ones, as made by
+ * @ref LetoCullBounds.
+ *
+ * @param occlusion The occlusion culler.
+ * @param bounds The set the indices refer to.
+ * @param visible The indices to filter, in place. Order is kept.
+ * @param count The amount of indices.
+ * @return size_t -- The amount of indices left.
+ */
+size_t LetoCullOccluded(const leto_occlusion_t *occlusion,
+                        const leto_bounds_t *bounds, uint32_t *visible,
+                        size_t count);
+
+#endif // LETO__OCCLUSION_H
@@ -0,0 +1,182 @@
+/**
+ * @file Pyramid.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's hierarchical depth pyramid. The first level is
+ * the largest power of two that fits in the depth buffer, so each level
+ * after it is an exact halving; every texel of the first level covers
+ * all the depth texels it overlaps, which keeps the pyramid conservative.
+ * @implements Pyramid.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Pyramid.h"           // Public interface parent
+#include <Input/Shaders.h>     // Compute program loading
+#include <Rendering/Release.h> // Deferred object release
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The width and height of one of the reduction pass's work groups.
+ * This must match the shader's local size.
+ */
+#define GROUP_SIZE 8
+
+/**
+ * @brief The indices of the reduction program's uniform locations.
+ */
+#define FIRST_LEVEL_UNIFORM 0
+#define DESTINATION_SIZE_UNIFORM 1
+#define SOURCE_SIZE_UNIFORM 2
+
+/**
+ * FloorPowerOfTwo
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the largest power of two no larger than a value.
+ *
+ * @param value The value, at least one.
+ * @return int -- The power of two.
+ */
+static int FloorPowerOfTwo_(int value)
+{
+    int power = 1;
+    while (power * 2 <= value) power *= 2;
+    return power;
+}
+
+/**
+ * MakeStorage
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Remake the pyramid's textures for a depth buffer of the given
+ * size. The old ones are released, so frames still using them are safe.
+ *
+ * @param pyramid The pyramid.
+ * @param width The width of the depth buffer, in pixels.
+ * @param height The height of the depth buffer, in pixels.
+ * @return void -- Nothing.
+ */
+static void MakeStorage_(leto_depth_pyramid_t *pyramid, int width,
+                         int height)
+{
+    LetoReleaseObject(texture_object, pyramid->texture);
+    LetoReleaseObject(texture_object, pyramid->depth);
+    pyramid->depth = 0;
+
+    pyramid->source_width = width;
+    pyramid->source_height = height;
+    pyramid->width = FloorPowerOfTwo_(width);
+    pyramid->height = FloorPowerOfTwo_(height);
+
+    int largest = pyramid->width;
+    if (pyramid->height > largest) largest = pyramid->height;
+    pyramid->levels = 1;
+    while (largest > 1) largest /= 2, pyramid->levels++;
+
+    pyramid->texture = LetoAcquireTexture(GL_TEXTURE_2D, pyramid->levels,
+                                          GL_R32F, pyramid->width,
+                                          pyramid->height, 1);
+    // Only ever read with texelFetch, but the sampler state still has to
+    // make the texture complete.
+    glTextureParameteri(pyramid->texture, GL_TEXTURE_MIN_FILTER,
+                        GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(pyramid->texture, GL_TEXTURE_MAG_FILTER,
+                        GL_NEAREST);
+}
+
+bool LetoCreateDepthPyramid(leto_depth_pyramid_t *pyramid)
+{
+    if (pyramid == NULL) return false;
+    memset(pyramid, 0, sizeof(leto_depth_pyramid_t));
+
+    pyramid->program = LetoLoadComputeShader("pyramid");
+    if (pyramid->program == 0) return false;
+
+    const char *names[3] = {"first_level", "destination_size",
+                            "source_size"};
+    for (size_t i = 0; i < 3; i++)
+        pyramid->uniforms[i] =
+            glGetUniformLocation(pyramid->program, names[i]);
+    glm_mat4_identity(pyramid->view_projection);
+    return true;
+}
+
+void LetoDestroyDepthPyramid(leto_depth_pyramid_t *pyramid)
+{
+    if (pyramid == NULL) return;
+
+    LetoReleaseObject(texture_object, pyramid->texture);
+    LetoReleaseObject(texture_object, pyramid->depth);
+    if (pyramid->program != 0) LetoUnloadShader(pyramid->program);
+    memset(pyramid, 0, sizeof(leto_depth_pyramid_t));
+}
+
+void LetoBuildDepthPyramid(leto_depth_pyramid_t *pyramid,
+                           unsigned int depth_texture, int width,
+                           int height, mat4 view_projection)
+{
+    if (pyramid == NULL || pyramid->program == 0) return;
+    if (width <= 0 || height <= 0) return;
+    if (width != pyramid->source_width ||
+        height != pyramid->source_height || pyramid->texture == 0)
+        MakeStorage_(pyramid, width, height);
+
+    // The window's depth can't be sampled, so take a copy of it.
+    if (depth_texture == 0)
+    {
+        if (pyramid->depth == 0)
+        {
+            pyramid->depth = LetoAcquireTexture(
+                GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, width, height, 1);
+            glTextureParameteri(pyramid->depth, GL_TEXTURE_MIN_FILTER,
+                                GL_NEAREST);
+            glTextureParameteri(pyramid->depth, GL_TEXTURE_MAG_FILTER,
+                                GL_NEAREST);
+        }
+        glCopyTextureSubImage2D(pyramid->depth, 0, 0, 0, 0, 0, width,
+                                height);
+        depth_texture = pyramid->depth;
+    }
+
+    const unsigned int program = pyramid->program;
+    const int *uniforms = pyramid->uniforms;
+    LetoUseProgram(program);
+    LetoBindTextureUnit(0, depth_texture);
+
+    int source[2] = {width, height};
+    int destination[2] = {pyramid->width, pyramid->height};
+    for (int level = 0; level < pyramid->levels; level++)
+    {
+        glBindImageTexture(0, pyramid->texture, level, GL_FALSE, 0,
+                           GL_WRITE_ONLY, GL_R32F);
+        if (level != 0)
+            glBindImageTexture(1, pyramid->texture, level - 1, GL_FALSE,
+                               0, GL_READ_ONLY, GL_R32F);
+        glProgramUniform1i(program, uniforms[FIRST_LEVEL_UNIFORM],
+                           level == 0);
+        glProgramUniform2iv(program, uniforms[DESTINATION_SIZE_UNIFORM],
+                            1, destination);
+        glProgramUniform2iv(program, uniforms[SOURCE_SIZE_UNIFORM], 1,
+                            source);
+
+        glDispatchCompute(
+            (unsigned int)(destination[0] + GROUP_SIZE - 1) / GROUP_SIZE,
+            (unsigned int)(destination[1] + GROUP_SIZE - 1) / GROUP_SIZE,
+            1);
+        // The next level reads this one through its image.
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+        source[0] = destination[0], source[1] = destination[1];
+        if (destination[0] > 1) destination[0] /= 2;
+        if (destination[1] > 1) destination[1] /= 2;
+    }
+    // Culling reads the pyramid with texelFetch.
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    glm_mat4_copy(view_projection, pyramid->view_projection);
+}
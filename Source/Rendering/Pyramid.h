@@ -0,0 +1,109 @@
+/**
+ * @file Pyramid.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's hierarchical depth pyramid. The depth buffer is
+ * reduced by a compute pass into a mip chain where every texel holds the
+ * farthest depth beneath it, which the GPU culler tests object bounds
+ * against to skip anything hidden behind what's already been drawn.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__PYRAMID_H
+#define LETO__PYRAMID_H
+
+// GLM 4x4 matrices.
+#include <CGLM/mat4.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+
+/**
+ * @brief A depth pyramid. This struct should only be modified through
+ * the functions below.
+ */
+typedef struct leto_depth_pyramid
+{
+    /**
+     * @brief The OpenGL ID of the reduction program.
+     */
+    unsigned int program;
+    /**
+     * @brief The OpenGL ID of the pyramid; a single-channel float texture
+     * with a full mip chain.
+     */
+    unsigned int texture;
+    /**
+     * @brief The OpenGL ID of the texture the framebuffer's depth is
+     * copied into, if no depth texture is given to build from.
+     */
+    unsigned int depth;
+    /**
+     * @brief The size of the depth buffer the pyramid is built from, in
+     * pixels.
+     */
+    int source_width, source_height;
+    /**
+     * @brief The size of the pyramid's first level; the largest powers of
+     * two no larger than the depth buffer.
+     */
+    int width, height;
+    /**
+     * @brief The amount of levels of the pyramid.
+     */
+    int levels;
+    /**
+     * @brief The view-projection matrix the depth was drawn with.
+     */
+    mat4 view_projection;
+    /**
+     * @brief The locations of the reduction program's uniforms.
+     */
+    int uniforms[3];
+} leto_depth_pyramid_t;
+
+/**
+ * CreateDepthPyramid
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty depth pyramid, loading the "pyramid" compute
+ * program. Storage is made the first time it's built. This must be called
+ * after the OpenGL context is current.
+ *
+ * @param pyramid The pyramid to initialize.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateDepthPyramid(leto_depth_pyramid_t *pyramid);
+
+/**
+ * DestroyDepthPyramid
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a depth pyramid owns.
+ *
+ * @param pyramid The pyramid to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyDepthPyramid(leto_depth_pyramid_t *pyramid);
+
+/**
+ * BuildDepthPyramid
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Rebuild the pyramid from the depth drawn so far. Storage is
+ * remade whenever the depth buffer changes size.
+ *
+ * @param pyramid The pyramid.
+ * @param depth_texture The OpenGL ID of the depth texture to build from,
+ * or 0 to copy the depth of the framebuffer bound for reading, such as
+ * the window's.
+ * @param width The width of the depth buffer, in pixels.
+ * @param height The height of the depth buffer, in pixels.
+ * @param view_projection The view-projection matrix the depth was drawn
+ * with.
+ * @return void -- Nothing.
+ */
+void LetoBuildDepthPyramid(leto_depth_pyramid_t *pyramid,
+                           unsigned int depth_texture, int width,
+                           int height, mat4 view_projection);
+
+#endif // LETO__PYRAMID_H
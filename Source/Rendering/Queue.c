@@ -0,0 +1,628 @@
+/**
+ * @file Queue.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's render queue. Keys are sorted with an LSD radix
+ * sort, skipping any byte every key agrees on, so a frame's sort costs a
+ * handful of linear passes no matter how many packets there are. Draws
+ * then go out through glMultiDrawElementsIndirect, and find their data
+ * through gl_DrawID. Everything a flush sends the GPU is written into a
+ * ring buffer, so flushing never makes the driver orphan or wait.
+ * @implements Queue.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Queue.h"             // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Frame counting
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <CGLM/mat3.h> // GLM 3x3 matrices
+#include <GLAD2/gl.h>  // OpenGL function pointers
+
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The bits of a key given to the depth of a packet.
+ */
+#define DEPTH_BITS 16
+
+/**
+ * @brief The bits of a key given to the state of a packet; its program,
+ * vertex format, material, mesh, submesh, and level of detail.
+ */
+#define STATE_BITS 44
+
+// Shaders index the instance array with a 128-byte stride, and the key
+// only has room for 10 bits of material slot.
+_Static_assert(sizeof(leto_instance_t) == 128,
+               "Instance data must match the std430 layout.");
+_Static_assert(sizeof(leto_motion_t) == 64,
+               "Motion data must match the std430 layout.");
+_Static_assert(LETO_MAX_MATERIALS <= 1024,
+               "Material slots must fit in 10 bits of the sort key.");
+_Static_assert(render_pass_count <= 16,
+               "Passes must fit in 4 bits of the sort key.");
+_Static_assert(LETO_MAX_VERTEX_FORMATS <= 8,
+               "Vertex formats must fit in 3 bits of the sort key.");
+
+/**
+ * HashPointer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Mix a pointer down to 13 bits, so the allocator's alignment
+ * doesn't leave the low bits all the same.
+ *
+ * @param pointer The pointer to hash.
+ * @return uint64_t -- The hash, below 8192.
+ */
+static uint64_t HashPointer_(const void *pointer)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)pointer;
+    hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdull;
+    return (hash ^ (hash >> 33)) & 0x1FFF;
+}
+
+/**
+ * MakeKey
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Build the sort key of a packet. The pass always comes first.
+ * Opaque packets then sort by program, vertex format, material, and
+ * geometry, with depth last so instances go front to back; translucent
+ * packets must go back to front, so their depth comes before everything
+ * else.
+ *
+ * @param pass The pass of the packet.
+ * @param packet The packet.
+ * @param depth The depth of the packet, from 0 to 1.
+ * @return uint64_t -- The key.
+ */
+static uint64_t MakeKey_(leto_render_pass_t pass,
+                         const leto_render_packet_t *packet, float depth)
+{
+    if (!(depth > 0.0f)) depth = 0.0f;
+    if (depth > 1.0f) depth = 1.0f;
+    const uint64_t bucket = (uint64_t)(depth * ((1 << DEPTH_BITS) - 1));
+
+    // Program 12, format 3, material 10, mesh 13, submesh 4, level of
+    // detail 2. The format goes before the material, since runs of draws
+    // can span materials but never vertex formats.
+    const uint64_t program = packet->material->sort_key >> 52;
+    const uint64_t format = packet->mesh->geometry.format & 0x7;
+    const uint64_t geometry = (HashPointer_(packet->mesh) << 6) |
+                              ((uint64_t)(packet->submesh & 0xF) << 2) |
+                              (packet->lod & 0x3);
+    const uint64_t state = (program << 32) | (format << 29) |
+                           ((uint64_t)packet->material->slot << 19) |
+                           geometry;
+
+    const uint64_t key = (uint64_t)pass << (DEPTH_BITS + STATE_BITS);
+    if (pass == render_pass_translucent)
+        return key |
+               ((((1 << DEPTH_BITS) - 1) - bucket) << STATE_BITS) | state;
+    return key | (state << DEPTH_BITS) | bucket;
+}
+
+/**
+ * SortKeys
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Sort the queue's keys, and the packet indices alongside them,
+ * eight bits at a time from least to most significant.
+ *
+ * @param queue The queue to sort.
+ * @return void -- Nothing.
+ */
+static void SortKeys_(leto_render_queue_t *queue)
+{
+    uint64_t *keys = queue->keys;
+    uint32_t *order = queue->order;
+    uint64_t *other_keys = queue->scratch;
+    uint32_t *other_order = (uint32_t *)(other_keys + queue->capacity);
+
+    for (size_t shift = 0; shift < 64; shift += 8)
+    {
+        size_t offsets[256] = {0};
+        for (size_t i = 0; i < queue->count; i++)
+            offsets[(keys[i] >> shift) & 0xFF]++;
+        // Every key agrees on this byte; nothing would move.
+        if (offsets[(keys[0] >> shift) & 0xFF] == queue->count) continue;
+
+        size_t total = 0;
+        for (size_t b = 0; b < 256; b++)
+        {
+            const size_t bucket = offsets[b];
+            offsets[b] = total;
+            total += bucket;
+        }
+        for (size_t i = 0; i < queue->count; i++)
+        {
+            const size_t slot = offsets[(keys[i] >> shift) & 0xFF]++;
+            other_keys[slot] = keys[i];
+            other_order[slot] = order[i];
+        }
+
+        uint64_t *swap_keys = keys;
+        keys = other_keys;
+        other_keys = swap_keys;
+        uint32_t *swap_order = order;
+        order = other_order;
+        other_order = swap_order;
+    }
+
+    // An odd amount of passes leaves the result in the scratch space.
+    if (keys != queue->keys)
+    {
+        memcpy(queue->keys, keys, queue->count * sizeof(uint64_t));
+        memcpy(queue->order, order, queue->count * sizeof(uint32_t));
+    }
+}
+
+/**
+ * Reserve
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure the queue has room for the given amount of packets.
+ *
+ * @param queue The queue.
+ * @param capacity The amount of packets needed.
+ * @return bool -- True for success, false for failure.
+ */
+static bool Reserve_(leto_render_queue_t *queue, size_t capacity)
+{
+    if (capacity <= queue->capacity) return true;
+    if (capacity < queue->capacity * 2) capacity = queue->capacity * 2;
+
+    // Keep the old arrays until every new one exists, so failure leaves
+    // the queue as it was.
+    void *arrays[6] = {
+        malloc(capacity * sizeof(uint64_t)),
+        malloc(capacity * sizeof(uint32_t)),
+        malloc(capacity * (sizeof(uint64_t) + sizeof(uint32_t))),
+        malloc(capacity * sizeof(leto_render_packet_t)),
+        malloc(capacity * sizeof(leto_instance_t)),
+        malloc(capacity * sizeof(leto_render_group_t))};
+    for (size_t i = 0; i < 6; i++)
+    {
+        if (arrays[i] != NULL) continue;
+        for (size_t j = 0; j < 6; j++) free(arrays[j]);
+        LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+        return false;
+    }
+
+    if (queue->count != 0)
+    {
+        memcpy(arrays[0], queue->keys, queue->count * sizeof(uint64_t));
+        memcpy(arrays[3], queue->packets,
+               queue->count * sizeof(leto_render_packet_t));
+        memcpy(arrays[4], queue->instances,
+               queue->count * sizeof(leto_instance_t));
+    }
+    free(queue->keys);
+    free(queue->order);
+    free(queue->scratch);
+    free(queue->packets);
+    free(queue->instances);
+    free(queue->groups);
+
+    queue->keys = arrays[0];
+    queue->order = arrays[1];
+    queue->scratch = arrays[2];
+    queue->packets = arrays[3];
+    queue->instances = arrays[4];
+    queue->groups = arrays[5];
+    queue->capacity = capacity;
+    return true;
+}
+
+/**
+ * ReserveDraws
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure the queue has room for the given amount of commands
+ * and draw records, doubling them if not.
+ *
+ * @param queue The queue.
+ * @param needed The amount of entries needed.
+ * @return void -- Nothing.
+ */
+static void ReserveDraws_(leto_render_queue_t *queue, size_t needed)
+{
+    if (needed <= queue->draw_capacity) return;
+
+    size_t capacity =
+        queue->draw_capacity == 0 ? 64 : queue->draw_capacity;
+    while (capacity < needed) capacity *= 2;
+    void *commands =
+        realloc(queue->commands, capacity * sizeof(leto_draw_command_t));
+    if (commands != NULL) queue->commands = commands;
+    void *draws =
+        realloc(queue->draws, capacity * sizeof(leto_draw_data_t));
+    if (draws != NULL) queue->draws = draws;
+    if (commands == NULL || draws == NULL)
+    {
+        LetoReportError(true, failed_allocation, LETO_FILE_CONTEXT);
+        return;
+    }
+    queue->draw_capacity = capacity;
+}
+
+/**
+ * SameBatch
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether two packets can be drawn by the same instanced
+ * draw. Keys aren't enough, since the mesh only gets a hash of itself.
+ *
+ * @param first The first packet.
+ * @param second The second packet.
+ * @return bool -- True if the packets draw the same thing.
+ */
+static bool SameBatch_(const leto_render_packet_t *first,
+                       const leto_render_packet_t *second)
+{
+    return first->material == second->material &&
+           first->mesh == second->mesh &&
+           first->submesh == second->submesh && first->lod == second->lod;
+}
+
+/**
+ * SameGroup
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether two packets can be drawn by the same multi-draw
+ * call; that is, whether they share a shader, textures, and vertex format.
+ * Material parameters are fetched per draw, so those may differ.
+ *
+ * @param first The first packet.
+ * @param second The second packet.
+ * @return bool -- True if the packets can share a call.
+ */
+static bool SameGroup_(const leto_render_packet_t *first,
+                       const leto_render_packet_t *second)
+{
+    return first->material->shader == second->material->shader &&
+           memcmp(first->material->textures, second->material->textures,
+                  sizeof(first->material->textures)) == 0 &&
+           first->mesh->geometry.format == second->mesh->geometry.format;
+}
+
+/**
+ * BuildDraws
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Turn the sorted packets into indirect commands, draw records,
+ * and the runs of them sharing a call. Every run starts on a draw record
+ * the storage buffer can be bound at, since gl_DrawID restarts at zero
+ * with every call.
+ *
+ * @param queue The queue.
+ * @param count Filled in with the amount of entries written, padding
+ * included.
+ * @return size_t -- The amount of runs.
+ */
+static size_t BuildDraws_(leto_render_queue_t *queue, size_t *count)
+{
+    size_t group_count = 0, draw_count = 0;
+    leto_render_group_t *group = NULL;
+    for (size_t first = 0; first < queue->count;)
+    {
+        const leto_render_packet_t *packet =
+            &queue->packets[queue->order[first]];
+        size_t last = first + 1;
+        while (last < queue->count &&
+               SameBatch_(packet, &queue->packets[queue->order[last]]))
+            last++;
+
+        leto_draw_command_t command;
+        if (!LetoGetSubmeshCommand(packet->mesh, packet->submesh,
+                                   packet->lod, &command))
+        {
+            first = last;
+            continue;
+        }
+
+        if (group == NULL || !SameGroup_(group->packet, packet))
+        {
+            const size_t alignment = queue->draw_alignment;
+            draw_count =
+                (draw_count + alignment - 1) / alignment * alignment;
+            group = &queue->groups[group_count++];
+            *group = (leto_render_group_t){.packet = packet,
+                                           .first = (uint32_t)draw_count};
+        }
+
+        ReserveDraws_(queue, draw_count + 1);
+        command.instance_count = (uint32_t)(last - first);
+        command.base_instance = (uint32_t)first;
+        queue->commands[draw_count] = command;
+        queue->draws[draw_count] = (leto_draw_data_t){
+            .first_instance = (uint32_t)first,
+            .instance_count = (uint32_t)(last - first),
+            .material = packet->material->slot};
+        draw_count++;
+        group->count++;
+        first = last;
+    }
+
+    *count = draw_count;
+    if (group_count == 0) return 0;
+    // Padding is never drawn, but it is uploaded, so it mustn't be
+    // garbage.
+    for (size_t g = 1; g < group_count; g++)
+    {
+        const leto_render_group_t *previous = &queue->groups[g - 1];
+        for (size_t i = previous->first + previous->count;
+             i < queue->groups[g].first; i++)
+        {
+            queue->commands[i] = (leto_draw_command_t){0};
+            queue->draws[i] = (leto_draw_data_t){0};
+        }
+    }
+
+    return group_count;
+}
+
+bool LetoCreateRenderQueue(leto_render_queue_t *queue, size_t capacity)
+{
+    if (queue == NULL) return false;
+    memset(queue, 0, sizeof(leto_render_queue_t));
+    if (!Reserve_(queue, capacity < 64 ? 64 : capacity)) return false;
+    ReserveDraws_(queue, queue->capacity);
+
+    // Runs of draws bind their records at multiples of this.
+    int alignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    queue->draw_alignment =
+        ((size_t)alignment + sizeof(leto_draw_data_t) - 1) /
+        sizeof(leto_draw_data_t);
+    if (queue->draw_alignment == 0) queue->draw_alignment = 1;
+
+    // Room for a frame of instances, draw records, and commands, at one
+    // draw per packet.
+    const size_t frame_size =
+        queue->capacity * (sizeof(leto_instance_t) +
+                           sizeof(leto_draw_data_t) +
+                           sizeof(leto_draw_command_t));
+    if (!LetoCreateRingBuffer(&queue->ring, frame_size))
+    {
+        LetoDestroyRenderQueue(queue);
+        return false;
+    }
+    return true;
+}
+
+void LetoDestroyRenderQueue(leto_render_queue_t *queue)
+{
+    if (queue == NULL) return;
+
+    LetoDestroyRingBuffer(&queue->ring);
+    free(queue->keys);
+    free(queue->order);
+    free(queue->scratch);
+    free(queue->packets);
+    free(queue->instances);
+    free(queue->motions);
+    free(queue->groups);
+    free(queue->commands);
+    free(queue->draws);
+    memset(queue, 0, sizeof(leto_render_queue_t));
+}
+
+void LetoSubmitDraw(leto_render_queue_t *queue, leto_render_pass_t pass,
+                    const leto_material_t *material,
+                    const leto_mesh_t *mesh, size_t submesh, size_t lod,
+                    mat4 model, float depth)
+{
+    if (queue == NULL || material == NULL || mesh == NULL) return;
+    if (pass >= render_pass_count) return;
+    if (!Reserve_(queue, queue->count + 1)) return;
+
+    const size_t index = queue->count++;
+    leto_render_packet_t *packet = &queue->packets[index];
+    *packet = (leto_render_packet_t){.material = material,
+                                     .mesh = mesh,
+                                     .submesh = (uint16_t)submesh,
+                                     .lod = (uint16_t)lod};
+    queue->keys[index] = MakeKey_(pass, packet, depth);
+
+    leto_instance_t *instance = &queue->instances[index];
+    LetoSetInstanceTransform(instance, mesh, model);
+    instance->material = material->slot;
+    instance->motion = 0;
+}
+
+void LetoSetInstanceTransform(leto_instance_t *instance,
+                              const leto_mesh_t *mesh, mat4 model)
+{
+    mat4 world;
+    glm_mat4_mul(model, (vec4 *)mesh->dequantize, world);
+    memcpy(instance->model, world, sizeof(instance->model));
+
+    mat3 normal;
+    glm_mat4_pick3(model, normal);
+    glm_mat3_inv(normal, normal);
+    glm_mat3_transpose(normal);
+    for (size_t i = 0; i < 3; i++)
+        glm_vec4(normal[i], 0.0f, instance->normal[i]);
+}
+
+void LetoSubmitMovingDraw(leto_render_queue_t *queue,
+                          leto_render_pass_t pass,
+                          const leto_material_t *material,
+                          const leto_mesh_t *mesh, size_t submesh,
+                          size_t lod, mat4 model, mat4 previous,
+                          float depth)
+{
+    if (queue == NULL) return;
+    const size_t count = queue->count;
+    LetoSubmitDraw(queue, pass, material, mesh, submesh, lod, model,
+                   depth);
+    if (queue->count == count) return;
+
+    if (queue->motion_count == queue->motion_capacity)
+    {
+        size_t capacity = queue->motion_capacity * 2;
+        if (capacity < 64) capacity = 64;
+        leto_motion_t *motions =
+            realloc(queue->motions, capacity * sizeof(leto_motion_t));
+        // Without room, the draw just goes without its motion.
+        if (motions == NULL)
+        {
+            LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+            return;
+        }
+        queue->motions = motions;
+        queue->motion_capacity = capacity;
+    }
+
+    mat4 world;
+    glm_mat4_mul(previous, (vec4 *)mesh->dequantize, world);
+    memcpy(queue->motions[queue->motion_count].model, world,
+           sizeof(world));
+    queue->instances[count].motion = (uint32_t)++queue->motion_count;
+}
+
+size_t LetoFlushRenderQueue(leto_render_queue_t *queue,
+                            leto_program_function_t function,
+                            void *argument)
+{
+    if (queue == NULL || queue->count == 0) return 0;
+
+    for (size_t i = 0; i < queue->count; i++)
+        queue->order[i] = (uint32_t)i;
+    SortKeys_(queue);
+    size_t draw_count = 0;
+    const size_t groups = BuildDraws_(queue, &draw_count);
+
+    // Last frame's draws have all been submitted; fence them, and take
+    // this flush's instances, draw records, and commands from the next
+    // region in one piece. Passes like shadows flush several times a
+    // frame, and share the frame's region. Instances are gathered
+    // straight into it in draw order.
+    if (queue->frame != LetoGetFrame())
+        LetoAdvanceRingBuffer(&queue->ring);
+    queue->frame = LetoGetFrame();
+    const size_t align = queue->ring.alignment;
+    const size_t size = queue->count * sizeof(leto_instance_t);
+    const size_t draws = (size + align - 1) / align * align;
+    const size_t commands =
+        draws + (draw_count * sizeof(leto_draw_data_t) + align - 1) /
+                    align * align;
+    const size_t motions =
+        commands + (draw_count * sizeof(leto_draw_command_t) + align -
+                    1) / align * align;
+    const size_t motion_size = queue->motion_count * sizeof(leto_motion_t);
+    leto_ring_allocation_t frame;
+    if (!LetoAllocateRing(&queue->ring, motions + motion_size, &frame))
+    {
+        queue->count = queue->motion_count = 0;
+        return 0;
+    }
+
+    unsigned char *data = frame.data;
+    leto_instance_t *sorted = (leto_instance_t *)data;
+    for (size_t i = 0; i < queue->count; i++)
+        sorted[i] = queue->instances[queue->order[i]];
+    memcpy(data + draws, queue->draws,
+           draw_count * sizeof(leto_draw_data_t));
+    memcpy(data + commands, queue->commands,
+           draw_count * sizeof(leto_draw_command_t));
+
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_INSTANCE_BINDING,
+                        frame.buffer, frame.offset, (ptrdiff_t)size);
+    if (motion_size != 0)
+    {
+        memcpy(data + motions, queue->motions, motion_size);
+        LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER, LETO_MOTION_BINDING,
+                            frame.buffer,
+                            frame.offset + (ptrdiff_t)motions,
+                            (ptrdiff_t)motion_size);
+    }
+    LetoBindBuffer(GL_DRAW_INDIRECT_BUFFER, frame.buffer);
+
+    unsigned int program = 0;
+    for (size_t g = 0; g < groups; g++)
+    {
+        const leto_render_group_t *group = &queue->groups[g];
+        unsigned int bound = LetoBindMaterial(group->packet->material);
+        if (bound != program && function != NULL)
+            function(bound, argument);
+        program = bound;
+
+        LetoBindGeometry(group->packet->mesh->geometry.format);
+        LetoBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER, LETO_DRAW_BINDING,
+            frame.buffer,
+            frame.offset + (ptrdiff_t)draws +
+                (ptrdiff_t)(group->first * sizeof(leto_draw_data_t)),
+            (ptrdiff_t)(group->count * sizeof(leto_draw_data_t)));
+        const size_t command =
+            (size_t)frame.offset + commands +
+            group->first * sizeof(leto_draw_command_t);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    (const void *)command,
+                                    (int)group->count, 0);
+    }
+
+    queue->count = queue->motion_count = 0;
+    return groups;
+}
+
+size_t LetoRecordRenderQueue(leto_render_queue_t *queue,
+                             leto_command_buffer_t *buffer,
+                             leto_program_function_t function,
+                             void *argument)
+{
+    if (queue == NULL || buffer == NULL || queue->count == 0) return 0;
+
+    for (size_t i = 0; i < queue->count; i++)
+        queue->order[i] = (uint32_t)i;
+    SortKeys_(queue);
+    size_t draw_count = 0;
+    const size_t groups = BuildDraws_(queue, &draw_count);
+
+    // Instances are gathered straight into the buffer in draw order; each
+    // run's records and commands follow its binds.
+    leto_instance_t *sorted = LetoRecordBindData(
+        buffer, GL_SHADER_STORAGE_BUFFER, LETO_INSTANCE_BINDING,
+        queue->count * sizeof(leto_instance_t));
+    if (sorted == NULL)
+    {
+        queue->count = queue->motion_count = 0;
+        return 0;
+    }
+    for (size_t i = 0; i < queue->count; i++)
+        sorted[i] = queue->instances[queue->order[i]];
+    // Motion slots aren't sorted, so they go as they are.
+    if (queue->motion_count != 0)
+    {
+        void *motions = LetoRecordBindData(
+            buffer, GL_SHADER_STORAGE_BUFFER, LETO_MOTION_BINDING,
+            queue->motion_count * sizeof(leto_motion_t));
+        if (motions != NULL)
+            memcpy(motions, queue->motions,
+                   queue->motion_count * sizeof(leto_motion_t));
+    }
+
+    for (size_t g = 0; g < groups; g++)
+    {
+        const leto_render_group_t *group = &queue->groups[g];
+        LetoRecordBindMaterial(buffer, group->packet->material, function,
+                               argument);
+        LetoRecordBindGeometry(buffer,
+                               group->packet->mesh->geometry.format);
+
+        void *draws = LetoRecordBindData(
+            buffer, GL_SHADER_STORAGE_BUFFER, LETO_DRAW_BINDING,
+            group->count * sizeof(leto_draw_data_t));
+        if (draws != NULL)
+            memcpy(draws, &queue->draws[group->first],
+                   group->count * sizeof(leto_draw_data_t));
+        leto_draw_command_t *commands =
+            LetoRecordDrawIndirect(buffer, group->count);
+        if (commands != NULL)
+            memcpy(commands, &queue->commands[group->first],
+                   group->count * sizeof(leto_draw_command_t));
+    }
+
+    queue->count = queue->motion_count = 0;
+    return groups;
+}
@@ -0,0 +1,353 @@
+/**
+ * @file Queue.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's render queue. Anything that wants to draw
+ * submits a packet, and once a frame the queue sorts every packet by a
+ * 64-bit key, merges packets drawing the same thing into instanced draws,
+ * and submits runs of draws sharing a program, textures, and vertex format
+ * with a single multi-draw indirect call.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__QUEUE_H
+#define LETO__QUEUE_H
+
+// The engine's mesh interface.
+#include <Input/Meshes.h>
+// The engine's command buffers.
+#include <Rendering/Commands.h>
+// The engine's material interface.
+#include <Rendering/Materials.h>
+// The engine's ring buffers.
+#include <Rendering/Ring.h>
+
+/**
+ * @brief The shader storage binding point the instance buffer is bound
+ * to. Shaders declare the block with "layout(std430, binding = 2)", and
+ * find their instance at their draw's first instance plus gl_InstanceID.
+ */
+#define LETO_INSTANCE_BINDING 2
+
+/**
+ * @brief The shader storage binding point the motion buffer is bound to;
+ * "layout(std430, binding = 12)". An instance whose motion slot isn't
+ * zero finds last frame's model matrix one before that slot.
+ */
+#define LETO_MOTION_BINDING 12
+
+/**
+ * @brief The passes a packet can be drawn in, in the order they're drawn.
+ */
+typedef enum leto_render_pass
+{
+    /**
+     * @brief Opaque geometry, sorted by state and then front to back.
+     */
+    render_pass_opaque,
+    /**
+     * @brief Blended geometry, sorted back to front and then by state.
+     */
+    render_pass_translucent,
+    render_pass_count
+} leto_render_pass_t;
+
+/**
+ * @brief The data of a single instance as shaders see it. This is laid
+ * out to match std430, and is exactly 128 bytes long.
+ */
+typedef struct leto_instance
+{
+    /**
+     * @brief The object-to-world matrix of the instance, with its mesh's
+     * dequantization already applied. This isn't a mat4, since AVX builds
+     * align those to 32 bytes, which would pad the struct.
+     */
+    vec4 model[4];
+    /**
+     * @brief The inverse transpose of the object-to-world matrix, without
+     * the dequantization, for normals; a std430 mat3, so each column is
+     * padded to a vec4. Dequantization scales each axis by the mesh's
+     * extent, which would skew normals, and flatten them on a flat mesh.
+     */
+    vec4 normal[3];
+    /**
+     * @brief The material slot of the instance. Draws carry this as well;
+     * it's here for passes that see instances without their draw.
+     */
+    uint32_t material;
+    /**
+     * @brief One past the instance's slot in the motion buffer, or zero
+     * if it hasn't moved since last frame.
+     */
+    uint32_t motion;
+    /**
+     * @brief Padding to a 16-byte multiple.
+     */
+    uint32_t _[2];
+} leto_instance_t;
+
+/**
+ * @brief Last frame's object-to-world matrix of a moving instance, with
+ * its mesh's dequantization applied.
+ */
+typedef struct leto_motion
+{
+    /**
+     * @brief The matrix, as in @ref leto_instance_t.
+     */
+    vec4 model[4];
+} leto_motion_t;
+
+/**
+ * @brief A single draw submitted to the queue.
+ */
+typedef struct leto_render_packet
+{
+    /**
+     * @brief The material to draw with.
+     */
+    const leto_material_t *material;
+    /**
+     * @brief The mesh to draw.
+     */
+    const leto_mesh_t *mesh;
+    /**
+     * @brief The submesh of the mesh to draw.
+     */
+    uint16_t submesh;
+    /**
+     * @brief The level of detail of the submesh to draw.
+     */
+    uint16_t lod;
+} leto_render_packet_t;
+
+/**
+ * @brief A run of draws submitted with one multi-draw indirect call.
+ */
+typedef struct leto_render_group
+{
+    /**
+     * @brief The first packet of the run, whose material and vertex
+     * format every draw of the run shares.
+     */
+    const leto_render_packet_t *packet;
+    /**
+     * @brief The index of the run's first command and draw record.
+     */
+    uint32_t first;
+    /**
+     * @brief The amount of draws in the run.
+     */
+    uint32_t count;
+} leto_render_group_t;
+
+/**
+ * @brief A render queue. This struct should only be modified through the
+ * functions below.
+ */
+typedef struct leto_render_queue
+{
+    /**
+     * @brief The sort key of every packet.
+     */
+    uint64_t *keys;
+    /**
+     * @brief The index of every packet, sorted along with @ref keys.
+     */
+    uint32_t *order;
+    /**
+     * @brief Scratch space for sorting; as large as @ref keys and @ref
+     * order together.
+     */
+    void *scratch;
+    /**
+     * @brief Every packet, in the order it was submitted.
+     */
+    leto_render_packet_t *packets;
+    /**
+     * @brief The instance data of every packet, in the order it was
+     * submitted.
+     */
+    leto_instance_t *instances;
+    /**
+     * @brief The previous matrices of the packets submitted as moving,
+     * the amount of them, and the amount there's room for.
+     */
+    leto_motion_t *motions;
+    size_t motion_count, motion_capacity;
+    /**
+     * @brief The runs of draws made by the last flush.
+     */
+    leto_render_group_t *groups;
+    /**
+     * @brief The indirect command of every draw. Each run starts on an
+     * index aligned for @ref draws, so some entries are padding.
+     */
+    leto_draw_command_t *commands;
+    /**
+     * @brief The per-draw data of every draw, parallel to @ref commands.
+     */
+    leto_draw_data_t *draws;
+    /**
+     * @brief The amount of entries @ref commands and @ref draws have room
+     * for.
+     */
+    size_t draw_capacity;
+    /**
+     * @brief The alignment of a storage buffer binding, in draw records.
+     */
+    size_t draw_alignment;
+    /**
+     * @brief The amount of packets submitted this frame.
+     */
+    size_t count;
+    /**
+     * @brief The amount of packets the queue has room for.
+     */
+    size_t capacity;
+    /**
+     * @brief The ring each flush's instances, draw records, and indirect
+     * commands are written into.
+     */
+    leto_ring_buffer_t ring;
+    /**
+     * @brief The frame the ring was last moved on in.
+     */
+    uint64_t frame;
+} leto_render_queue_t;
+
+/**
+ * CreateRenderQueue
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty render queue. This must be called after the
+ * OpenGL context is current.
+ *
+ * @param queue The queue to initialize.
+ * @param capacity The amount of packets to make room for up front. The
+ * queue grows past this if it has to.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateRenderQueue(leto_render_queue_t *queue, size_t capacity);
+
+/**
+ * DestroyRenderQueue
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a render queue owns.
+ *
+ * @param queue The queue to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyRenderQueue(leto_render_queue_t *queue);
+
+/**
+ * SubmitDraw
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Submit a submesh to be drawn this frame.
+ *
+ * @param queue The queue to submit to.
+ * @param pass The pass to draw in.
+ * @param material The material to draw with. This must stay valid until
+ * the queue is flushed.
+ * @param mesh The mesh to draw. This must stay valid until the queue is
+ * flushed.
+ * @param submesh The submesh to draw.
+ * @param lod The level of detail to draw.
+ * @param model The object-to-world matrix, without the mesh's
+ * dequantization.
+ * @param depth The distance of the draw from the camera, over the
+ * distance of the far plane; from 0 to 1.
+ * @return void -- Nothing.
+ */
+void LetoSubmitDraw(leto_render_queue_t *queue, leto_render_pass_t pass,
+                    const leto_material_t *material,
+                    const leto_mesh_t *mesh, size_t submesh, size_t lod,
+                    mat4 model, float depth);
+
+/**
+ * SetInstanceTransform
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fill in an instance's model and normal matrices. Anything that
+ * writes instances itself should go through this.
+ *
+ * @param instance The instance.
+ * @param mesh The mesh the instance draws.
+ * @param model The object-to-world matrix, without the mesh's
+ * dequantization.
+ * @return void -- Nothing.
+ */
+void LetoSetInstanceTransform(leto_instance_t *instance,
+                              const leto_mesh_t *mesh, mat4 model);
+
+/**
+ * SubmitMovingDraw
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Submit a submesh to be drawn this frame, along with where it was
+ * last frame, so its motion can be found. Anything that hasn't moved is
+ * better off going through @ref LetoSubmitDraw.
+ *
+ * @param queue The queue to submit to.
+ * @param pass The pass to draw in.
+ * @param material The material to draw with. This must stay valid until
+ * the queue is flushed.
+ * @param mesh The mesh to draw. This must stay valid until the queue is
+ * flushed.
+ * @param submesh The submesh to draw.
+ * @param lod The level of detail to draw.
+ * @param model The object-to-world matrix, without the mesh's
+ * dequantization.
+ * @param previous Last frame's object-to-world matrix, the same way.
+ * @param depth The distance of the draw from the camera, over the
+ * distance of the far plane; from 0 to 1.
+ * @return void -- Nothing.
+ */
+void LetoSubmitMovingDraw(leto_render_queue_t *queue,
+                          leto_render_pass_t pass,
+                          const leto_material_t *material,
+                          const leto_mesh_t *mesh, size_t submesh,
+                          size_t lod, mat4 model, mat4 previous,
+                          float depth);
+
+/**
+ * FlushRenderQueue
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Sort every packet submitted since the last flush, upload their
+ * instance data, and draw them; one instanced draw per run of packets
+ * sharing a material, mesh, submesh, and level of detail, and one
+ * multi-draw indirect call per run of those draws sharing a program,
+ * textures, and vertex format. The queue is empty afterwards.
+ *
+ * @param queue The queue to flush.
+ * @param function Called whenever the program in use changes. This may
+ * be NULL.
+ * @param argument The argument passed to @ref function.
+ * @return size_t -- The amount of multi-draw calls made.
+ */
+size_t LetoFlushRenderQueue(leto_render_queue_t *queue,
+                            leto_program_function_t function,
+                            void *argument);
+
+/**
+ * RecordRenderQueue
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Sort and batch the queue as @ref LetoFlushRenderQueue does, but
+ * record the draws into a command buffer instead of making them. This
+ * makes no OpenGL calls, so any thread owning both the queue and the
+ * buffer can call it. The queue is empty afterwards.
+ *
+ * @param queue The queue to record.
+ * @param buffer The command buffer to record into.
+ * @param function Called on replay whenever the program in use changes.
+ * This may be NULL.
+ * @param argument The argument passed to @ref function.
+ * @return size_t -- The amount of multi-draw calls recorded.
+ */
+size_t LetoRecordRenderQueue(leto_render_queue_t *queue,
+                             leto_command_buffer_t *buffer,
+                             leto_program_function_t function,
+                             void *argument);
+
+#endif // LETO__QUEUE_H
@@ -0,0 +1,476 @@
+/**
+ * @file Release.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's deferred release of OpenGL objects. Released
+ * objects are stamped with the frame they were released in; frames end
+ * with a fence, and fences are polled, never waited on, so an object
+ * lingers only as long as the GPU is actually behind.
+ * @implements Release.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Release.h"       // Public interface parent
+#include <Output/Errors.h> // Error reporting
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <stdint.h> // Standard fixed-width integers
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief A released object, along with the shape of its storage if it
+ * can be pooled.
+ */
+typedef struct release_object
+{
+    /**
+     * @brief The kind of object.
+     */
+    leto_state_object_t type;
+    /**
+     * @brief The OpenGL ID of the object.
+     */
+    unsigned int id;
+    /**
+     * @brief The frame the object was released or pooled in.
+     */
+    uint64_t frame;
+    /**
+     * @brief Whether the object was handed out by an acquire function,
+     * and so has a known shape and can be pooled.
+     */
+    bool poolable;
+    /**
+     * @brief The storage flags of a buffer, or the target of a texture.
+     */
+    unsigned int kind;
+    /**
+     * @brief The size of a buffer in bytes, or the sized internal format
+     * of a texture.
+     */
+    size_t size;
+    /**
+     * @brief The mip levels, width, height, and depth of a texture.
+     */
+    int extent[4];
+} release_object_t;
+
+/**
+ * @brief The fence placed at the end of a frame that released anything.
+ */
+typedef struct release_fence
+{
+    /**
+     * @brief The fence.
+     */
+    void *fence;
+    /**
+     * @brief The frame the fence ends.
+     */
+    uint64_t frame;
+} release_fence_t;
+
+/**
+ * @brief The state of the release queue. There is only ever one.
+ */
+static struct
+{
+    /**
+     * @brief Whether the queue is initialized.
+     */
+    bool ready;
+    /**
+     * @brief The current frame.
+     */
+    uint64_t frame;
+    /**
+     * @brief The last frame the GPU is known to have finished.
+     */
+    uint64_t finished;
+    /**
+     * @brief Every released object not yet let go of, oldest first.
+     */
+    release_object_t *pending;
+    /**
+     * @brief The amount of objects in @ref pending.
+     */
+    size_t pending_count;
+    /**
+     * @brief The amount of objects @ref pending has room for.
+     */
+    size_t pending_capacity;
+    /**
+     * @brief The fences of the frames still pending, oldest first,
+     * starting at @ref fence_first.
+     */
+    release_fence_t fences[LETO_RELEASE_FRAMES];
+    /**
+     * @brief The index of the oldest fence.
+     */
+    size_t fence_first;
+    /**
+     * @brief The amount of fences.
+     */
+    size_t fence_count;
+    /**
+     * @brief The reuse pool, least recently pooled first.
+     */
+    release_object_t pool[LETO_RELEASE_POOL_SIZE];
+    /**
+     * @brief The amount of objects in the pool.
+     */
+    size_t pool_count;
+    /**
+     * @brief The shape of every object handed out by an acquire function
+     * and not yet released, the amount of them, and the amount there's
+     * room for.
+     */
+    release_object_t *acquired;
+    size_t acquired_count, acquired_capacity;
+} releases;
+
+/**
+ * DeleteObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Delete an object for real.
+ *
+ * @param type The kind of object.
+ * @param id The OpenGL ID of the object.
+ * @return void -- Nothing.
+ */
+static void DeleteObject_(leto_state_object_t type, unsigned int id)
+{
+    LetoForgetStateObject(type, id);
+    switch (type)
+    {
+        case program_object:      glDeleteProgram(id); break;
+        case vertex_array_object: glDeleteVertexArrays(1, &id); break;
+        case buffer_object:       glDeleteBuffers(1, &id); break;
+        case texture_object:      glDeleteTextures(1, &id); break;
+    }
+}
+
+/**
+ * Record
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Remember the storage shape of an object just handed out, so it
+ * can be pooled once released without asking the driver what it is.
+ *
+ * @param shape The shape of the object, with its ID set.
+ * @return void -- Nothing.
+ */
+static void Record_(const release_object_t *shape)
+{
+    if (releases.acquired_count == releases.acquired_capacity)
+    {
+        size_t capacity = releases.acquired_capacity == 0
+                              ? 64
+                              : releases.acquired_capacity * 2;
+        void *acquired = realloc(releases.acquired,
+                                 capacity * sizeof(release_object_t));
+        if (acquired == NULL)
+        {
+            LetoReportError(true, failed_allocation, LETO_FILE_CONTEXT);
+            return;
+        }
+        releases.acquired = acquired;
+        releases.acquired_capacity = capacity;
+    }
+    releases.acquired[releases.acquired_count++] = *shape;
+}
+
+/**
+ * Recall
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fill in the storage shape of a released object from the record
+ * made when it was handed out, forgetting the record.
+ *
+ * @param object The object, whose type and ID are already set.
+ * @return bool -- True if the object was handed out by an acquire
+ * function, and so can be pooled; false if not.
+ */
+static bool Recall_(release_object_t *object)
+{
+    for (size_t i = 0; i < releases.acquired_count; i++)
+    {
+        const release_object_t *record = &releases.acquired[i];
+        if (record->type != object->type || record->id != object->id)
+            continue;
+
+        object->kind = record->kind;
+        object->size = record->size;
+        memcpy(object->extent, record->extent, sizeof(object->extent));
+        releases.acquired[i] =
+            releases.acquired[--releases.acquired_count];
+        return true;
+    }
+    return false;
+}
+
+/**
+ * ResetTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Put a pooled texture's sampling parameters back to OpenGL's
+ * defaults, so it samples like a freshly created one.
+ *
+ * @param texture The OpenGL ID of the texture.
+ * @return void -- Nothing.
+ */
+static void ResetTexture_(unsigned int texture)
+{
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER,
+                        GL_NEAREST_MIPMAP_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+    glTextureParameteri(texture, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+}
+
+/**
+ * Pool
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Put an object the GPU is done with into the reuse pool, making
+ * room by deleting the least recently pooled object if need be.
+ *
+ * @param object The object.
+ * @return void -- Nothing.
+ */
+static void Pool_(const release_object_t *object)
+{
+    if (releases.pool_count == LETO_RELEASE_POOL_SIZE)
+    {
+        DeleteObject_(releases.pool[0].type, releases.pool[0].id);
+        memmove(&releases.pool[0], &releases.pool[1],
+                (--releases.pool_count) * sizeof(release_object_t));
+    }
+
+    release_object_t *pooled = &releases.pool[releases.pool_count++];
+    *pooled = *object;
+    pooled->frame = releases.frame;
+}
+
+/**
+ * TakePooled
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take the most recently pooled object matching the given shape
+ * out of the pool.
+ *
+ * @param shape The shape to look for.
+ * @return unsigned int -- The OpenGL ID of the object, or 0 if none
+ * matched.
+ */
+static unsigned int TakePooled_(const release_object_t *shape)
+{
+    for (size_t i = releases.pool_count; i-- > 0;)
+    {
+        const release_object_t *pooled = &releases.pool[i];
+        if (pooled->type != shape->type || pooled->kind != shape->kind ||
+            pooled->size != shape->size ||
+            memcmp(pooled->extent, shape->extent, sizeof(shape->extent)) !=
+                0)
+            continue;
+
+        unsigned int id = pooled->id;
+        memmove(&releases.pool[i], &releases.pool[i + 1],
+                (--releases.pool_count - i) * sizeof(release_object_t));
+        return id;
+    }
+    return 0;
+}
+
+/**
+ * PollFences
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move the finished frame past every fence the GPU has passed,
+ * oldest first, stopping at the first it hasn't.
+ *
+ * @param wait Whether to wait for the oldest fence, rather than only
+ * check it.
+ * @return void -- Nothing.
+ */
+static void PollFences_(bool wait)
+{
+    while (releases.fence_count != 0)
+    {
+        release_fence_t *oldest = &releases.fences[releases.fence_first];
+        if (!LetoWaitFence(&oldest->fence, wait)) return;
+
+        releases.finished = oldest->frame;
+        releases.fence_first =
+            (releases.fence_first + 1) % LETO_RELEASE_FRAMES;
+        releases.fence_count--;
+        wait = false;
+    }
+}
+
+bool LetoInitReleases(void)
+{
+    memset(&releases, 0, sizeof(releases));
+    // Frame zero is "finished" before anything has been released.
+    releases.frame = 1;
+    releases.ready = true;
+    return true;
+}
+
+void LetoTerminateReleases(void)
+{
+    if (!releases.ready) return;
+
+    for (size_t i = 0; i < releases.fence_count; i++)
+        glDeleteSync(
+            releases.fences[(releases.fence_first + i) %
+                            LETO_RELEASE_FRAMES]
+                .fence);
+    for (size_t i = 0; i < releases.pending_count; i++)
+        DeleteObject_(releases.pending[i].type, releases.pending[i].id);
+    for (size_t i = 0; i < releases.pool_count; i++)
+        DeleteObject_(releases.pool[i].type, releases.pool[i].id);
+
+    free(releases.pending);
+    free(releases.acquired);
+    memset(&releases, 0, sizeof(releases));
+}
+
+void LetoReleaseObject(leto_state_object_t type, unsigned int id)
+{
+    if (id == 0) return;
+    if (!releases.ready)
+    {
+        Recall_(&(release_object_t){.type = type, .id = id});
+        DeleteObject_(type, id);
+        return;
+    }
+
+    if (releases.pending_count == releases.pending_capacity)
+    {
+        size_t capacity = releases.pending_capacity == 0
+                              ? 64
+                              : releases.pending_capacity * 2;
+        void *pending = realloc(releases.pending,
+                                capacity * sizeof(release_object_t));
+        if (pending == NULL)
+        {
+            LetoReportError(true, failed_allocation, LETO_FILE_CONTEXT);
+            return;
+        }
+        releases.pending = pending;
+        releases.pending_capacity = capacity;
+    }
+
+    release_object_t *object = &releases.pending[releases.pending_count++];
+    *object = (release_object_t){
+        .type = type, .id = id, .frame = releases.frame};
+    object->poolable = Recall_(object);
+}
+
+void LetoAdvanceReleases(void)
+{
+    if (!releases.ready) return;
+
+    // Only frames that released something need a fence.
+    if (releases.pending_count != 0 &&
+        releases.pending[releases.pending_count - 1].frame ==
+            releases.frame)
+    {
+        if (releases.fence_count == LETO_RELEASE_FRAMES) PollFences_(true);
+        size_t index = (releases.fence_first + releases.fence_count++) %
+                       LETO_RELEASE_FRAMES;
+        releases.fences[index] = (release_fence_t){
+            .fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+            .frame = releases.frame};
+    }
+    PollFences_(false);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < releases.pending_count; i++)
+    {
+        const release_object_t *object = &releases.pending[i];
+        if (object->frame > releases.finished)
+            releases.pending[kept++] = *object;
+        else if (object->poolable) Pool_(object);
+        else DeleteObject_(object->type, object->id);
+    }
+    releases.pending_count = kept;
+
+    // Objects nobody has asked for in a while aren't coming back.
+    size_t stale = 0;
+    while (stale < releases.pool_count &&
+           releases.frame - releases.pool[stale].frame >
+               LETO_RELEASE_POOL_FRAMES)
+    {
+        DeleteObject_(releases.pool[stale].type, releases.pool[stale].id);
+        stale++;
+    }
+    releases.pool_count -= stale;
+    memmove(&releases.pool[0], &releases.pool[stale],
+            releases.pool_count * sizeof(release_object_t));
+
+    releases.frame++;
+}
+
+uint64_t LetoGetFrame(void) { return releases.frame; }
+
+bool LetoWaitFence(void **fence, bool wait)
+{
+    if (fence == NULL || *fence == NULL) return true;
+
+    GLenum status = glClientWaitSync(*fence, 0, 0);
+    // Wait in one-second steps; anything other than a timeout means we're
+    // done waiting, one way or another.
+    while (wait && status == GL_TIMEOUT_EXPIRED)
+        status = glClientWaitSync(*fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                  1000000000);
+    if (status == GL_TIMEOUT_EXPIRED) return false;
+
+    glDeleteSync(*fence);
+    *fence = NULL;
+    return true;
+}
+
+unsigned int LetoAcquireBuffer(size_t size, unsigned int flags)
+{
+    release_object_t shape = {
+        .type = buffer_object, .kind = flags, .size = size};
+    shape.id = TakePooled_(&shape);
+    if (shape.id == 0)
+    {
+        glCreateBuffers(1, &shape.id);
+        glNamedBufferStorage(shape.id, (GLsizeiptr)size, NULL, flags);
+    }
+    Record_(&shape);
+    return shape.id;
+}
+
+unsigned int LetoAcquireTexture(unsigned int target, int levels,
+                                unsigned int format, int width,
+                                int height, int depth)
+{
+    const bool flat =
+        target == GL_TEXTURE_2D || target == GL_TEXTURE_CUBE_MAP;
+    if (flat) depth = 1;
+
+    release_object_t shape = {.type = texture_object,
+                              .kind = target,
+                              .size = format,
+                              .extent = {levels, width, height, depth}};
+    shape.id = TakePooled_(&shape);
+    if (shape.id != 0) ResetTexture_(shape.id);
+    else
+    {
+        glCreateTextures(target, 1, &shape.id);
+        if (flat)
+            glTextureStorage2D(shape.id, levels, format, width, height);
+        else
+            glTextureStorage3D(shape.id, levels, format, width, height,
+                               depth);
+    }
+    Record_(&shape);
+    return shape.id;
+}
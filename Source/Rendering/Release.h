@@ -0,0 +1,155 @@
+/**
+ * @file Release.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's deferred release of OpenGL objects. Objects
+ * released during a frame are held until a fence placed at the end of
+ * that frame is signalled, so the driver is never asked to free something
+ * a queued frame still reads. Buffers and textures handed out by the
+ * acquire functions aren't deleted at all; they're pooled, and handed
+ * back out to anything asking for storage of exactly the same shape.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__RELEASE_H
+#define LETO__RELEASE_H
+
+// The engine's OpenGL object kinds.
+#include <Rendering/State.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size and offset types.
+#include <stddef.h>
+// Fixed-width integer types.
+#include <stdint.h>
+
+/**
+ * @brief The amount of frames whose releases can be waiting on the GPU
+ * at once. Past this, the end of a frame waits for the oldest.
+ */
+#define LETO_RELEASE_FRAMES 8
+
+/**
+ * @brief The amount of buffers and textures the reuse pool holds. Past
+ * this, the least recently pooled object is deleted for real.
+ */
+#define LETO_RELEASE_POOL_SIZE 64
+
+/**
+ * @brief The amount of frames an object can sit in the reuse pool unused
+ * before it's deleted for real.
+ */
+#define LETO_RELEASE_POOL_FRAMES 600
+
+/**
+ * InitReleases
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Initialize the release queue and reuse pool. This must be called
+ * after the OpenGL context is current.
+ *
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoInitReleases(void);
+
+/**
+ * TerminateReleases
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Delete every released and pooled object right away. This must
+ * be called while the OpenGL context is still current, after everything
+ * that could release an object has been terminated.
+ *
+ * @return void -- Nothing.
+ */
+void LetoTerminateReleases(void);
+
+/**
+ * ReleaseObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give up an OpenGL object. It's deleted, or pooled for reuse,
+ * once the GPU finishes the frame it was released in. Buffers must be
+ * unmapped first. If the release queue isn't initialized, the object is
+ * deleted right away.
+ *
+ * @param type The kind of object.
+ * @param id The OpenGL ID of the object. Nothing happens if this is 0.
+ * @return void -- Nothing.
+ */
+void LetoReleaseObject(leto_state_object_t type, unsigned int id);
+
+/**
+ * AdvanceReleases
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fence the objects released this frame, and let go of those whose
+ * frames the GPU has finished. This is called once a frame by the
+ * application, after the frame's been submitted; it never waits unless
+ * @ref LETO_RELEASE_FRAMES frames are already pending.
+ *
+ * @return void -- Nothing.
+ */
+void LetoAdvanceReleases(void);
+
+/**
+ * GetFrame
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the current frame, counted up from one by @ref
+ * LetoAdvanceReleases. Work meant to happen once a frame can compare
+ * against it.
+ *
+ * @return uint64_t -- The frame.
+ */
+uint64_t LetoGetFrame(void);
+
+/**
+ * WaitFence
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether the GPU has passed a fence, or block until it has,
+ * and delete the fence once it's passed. Everything that fences its own
+ * memory goes through this.
+ *
+ * @param fence The fence, which is set to NULL once passed. If already
+ * NULL, it counts as passed.
+ * @param wait Whether to block until the fence is passed, rather than
+ * only check it.
+ * @return bool -- True if the fence has been passed, false if not.
+ */
+bool LetoWaitFence(void **fence, bool wait);
+
+/**
+ * AcquireBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get a buffer with immutable storage, from the reuse pool if it
+ * holds one of the same size and flags, or newly created if not. The
+ * contents of a reused buffer are undefined.
+ *
+ * @param size The size of the storage, in bytes.
+ * @param flags The storage flags, as given to glNamedBufferStorage.
+ * @return unsigned int -- The OpenGL ID of the buffer.
+ */
+unsigned int LetoAcquireBuffer(size_t size, unsigned int flags);
+
+/**
+ * AcquireTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get a texture with immutable storage, from the reuse pool if it
+ * holds one of the same shape, or newly created if not. The contents of
+ * a reused texture are undefined; its filtering, wrapping, and comparison
+ * parameters are reset to OpenGL's defaults.
+ *
+ * @param target The target of the texture; GL_TEXTURE_2D,
+ * GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, or GL_TEXTURE_3D.
+ * @param levels The amount of mip levels.
+ * @param format The sized internal format.
+ * @param width The width of the first level.
+ * @param height The height of the first level.
+ * @param depth The depth or layer count of the first level. Ignored for
+ * two-dimensional targets.
+ * @return unsigned int -- The OpenGL ID of the texture.
+ */
+unsigned int LetoAcquireTexture(unsigned int target, int levels,
+                                unsigned int format, int width,
+                                int height, int depth);
+
+#endif // LETO__RELEASE_H
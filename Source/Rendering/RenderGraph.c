@@ -0,0 +1,802 @@
+/**
+ * @file RenderGraph.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's render graph. OpenGL can't place two textures
+ * in the same memory, so transient textures alias by sharing one of the
+ * graph's own textures outright; that works between any two textures of
+ * the same format and size, which is most of a frame's targets.
+ * @implements RenderGraph.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "RenderGraph.h"       // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Deferred object release
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The slot of a pass's record of attachments that holds its depth
+ * attachment; the ones before it are color.
+ */
+#define DEPTH_SLOT (LETO_MAX_PASS_WRITES - 1)
+
+/**
+ * IsDepth
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether a format is attached as depth.
+ *
+ * @param format The sized internal format.
+ * @return bool -- True if it is.
+ */
+static bool IsDepth_(unsigned int format)
+{
+    return format == GL_DEPTH_COMPONENT16 ||
+           format == GL_DEPTH_COMPONENT24 ||
+           format == GL_DEPTH_COMPONENT32 ||
+           format == GL_DEPTH_COMPONENT32F ||
+           format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+/**
+ * HasStencil
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether a depth format has stencil as well.
+ *
+ * @param format The sized internal format.
+ * @return bool -- True if it does.
+ */
+static bool HasStencil_(unsigned int format)
+{
+    return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+/**
+ * IsUnsignedInteger
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether a color format holds unsigned, unnormalized
+ * integers, which can't be filtered and have to be cleared as integers.
+ *
+ * @param format The sized internal format.
+ * @return bool -- True if it does.
+ */
+static bool IsUnsignedInteger_(unsigned int format)
+{
+    switch (format)
+    {
+        case GL_R8UI:    case GL_R16UI:    case GL_R32UI:
+        case GL_RG8UI:   case GL_RG16UI:   case GL_RG32UI:
+        case GL_RGBA8UI: case GL_RGBA16UI: case GL_RGBA32UI: return true;
+        default:                                             return false;
+    }
+}
+
+/**
+ * TexelSize
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get roughly how many bytes a texel of a format takes.
+ *
+ * @param format The sized internal format.
+ * @return size_t -- The size, in bytes.
+ */
+static size_t TexelSize_(unsigned int format)
+{
+    switch (format)
+    {
+        case GL_R8:                return 1;
+        case GL_RG8:               return 2;
+        case GL_R16F:              return 2;
+        case GL_DEPTH_COMPONENT16: return 2;
+        case GL_RGBA16F:           return 8;
+        case GL_RG32F:             return 8;
+        case GL_DEPTH32F_STENCIL8: return 8;
+        case GL_RGBA32F:           return 16;
+        default:                   return 4;
+    }
+}
+
+/**
+ * Cull
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Cull a pass, and note every transient texture nothing reads
+ * anymore as a result.
+ *
+ * @param graph The graph.
+ * @param pass The pass to cull.
+ * @param unread The stack of textures nothing reads.
+ * @param unread_count The height of the stack.
+ * @return void -- Nothing.
+ */
+static void Cull_(leto_render_graph_t *graph, leto_graph_pass_t *pass,
+                  uint32_t *unread, size_t *unread_count)
+{
+    pass->culled = true;
+    for (size_t i = 0; i < pass->read_count; i++)
+    {
+        leto_graph_resource_t *resource =
+            &graph->resources[pass->reads[i]];
+        if (--resource->references == 0 && !resource->imported)
+            unread[(*unread_count)++] = pass->reads[i];
+    }
+}
+
+/**
+ * CullPasses
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Cull every pass whose writes nothing ever reads, working back
+ * from the textures nothing reads at all.
+ *
+ * @param graph The graph.
+ * @return void -- Nothing.
+ */
+static void CullPasses_(leto_render_graph_t *graph)
+{
+    for (size_t i = 0; i < graph->resource_count; i++)
+        graph->resources[i].references = 0;
+
+    for (size_t i = 0; i < graph->pass_count; i++)
+    {
+        leto_graph_pass_t *pass = &graph->passes[i];
+        pass->culled = false;
+        pass->references = (uint32_t)pass->write_count;
+        for (size_t j = 0; j < pass->read_count; j++)
+            graph->resources[pass->reads[j]].references++;
+        // Writing something the graph doesn't own is as good as being
+        // read.
+        for (size_t j = 0; j < pass->write_count; j++)
+            if (graph->resources[pass->writes[j]].imported)
+                pass->kept = true;
+    }
+
+    // Every pass can make every texture it reads unread, at most.
+    uint32_t unread[LETO_MAX_GRAPH_PASSES * LETO_MAX_PASS_READS +
+                    LETO_MAX_GRAPH_RESOURCES];
+    size_t unread_count = 0;
+    for (size_t i = 0; i < graph->resource_count; i++)
+        if (graph->resources[i].references == 0 &&
+            !graph->resources[i].imported)
+            unread[unread_count++] = (uint32_t)i;
+
+    for (size_t i = 0; i < graph->pass_count; i++)
+    {
+        leto_graph_pass_t *pass = &graph->passes[i];
+        if (pass->write_count == 0 && !pass->kept)
+            Cull_(graph, pass, unread, &unread_count);
+    }
+
+    while (unread_count > 0)
+    {
+        const uint32_t resource = unread[--unread_count];
+        for (size_t i = 0; i < graph->pass_count; i++)
+        {
+            leto_graph_pass_t *pass = &graph->passes[i];
+            if (pass->culled) continue;
+            for (size_t j = 0; j < pass->write_count; j++)
+            {
+                if (pass->writes[j] != resource) continue;
+                if (--pass->references == 0 && !pass->kept)
+                    Cull_(graph, pass, unread, &unread_count);
+            }
+        }
+    }
+}
+
+/**
+ * Touches
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether a pass reads or writes a texture.
+ *
+ * @param handles The textures the pass reads or writes.
+ * @param count The amount of textures.
+ * @param resource The texture.
+ * @return bool -- True if it does.
+ */
+static bool Touches_(const uint32_t *handles, size_t count,
+                     uint32_t resource)
+{
+    for (size_t i = 0; i < count; i++)
+        if (handles[i] == resource) return true;
+    return false;
+}
+
+/**
+ * MustPrecede
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether one pass has to run before another. Whatever
+ * writes a transient texture runs before whatever reads it, wherever
+ * either was declared; everything else that shares a texture, including
+ * two writers of one and every use of an imported texture (which may
+ * hold last frame's contents), keeps the order it was declared in.
+ *
+ * @param graph The graph.
+ * @param first The pass that might run first.
+ * @param second The pass that might run second.
+ * @return bool -- True if it has to.
+ */
+static bool MustPrecede_(const leto_render_graph_t *graph, uint32_t first,
+                         uint32_t second)
+{
+    const leto_graph_pass_t *a = &graph->passes[first];
+    const leto_graph_pass_t *b = &graph->passes[second];
+
+    for (size_t i = 0; i < a->write_count; i++)
+    {
+        const uint32_t resource = a->writes[i];
+        const bool read = Touches_(b->reads, b->read_count, resource);
+        if (read && !graph->resources[resource].imported) return true;
+        if (first >= second) continue;
+        if (read || Touches_(b->writes, b->write_count, resource))
+            return true;
+    }
+
+    if (first >= second) return false;
+    for (size_t i = 0; i < a->read_count; i++)
+    {
+        const uint32_t resource = a->reads[i];
+        if (graph->resources[resource].imported &&
+            Touches_(b->writes, b->write_count, resource))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * OrderPasses
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Sort the passes left after culling so every one runs after the
+ * passes it depends on. Of the passes ready to run, the one declared
+ * first always goes next, so a graph declared in a working order runs in
+ * that order.
+ *
+ * @param graph The graph.
+ * @return bool -- True for success, false if the passes depend on each
+ * other in a cycle.
+ */
+static bool OrderPasses_(leto_render_graph_t *graph)
+{
+    bool after[LETO_MAX_GRAPH_PASSES][LETO_MAX_GRAPH_PASSES] = {0};
+    uint32_t waiting[LETO_MAX_GRAPH_PASSES] = {0};
+    bool placed[LETO_MAX_GRAPH_PASSES] = {0};
+    size_t remaining = 0;
+
+    for (uint32_t i = 0; i < graph->pass_count; i++)
+    {
+        if (graph->passes[i].culled) continue;
+        remaining++;
+        for (uint32_t j = 0; j < graph->pass_count; j++)
+        {
+            if (graph->passes[j].culled) continue;
+            // A pass that reads a transient texture it writes waits on
+            // itself, which counts as a cycle.
+            if (!MustPrecede_(graph, i, j)) continue;
+            after[i][j] = true;
+            waiting[j]++;
+        }
+    }
+
+    graph->order_count = 0;
+    while (graph->order_count < remaining)
+    {
+        uint32_t next = LETO_GRAPH_NONE;
+        for (uint32_t i = 0; i < graph->pass_count; i++)
+            if (!graph->passes[i].culled && !placed[i] && waiting[i] == 0)
+            {
+                next = i;
+                break;
+            }
+        if (next == LETO_GRAPH_NONE)
+        {
+            graph->order_count = 0;
+            return false;
+        }
+
+        placed[next] = true;
+        graph->order[graph->order_count++] = next;
+        for (uint32_t j = 0; j < graph->pass_count; j++)
+            if (after[next][j]) waiting[j]--;
+    }
+    return true;
+}
+
+/**
+ * TrimTextures
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Release every one of the graph's textures that hasn't been used
+ * in a while; a resize leaves a whole set of them behind.
+ *
+ * @param graph The graph.
+ * @param frame The current frame.
+ * @return void -- Nothing.
+ */
+static void TrimTextures_(leto_render_graph_t *graph, uint64_t frame)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < graph->texture_count; i++)
+    {
+        leto_graph_texture_t *texture = &graph->textures[i];
+        texture->busy = false;
+        if (frame - texture->used > LETO_GRAPH_TEXTURE_FRAMES)
+        {
+            LetoReleaseObject(texture_object, texture->texture);
+            continue;
+        }
+        graph->textures[kept++] = *texture;
+    }
+    graph->texture_count = kept;
+}
+
+/**
+ * TakeTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find one of the graph's textures for a transient texture to live
+ * in, making a new one if none of the right shape are free.
+ *
+ * @param graph The graph.
+ * @param resource The transient texture.
+ * @param frame The current frame.
+ * @return uint32_t -- The graph texture, or @ref LETO_GRAPH_NONE.
+ */
+static uint32_t TakeTexture_(leto_render_graph_t *graph,
+                             const leto_graph_resource_t *resource,
+                             uint64_t frame)
+{
+    for (size_t i = 0; i < graph->texture_count; i++)
+    {
+        leto_graph_texture_t *texture = &graph->textures[i];
+        if (texture->busy || texture->format != resource->format ||
+            texture->width != resource->width ||
+            texture->height != resource->height)
+            continue;
+        texture->busy = true;
+        texture->used = frame;
+        return (uint32_t)i;
+    }
+
+    if (graph->texture_count == LETO_MAX_GRAPH_TEXTURES)
+    {
+        LetoReportError(false, invalid_render_graph, LETO_FILE_CONTEXT);
+        return LETO_GRAPH_NONE;
+    }
+
+    leto_graph_texture_t *texture = &graph->textures[graph->texture_count];
+    texture->texture =
+        LetoAcquireTexture(GL_TEXTURE_2D, 1, resource->format,
+                           resource->width, resource->height, 1);
+    texture->format = resource->format;
+    texture->width = resource->width;
+    texture->height = resource->height;
+    texture->busy = true;
+    texture->used = frame;
+
+    const int filter =
+        IsUnsignedInteger_(resource->format) ? GL_NEAREST : GL_LINEAR;
+    glTextureParameteri(texture->texture, GL_TEXTURE_MIN_FILTER, filter);
+    glTextureParameteri(texture->texture, GL_TEXTURE_MAG_FILTER, filter);
+    glTextureParameteri(texture->texture, GL_TEXTURE_WRAP_S,
+                        GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture->texture, GL_TEXTURE_WRAP_T,
+                        GL_CLAMP_TO_EDGE);
+    return (uint32_t)graph->texture_count++;
+}
+
+/**
+ * AssignTextures
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Work out the lifetime of every texture, then walk the passes in
+ * order, giving each transient texture storage at its first use and
+ * freeing it after its last.
+ *
+ * @param graph The graph.
+ * @return void -- Nothing.
+ */
+static void AssignTextures_(leto_render_graph_t *graph)
+{
+    for (size_t i = 0; i < graph->resource_count; i++)
+    {
+        leto_graph_resource_t *resource = &graph->resources[i];
+        resource->first = UINT32_MAX;
+        resource->last = 0;
+        resource->physical = LETO_GRAPH_NONE;
+    }
+
+    for (size_t i = 0; i < graph->order_count; i++)
+    {
+        const leto_graph_pass_t *pass = &graph->passes[graph->order[i]];
+        const uint32_t *uses[2] = {pass->reads, pass->writes};
+        const size_t counts[2] = {pass->read_count, pass->write_count};
+        for (size_t k = 0; k < 2; k++)
+            for (size_t j = 0; j < counts[k]; j++)
+            {
+                leto_graph_resource_t *resource =
+                    &graph->resources[uses[k][j]];
+                if (resource->first == UINT32_MAX)
+                    resource->first = (uint32_t)i;
+                resource->last = (uint32_t)i;
+            }
+    }
+
+    const uint64_t frame = LetoGetFrame();
+    TrimTextures_(graph, frame);
+    graph->transient_bytes = 0;
+    graph->physical_bytes = 0;
+
+    for (size_t i = 0; i < graph->order_count; i++)
+    {
+        for (size_t r = 0; r < graph->resource_count; r++)
+        {
+            leto_graph_resource_t *resource = &graph->resources[r];
+            if (resource->imported || resource->first != i) continue;
+
+            resource->physical = TakeTexture_(graph, resource, frame);
+            if (resource->physical == LETO_GRAPH_NONE) continue;
+            resource->texture =
+                graph->textures[resource->physical].texture;
+            graph->transient_bytes += (size_t)resource->width *
+                                      (size_t)resource->height *
+                                      TexelSize_(resource->format);
+        }
+
+        for (size_t r = 0; r < graph->resource_count; r++)
+        {
+            const leto_graph_resource_t *resource = &graph->resources[r];
+            if (resource->physical != LETO_GRAPH_NONE &&
+                resource->last == i)
+                graph->textures[resource->physical].busy = false;
+        }
+    }
+
+    for (size_t i = 0; i < graph->texture_count; i++)
+    {
+        const leto_graph_texture_t *texture = &graph->textures[i];
+        if (texture->used == frame)
+            graph->physical_bytes += (size_t)texture->width *
+                                     (size_t)texture->height *
+                                     TexelSize_(texture->format);
+    }
+}
+
+/**
+ * BindPass
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind a pass's attachments, size the viewport to them, and clear
+ * them if the pass asked.
+ *
+ * @param graph The graph.
+ * @param index The pass.
+ * @return void -- Nothing.
+ */
+static void BindPass_(leto_render_graph_t *graph, uint32_t index)
+{
+    const leto_graph_pass_t *pass = &graph->passes[index];
+    const float depth = 1.0f;
+
+    if (pass->writes[0] == LETO_GRAPH_BACKBUFFER)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, graph->width, graph->height);
+        if (!pass->clear) return;
+        LetoSetDepthWrite(true);
+        glClearNamedFramebufferfv(0, GL_COLOR, 0, pass->clear_color);
+        glClearNamedFramebufferfv(0, GL_DEPTH, 0, &depth);
+        return;
+    }
+
+    // Attachments are only touched when they change, since every change
+    // has the driver check the framebuffer over again.
+    const unsigned int framebuffer = graph->framebuffers[index];
+    unsigned int *attached = graph->attached[index];
+    unsigned int wanted[LETO_MAX_PASS_WRITES] = {0};
+    unsigned int buffers[LETO_MAX_PASS_WRITES];
+    unsigned int formats[LETO_MAX_PASS_WRITES];
+    unsigned int depth_format = 0;
+    int colors = 0;
+    for (size_t i = 0; i < pass->write_count; i++)
+    {
+        const leto_graph_resource_t *resource =
+            &graph->resources[pass->writes[i]];
+        if (IsDepth_(resource->format))
+        {
+            wanted[DEPTH_SLOT] = resource->texture;
+            depth_format = resource->format;
+            continue;
+        }
+        buffers[colors] = GL_COLOR_ATTACHMENT0 + colors;
+        formats[colors] = resource->format;
+        wanted[colors++] = resource->texture;
+    }
+
+    for (int i = 0; i < DEPTH_SLOT; i++)
+    {
+        if (attached[i] == wanted[i]) continue;
+        glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0 + i,
+                                  wanted[i], 0);
+        attached[i] = wanted[i];
+    }
+    if (attached[DEPTH_SLOT] != wanted[DEPTH_SLOT])
+    {
+        // Whatever was there before may have had stencil.
+        glNamedFramebufferTexture(framebuffer,
+                                  GL_DEPTH_STENCIL_ATTACHMENT, 0, 0);
+        glNamedFramebufferTexture(framebuffer,
+                                  HasStencil_(depth_format)
+                                      ? GL_DEPTH_STENCIL_ATTACHMENT
+                                      : GL_DEPTH_ATTACHMENT,
+                                  wanted[DEPTH_SLOT], 0);
+        attached[DEPTH_SLOT] = wanted[DEPTH_SLOT];
+    }
+    if (colors > 0)
+        glNamedFramebufferDrawBuffers(framebuffer, colors, buffers);
+    else glNamedFramebufferDrawBuffer(framebuffer, GL_NONE);
+
+    const leto_graph_resource_t *first =
+        &graph->resources[pass->writes[0]];
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, first->width, first->height);
+    if (!pass->clear) return;
+
+    // Integer attachments take the clear color as whole numbers; clearing
+    // them as floats is undefined.
+    const unsigned int integer_color[4] = {
+        (unsigned int)pass->clear_color[0],
+        (unsigned int)pass->clear_color[1],
+        (unsigned int)pass->clear_color[2],
+        (unsigned int)pass->clear_color[3]};
+    for (int i = 0; i < colors; i++)
+    {
+        if (IsUnsignedInteger_(formats[i]))
+            glClearNamedFramebufferuiv(framebuffer, GL_COLOR, i,
+                                       integer_color);
+        else
+            glClearNamedFramebufferfv(framebuffer, GL_COLOR, i,
+                                      pass->clear_color);
+    }
+    if (depth_format == 0) return;
+    LetoSetDepthWrite(true);
+    if (HasStencil_(depth_format))
+        glClearNamedFramebufferfi(framebuffer, GL_DEPTH_STENCIL, 0, depth,
+                                  0);
+    else glClearNamedFramebufferfv(framebuffer, GL_DEPTH, 0, &depth);
+}
+
+/**
+ * AddResource
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Declare a texture of this frame.
+ *
+ * @param graph The graph.
+ * @param resource The texture.
+ * @return uint32_t -- The texture's handle, or @ref LETO_GRAPH_NONE.
+ */
+static uint32_t AddResource_(leto_render_graph_t *graph,
+                             const leto_graph_resource_t *resource)
+{
+    if (graph->resource_count == LETO_MAX_GRAPH_RESOURCES)
+    {
+        LetoReportError(false, invalid_render_graph, LETO_FILE_CONTEXT);
+        return LETO_GRAPH_NONE;
+    }
+    graph->resources[graph->resource_count] = *resource;
+    graph->resources[graph->resource_count].physical = LETO_GRAPH_NONE;
+    graph->compiled = false;
+    return (uint32_t)graph->resource_count++;
+}
+
+bool LetoCreateRenderGraph(leto_render_graph_t *graph)
+{
+    if (graph == NULL) return false;
+    memset(graph, 0, sizeof(leto_render_graph_t));
+
+    glCreateFramebuffers(LETO_MAX_GRAPH_PASSES, graph->framebuffers);
+    glCreateVertexArrays(1, &graph->vertex_array);
+    if (graph->framebuffers[0] == 0 || graph->vertex_array == 0)
+    {
+        LetoDestroyRenderGraph(graph);
+        return false;
+    }
+
+    LetoResetRenderGraph(graph, 0, 0);
+    return true;
+}
+
+void LetoDestroyRenderGraph(leto_render_graph_t *graph)
+{
+    if (graph == NULL) return;
+
+    for (size_t i = 0; i < graph->texture_count; i++)
+        LetoReleaseObject(texture_object, graph->textures[i].texture);
+    if (graph->framebuffers[0] != 0)
+        glDeleteFramebuffers(LETO_MAX_GRAPH_PASSES, graph->framebuffers);
+    LetoReleaseObject(vertex_array_object, graph->vertex_array);
+    memset(graph, 0, sizeof(leto_render_graph_t));
+}
+
+void LetoResetRenderGraph(leto_render_graph_t *graph, int width,
+                          int height)
+{
+    if (graph == NULL) return;
+
+    graph->pass_count = 0;
+    graph->resource_count = 0;
+    graph->order_count = 0;
+    graph->width = width;
+    graph->height = height;
+    graph->compiled = false;
+
+    (void)AddResource_(graph, &(leto_graph_resource_t){
+                                  .name = "backbuffer",
+                                  .format = GL_RGBA8,
+                                  .width = width,
+                                  .height = height,
+                                  .imported = true});
+}
+
+uint32_t LetoCreateGraphTexture(leto_render_graph_t *graph,
+                                const char *name, unsigned int format,
+                                int width, int height)
+{
+    if (graph == NULL) return LETO_GRAPH_NONE;
+    return AddResource_(
+        graph, &(leto_graph_resource_t){
+                   .name = name,
+                   .format = format,
+                   .width = (width > 0) ? width : graph->width,
+                   .height = (height > 0) ? height : graph->height});
+}
+
+uint32_t LetoImportGraphTexture(leto_render_graph_t *graph,
+                                const char *name, unsigned int texture,
+                                unsigned int format, int width,
+                                int height)
+{
+    if (graph == NULL) return LETO_GRAPH_NONE;
+    return AddResource_(graph, &(leto_graph_resource_t){
+                                   .name = name,
+                                   .format = format,
+                                   .width = width,
+                                   .height = height,
+                                   .imported = true,
+                                   .texture = texture});
+}
+
+uint32_t LetoAddGraphPass(leto_render_graph_t *graph, const char *name,
+                          leto_graph_function_t function, void *argument)
+{
+    if (graph == NULL) return LETO_GRAPH_NONE;
+    if (graph->pass_count == LETO_MAX_GRAPH_PASSES)
+    {
+        LetoReportError(false, invalid_render_graph, LETO_FILE_CONTEXT);
+        return LETO_GRAPH_NONE;
+    }
+
+    leto_graph_pass_t *pass = &graph->passes[graph->pass_count];
+    memset(pass, 0, sizeof(leto_graph_pass_t));
+    pass->name = name;
+    pass->function = function;
+    pass->argument = argument;
+    graph->compiled = false;
+    return (uint32_t)graph->pass_count++;
+}
+
+bool LetoGraphRead(leto_render_graph_t *graph, uint32_t pass,
+                   uint32_t resource)
+{
+    if (graph == NULL || pass >= graph->pass_count ||
+        resource >= graph->resource_count)
+        return false;
+
+    leto_graph_pass_t *entry = &graph->passes[pass];
+    for (size_t i = 0; i < entry->read_count; i++)
+        if (entry->reads[i] == resource) return true;
+    if (entry->read_count == LETO_MAX_PASS_READS ||
+        resource == LETO_GRAPH_BACKBUFFER)
+    {
+        LetoReportError(false, invalid_render_graph, LETO_FILE_CONTEXT);
+        return false;
+    }
+
+    entry->reads[entry->read_count++] = resource;
+    graph->compiled = false;
+    return true;
+}
+
+bool LetoGraphWrite(leto_render_graph_t *graph, uint32_t pass,
+                    uint32_t resource)
+{
+    if (graph == NULL || pass >= graph->pass_count ||
+        resource >= graph->resource_count)
+        return false;
+
+    leto_graph_pass_t *entry = &graph->passes[pass];
+    for (size_t i = 0; i < entry->write_count; i++)
+        if (entry->writes[i] == resource) return true;
+
+    size_t colors = 0;
+    bool depth = false;
+    for (size_t i = 0; i < entry->write_count; i++)
+    {
+        if (IsDepth_(graph->resources[entry->writes[i]].format))
+            depth = true;
+        else colors++;
+    }
+    const bool is_depth = IsDepth_(graph->resources[resource].format);
+    const bool mixed =
+        entry->write_count > 0 &&
+        (resource == LETO_GRAPH_BACKBUFFER ||
+         entry->writes[0] == LETO_GRAPH_BACKBUFFER);
+    if (mixed || (is_depth && depth) ||
+        (!is_depth && colors == DEPTH_SLOT))
+    {
+        LetoReportError(false, invalid_render_graph, LETO_FILE_CONTEXT);
+        return false;
+    }
+
+    entry->writes[entry->write_count++] = resource;
+    graph->compiled = false;
+    return true;
+}
+
+void LetoClearGraphPass(leto_render_graph_t *graph, uint32_t pass,
+                        vec4 color)
+{
+    if (graph == NULL || pass >= graph->pass_count) return;
+    graph->passes[pass].clear = true;
+    glm_vec4_copy(color, graph->passes[pass].clear_color);
+}
+
+void LetoKeepGraphPass(leto_render_graph_t *graph, uint32_t pass)
+{
+    if (graph == NULL || pass >= graph->pass_count) return;
+    graph->passes[pass].kept = true;
+}
+
+size_t LetoCompileRenderGraph(leto_render_graph_t *graph)
+{
+    if (graph == NULL) return 0;
+
+    CullPasses_(graph);
+    // A graph that can't be ordered runs nothing, rather than passes
+    // reading textures that were never drawn.
+    if (!OrderPasses_(graph))
+        LetoReportError(false, invalid_render_graph, LETO_FILE_CONTEXT);
+
+    AssignTextures_(graph);
+    graph->compiled = true;
+    return graph->order_count;
+}
+
+void LetoExecuteRenderGraph(leto_render_graph_t *graph)
+{
+    if (graph == NULL) return;
+    if (!graph->compiled) (void)LetoCompileRenderGraph(graph);
+
+    for (size_t i = 0; i < graph->order_count; i++)
+    {
+        const uint32_t index = graph->order[i];
+        const leto_graph_pass_t *pass = &graph->passes[index];
+        if (pass->write_count > 0) BindPass_(graph, index);
+        if (pass->function != NULL) pass->function(graph, pass->argument);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, graph->width, graph->height);
+}
+
+unsigned int LetoGetGraphTexture(const leto_render_graph_t *graph,
+                                 uint32_t resource)
+{
+    if (graph == NULL || resource >= graph->resource_count) return 0;
+    return graph->resources[resource].texture;
+}
+
+void LetoDrawGraphFullscreen(const leto_render_graph_t *graph)
+{
+    if (graph == NULL) return;
+    LetoBindVertexArray(graph->vertex_array);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
@@ -0,0 +1,438 @@
+/**
+ * @file RenderGraph.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's render graph. Every frame, passes are declared
+ * along with the textures they read and the attachments they write; the
+ * graph then culls passes nothing depends on, works out how long each
+ * texture lives, and lets textures whose lives don't overlap share the
+ * same storage before running what's left in an order that respects
+ * what each pass reads and writes.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__RENDER_GRAPH_H
+#define LETO__RENDER_GRAPH_H
+
+// GLM 4D vectors.
+#include <CGLM/vec4.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size and offset types.
+#include <stddef.h>
+// Fixed-width integer types.
+#include <stdint.h>
+
+/**
+ * @brief The most passes and textures a graph can hold in a frame.
+ */
+#define LETO_MAX_GRAPH_PASSES 32
+#define LETO_MAX_GRAPH_RESOURCES 64
+
+/**
+ * @brief The most textures a single pass can read, and the most
+ * attachments it can write; a depth attachment counts as one.
+ */
+#define LETO_MAX_PASS_READS 8
+#define LETO_MAX_PASS_WRITES 8
+
+/**
+ * @brief The most textures a graph can keep for its transient textures
+ * to share.
+ */
+#define LETO_MAX_GRAPH_TEXTURES 32
+
+/**
+ * @brief The amount of frames one of a graph's textures can go unused
+ * before it's released.
+ */
+#define LETO_GRAPH_TEXTURE_FRAMES 60
+
+/**
+ * @brief The handle of the window's own framebuffer, which every graph
+ * has. A pass writing it can write nothing else.
+ */
+#define LETO_GRAPH_BACKBUFFER 0
+
+/**
+ * @brief The handle given back when a pass or texture can't be added.
+ */
+#define LETO_GRAPH_NONE UINT32_MAX
+
+// Forward-declared for the pass function.
+typedef struct leto_render_graph leto_render_graph_t;
+
+/**
+ * @brief The signature of the function a pass runs. By the time it's
+ * called the pass's attachments are bound, sized, and cleared if asked
+ * for, and the textures it reads can be found through @ref
+ * LetoGetGraphTexture.
+ */
+typedef void (*leto_graph_function_t)(const leto_render_graph_t *graph,
+                                      void *argument);
+
+/**
+ * @brief A texture used by a frame's passes.
+ */
+typedef struct leto_graph_resource
+{
+    /**
+     * @brief The name of the texture, for debugging.
+     */
+    const char *name;
+    /**
+     * @brief The sized internal format of the texture.
+     */
+    unsigned int format;
+    /**
+     * @brief The width and height of the texture, in texels.
+     */
+    int width, height;
+    /**
+     * @brief Whether the texture is owned outside the graph. Imported
+     * textures are never shared, and passes writing them are never
+     * culled.
+     */
+    bool imported;
+    /**
+     * @brief The OpenGL ID of the texture, once the graph is compiled.
+     */
+    unsigned int texture;
+    /**
+     * @brief The places in the frame's order of the first and last pass
+     * to use the texture.
+     */
+    uint32_t first, last;
+    /**
+     * @brief The graph texture the resource was given, or @ref
+     * LETO_GRAPH_NONE.
+     */
+    uint32_t physical;
+    /**
+     * @brief The amount of passes left that read the texture, for
+     * culling.
+     */
+    uint32_t references;
+} leto_graph_resource_t;
+
+/**
+ * @brief A pass of a frame.
+ */
+typedef struct leto_graph_pass
+{
+    /**
+     * @brief The name of the pass, for debugging.
+     */
+    const char *name;
+    /**
+     * @brief The function the pass runs, and what it's given.
+     */
+    leto_graph_function_t function;
+    void *argument;
+    /**
+     * @brief The textures the pass reads.
+     */
+    uint32_t reads[LETO_MAX_PASS_READS];
+    size_t read_count;
+    /**
+     * @brief The attachments the pass writes, color in the order given.
+     */
+    uint32_t writes[LETO_MAX_PASS_WRITES];
+    size_t write_count;
+    /**
+     * @brief Whether the pass clears its attachments first, and the color
+     * it clears to. Depth is cleared to one.
+     */
+    bool clear;
+    vec4 clear_color;
+    /**
+     * @brief Whether the pass does something outside the graph, and so
+     * must never be culled.
+     */
+    bool kept;
+    /**
+     * @brief Whether the pass was culled.
+     */
+    bool culled;
+    /**
+     * @brief The amount of the pass's writes still read by something,
+     * for culling.
+     */
+    uint32_t references;
+} leto_graph_pass_t;
+
+/**
+ * @brief A texture the graph owns, shared by any transient textures of
+ * the same shape whose lives don't overlap.
+ */
+typedef struct leto_graph_texture
+{
+    /**
+     * @brief The OpenGL ID of the texture.
+     */
+    unsigned int texture;
+    /**
+     * @brief The sized internal format of the texture.
+     */
+    unsigned int format;
+    /**
+     * @brief The width and height of the texture, in texels.
+     */
+    int width, height;
+    /**
+     * @brief Whether a resource is living in the texture right now.
+     */
+    bool busy;
+    /**
+     * @brief The frame the texture was last used in.
+     */
+    uint64_t used;
+} leto_graph_texture_t;
+
+/**
+ * @brief A render graph. This struct should only be modified through the
+ * functions below.
+ */
+struct leto_render_graph
+{
+    /**
+     * @brief The passes declared this frame.
+     */
+    leto_graph_pass_t passes[LETO_MAX_GRAPH_PASSES];
+    size_t pass_count;
+    /**
+     * @brief The textures declared this frame; the first is always @ref
+     * LETO_GRAPH_BACKBUFFER.
+     */
+    leto_graph_resource_t resources[LETO_MAX_GRAPH_RESOURCES];
+    size_t resource_count;
+    /**
+     * @brief The passes to run, in order, once the graph is compiled.
+     */
+    uint32_t order[LETO_MAX_GRAPH_PASSES];
+    size_t order_count;
+    /**
+     * @brief The textures transient textures live in.
+     */
+    leto_graph_texture_t textures[LETO_MAX_GRAPH_TEXTURES];
+    size_t texture_count;
+    /**
+     * @brief The OpenGL ID of each pass slot's framebuffer, and what was
+     * last attached to it.
+     */
+    unsigned int framebuffers[LETO_MAX_GRAPH_PASSES];
+    unsigned int attached[LETO_MAX_GRAPH_PASSES][LETO_MAX_PASS_WRITES];
+    /**
+     * @brief The OpenGL ID of an empty vertex array, for fullscreen
+     * passes.
+     */
+    unsigned int vertex_array;
+    /**
+     * @brief The size of the window's framebuffer, and of every texture
+     * declared without one.
+     */
+    int width, height;
+    /**
+     * @brief The bytes this frame's transient textures would take apart,
+     * and the bytes they take sharing storage.
+     */
+    size_t transient_bytes, physical_bytes;
+    /**
+     * @brief Whether the graph has been compiled since it was reset.
+     */
+    bool compiled;
+};
+
+/**
+ * CreateRenderGraph
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty render graph. This must be called after the
+ * OpenGL context is current.
+ *
+ * @param graph The graph to initialize.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateRenderGraph(leto_render_graph_t *graph);
+
+/**
+ * DestroyRenderGraph
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a graph owns.
+ *
+ * @param graph The graph to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyRenderGraph(leto_render_graph_t *graph);
+
+/**
+ * ResetRenderGraph
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Throw away last frame's passes and textures, to declare this
+ * frame's. The graph's own textures are kept for them to reuse.
+ *
+ * @param graph The graph.
+ * @param width The width of the window's framebuffer.
+ * @param height The height of the window's framebuffer.
+ * @return void -- Nothing.
+ */
+void LetoResetRenderGraph(leto_render_graph_t *graph, int width,
+                          int height);
+
+/**
+ * CreateGraphTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Declare a texture that only lives within this frame.
+ *
+ * @param graph The graph.
+ * @param name The name of the texture, for debugging.
+ * @param format The sized internal format of the texture.
+ * @param width The width of the texture, or 0 for the graph's.
+ * @param height The height of the texture, or 0 for the graph's.
+ * @return uint32_t -- The texture's handle, or @ref LETO_GRAPH_NONE.
+ */
+uint32_t LetoCreateGraphTexture(leto_render_graph_t *graph,
+                                const char *name, unsigned int format,
+                                int width, int height);
+
+/**
+ * ImportGraphTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Declare a texture owned outside the graph, like a shadow map or
+ * last frame's history, so passes can read and write it.
+ *
+ * @param graph The graph.
+ * @param name The name of the texture, for debugging.
+ * @param texture The OpenGL ID of the texture.
+ * @param format The sized internal format of the texture.
+ * @param width The width of the texture.
+ * @param height The height of the texture.
+ * @return uint32_t -- The texture's handle, or @ref LETO_GRAPH_NONE.
+ */
+uint32_t LetoImportGraphTexture(leto_render_graph_t *graph,
+                                const char *name, unsigned int texture,
+                                unsigned int format, int width,
+                                int height);
+
+/**
+ * AddGraphPass
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Declare a pass. Passes run after every pass that writes a
+ * transient texture they read; past that, they run in the order they're
+ * added, less any that are culled.
+ *
+ * @param graph The graph.
+ * @param name The name of the pass, for debugging.
+ * @param function The function the pass runs.
+ * @param argument What the function is given.
+ * @return uint32_t -- The pass's handle, or @ref LETO_GRAPH_NONE.
+ */
+uint32_t LetoAddGraphPass(leto_render_graph_t *graph, const char *name,
+                          leto_graph_function_t function, void *argument);
+
+/**
+ * GraphRead
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Declare that a pass samples a texture.
+ *
+ * @param graph The graph.
+ * @param pass The pass.
+ * @param resource The texture.
+ * @return bool -- True for success, false if the pass reads too much.
+ */
+bool LetoGraphRead(leto_render_graph_t *graph, uint32_t pass,
+                   uint32_t resource);
+
+/**
+ * GraphWrite
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Declare that a pass draws into a texture. Depth formats are
+ * attached as depth, everything else as the next color attachment.
+ *
+ * @param graph The graph.
+ * @param pass The pass.
+ * @param resource The texture.
+ * @return bool -- True for success, false if the pass writes too much or
+ * would mix the window's framebuffer with anything else.
+ */
+bool LetoGraphWrite(leto_render_graph_t *graph, uint32_t pass,
+                    uint32_t resource);
+
+/**
+ * ClearGraphPass
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Have a pass clear its attachments before it runs.
+ *
+ * @param graph The graph.
+ * @param pass The pass.
+ * @param color The color to clear color attachments to.
+ * @return void -- Nothing.
+ */
+void LetoClearGraphPass(leto_render_graph_t *graph, uint32_t pass,
+                        vec4 color);
+
+/**
+ * KeepGraphPass
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Keep a pass from being culled, even if nothing reads what it
+ * writes; for passes that draw into things the graph doesn't see.
+ *
+ * @param graph The graph.
+ * @param pass The pass.
+ * @return void -- Nothing.
+ */
+void LetoKeepGraphPass(leto_render_graph_t *graph, uint32_t pass);
+
+/**
+ * CompileRenderGraph
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Cull every pass whose work is never used, sort what's left by
+ * what each pass reads and writes, work out each texture's lifetime, and
+ * give every transient texture storage, sharing it between textures of
+ * the same shape whose lifetimes don't overlap. Passes that depend on
+ * each other in a cycle, including one that reads a transient texture it
+ * writes, are reported as an error and leave nothing to run.
+ *
+ * @param graph The graph.
+ * @return size_t -- The amount of passes left to run.
+ */
+size_t LetoCompileRenderGraph(leto_render_graph_t *graph);
+
+/**
+ * ExecuteRenderGraph
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Run every pass left after compiling, in order. The window's
+ * framebuffer is bound once it's done.
+ *
+ * @param graph The graph.
+ * @return void -- Nothing.
+ */
+void LetoExecuteRenderGraph(leto_render_graph_t *graph);
+
+/**
+ * GetGraphTexture
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the OpenGL ID of a texture of a compiled graph.
+ *
+ * @param graph The graph.
+ * @param resource The texture.
+ * @return unsigned int -- The texture's ID, or 0.
+ */
+unsigned int LetoGetGraphTexture(const leto_render_graph_t *graph,
+                                 uint32_t resource);
+
+/**
+ * DrawGraphFullscreen
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Draw a single triangle covering the whole viewport, for passes
+ * that run a shader over every pixel. The vertex shader should make the
+ * triangle from gl_VertexID.
+ *
+ * @param graph The graph.
+ * @return void -- Nothing.
+ */
+void LetoDrawGraphFullscreen(const leto_render_graph_t *graph);
+
+#endif // LETO__RENDER_GRAPH_H
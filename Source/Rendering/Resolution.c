@@ -0,0 +1,168 @@
+/**
+ * @file Resolution.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's dynamic resolution. The controller works on
+ * the scale itself; the integral term settles on whatever scale meets the
+ * budget, and the proportional term reacts to sudden spikes on top of it.
+ * @implements Resolution.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Resolution.h" // Public interface parent
+
+#include <CGLM/util.h> // GLM utilities (clamp, etc.)
+#include <GLAD2/gl.h>  // OpenGL function pointers
+
+#include <math.h>   // Standard math functions
+#include <string.h> // Standard memory utilities
+
+/**
+ * Control
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Feed a frame's GPU time to the controller, and step the scale
+ * if it's moved far enough.
+ *
+ * @param resolution The controller.
+ * @param time The frame's GPU time, in milliseconds.
+ * @return void -- Nothing.
+ */
+static void Control_(leto_resolution_t *resolution, float time)
+{
+    resolution->gpu_time = time;
+    if (resolution->budget <= 0.0f) return;
+
+    // Positive when there's time to spare.
+    const float error = (resolution->budget - time) / resolution->budget;
+    const float span = resolution->maximum - resolution->minimum;
+
+    // The integral alone is the scale the controller settles on; it's
+    // kept within the range, so it never winds up past what can be used.
+    resolution->integral = glm_clamp(
+        resolution->integral + error * LETO_RESOLUTION_INTEGRAL, -span,
+        0.0f);
+    const float wanted =
+        glm_clamp(resolution->maximum + resolution->integral +
+                      error * LETO_RESOLUTION_PROPORTIONAL,
+                  resolution->minimum, resolution->maximum);
+
+    if (resolution->hold > 0)
+    {
+        resolution->hold--;
+        return;
+    }
+
+    float scale = resolution->scale;
+    if (wanted <= scale - LETO_RESOLUTION_STEP)
+        scale -= floorf((scale - wanted) / LETO_RESOLUTION_STEP) *
+                 LETO_RESOLUTION_STEP;
+    else if (wanted >= scale + LETO_RESOLUTION_STEP &&
+             time < resolution->budget * LETO_RESOLUTION_HEADROOM)
+        scale += LETO_RESOLUTION_STEP;
+    else return;
+
+    resolution->scale =
+        glm_clamp(scale, resolution->minimum, resolution->maximum);
+    resolution->hold = LETO_RESOLUTION_HOLD;
+}
+
+/**
+ * Scale
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Scale a window dimension, rounding it up to the alignment but
+ * never past the window.
+ *
+ * @param size The window dimension.
+ * @param scale The scale.
+ * @return int -- The scaled dimension.
+ */
+static int Scale_(int size, float scale)
+{
+    int scaled = (int)ceilf((float)size * scale);
+    scaled = (scaled + LETO_RESOLUTION_ALIGNMENT - 1) /
+             LETO_RESOLUTION_ALIGNMENT * LETO_RESOLUTION_ALIGNMENT;
+    if (scaled > size) scaled = size;
+    return (scaled < 1) ? 1 : scaled;
+}
+
+bool LetoCreateResolution(leto_resolution_t *resolution, float budget)
+{
+    if (resolution == NULL) return false;
+    memset(resolution, 0, sizeof(leto_resolution_t));
+
+    glCreateQueries(GL_TIME_ELAPSED, LETO_RESOLUTION_QUERIES,
+                    resolution->queries);
+    if (resolution->queries[0] == 0) return false;
+
+    resolution->budget = budget;
+    resolution->minimum = LETO_RESOLUTION_MINIMUM;
+    resolution->maximum = LETO_RESOLUTION_MAXIMUM;
+    resolution->scale = LETO_RESOLUTION_MAXIMUM;
+    return true;
+}
+
+void LetoDestroyResolution(leto_resolution_t *resolution)
+{
+    if (resolution == NULL) return;
+    if (resolution->queries[0] != 0)
+        glDeleteQueries(LETO_RESOLUTION_QUERIES, resolution->queries);
+    memset(resolution, 0, sizeof(leto_resolution_t));
+}
+
+bool LetoUpdateResolution(leto_resolution_t *resolution, int width,
+                          int height)
+{
+    if (resolution == NULL) return false;
+
+    // Oldest first, stopping at the first that isn't ready; they finish
+    // in order anyway. The next query to begin is the oldest.
+    for (size_t i = 0; i < LETO_RESOLUTION_QUERIES; i++)
+    {
+        const size_t query =
+            (resolution->current + i) % LETO_RESOLUTION_QUERIES;
+        if (!resolution->pending[query]) continue;
+
+        int available = 0;
+        glGetQueryObjectiv(resolution->queries[query],
+                           GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(resolution->queries[query], GL_QUERY_RESULT,
+                              &elapsed);
+        resolution->pending[query] = false;
+        Control_(resolution, (float)((double)elapsed / 1e6));
+    }
+
+    const int scaled_width = Scale_(width, resolution->scale);
+    const int scaled_height = Scale_(height, resolution->scale);
+    const bool changed = scaled_width != resolution->width ||
+                         scaled_height != resolution->height;
+    resolution->width = scaled_width;
+    resolution->height = scaled_height;
+    return changed;
+}
+
+void LetoBeginResolutionTiming(leto_resolution_t *resolution)
+{
+    if (resolution == NULL || resolution->timing) return;
+    if (resolution->pending[resolution->current]) return;
+
+    glBeginQuery(GL_TIME_ELAPSED,
+                 resolution->queries[resolution->current]);
+    resolution->timing = true;
+}
+
+void LetoEndResolutionTiming(leto_resolution_t *resolution)
+{
+    if (resolution == NULL || !resolution->timing) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    resolution->pending[resolution->current] = true;
+    resolution->current =
+        (resolution->current + 1) % LETO_RESOLUTION_QUERIES;
+    resolution->timing = false;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file Resolution.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's dynamic resolution. The GPU time of every frame
+ * is measured with timer queries, and a proportional-integral controller
+ * scales the resolution the scene is drawn at to keep that time within a
+ * budget. The scale moves in steps, and holds after every change, so it
+ * doesn't flicker between two sizes; the scene is scaled back up to the
+ * window when it's shown.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__RESOLUTION_H
+#define LETO__RESOLUTION_H
+
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size and offset types.
+#include <stddef.h>
+
+/**
+ * @brief The amount of frames whose timings can be waiting on the GPU at
+ * once. Results are only read once they're ready, so this is how late
+ * the controller can see a frame.
+ */
+#define LETO_RESOLUTION_QUERIES 4
+
+/**
+ * @brief The smallest and largest scale the scene is drawn at, unless
+ * the controller is told otherwise.
+ */
+#define LETO_RESOLUTION_MINIMUM 0.5f
+#define LETO_RESOLUTION_MAXIMUM 1.0f
+
+/**
+ * @brief The steps the scale moves in. A step is only taken once the
+ * controller wants a whole step's change.
+ */
+#define LETO_RESOLUTION_STEP 0.05f
+
+/**
+ * @brief The amount of frames the scale holds after it changes, so the
+ * controller sees the new scale's timings before it moves again.
+ */
+#define LETO_RESOLUTION_HOLD 8
+
+/**
+ * @brief The fraction of the budget a frame must come in under before
+ * the scale is allowed back up.
+ */
+#define LETO_RESOLUTION_HEADROOM 0.9f
+
+/**
+ * @brief The proportional and integral gains of the controller, against
+ * the error as a fraction of the budget.
+ */
+#define LETO_RESOLUTION_PROPORTIONAL 0.4f
+#define LETO_RESOLUTION_INTEGRAL 0.05f
+
+/**
+ * @brief The multiple the scene's width and height are rounded up to.
+ */
+#define LETO_RESOLUTION_ALIGNMENT 8
+
+/**
+ * @brief A dynamic resolution controller. This struct should only be
+ * modified through the functions below, besides its @ref budget, @ref
+ * minimum, and @ref maximum.
+ */
+typedef struct leto_resolution
+{
+    /**
+     * @brief The OpenGL IDs of the timer queries, one per frame in
+     * flight.
+     */
+    unsigned int queries[LETO_RESOLUTION_QUERIES];
+    /**
+     * @brief Whether each query has been ended, but not yet read.
+     */
+    bool pending[LETO_RESOLUTION_QUERIES];
+    /**
+     * @brief The query of this frame, and whether it's running.
+     */
+    size_t current;
+    bool timing;
+    /**
+     * @brief The GPU time a frame should take, in milliseconds.
+     */
+    float budget;
+    /**
+     * @brief The smallest and largest scale allowed.
+     */
+    float minimum, maximum;
+    /**
+     * @brief The scale the scene is drawn at.
+     */
+    float scale;
+    /**
+     * @brief The accumulated error of the controller.
+     */
+    float integral;
+    /**
+     * @brief The last GPU time measured, in milliseconds.
+     */
+    float gpu_time;
+    /**
+     * @brief The amount of frames until the scale can change again.
+     */
+    unsigned int hold;
+    /**
+     * @brief The width and height the scene is drawn at, in pixels.
+     */
+    int width, height;
+} leto_resolution_t;
+
+/**
+ * CreateResolution
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create a dynamic resolution controller, starting at the largest
+ * scale. This must be called after the OpenGL context is current.
+ *
+ * @param resolution The controller to initialize.
+ * @param budget The GPU time a frame should take, in milliseconds.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateResolution(leto_resolution_t *resolution, float budget);
+
+/**
+ * DestroyResolution
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a controller owns.
+ *
+ * @param resolution The controller to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyResolution(leto_resolution_t *resolution);
+
+/**
+ * UpdateResolution
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Feed every finished frame's timing to the controller, and work
+ * out the size the scene should be drawn at this frame. This should be
+ * called once a frame, before anything is drawn at that size.
+ *
+ * @param resolution The controller.
+ * @param width The width of the window, in pixels.
+ * @param height The height of the window, in pixels.
+ * @return bool -- True if the size changed.
+ */
+bool LetoUpdateResolution(leto_resolution_t *resolution, int width,
+                          int height);
+
+/**
+ * BeginResolutionTiming
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Start timing the frame's GPU work. Nothing else may use a time
+ * elapsed query until the timing's ended. If every query is still
+ * waiting on the GPU, this frame goes untimed.
+ *
+ * @param resolution The controller.
+ * @return void -- Nothing.
+ */
+void LetoBeginResolutionTiming(leto_resolution_t *resolution);
+
+/**
+ * EndResolutionTiming
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Stop timing the frame's GPU work.
+ *
+ * @param resolution The controller.
+ * @return void -- Nothing.
+ */
+void LetoEndResolutionTiming(leto_resolution_t *resolution);
+
+#endif // LETO__RESOLUTION_H
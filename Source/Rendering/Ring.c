@@ -0,0 +1,161 @@
+/**
+ * @file Ring.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's ring buffers. Each region is handed out front
+ * to back and fenced once the frame's done with it; coming back around to
+ * a region waits on its fence, which has almost always long since been
+ * signalled.
+ * @implements Ring.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Ring.h"              // Public interface parent
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Deferred object release
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <string.h> // Standard memory utilities
+
+/**
+ * MakeStorage
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create and map a buffer with room for every region.
+ *
+ * @param ring The ring, whose buffer and mapping are replaced.
+ * @param region_size The size of each region, in bytes.
+ * @return bool -- True for success, false for failure.
+ */
+static bool MakeStorage_(leto_ring_buffer_t *ring, size_t region_size)
+{
+    const GLsizeiptr size = (GLsizeiptr)(region_size * LETO_RING_FRAMES);
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    unsigned int buffer = LetoAcquireBuffer((size_t)size, flags);
+    // Coherent, so nothing ever has to be flushed; every write is
+    // written once and read once, which is what coherent memory is for.
+    void *mapping = glMapNamedBufferRange(buffer, 0, size, flags);
+    if (mapping == NULL)
+    {
+        LetoReportError(false, failed_buffer_map, LETO_FILE_CONTEXT);
+        LetoReleaseObject(buffer_object, buffer);
+        return false;
+    }
+
+    ring->buffer = buffer;
+    ring->mapping = mapping;
+    ring->region_size = region_size;
+    return true;
+}
+
+/**
+ * DeleteStorage
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Release a buffer of the ring's. It's unmapped, and pooled once
+ * the GPU is done with it, so this never waits. A persistent mapping can
+ * go while the GPU still reads the buffer.
+ *
+ * @param buffer The OpenGL ID of the buffer, which is set to 0. If
+ * already 0, this does nothing.
+ * @return void -- Nothing.
+ */
+static void DeleteStorage_(unsigned int *buffer)
+{
+    if (*buffer == 0) return;
+    glUnmapNamedBuffer(*buffer);
+    LetoReleaseObject(buffer_object, *buffer);
+    *buffer = 0;
+}
+
+bool LetoCreateRingBuffer(leto_ring_buffer_t *ring, size_t frame_size)
+{
+    if (ring == NULL) return false;
+    memset(ring, 0, sizeof(leto_ring_buffer_t));
+
+    // Allocations are bound as both kinds of block, so they're aligned
+    // for whichever is stricter.
+    int uniform = 0, storage = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storage);
+    ring->alignment = (size_t)(uniform > storage ? uniform : storage);
+    if (ring->alignment < 16) ring->alignment = 16;
+
+    // Keep regions aligned, so every region's first allocation is too.
+    frame_size = frame_size < 4096 ? 4096 : frame_size;
+    frame_size = (frame_size + ring->alignment - 1) / ring->alignment *
+                 ring->alignment;
+    return MakeStorage_(ring, frame_size);
+}
+
+void LetoDestroyRingBuffer(leto_ring_buffer_t *ring)
+{
+    if (ring == NULL) return;
+
+    for (size_t i = 0; i < LETO_RING_FRAMES; i++)
+        if (ring->fences[i] != NULL) glDeleteSync(ring->fences[i]);
+    DeleteStorage_(&ring->retired);
+    DeleteStorage_(&ring->buffer);
+    memset(ring, 0, sizeof(leto_ring_buffer_t));
+}
+
+void LetoAdvanceRingBuffer(leto_ring_buffer_t *ring)
+{
+    if (ring == NULL || ring->buffer == 0) return;
+
+    // A region nothing came out of has nothing to guard.
+    if (ring->in_use)
+        ring->fences[ring->region] =
+            glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    DeleteStorage_(&ring->retired);
+
+    ring->region = (ring->region + 1) % LETO_RING_FRAMES;
+    (void)LetoWaitFence(&ring->fences[ring->region], true);
+    ring->head = 0;
+    ring->in_use = false;
+}
+
+bool LetoAllocateRing(leto_ring_buffer_t *ring, size_t size,
+                      leto_ring_allocation_t *allocation)
+{
+    if (ring == NULL || ring->buffer == 0 || allocation == NULL)
+        return false;
+    const size_t taken = (size + ring->alignment - 1) / ring->alignment *
+                         ring->alignment;
+
+    if (ring->head + taken > ring->region_size)
+    {
+        // Grow into a fresh buffer rather than wait; the old one lives
+        // until the frame's over, so whatever came out of it this frame
+        // can still be written and drawn with. The GPU never touched the
+        // new buffer, so none of the fences mean anything anymore.
+        size_t region_size = ring->region_size * 2;
+        while (region_size < taken * 2) region_size *= 2;
+
+        unsigned int old = ring->buffer;
+        if (!MakeStorage_(ring, region_size)) return false;
+        DeleteStorage_(&ring->retired);
+        ring->retired = old;
+
+        for (size_t i = 0; i < LETO_RING_FRAMES; i++)
+        {
+            if (ring->fences[i] == NULL) continue;
+            glDeleteSync(ring->fences[i]);
+            ring->fences[i] = NULL;
+        }
+        ring->head = 0;
+    }
+
+    const size_t offset = ring->region * ring->region_size + ring->head;
+    *allocation = (leto_ring_allocation_t){.data = ring->mapping + offset,
+                                           .buffer = ring->buffer,
+                                           .offset = (ptrdiff_t)offset,
+                                           .size = size};
+    ring->head += taken;
+    ring->in_use = true;
+    return true;
+}
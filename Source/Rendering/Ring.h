@@ -0,0 +1,152 @@
+/**
+ * @file Ring.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's ring buffers, for data rewritten every frame.
+ * A ring is one persistently and coherently mapped buffer split into a
+ * region per frame in flight; allocations are bumped out of the current
+ * region, and a fence guards each region so it's never written while the
+ * GPU may still read it. Nothing is ever orphaned or reallocated by the
+ * driver.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__RING_H
+#define LETO__RING_H
+
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size and offset types.
+#include <stddef.h>
+
+/**
+ * @brief The amount of regions in a ring, one per frame the GPU may still
+ * be working on.
+ */
+#define LETO_RING_FRAMES 3
+
+/**
+ * @brief A piece of a ring handed out for this frame.
+ */
+typedef struct leto_ring_allocation
+{
+    /**
+     * @brief Where to write the data. Writes are seen by the GPU without
+     * any flushing.
+     */
+    void *data;
+    /**
+     * @brief The OpenGL ID of the buffer the allocation lives in.
+     */
+    unsigned int buffer;
+    /**
+     * @brief The offset of the allocation within @ref buffer, aligned for
+     * binding as a uniform or shader storage buffer.
+     */
+    ptrdiff_t offset;
+    /**
+     * @brief The size of the allocation, in bytes.
+     */
+    size_t size;
+} leto_ring_allocation_t;
+
+/**
+ * @brief A ring buffer. This struct should only be modified through the
+ * functions below.
+ */
+typedef struct leto_ring_buffer
+{
+    /**
+     * @brief The OpenGL ID of the buffer.
+     */
+    unsigned int buffer;
+    /**
+     * @brief The persistent mapping of the whole buffer.
+     */
+    unsigned char *mapping;
+    /**
+     * @brief The size of each region, in bytes.
+     */
+    size_t region_size;
+    /**
+     * @brief The region allocations are made from.
+     */
+    size_t region;
+    /**
+     * @brief The offset of the next allocation within the region.
+     */
+    size_t head;
+    /**
+     * @brief The alignment of every allocation, in bytes.
+     */
+    size_t alignment;
+    /**
+     * @brief Whether anything was allocated from the current region.
+     */
+    bool in_use;
+    /**
+     * @brief The fence signalled once the GPU is done with each region.
+     */
+    void *fences[LETO_RING_FRAMES];
+    /**
+     * @brief A buffer the ring outgrew this frame, deleted once the frame
+     * is over, or 0.
+     */
+    unsigned int retired;
+} leto_ring_buffer_t;
+
+/**
+ * CreateRingBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create a ring buffer. This must be called after the OpenGL
+ * context is current.
+ *
+ * @param ring The ring to initialize.
+ * @param frame_size The amount of bytes to make room for each frame. The
+ * ring grows past this if it has to.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateRingBuffer(leto_ring_buffer_t *ring, size_t frame_size);
+
+/**
+ * DestroyRingBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a ring buffer owns.
+ *
+ * @param ring The ring to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyRingBuffer(leto_ring_buffer_t *ring);
+
+/**
+ * AdvanceRingBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move on to the next region; call this once a frame, before
+ * allocating anything. Everything drawn with the current region must
+ * have been submitted already. This only blocks if the GPU is still
+ * @ref LETO_RING_FRAMES frames behind.
+ *
+ * @param ring The ring.
+ * @return void -- Nothing.
+ */
+void LetoAdvanceRingBuffer(leto_ring_buffer_t *ring);
+
+/**
+ * AllocateRing
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take some room from the current region. If the region is full,
+ * the ring grows; allocations made earlier this frame stay valid until
+ * the next @ref LetoAdvanceRingBuffer.
+ *
+ * @param ring The ring.
+ * @param size The amount of bytes needed.
+ * @param allocation Filled in with the allocation.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoAllocateRing(leto_ring_buffer_t *ring, size_t size,
+                      leto_ring_allocation_t *allocation);
+
+#endif // LETO__RING_H
@@ -0,0 +1,577 @@
+/**
+ * @file ShadowAtlas.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's spot light shadow atlas. Tiles come out of a
+ * quadtree over the atlas; a request takes the smallest free node that
+ * fits, splitting it down to size, and freed nodes merge back with their
+ * siblings once all four are free.
+ * @implements ShadowAtlas.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "ShadowAtlas.h"        // Public interface parent
+#include <Input/Shaders.h>      // Uniform locations
+#include <Rendering/Cascades.h> // Shared shadow depth setup
+#include <Rendering/Release.h>  // Deferred object release
+#include <Rendering/State.h>    // OpenGL state cache
+
+#include <CGLM/cam.h> // GLM camera functions (lookat, etc.)
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <math.h>   // Standard math functions
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The states a quadtree node can be in; part of a larger node,
+ * free, split into four, or handed out.
+ */
+#define NODE_HIDDEN 0
+#define NODE_FREE 1
+#define NODE_SPLIT 2
+#define NODE_USED 3
+
+/**
+ * @brief How much wider than its outer cone a light's tile sees, in
+ * radians, so filtering at the cone's edge stays inside the tile.
+ */
+#define CONE_MARGIN 0.05f
+
+/**
+ * LevelStart
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the index of the first node of a quadtree level.
+ *
+ * @param level The level, zero being the whole atlas.
+ * @return size_t -- The index.
+ */
+static size_t LevelStart_(size_t level)
+{
+    return (((size_t)1 << (2 * level)) - 1) / 3;
+}
+
+/**
+ * LevelOf
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the quadtree level whose nodes are a given size.
+ *
+ * @param atlas The atlas.
+ * @param size The size of the node, a power of two.
+ * @return size_t -- The level.
+ */
+static size_t LevelOf_(const leto_shadow_atlas_t *atlas, int size)
+{
+    size_t level = 0;
+    while ((atlas->size >> level) > size) level++;
+    return level;
+}
+
+/**
+ * Allocate
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take a tile from the atlas.
+ *
+ * @param atlas The atlas.
+ * @param level The level of the tile wanted.
+ * @return size_t -- The tile's node, or 0 if there's no room.
+ */
+static size_t Allocate_(leto_shadow_atlas_t *atlas, size_t level)
+{
+    // The smallest free node that fits, so big ones aren't split for
+    // nothing.
+    for (size_t found = level + 1; found-- > 0;)
+    {
+        const size_t start = LevelStart_(found);
+        const size_t width = (size_t)1 << found;
+        for (size_t i = 0; i < width * width; i++)
+        {
+            if (atlas->nodes[start + i] != NODE_FREE) continue;
+
+            size_t x = i % width, y = i / width, node = start + i;
+            for (size_t k = found; k < level; k++)
+            {
+                atlas->nodes[node] = NODE_SPLIT;
+                x *= 2, y *= 2;
+                const size_t child_start = LevelStart_(k + 1);
+                const size_t child_width = (size_t)1 << (k + 1);
+                node = child_start + y * child_width + x;
+                atlas->nodes[node] = NODE_FREE;
+                atlas->nodes[node + 1] = NODE_FREE;
+                atlas->nodes[node + child_width] = NODE_FREE;
+                atlas->nodes[node + child_width + 1] = NODE_FREE;
+            }
+            atlas->nodes[node] = NODE_USED;
+            return node;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Free
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give a tile back to the atlas, merging it with its siblings
+ * while all four are free.
+ *
+ * @param atlas The atlas.
+ * @param node The tile's node.
+ * @param level The tile's level.
+ * @return void -- Nothing.
+ */
+static void Free_(leto_shadow_atlas_t *atlas, size_t node, size_t level)
+{
+    atlas->nodes[node] = NODE_FREE;
+    while (level > 0)
+    {
+        const size_t start = LevelStart_(level);
+        const size_t width = (size_t)1 << level;
+        const size_t x = (node - start) % width & ~(size_t)1;
+        const size_t y = (node - start) / width & ~(size_t)1;
+        const size_t first = start + y * width + x;
+        const size_t siblings[4] = {first, first + 1, first + width,
+                                    first + width + 1};
+        for (size_t i = 0; i < 4; i++)
+            if (atlas->nodes[siblings[i]] != NODE_FREE) return;
+
+        for (size_t i = 0; i < 4; i++)
+            atlas->nodes[siblings[i]] = NODE_HIDDEN;
+        level--;
+        node = LevelStart_(level) + (y / 2) * (width / 2) + x / 2;
+        atlas->nodes[node] = NODE_FREE;
+    }
+}
+
+/**
+ * GetTile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find where a shadowed light's tile is in the atlas.
+ *
+ * @param atlas The atlas.
+ * @param shadowed The light.
+ * @param x Filled with the left edge of the tile, in texels.
+ * @param y Filled with the bottom edge of the tile, in texels.
+ * @return void -- Nothing.
+ */
+static void GetTile_(const leto_shadow_atlas_t *atlas,
+                     const leto_shadowed_light_t *shadowed, int *x,
+                     int *y)
+{
+    const size_t level = LevelOf_(atlas, shadowed->size);
+    const size_t width = (size_t)1 << level;
+    const size_t index = shadowed->node - LevelStart_(level);
+    *x = (int)(index % width) * shadowed->size;
+    *y = (int)(index / width) * shadowed->size;
+}
+
+/**
+ * ReleaseTile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free a shadowed light's tile, if it has one.
+ *
+ * @param atlas The atlas.
+ * @param shadowed The light.
+ * @return void -- Nothing.
+ */
+static void ReleaseTile_(leto_shadow_atlas_t *atlas,
+                         leto_shadowed_light_t *shadowed)
+{
+    if (shadowed->node != 0)
+        Free_(atlas, shadowed->node, LevelOf_(atlas, shadowed->size));
+    shadowed->node = 0;
+    shadowed->size = 0;
+}
+
+/**
+ * PlaceTile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give a shadowed light a tile of the size it wants, or the
+ * largest smaller one there's room for.
+ *
+ * @param atlas The atlas.
+ * @param shadowed The light.
+ * @return bool -- True if the light has a tile.
+ */
+static bool PlaceTile_(leto_shadow_atlas_t *atlas,
+                       leto_shadowed_light_t *shadowed)
+{
+    if (shadowed->node != 0 && shadowed->size == shadowed->wanted_size)
+        return true;
+    ReleaseTile_(atlas, shadowed);
+
+    for (int size = shadowed->wanted_size;
+         size >= LETO_SHADOW_TILE_MINIMUM; size /= 2)
+    {
+        shadowed->node = Allocate_(atlas, LevelOf_(atlas, size));
+        if (shadowed->node == 0) continue;
+        shadowed->size = size;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * DrawLight
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Work out the matrices a light's tile is drawn and sampled with,
+ * and remember the light as it was.
+ *
+ * @param atlas The atlas.
+ * @param shadowed The shadowed light.
+ * @param light The light itself.
+ * @return void -- Nothing.
+ */
+static void DrawLight_(const leto_shadow_atlas_t *atlas,
+                       leto_shadowed_light_t *shadowed,
+                       const leto_light_t *light)
+{
+    vec3 direction, target, up = {0.0f, 1.0f, 0.0f};
+    glm_vec3_normalize_to((float *)light->direction, direction);
+    if (fabsf(direction[1]) > 0.99f) glm_vec3_copy(GLM_XUP, up);
+    glm_vec3_add((float *)light->position, direction, target);
+
+    const float angle =
+        glm_clamp(light->outer_angle + CONE_MARGIN, 0.01f, 1.5f);
+    mat4 view, projection;
+    glm_lookat((float *)light->position, target, up, view);
+    glm_perspective(2.0f * angle, 1.0f, fmaxf(light->range * 0.01f, 0.05f),
+                    light->range, projection);
+    glm_mat4_mul(projection, view, shadowed->view_projection);
+    LetoExtractFrustum(&shadowed->frustum, shadowed->view_projection);
+
+    // Take normalized device coordinates onto the tile, and depth to the
+    // zero-to-one range it's stored in.
+    int x, y;
+    GetTile_(atlas, shadowed, &x, &y);
+    const float scale = (float)shadowed->size / (float)atlas->size;
+    mat4 tile = GLM_MAT4_IDENTITY_INIT;
+    tile[0][0] = tile[1][1] = scale * 0.5f;
+    tile[2][2] = 0.5f;
+    tile[3][0] = (float)x / (float)atlas->size + scale * 0.5f;
+    tile[3][1] = (float)y / (float)atlas->size + scale * 0.5f;
+    tile[3][2] = 0.5f;
+    glm_mat4_mul(tile, shadowed->view_projection, shadowed->atlas_matrix);
+
+    glm_vec3_copy((float *)light->position, shadowed->drawn_position);
+    shadowed->drawn_position[3] = light->range;
+    glm_vec3_copy((float *)light->direction, shadowed->drawn_direction);
+    shadowed->drawn_direction[3] = light->outer_angle;
+    shadowed->dirty = false;
+}
+
+/**
+ * Moved
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether a light has changed since its tile was drawn.
+ *
+ * @param shadowed The shadowed light.
+ * @param light The light itself.
+ * @return bool -- True if it has.
+ */
+static bool Moved_(const leto_shadowed_light_t *shadowed,
+                   const leto_light_t *light)
+{
+    return !glm_vec3_eqv((float *)shadowed->drawn_position,
+                         (float *)light->position) ||
+           !glm_vec3_eqv((float *)shadowed->drawn_direction,
+                         (float *)light->direction) ||
+           shadowed->drawn_position[3] != light->range ||
+           shadowed->drawn_direction[3] != light->outer_angle;
+}
+
+/**
+ * Upload
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Upload every slot's sampling matrix, and bind them.
+ *
+ * @param atlas The atlas.
+ * @return void -- Nothing.
+ */
+static void Upload_(leto_shadow_atlas_t *atlas)
+{
+    const size_t size = LETO_MAX_SHADOWED_LIGHTS * sizeof(float[16]);
+    LetoAdvanceRingBuffer(&atlas->ring);
+    leto_ring_allocation_t frame;
+    if (!LetoAllocateRing(&atlas->ring, size, &frame)) return;
+
+    float *matrices = frame.data;
+    for (size_t i = 0; i < LETO_MAX_SHADOWED_LIGHTS; i++)
+        memcpy(&matrices[i * 16], atlas->lights[i].atlas_matrix,
+               sizeof(float[16]));
+    LetoBindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                        LETO_SHADOW_MATRIX_BINDING, frame.buffer,
+                        frame.offset, (ptrdiff_t)size);
+}
+
+bool LetoCreateShadowAtlas(leto_shadow_atlas_t *atlas, int size)
+{
+    if (atlas == NULL) return false;
+    memset(atlas, 0, sizeof(leto_shadow_atlas_t));
+    if (size < LETO_SHADOW_TILE_MINIMUM * 2 ||
+        size > LETO_SHADOW_ATLAS_MAXIMUM || (size & (size - 1)) != 0)
+        return false;
+
+    atlas->size = size;
+    atlas->levels = LevelOf_(atlas, LETO_SHADOW_TILE_MINIMUM) + 1;
+    atlas->budget = LETO_SHADOW_BUDGET;
+    atlas->current = -1;
+    atlas->nodes[0] = NODE_FREE;
+
+    atlas->texture = LetoAcquireTexture(
+        GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, size, size, 1);
+    glTextureParameteri(atlas->texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(atlas->texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(atlas->texture, GL_TEXTURE_WRAP_S,
+                        GL_CLAMP_TO_EDGE);
+    glTextureParameteri(atlas->texture, GL_TEXTURE_WRAP_T,
+                        GL_CLAMP_TO_EDGE);
+    glTextureParameteri(atlas->texture, GL_TEXTURE_COMPARE_MODE,
+                        GL_COMPARE_REF_TO_TEXTURE);
+    glTextureParameteri(atlas->texture, GL_TEXTURE_COMPARE_FUNC,
+                        GL_LEQUAL);
+
+    glCreateFramebuffers(1, &atlas->framebuffer);
+    glNamedFramebufferTexture(atlas->framebuffer, GL_DEPTH_ATTACHMENT,
+                              atlas->texture, 0);
+    glNamedFramebufferDrawBuffer(atlas->framebuffer, GL_NONE);
+    glNamedFramebufferReadBuffer(atlas->framebuffer, GL_NONE);
+
+    if (atlas->texture == 0 ||
+        !LetoCreateRingBuffer(&atlas->ring,
+                              LETO_MAX_SHADOWED_LIGHTS * sizeof(mat4)))
+    {
+        LetoDestroyShadowAtlas(atlas);
+        return false;
+    }
+    return true;
+}
+
+void LetoDestroyShadowAtlas(leto_shadow_atlas_t *atlas)
+{
+    if (atlas == NULL) return;
+
+    LetoDestroyRingBuffer(&atlas->ring);
+    LetoReleaseObject(texture_object, atlas->texture);
+    if (atlas->framebuffer != 0)
+        glDeleteFramebuffers(1, &atlas->framebuffer);
+    memset(atlas, 0, sizeof(leto_shadow_atlas_t));
+    atlas->current = -1;
+}
+
+size_t LetoAddShadowedLight(leto_shadow_atlas_t *atlas, size_t light)
+{
+    if (atlas == NULL) return LETO_MAX_SHADOWED_LIGHTS;
+
+    for (size_t i = 0; i < LETO_MAX_SHADOWED_LIGHTS; i++)
+    {
+        leto_shadowed_light_t *shadowed = &atlas->lights[i];
+        if (shadowed->active) continue;
+        memset(shadowed, 0, sizeof(leto_shadowed_light_t));
+        shadowed->active = true;
+        shadowed->light = light;
+        return i;
+    }
+    return LETO_MAX_SHADOWED_LIGHTS;
+}
+
+void LetoRemoveShadowedLight(leto_shadow_atlas_t *atlas,
+                             leto_lights_t *lights, size_t slot)
+{
+    if (atlas == NULL || slot >= LETO_MAX_SHADOWED_LIGHTS) return;
+    leto_shadowed_light_t *shadowed = &atlas->lights[slot];
+    if (!shadowed->active) return;
+
+    if (lights != NULL && shadowed->light < lights->count)
+        lights->lights[shadowed->light].shadow = 0;
+    ReleaseTile_(atlas, shadowed);
+    shadowed->active = false;
+}
+
+void LetoMarkShadowCaster(leto_shadow_atlas_t *atlas,
+                          const leto_lights_t *lights, vec3 center,
+                          vec3 extent)
+{
+    if (atlas == NULL || lights == NULL) return;
+
+    for (size_t i = 0; i < LETO_MAX_SHADOWED_LIGHTS; i++)
+    {
+        leto_shadowed_light_t *shadowed = &atlas->lights[i];
+        if (!shadowed->active || shadowed->light >= lights->count)
+            continue;
+
+        // The distance from the light to the box, against its range.
+        const leto_light_t *light = &lights->lights[shadowed->light];
+        float distance = 0.0f;
+        for (size_t a = 0; a < 3; a++)
+        {
+            float gap = fabsf(light->position[a] - center[a]) -
+                        fabsf(extent[a]);
+            if (gap > 0.0f) distance += gap * gap;
+        }
+        if (distance <= light->range * light->range)
+            shadowed->dirty = true;
+    }
+}
+
+size_t LetoScheduleShadows(leto_shadow_atlas_t *atlas,
+                           leto_lights_t *lights, mat4 view,
+                           mat4 projection, float viewport_height)
+{
+    if (atlas == NULL || lights == NULL) return 0;
+    atlas->scheduled_count = 0;
+
+    mat4 view_projection;
+    glm_mat4_mul(projection, view, view_projection);
+    leto_frustum_t frustum;
+    LetoExtractFrustum(&frustum, view_projection);
+
+    int largest = LETO_SHADOW_TILE_MAXIMUM;
+    if (largest > atlas->size / 2) largest = atlas->size / 2;
+
+    // How much each light needs drawing; zero if not at all.
+    unsigned int urgency[LETO_MAX_SHADOWED_LIGHTS] = {0};
+    for (size_t i = 0; i < LETO_MAX_SHADOWED_LIGHTS; i++)
+    {
+        leto_shadowed_light_t *shadowed = &atlas->lights[i];
+        if (!shadowed->active) continue;
+        if (shadowed->light >= lights->count)
+        {
+            ReleaseTile_(atlas, shadowed);
+            continue;
+        }
+        const leto_light_t *light = &lights->lights[shadowed->light];
+
+        bool visible = true;
+        for (size_t p = 0; p < 6; p++)
+            visible &= glm_vec3_dot(frustum.planes[p],
+                                    (float *)light->position) +
+                           frustum.planes[p][3] >=
+                       -light->range;
+        if (!visible)
+        {
+            // Nothing it lights can be seen, so its tile is better spent
+            // elsewhere.
+            ReleaseTile_(atlas, shadowed);
+            shadowed->importance = 0.0f;
+            continue;
+        }
+
+        // Roughly how many pixels across the light's reach is.
+        vec3 position;
+        glm_mat4_mulv3(view, (float *)light->position, 1.0f, position);
+        const float distance = glm_vec3_norm(position);
+        shadowed->importance =
+            distance <= light->range
+                ? viewport_height
+                : light->range / distance * projection[1][1] *
+                      viewport_height;
+
+        int wanted = LETO_SHADOW_TILE_MINIMUM;
+        while (wanted < largest && wanted < shadowed->importance)
+            wanted *= 2;
+        // Lights on the edge between two sizes shouldn't flip back and
+        // forth; only shrink once half the size would do.
+        if (shadowed->size != 0 && wanted == shadowed->size / 2)
+            wanted = shadowed->size;
+        shadowed->wanted_size = wanted;
+
+        if (shadowed->node == 0) urgency[i] = 3;
+        else if (shadowed->size != wanted) urgency[i] = 2;
+        else if (shadowed->dirty || Moved_(shadowed, light))
+            urgency[i] = 1;
+    }
+
+    // Most urgent first, then most important.
+    uint32_t order[LETO_MAX_SHADOWED_LIGHTS];
+    size_t candidates = 0;
+    for (uint32_t i = 0; i < LETO_MAX_SHADOWED_LIGHTS; i++)
+    {
+        if (urgency[i] == 0) continue;
+        size_t j = candidates++;
+        for (; j > 0; j--)
+        {
+            const uint32_t other = order[j - 1];
+            if (urgency[other] > urgency[i] ||
+                (urgency[other] == urgency[i] &&
+                 atlas->lights[other].importance >=
+                     atlas->lights[i].importance))
+                break;
+            order[j] = other;
+        }
+        order[j] = i;
+    }
+
+    for (size_t c = 0; c < candidates; c++)
+    {
+        if (atlas->scheduled_count == atlas->budget) break;
+        leto_shadowed_light_t *shadowed = &atlas->lights[order[c]];
+        if (!PlaceTile_(atlas, shadowed)) continue;
+
+        DrawLight_(atlas, shadowed, &lights->lights[shadowed->light]);
+        atlas->scheduled[atlas->scheduled_count++] = order[c];
+    }
+
+    // Lights whose tile hasn't been drawn yet have no shadow to sample.
+    for (size_t i = 0; i < LETO_MAX_SHADOWED_LIGHTS; i++)
+    {
+        const leto_shadowed_light_t *shadowed = &atlas->lights[i];
+        if (!shadowed->active || shadowed->light >= lights->count)
+            continue;
+        const bool drawn =
+            shadowed->node != 0 && shadowed->drawn_position[3] != 0.0f;
+        lights->lights[shadowed->light].shadow =
+            drawn ? (uint32_t)i + 1 : 0;
+    }
+
+    Upload_(atlas);
+    return atlas->scheduled_count;
+}
+
+bool LetoBeginShadowTile(leto_shadow_atlas_t *atlas, size_t index)
+{
+    if (atlas == NULL || index >= atlas->scheduled_count) return false;
+
+    const uint32_t slot = atlas->scheduled[index];
+    const leto_shadowed_light_t *shadowed = &atlas->lights[slot];
+    int x, y;
+    GetTile_(atlas, shadowed, &x, &y);
+
+    LetoBeginShadowDepth(atlas->framebuffer, x, y, shadowed->size);
+    // Clearing only touches the scissor box, so other tiles survive.
+    LetoSetScissorTest(true);
+    glScissor(x, y, shadowed->size, shadowed->size);
+    const float clear = 1.0f;
+    glClearNamedFramebufferfv(atlas->framebuffer, GL_DEPTH, 0, &clear);
+
+    atlas->current = (int)slot;
+    return true;
+}
+
+void LetoEndShadowTile(leto_shadow_atlas_t *atlas)
+{
+    if (atlas == NULL || atlas->current < 0) return;
+
+    LetoEndShadowDepth();
+    LetoSetScissorTest(false);
+    atlas->current = -1;
+}
+
+void LetoSetShadowTileMatrix(const leto_shadow_atlas_t *atlas,
+                             unsigned int shader)
+{
+    if (atlas == NULL || atlas->current < 0) return;
+
+    const leto_shadowed_light_t *shadowed =
+        &atlas->lights[atlas->current];
+    int location = LetoGetUniformLocation(shader, uniform_shadow_matrix);
+    glProgramUniformMatrix4fv(shader, location, 1, GL_FALSE,
+                              &shadowed->view_projection[0][0]);
+}
+
+void LetoBindShadowAtlas(const leto_shadow_atlas_t *atlas)
+{
+    if (atlas == NULL) return;
+    LetoBindTextureUnit(LETO_SHADOW_ATLAS_TEXTURE_UNIT, atlas->texture);
+}
@@ -0,0 +1,311 @@
+/**
+ * @file ShadowAtlas.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's spot light shadow atlas. Every shadowed spot
+ * light gets a square tile of one large depth texture, sized by how much
+ * of the screen the light covers. Tiles are only redrawn when their light
+ * or something in it moved, or their size has to change, and only so
+ * many are redrawn each frame; the rest keep last frame's shadows.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__SHADOW_ATLAS_H
+#define LETO__SHADOW_ATLAS_H
+
+// The engine's frustum culler.
+#include <Rendering/Culling.h>
+// The engine's clustered lights.
+#include <Rendering/Lights.h>
+
+/**
+ * @brief The most spot lights an atlas can shadow at once.
+ */
+#define LETO_MAX_SHADOWED_LIGHTS 64
+
+/**
+ * @brief The largest and smallest tiles the atlas hands out, in texels.
+ * No tile is ever more than half the atlas.
+ */
+#define LETO_SHADOW_TILE_MAXIMUM 1024
+#define LETO_SHADOW_TILE_MINIMUM 128
+
+/**
+ * @brief The largest atlas there can be, in texels. An atlas's size must
+ * be a power of two, at least twice @ref LETO_SHADOW_TILE_MINIMUM and at
+ * most this.
+ */
+#define LETO_SHADOW_ATLAS_MAXIMUM 8192
+
+/**
+ * @brief The amount of tile sizes an atlas of the largest size has, from
+ * the whole atlas down to @ref LETO_SHADOW_TILE_MINIMUM, and the amount
+ * of quadtree nodes that takes.
+ */
+#define LETO_SHADOW_ATLAS_LEVELS 7
+#define LETO_SHADOW_ATLAS_NODES 5461
+
+/**
+ * @brief The amount of tiles redrawn each frame, unless the atlas is told
+ * otherwise.
+ */
+#define LETO_SHADOW_BUDGET 4
+
+/**
+ * @brief The texture unit the atlas is bound to, just past the sun's
+ * cascades. Shaders declare it with
+ * "layout(binding = 5) uniform sampler2DShadow".
+ */
+#define LETO_SHADOW_ATLAS_TEXTURE_UNIT 5
+
+/**
+ * @brief The shader storage binding point the atlas's shadow matrices
+ * are bound to. Shaders declare the block with
+ * "layout(std430, binding = 11)", and find a light's matrix one before
+ * its shadow.
+ */
+#define LETO_SHADOW_MATRIX_BINDING 11
+
+/**
+ * @brief A spot light with a shadow in the atlas.
+ */
+typedef struct leto_shadowed_light
+{
+    /**
+     * @brief Whether the slot is taken.
+     */
+    bool active;
+    /**
+     * @brief Whether something moved within the light since its tile was
+     * last drawn.
+     */
+    bool dirty;
+    /**
+     * @brief The index of the light in its set.
+     */
+    size_t light;
+    /**
+     * @brief The quadtree node of the light's tile, or 0 if it has none;
+     * the root is never handed out.
+     */
+    size_t node;
+    /**
+     * @brief The size of the light's tile, in texels, and the size it
+     * should be given how much of the screen it covers; 0 for none.
+     */
+    int size, wanted_size;
+    /**
+     * @brief How much of the screen the light covers, roughly in pixels
+     * across.
+     */
+    float importance;
+    /**
+     * @brief The position, direction, range, and outer angle of the light
+     * when its tile was drawn.
+     */
+    vec4 drawn_position, drawn_direction;
+    /**
+     * @brief The world-to-clip matrix the light's tile is drawn with.
+     */
+    mat4 view_projection;
+    /**
+     * @brief The frustum of the light's tile, for culling its casters.
+     */
+    leto_frustum_t frustum;
+    /**
+     * @brief The world-to-atlas matrix shaders sample the tile with.
+     */
+    mat4 atlas_matrix;
+} leto_shadowed_light_t;
+
+/**
+ * @brief A shadow atlas. This struct should only be modified through the
+ * functions below, besides its @ref budget.
+ */
+typedef struct leto_shadow_atlas
+{
+    /**
+     * @brief The OpenGL ID of the atlas's depth texture.
+     */
+    unsigned int texture;
+    /**
+     * @brief The OpenGL ID of the framebuffer tiles are drawn through.
+     */
+    unsigned int framebuffer;
+    /**
+     * @brief The width and height of the atlas, in texels.
+     */
+    int size;
+    /**
+     * @brief The amount of tile sizes the atlas has.
+     */
+    size_t levels;
+    /**
+     * @brief The state of every quadtree node, level by level and row by
+     * row.
+     */
+    uint8_t nodes[LETO_SHADOW_ATLAS_NODES];
+    /**
+     * @brief Every shadowed light's slot.
+     */
+    leto_shadowed_light_t lights[LETO_MAX_SHADOWED_LIGHTS];
+    /**
+     * @brief The slots whose tiles should be drawn this frame, most
+     * important first.
+     */
+    uint32_t scheduled[LETO_MAX_SHADOWED_LIGHTS];
+    /**
+     * @brief The amount of slots scheduled this frame.
+     */
+    size_t scheduled_count;
+    /**
+     * @brief The most tiles drawn in a frame.
+     */
+    size_t budget;
+    /**
+     * @brief The slot being drawn, or -1.
+     */
+    int current;
+    /**
+     * @brief The ring shadow matrices are uploaded through.
+     */
+    leto_ring_buffer_t ring;
+} leto_shadow_atlas_t;
+
+/**
+ * CreateShadowAtlas
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty shadow atlas. This must be called after the
+ * OpenGL context is current.
+ *
+ * @param atlas The atlas to initialize.
+ * @param size The width and height of the atlas, in texels.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateShadowAtlas(leto_shadow_atlas_t *atlas, int size);
+
+/**
+ * DestroyShadowAtlas
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything an atlas owns.
+ *
+ * @param atlas The atlas to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyShadowAtlas(leto_shadow_atlas_t *atlas);
+
+/**
+ * AddShadowedLight
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give a spot light a shadow.
+ *
+ * @param atlas The atlas.
+ * @param light The index of the light in the set it'll be scheduled with.
+ * @return size_t -- The light's slot, or @ref LETO_MAX_SHADOWED_LIGHTS if
+ * the atlas is full.
+ */
+size_t LetoAddShadowedLight(leto_shadow_atlas_t *atlas, size_t light);
+
+/**
+ * RemoveShadowedLight
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take a light's shadow away, and free its tile.
+ *
+ * @param atlas The atlas.
+ * @param lights The set holding the light.
+ * @param slot The light's slot.
+ * @return void -- Nothing.
+ */
+void LetoRemoveShadowedLight(leto_shadow_atlas_t *atlas,
+                             leto_lights_t *lights, size_t slot);
+
+/**
+ * MarkShadowCaster
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Tell the atlas a caster moved, so every light it's within is
+ * redrawn. Call this with both where it was and where it is.
+ *
+ * @param atlas The atlas.
+ * @param lights The set the atlas's lights are in.
+ * @param center The center of the caster's box.
+ * @param extent The half-size of the caster's box along each axis.
+ * @return void -- Nothing.
+ */
+void LetoMarkShadowCaster(leto_shadow_atlas_t *atlas,
+                          const leto_lights_t *lights, vec3 center,
+                          vec3 extent);
+
+/**
+ * ScheduleShadows
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Size every shadowed light's tile by how much of the view it
+ * covers, pick which tiles get drawn this frame, and upload the matrices
+ * shaders sample them with. Lights out of view give up their tiles;
+ * lights without one, then those needing a new size, then those that
+ * moved, are drawn first, and the more important first within each. This
+ * should be called once a frame, before @ref LetoBinLights.
+ *
+ * @param atlas The atlas.
+ * @param lights The set the atlas's lights are in. Their shadows are
+ * filled in.
+ * @param view The camera's view matrix.
+ * @param projection The camera's projection.
+ * @param viewport_height The height of the viewport, in pixels.
+ * @return size_t -- The amount of tiles to draw this frame, as listed in
+ * @ref scheduled.
+ */
+size_t LetoScheduleShadows(leto_shadow_atlas_t *atlas,
+                           leto_lights_t *lights, mat4 view,
+                           mat4 projection, float viewport_height);
+
+/**
+ * BeginShadowTile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Start drawing one of the tiles scheduled this frame. The casters
+ * drawn in between should be culled against its light's @ref frustum.
+ *
+ * @param atlas The atlas.
+ * @param index The tile's place in the schedule.
+ * @return bool -- True if the tile should be drawn now, and ended with
+ * @ref LetoEndShadowTile.
+ */
+bool LetoBeginShadowTile(leto_shadow_atlas_t *atlas, size_t index);
+
+/**
+ * EndShadowTile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Finish drawing a tile. The framebuffer stays bound; the next
+ * render graph pass binds its own.
+ *
+ * @param atlas The atlas.
+ * @return void -- Nothing.
+ */
+void LetoEndShadowTile(leto_shadow_atlas_t *atlas);
+
+/**
+ * SetShadowTileMatrix
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set the given shader's "shadow_matrix" uniform to the matrix of
+ * the tile being drawn.
+ *
+ * @param atlas The atlas.
+ * @param shader The shader whose matrix we are trying to set.
+ * @return void -- Nothing.
+ */
+void LetoSetShadowTileMatrix(const leto_shadow_atlas_t *atlas,
+                             unsigned int shader);
+
+/**
+ * BindShadowAtlas
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the atlas for shading.
+ *
+ * @param atlas The atlas.
+ * @return void -- Nothing.
+ */
+void LetoBindShadowAtlas(const leto_shadow_atlas_t *atlas);
+
+#endif // LETO__SHADOW_ATLAS_H
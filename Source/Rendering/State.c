@@ -0,0 +1,275 @@
+/**
+ * @file State.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the OpenGL state cache. Only one context is ever
+ * current in Leto, so the shadow state lives in a single static.
+ * @implements State.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "State.h" // Public interface parent
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The value a shadowed ID holds when we don't know what's bound.
+ * No real OpenGL name will ever be this.
+ */
+#define UNKNOWN_ID 0xFFFFFFFFu
+
+/**
+ * @brief The non-indexed buffer targets the cache shadows. The element
+ * array binding belongs to the bound vertex array, so it is forgotten each
+ * time that changes.
+ */
+static const unsigned int buffer_targets[] = {
+    GL_ARRAY_BUFFER,         GL_ELEMENT_ARRAY_BUFFER,
+    GL_UNIFORM_BUFFER,       GL_SHADER_STORAGE_BUFFER,
+    GL_DRAW_INDIRECT_BUFFER, GL_PARAMETER_BUFFER,
+    GL_DISPATCH_INDIRECT_BUFFER};
+
+/**
+ * @brief The amount of non-indexed buffer targets we shadow.
+ */
+#define BUFFER_TARGET_COUNT                                               \
+    (sizeof(buffer_targets) / sizeof(buffer_targets[0]))
+
+/**
+ * @brief A bound range of a buffer on an indexed binding point.
+ */
+typedef struct buffer_range
+{
+    unsigned int buffer;
+    ptrdiff_t offset;
+    ptrdiff_t size;
+} buffer_range_t;
+
+/**
+ * @brief The shadow copy of every piece of state the cache tracks.
+ */
+static struct
+{
+    unsigned int program;
+    unsigned int vertex_array;
+    unsigned int buffers[BUFFER_TARGET_COUNT];
+    buffer_range_t uniform_ranges[LETO_TRACKED_BUFFER_INDICES];
+    buffer_range_t storage_ranges[LETO_TRACKED_BUFFER_INDICES];
+    unsigned int textures[LETO_TRACKED_TEXTURE_UNITS];
+    int blending, blend_source, blend_destination;
+    int depth_test, depth_write, depth_function;
+    int culling, cull_face;
+    int polygon_offset, scissor_test;
+} state;
+
+/**
+ * GetBufferSlot
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the shadow slot of the given buffer target.
+ *
+ * @param target The OpenGL buffer target.
+ * @return unsigned int* -- The slot, or NULL if the target isn't tracked.
+ */
+static unsigned int *GetBufferSlot_(unsigned int target)
+{
+    for (size_t i = 0; i < BUFFER_TARGET_COUNT; i++)
+        if (buffer_targets[i] == target) return &state.buffers[i];
+    return NULL;
+}
+
+/**
+ * SetToggle
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Enable or disable a capability if its shadow state differs.
+ *
+ * @param shadow The shadow state of the capability.
+ * @param capability The OpenGL capability, like @ref GL_BLEND.
+ * @param enabled The desired state.
+ * @return void -- Nothing.
+ */
+static void SetToggle_(int *shadow, unsigned int capability, bool enabled)
+{
+    if (*shadow == (int)enabled) return;
+    *shadow = enabled;
+
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+}
+
+/**
+ * ForgetRanges
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Mark any indexed binding of the given buffer as unknown.
+ *
+ * @param ranges The shadowed binding points.
+ * @param buffer The buffer that was deleted.
+ * @return void -- Nothing.
+ */
+static void ForgetRanges_(buffer_range_t *ranges, unsigned int buffer)
+{
+    for (size_t i = 0; i < LETO_TRACKED_BUFFER_INDICES; i++)
+        if (ranges[i].buffer == buffer) ranges[i].buffer = UNKNOWN_ID;
+}
+
+void LetoResetState(void)
+{
+    // Every member is an ID, offset, or small integer. 0xFF bytes make
+    // UNKNOWN_ID for IDs and -1, which no toggle or enum can be, for the
+    // rest.
+    memset(&state, 0xFF, sizeof(state));
+}
+
+void LetoForgetStateObject(leto_state_object_t type, unsigned int id)
+{
+    switch (type)
+    {
+        case program_object:
+            if (state.program == id) state.program = UNKNOWN_ID;
+            break;
+        case vertex_array_object:
+            if (state.vertex_array == id)
+            {
+                state.vertex_array = UNKNOWN_ID;
+                *GetBufferSlot_(GL_ELEMENT_ARRAY_BUFFER) = UNKNOWN_ID;
+            }
+            break;
+        case buffer_object:
+            for (size_t i = 0; i < BUFFER_TARGET_COUNT; i++)
+                if (state.buffers[i] == id) state.buffers[i] = UNKNOWN_ID;
+            ForgetRanges_(state.uniform_ranges, id);
+            ForgetRanges_(state.storage_ranges, id);
+            break;
+        case texture_object:
+            for (size_t i = 0; i < LETO_TRACKED_TEXTURE_UNITS; i++)
+                if (state.textures[i] == id)
+                    state.textures[i] = UNKNOWN_ID;
+            break;
+        default: break; // can't happen
+    }
+}
+
+void LetoUseProgram(unsigned int program)
+{
+    if (state.program == program) return;
+    state.program = program;
+    glUseProgram(program);
+}
+
+void LetoBindVertexArray(unsigned int vertex_array)
+{
+    if (state.vertex_array == vertex_array) return;
+    state.vertex_array = vertex_array;
+    glBindVertexArray(vertex_array);
+
+    // The element buffer binding is vertex array state, so we no longer
+    // know what it is.
+    *GetBufferSlot_(GL_ELEMENT_ARRAY_BUFFER) = UNKNOWN_ID;
+}
+
+void LetoBindBuffer(unsigned int target, unsigned int buffer)
+{
+    unsigned int *slot = GetBufferSlot_(target);
+    if (slot != NULL)
+    {
+        if (*slot == buffer) return;
+        *slot = buffer;
+    }
+    glBindBuffer(target, buffer);
+}
+
+void LetoBindBufferRange(unsigned int target, unsigned int index,
+                         unsigned int buffer, ptrdiff_t offset,
+                         ptrdiff_t size)
+{
+    buffer_range_t *ranges = NULL;
+    if (target == GL_UNIFORM_BUFFER) ranges = state.uniform_ranges;
+    else if (target == GL_SHADER_STORAGE_BUFFER)
+        ranges = state.storage_ranges;
+
+    if (ranges != NULL && index < LETO_TRACKED_BUFFER_INDICES)
+    {
+        buffer_range_t *range = &ranges[index];
+        if (range->buffer == buffer && range->offset == offset &&
+            range->size == size)
+            return;
+        *range = (buffer_range_t){buffer, offset, size};
+    }
+
+    if (size == 0) glBindBufferBase(target, index, buffer);
+    else glBindBufferRange(target, index, buffer, offset, size);
+
+    // Both of the above also bind the buffer to the generic target.
+    unsigned int *slot = GetBufferSlot_(target);
+    if (slot != NULL) *slot = buffer;
+}
+
+void LetoBindTextureUnit(unsigned int unit, unsigned int texture)
+{
+    if (unit < LETO_TRACKED_TEXTURE_UNITS)
+    {
+        if (state.textures[unit] == texture) return;
+        state.textures[unit] = texture;
+    }
+    glBindTextureUnit(unit, texture);
+}
+
+void LetoSetBlending(bool enabled)
+{
+    SetToggle_(&state.blending, GL_BLEND, enabled);
+}
+
+void LetoSetBlendFunction(unsigned int source, unsigned int destination)
+{
+    if (state.blend_source == (int)source &&
+        state.blend_destination == (int)destination)
+        return;
+    state.blend_source = (int)source;
+    state.blend_destination = (int)destination;
+    glBlendFunc(source, destination);
+}
+
+void LetoSetDepthTest(bool enabled)
+{
+    SetToggle_(&state.depth_test, GL_DEPTH_TEST, enabled);
+}
+
+void LetoSetDepthWrite(bool enabled)
+{
+    if (state.depth_write == (int)enabled) return;
+    state.depth_write = enabled;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void LetoSetDepthFunction(unsigned int function)
+{
+    if (state.depth_function == (int)function) return;
+    state.depth_function = (int)function;
+    glDepthFunc(function);
+}
+
+void LetoSetCulling(bool enabled)
+{
+    SetToggle_(&state.culling, GL_CULL_FACE, enabled);
+}
+
+void LetoSetCullFace(unsigned int face)
+{
+    if (state.cull_face == (int)face) return;
+    state.cull_face = (int)face;
+    glCullFace(face);
+}
+
+void LetoSetPolygonOffset(bool enabled)
+{
+    SetToggle_(&state.polygon_offset, GL_POLYGON_OFFSET_FILL, enabled);
+}
+
+void LetoSetScissorTest(bool enabled)
+{
+    SetToggle_(&state.scissor_test, GL_SCISSOR_TEST, enabled);
+}
@@ -0,0 +1,228 @@
+/**
+ * @file State.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides a thin state-tracking layer over OpenGL. Every binding
+ * and toggle that goes through here is shadowed, and redundant calls are
+ * never passed on to the driver.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__STATE_H
+#define LETO__STATE_H
+
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size and offset types.
+#include <stddef.h>
+
+/**
+ * @brief The amount of texture units whose bindings are shadowed. Any
+ * unit past this is passed straight through to OpenGL.
+ */
+#define LETO_TRACKED_TEXTURE_UNITS 32
+
+/**
+ * @brief The amount of indexed uniform and storage buffer binding points
+ * whose bindings are shadowed.
+ */
+#define LETO_TRACKED_BUFFER_INDICES 16
+
+/**
+ * @brief An enumerator describing the kinds of OpenGL object that the
+ * state cache keeps track of. Used to tell the cache that an object was
+ * deleted, since OpenGL is free to hand its name out again.
+ */
+typedef enum leto_state_object
+{
+    program_object,
+    vertex_array_object,
+    buffer_object,
+    texture_object
+} leto_state_object_t;
+
+/**
+ * ResetState
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Forget everything the cache knows, so the next call of every
+ * setter goes through to the driver. This should be called once a context
+ * is made current, and whenever code outside the cache touched state.
+ *
+ * @return void -- Nothing.
+ */
+void LetoResetState(void);
+
+/**
+ * ForgetStateObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Remove the given object from every binding the cache shadows.
+ * This must be called whenever a tracked object is deleted.
+ *
+ * @param type The kind of object that was deleted.
+ * @param id The OpenGL ID of the deleted object.
+ * @return void -- Nothing.
+ */
+void LetoForgetStateObject(leto_state_object_t type, unsigned int id);
+
+/**
+ * UseProgram
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make the given program current, if it isn't already.
+ *
+ * @param program The OpenGL ID of the program.
+ * @return void -- Nothing.
+ */
+void LetoUseProgram(unsigned int program);
+
+/**
+ * BindVertexArray
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the given vertex array, if it isn't already.
+ *
+ * @param vertex_array The OpenGL ID of the vertex array.
+ * @return void -- Nothing.
+ */
+void LetoBindVertexArray(unsigned int vertex_array);
+
+/**
+ * BindBuffer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the given buffer to the given non-indexed target, if it
+ * isn't already. Prefer the glNamedBuffer* family of functions, which do
+ * not need the buffer bound at all.
+ *
+ * @param target The OpenGL buffer target, like @ref GL_ARRAY_BUFFER.
+ * @param buffer The OpenGL ID of the buffer.
+ * @return void -- Nothing.
+ */
+void LetoBindBuffer(unsigned int target, unsigned int buffer);
+
+/**
+ * BindBufferRange
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind a range of the given buffer to an indexed uniform or shader
+ * storage binding point, if that exact range isn't already bound.
+ *
+ * @param target Either @ref GL_UNIFORM_BUFFER or @ref
+ * GL_SHADER_STORAGE_BUFFER.
+ * @param index The binding point.
+ * @param buffer The OpenGL ID of the buffer.
+ * @param offset The offset into the buffer, in bytes.
+ * @param size The size of the range, in bytes. If this is 0, the whole
+ * buffer is bound.
+ * @return void -- Nothing.
+ */
+void LetoBindBufferRange(unsigned int target, unsigned int index,
+                         unsigned int buffer, ptrdiff_t offset,
+                         ptrdiff_t size);
+
+/**
+ * BindTextureUnit
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the given texture to the given texture unit, if it isn't
+ * already. This goes through direct state access, so the active texture
+ * unit is never touched.
+ *
+ * @param unit The texture unit, starting at 0.
+ * @param texture The OpenGL ID of the texture.
+ * @return void -- Nothing.
+ */
+void LetoBindTextureUnit(unsigned int unit, unsigned int texture);
+
+/**
+ * SetBlending
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Enable or disable blending.
+ *
+ * @param enabled The desired state.
+ * @return void -- Nothing.
+ */
+void LetoSetBlending(bool enabled);
+
+/**
+ * SetBlendFunction
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set the source and destination blending factors.
+ *
+ * @param source The source factor, like @ref GL_SRC_ALPHA.
+ * @param destination The destination factor.
+ * @return void -- Nothing.
+ */
+void LetoSetBlendFunction(unsigned int source, unsigned int destination);
+
+/**
+ * SetDepthTest
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Enable or disable depth testing.
+ *
+ * @param enabled The desired state.
+ * @return void -- Nothing.
+ */
+void LetoSetDepthTest(bool enabled);
+
+/**
+ * SetDepthWrite
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Enable or disable writes to the depth buffer.
+ *
+ * @param enabled The desired state.
+ * @return void -- Nothing.
+ */
+void LetoSetDepthWrite(bool enabled);
+
+/**
+ * SetDepthFunction
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set the depth comparison function.
+ *
+ * @param function The function, like @ref GL_LESS.
+ * @return void -- Nothing.
+ */
+void LetoSetDepthFunction(unsigned int function);
+
+/**
+ * SetCulling
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Enable or disable face culling.
+ *
+ * @param enabled The desired state.
+ * @return void -- Nothing.
+ */
+void LetoSetCulling(bool enabled);
+
+/**
+ * SetCullFace
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Set which faces get culled when culling is enabled.
+ *
+ * @param face The face, like @ref GL_BACK.
+ * @return void -- Nothing.
+ */
+void LetoSetCullFace(unsigned int face);
+
+/**
+ * SetPolygonOffset
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Enable or disable polygon offset for filled primitives. The
+ * offset amount itself is set with @ref glPolygonOffset.
+ *
+ * @param enabled The desired state.
+ * @return void -- Nothing.
+ */
+void LetoSetPolygonOffset(bool enabled);
+
+/**
+ * SetScissorTest
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Enable or disable the scissor test. Clears are clipped by it as
+ * well as draws.
+ *
+ * @param enabled The desired state.
+ * @return void -- Nothing.
+ */
+void LetoSetScissorTest(bool enabled);
+
+#endif // LETO__STATE_H
@@ -0,0 +1,201 @@
+/**
+ * @file Temporal.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's temporal anti-aliasing. The resolve is a
+ * single compute pass; it reads the scene and last frame's history, and
+ * writes this frame's history through an image, so the two histories
+ * just trade places every frame.
+ * @implements Temporal.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Temporal.h"          // Public interface parent
+#include <Input/Shaders.h>     // Programs, jitter, uniform locations
+#include <Rendering/Release.h> // Deferred object release
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The width and height of one of the resolve's work groups. This
+ * must match the shader's local size.
+ */
+#define GROUP_SIZE 8
+
+/**
+ * @brief The indices of the resolve program's uniform locations.
+ */
+#define JITTER_UNIFORM 0
+#define REPROJECTION_UNIFORM 1
+#define BLEND_UNIFORM 2
+
+/**
+ * Halton
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get an entry of a Halton sequence.
+ *
+ * @param index The index of the entry, from one.
+ * @param base The base of the sequence; a prime.
+ * @return float -- The entry, from 0 to 1.
+ */
+static float Halton_(size_t index, size_t base)
+{
+    float result = 0.0f, fraction = 1.0f;
+    while (index > 0)
+    {
+        fraction /= (float)base;
+        result += fraction * (float)(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+/**
+ * MakeHistory
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Remake both histories at the given size. The old ones are
+ * released, so frames still using them are safe.
+ *
+ * @param temporal The accumulator.
+ * @param width The width of the history, in pixels.
+ * @param height The height of the history, in pixels.
+ * @return void -- Nothing.
+ */
+static void MakeHistory_(leto_temporal_t *temporal, int width, int height)
+{
+    for (size_t i = 0; i < 2; i++)
+    {
+        LetoReleaseObject(texture_object, temporal->history[i]);
+        temporal->history[i] = LetoAcquireTexture(
+            GL_TEXTURE_2D, 1, GL_RGBA16F, width, height, 1);
+        // Reprojected lookups land between texels, and off the edge.
+        const unsigned int texture = temporal->history[i];
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    temporal->width = width;
+    temporal->height = height;
+    temporal->reset = true;
+}
+
+bool LetoCreateTemporal(leto_temporal_t *temporal)
+{
+    if (temporal == NULL) return false;
+    memset(temporal, 0, sizeof(leto_temporal_t));
+
+    temporal->program = LetoLoadComputeShader("temporal");
+    if (temporal->program == 0) return false;
+
+    const char *names[3] = {"jitter", "reprojection", "blend"};
+    for (size_t i = 0; i < 3; i++)
+        temporal->uniforms[i] =
+            glGetUniformLocation(temporal->program, names[i]);
+
+    temporal->upscale = true;
+    temporal->reset = true;
+    temporal->blend = LETO_TEMPORAL_BLEND;
+    glm_mat4_identity(temporal->view_projection);
+    glm_mat4_identity(temporal->previous);
+    return true;
+}
+
+void LetoDestroyTemporal(leto_temporal_t *temporal)
+{
+    if (temporal == NULL) return;
+
+    LetoReleaseObject(texture_object, temporal->history[0]);
+    LetoReleaseObject(texture_object, temporal->history[1]);
+    if (temporal->program != 0) LetoUnloadShader(temporal->program);
+    memset(temporal, 0, sizeof(leto_temporal_t));
+}
+
+void LetoBeginTemporalFrame(leto_temporal_t *temporal,
+                            mat4 view_projection, int width, int height,
+                            int output_width, int output_height)
+{
+    if (temporal == NULL || width <= 0 || height <= 0) return;
+
+    const int history_width = temporal->upscale ? output_width : width;
+    const int history_height = temporal->upscale ? output_height : height;
+    if (history_width != temporal->width ||
+        history_height != temporal->height || temporal->history[0] == 0)
+        MakeHistory_(temporal, history_width, history_height);
+    temporal->current = 1 - temporal->current;
+
+    // Without a history there's nothing to move relative to, either.
+    glm_mat4_copy(temporal->reset ? view_projection
+                                  : temporal->view_projection,
+                  temporal->previous);
+    glm_mat4_copy(view_projection, temporal->view_projection);
+
+    // Jitter by up to half a pixel of the scene each way, not of the
+    // output; it's the scene's pixels that need covering.
+    temporal->sample = (temporal->sample + 1) % LETO_TEMPORAL_SAMPLES;
+    temporal->jitter[0] =
+        (Halton_(temporal->sample + 1, 2) - 0.5f) * 2.0f / (float)width;
+    temporal->jitter[1] =
+        (Halton_(temporal->sample + 1, 3) - 0.5f) * 2.0f / (float)height;
+    LetoSetProjectionJitter(temporal->jitter[0], temporal->jitter[1]);
+}
+
+void LetoSetTemporalUniforms(const leto_temporal_t *temporal,
+                             unsigned int program)
+{
+    if (temporal == NULL) return;
+
+    int location = LetoGetUniformLocation(
+        program, uniform_previous_view_projection);
+    glProgramUniformMatrix4fv(program, location, 1, GL_FALSE,
+                              &temporal->previous[0][0]);
+}
+
+void LetoResolveTemporal(leto_temporal_t *temporal, unsigned int color,
+                         unsigned int velocity, unsigned int depth)
+{
+    if (temporal == NULL || temporal->program == 0) return;
+    if (temporal->history[0] == 0) return;
+
+    const unsigned int program = temporal->program;
+    const int *uniforms = temporal->uniforms;
+    LetoUseProgram(program);
+    LetoBindTextureUnit(0, color);
+    LetoBindTextureUnit(1, velocity);
+    LetoBindTextureUnit(2, depth);
+    LetoBindTextureUnit(3, temporal->history[1 - temporal->current]);
+    glBindImageTexture(0, temporal->history[temporal->current], 0,
+                       GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    // Takes a point on screen now to where it was last frame, for the
+    // pixels nothing was drawn over.
+    mat4 inverse, reprojection;
+    glm_mat4_inv(temporal->view_projection, inverse);
+    glm_mat4_mul(temporal->previous, inverse, reprojection);
+
+    glProgramUniform2fv(program, uniforms[JITTER_UNIFORM], 1,
+                        temporal->jitter);
+    glProgramUniformMatrix4fv(program, uniforms[REPROJECTION_UNIFORM], 1,
+                              GL_FALSE, &reprojection[0][0]);
+    glProgramUniform1f(program, uniforms[BLEND_UNIFORM],
+                       temporal->reset ? 1.0f : temporal->blend);
+
+    glDispatchCompute(
+        (unsigned int)(temporal->width + GROUP_SIZE - 1) / GROUP_SIZE,
+        (unsigned int)(temporal->height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+    // The output is sampled, now to be shown and next frame as history.
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    temporal->reset = false;
+}
+
+unsigned int LetoGetTemporalOutput(const leto_temporal_t *temporal)
+{
+    if (temporal == NULL) return 0;
+    return temporal->history[temporal->current];
+}
@@ -0,0 +1,178 @@
+/**
+ * @file Temporal.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's temporal anti-aliasing. Every frame's projection
+ * is jittered by a different fraction of a pixel, and the frames are
+ * accumulated into a history; each pixel finds where it was last frame
+ * through the velocity buffer, and the history is clamped to what its
+ * neighbourhood looks like now so that stale colors don't smear. The
+ * history can be kept at the window's size while the scene is drawn
+ * smaller, which makes the resolve an upscale as well.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__TEMPORAL_H
+#define LETO__TEMPORAL_H
+
+// GLM 4x4 matrices.
+#include <CGLM/mat4.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size and offset types.
+#include <stddef.h>
+
+/**
+ * @brief The length of the jitter sequence. Jitter comes from the (2, 3)
+ * Halton sequence, which covers a pixel evenly at any length.
+ */
+#define LETO_TEMPORAL_SAMPLES 8
+
+/**
+ * @brief How much of each new frame is blended into the history.
+ */
+#define LETO_TEMPORAL_BLEND 0.1f
+
+/**
+ * @brief A temporal accumulator. This struct should only be modified
+ * through the functions below, besides its @ref upscale and @ref blend
+ * members, and @ref reset.
+ */
+typedef struct leto_temporal
+{
+    /**
+     * @brief The OpenGL ID of the resolve program.
+     */
+    unsigned int program;
+    /**
+     * @brief The OpenGL IDs of the two history textures. One is read as
+     * last frame's while the other is written as this frame's.
+     */
+    unsigned int history[2];
+    /**
+     * @brief The history this frame writes.
+     */
+    size_t current;
+    /**
+     * @brief The size of the history, in pixels.
+     */
+    int width, height;
+    /**
+     * @brief Whether the history is kept at the output's size, rather
+     * than the scene's.
+     */
+    bool upscale;
+    /**
+     * @brief Whether the history should be thrown away this frame, like
+     * after a camera cut. This is set whenever the history is remade.
+     */
+    bool reset;
+    /**
+     * @brief How much of each new frame is blended into the history.
+     */
+    float blend;
+    /**
+     * @brief The frame's place in the jitter sequence.
+     */
+    size_t sample;
+    /**
+     * @brief The frame's jitter, in normalized device coordinates.
+     */
+    vec2 jitter;
+    /**
+     * @brief The unjittered view-projection matrices of this frame and
+     * the last.
+     */
+    mat4 view_projection, previous;
+    /**
+     * @brief The locations of the resolve program's uniforms.
+     */
+    int uniforms[3];
+} leto_temporal_t;
+
+/**
+ * CreateTemporal
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create a temporal accumulator with no history, loading the
+ * "temporal" compute program. Upscaling is on. This must be called after
+ * the OpenGL context is current.
+ *
+ * @param temporal The accumulator to initialize.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateTemporal(leto_temporal_t *temporal);
+
+/**
+ * DestroyTemporal
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything an accumulator owns.
+ *
+ * @param temporal The accumulator to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyTemporal(leto_temporal_t *temporal);
+
+/**
+ * BeginTemporalFrame
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move on to the next frame; pick its jitter and hand it to @ref
+ * LetoSetProjectionJitter, and remake the history if its size changed.
+ * This should be called once a frame, before any projection is set.
+ *
+ * @param temporal The accumulator.
+ * @param view_projection The frame's unjittered view-projection matrix.
+ * @param width The width the scene is drawn at, in pixels.
+ * @param height The height the scene is drawn at, in pixels.
+ * @param output_width The width of the output, in pixels.
+ * @param output_height The height of the output, in pixels.
+ * @return void -- Nothing.
+ */
+void LetoBeginTemporalFrame(leto_temporal_t *temporal,
+                            mat4 view_projection, int width, int height,
+                            int output_width, int output_height);
+
+/**
+ * SetTemporalUniforms
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Hand a program last frame's view-projection matrix, as
+ * "previous_view_projection", so it can write the velocity buffer.
+ *
+ * @param temporal The accumulator.
+ * @param program The OpenGL ID of the program.
+ * @return void -- Nothing.
+ */
+void LetoSetTemporalUniforms(const leto_temporal_t *temporal,
+                             unsigned int program);
+
+/**
+ * ResolveTemporal
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Blend the frame into the history. Texture units 0 through 3 and
+ * image unit 0 are left bound to the resolve's inputs and output.
+ *
+ * @param temporal The accumulator.
+ * @param color The OpenGL ID of the scene's color.
+ * @param velocity The OpenGL ID of the scene's velocity; a two-channel
+ * texture of how far each pixel moved since last frame, in texture
+ * coordinates.
+ * @param depth The OpenGL ID of the scene's depth.
+ * @return void -- Nothing.
+ */
+void LetoResolveTemporal(leto_temporal_t *temporal, unsigned int color,
+                         unsigned int velocity, unsigned int depth);
+
+/**
+ * GetTemporalOutput
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the history written this frame.
+ *
+ * @param temporal The accumulator.
+ * @return unsigned int -- The OpenGL ID of the texture, an RGBA16F one
+ * of @ref leto_temporal_t.width by @ref leto_temporal_t.height pixels.
+ */
+unsigned int LetoGetTemporalOutput(const leto_temporal_t *temporal);
+
+#endif // LETO__TEMPORAL_H
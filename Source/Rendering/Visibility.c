@@ -0,0 +1,395 @@
+/**
+ * @file Visibility.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's visibility buffer. The geometry pass needs no
+ * material state, so draws are only grouped by vertex format, with a
+ * counting sort, and each is its own single-instance command; a draw finds
+ * its record through gl_BaseInstance. The shading pass is one full-screen
+ * triangle per vertex format, each finding its pixels' draws with a
+ * binary search over that format's records.
+ * @implements Visibility.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Visibility.h"        // Public interface parent
+#include <Input/Shaders.h>     // Program loading
+#include <Output/Errors.h>     // Error reporting
+#include <Rendering/Release.h> // Frame counting, deferred release
+#include <Rendering/State.h>   // OpenGL state cache
+
+#include <GLAD2/gl.h> // OpenGL function pointers
+
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The indices of the shading program's uniform locations.
+ */
+#define STRIDE_UNIFORM 0
+#define ATTRIBUTES_UNIFORM 1
+#define RANGE_UNIFORM 2
+
+// Shaders index the draw array with a 32-bit stride.
+_Static_assert(sizeof(leto_visibility_draw_t) == 32,
+               "Visibility draws must match the std430 layout.");
+
+/**
+ * Reserve
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure the renderer has room for the given amount of draws.
+ *
+ * @param visibility The renderer.
+ * @param capacity The amount of draws needed.
+ * @return bool -- True for success, false for failure.
+ */
+static bool Reserve_(leto_visibility_t *visibility, size_t capacity)
+{
+    if (capacity <= visibility->capacity) return true;
+    if (capacity < visibility->capacity * 2)
+        capacity = visibility->capacity * 2;
+
+    // Each array only takes the new capacity once every one has it, so
+    // failure leaves the renderer as it was.
+    void *arrays[4] = {
+        realloc(visibility->draws,
+                capacity * sizeof(leto_visibility_draw_t)),
+        realloc(visibility->commands,
+                capacity * sizeof(leto_draw_command_t)),
+        realloc(visibility->instances,
+                capacity * sizeof(leto_instance_t)),
+        realloc(visibility->formats, capacity * sizeof(uint32_t))};
+    if (arrays[0] != NULL) visibility->draws = arrays[0];
+    if (arrays[1] != NULL) visibility->commands = arrays[1];
+    if (arrays[2] != NULL) visibility->instances = arrays[2];
+    if (arrays[3] != NULL) visibility->formats = arrays[3];
+    for (size_t i = 0; i < 4; i++)
+    {
+        if (arrays[i] != NULL) continue;
+        LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+        return false;
+    }
+
+    visibility->capacity = capacity;
+    return true;
+}
+
+/**
+ * AddMotion
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Store last frame's matrix of a moving draw.
+ *
+ * @param visibility The renderer.
+ * @param previous The matrix, with the mesh's dequantization applied.
+ * @return uint32_t -- One past the matrix's slot, or zero if there was no
+ * room for it.
+ */
+static uint32_t AddMotion_(leto_visibility_t *visibility, mat4 previous)
+{
+    if (visibility->motion_count == visibility->motion_capacity)
+    {
+        size_t capacity = visibility->motion_capacity * 2;
+        if (capacity < 64) capacity = 64;
+        leto_motion_t *motions = realloc(
+            visibility->motions, capacity * sizeof(leto_motion_t));
+        if (motions == NULL)
+        {
+            LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+            return 0;
+        }
+        visibility->motions = motions;
+        visibility->motion_capacity = capacity;
+    }
+
+    memcpy(visibility->motions[visibility->motion_count].model, previous,
+           sizeof(mat4));
+    return (uint32_t)++visibility->motion_count;
+}
+
+/**
+ * Upload
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Sort the frame's draws by vertex format, number their triangles,
+ * and write them into the ring.
+ *
+ * @param visibility The renderer.
+ * @return bool -- True for success, false for failure.
+ */
+static bool Upload_(leto_visibility_t *visibility)
+{
+    const size_t count = visibility->count;
+    uint32_t triangles[LETO_MAX_VERTEX_FORMATS] = {0};
+    memset(visibility->format_count, 0,
+           sizeof(visibility->format_count));
+    for (size_t i = 0; i < count; i++)
+    {
+        visibility->format_count[visibility->formats[i]]++;
+        triangles[visibility->formats[i]] +=
+            visibility->draws[i].triangle_count;
+    }
+
+    // Zero is kept for where nothing was drawn. Four billion triangles a
+    // frame is well past anything that could be drawn, so the count
+    // never wraps.
+    uint32_t cursor[LETO_MAX_VERTEX_FORMATS], first = 0, triangle = 1;
+    for (size_t i = 0; i < LETO_MAX_VERTEX_FORMATS; i++)
+    {
+        visibility->format_first[i] = cursor[i] = first;
+        first += visibility->format_count[i];
+        const uint32_t format_triangles = triangles[i];
+        triangles[i] = triangle;
+        triangle += format_triangles;
+    }
+
+    // Every draw of the frame goes in one piece: instances, motions,
+    // records, and then commands.
+    if (visibility->frame != LetoGetFrame())
+        LetoAdvanceRingBuffer(&visibility->ring);
+    visibility->frame = LetoGetFrame();
+    const size_t align = visibility->ring.alignment;
+    const size_t motion_size =
+        visibility->motion_count * sizeof(leto_motion_t);
+    visibility->motion_offset =
+        (count * sizeof(leto_instance_t) + align - 1) / align * align;
+    visibility->draw_offset =
+        visibility->motion_offset +
+        (motion_size + align - 1) / align * align;
+    visibility->command_offset =
+        visibility->draw_offset +
+        (count * sizeof(leto_visibility_draw_t) + align - 1) / align *
+            align;
+    if (!LetoAllocateRing(&visibility->ring,
+                          visibility->command_offset +
+                              count * sizeof(leto_draw_command_t),
+                          &visibility->upload))
+        return false;
+
+    unsigned char *data = visibility->upload.data;
+    leto_instance_t *instances = (leto_instance_t *)data;
+    leto_visibility_draw_t *draws =
+        (leto_visibility_draw_t *)(data + visibility->draw_offset);
+    leto_draw_command_t *commands =
+        (leto_draw_command_t *)(data + visibility->command_offset);
+    memcpy(data + visibility->motion_offset, visibility->motions,
+           motion_size);
+    // Within a format, slots keep the order draws were submitted in, so
+    // their IDs rise with their slot.
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t format = visibility->formats[i];
+        const uint32_t slot = cursor[format]++;
+        leto_visibility_draw_t draw = visibility->draws[i];
+        draw.first_triangle = triangles[format];
+        triangles[format] += draw.triangle_count;
+
+        instances[slot] = visibility->instances[i];
+        draws[slot] = draw;
+        commands[slot] = visibility->commands[i];
+        commands[slot].instance_count = 1;
+        commands[slot].base_instance = slot;
+    }
+    return true;
+}
+
+/**
+ * BindUpload
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Bind the frame's instances, motions, and records.
+ *
+ * @param visibility The renderer.
+ * @return void -- Nothing.
+ */
+static void BindUpload_(const leto_visibility_t *visibility)
+{
+    const leto_ring_allocation_t *upload = &visibility->upload;
+    LetoBindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, LETO_INSTANCE_BINDING, upload->buffer,
+        upload->offset,
+        (ptrdiff_t)(visibility->count * sizeof(leto_instance_t)));
+    if (visibility->motion_count != 0)
+        LetoBindBufferRange(
+            GL_SHADER_STORAGE_BUFFER, LETO_MOTION_BINDING, upload->buffer,
+            upload->offset + (ptrdiff_t)visibility->motion_offset,
+            (ptrdiff_t)(visibility->motion_count * sizeof(leto_motion_t)));
+    LetoBindBufferRange(
+        GL_SHADER_STORAGE_BUFFER, LETO_VISIBILITY_DRAW_BINDING,
+        upload->buffer,
+        upload->offset + (ptrdiff_t)visibility->draw_offset,
+        (ptrdiff_t)(visibility->count * sizeof(leto_visibility_draw_t)));
+}
+
+bool LetoCreateVisibility(leto_visibility_t *visibility, size_t capacity)
+{
+    if (visibility == NULL) return false;
+    memset(visibility, 0, sizeof(leto_visibility_t));
+    if (!Reserve_(visibility, capacity < 64 ? 64 : capacity))
+        return false;
+
+    const size_t frame_size =
+        visibility->capacity *
+        (sizeof(leto_instance_t) + sizeof(leto_visibility_draw_t) +
+         sizeof(leto_draw_command_t));
+    if (!LetoCreateRingBuffer(&visibility->ring, frame_size))
+    {
+        LetoDestroyVisibility(visibility);
+        return false;
+    }
+
+    visibility->geometry_program = LetoLoadShader("visibility");
+    visibility->shade_program = LetoLoadShader("shade");
+    if (visibility->geometry_program == 0 ||
+        visibility->shade_program == 0)
+    {
+        LetoDestroyVisibility(visibility);
+        return false;
+    }
+
+    const char *names[3] = {"vertex_stride", "vertex_attributes",
+                            "draw_range"};
+    for (size_t i = 0; i < 3; i++)
+        visibility->uniforms[i] =
+            glGetUniformLocation(visibility->shade_program, names[i]);
+
+    glCreateVertexArrays(1, &visibility->vertex_array);
+    return true;
+}
+
+void LetoDestroyVisibility(leto_visibility_t *visibility)
+{
+    if (visibility == NULL) return;
+
+    LetoDestroyRingBuffer(&visibility->ring);
+    LetoReleaseObject(vertex_array_object, visibility->vertex_array);
+    if (visibility->geometry_program != 0)
+        LetoUnloadShader(visibility->geometry_program);
+    if (visibility->shade_program != 0)
+        LetoUnloadShader(visibility->shade_program);
+    free(visibility->draws);
+    free(visibility->commands);
+    free(visibility->instances);
+    free(visibility->formats);
+    free(visibility->motions);
+    memset(visibility, 0, sizeof(leto_visibility_t));
+}
+
+void LetoSubmitVisibility(leto_visibility_t *visibility,
+                          const leto_material_t *material,
+                          const leto_mesh_t *mesh, size_t submesh,
+                          size_t lod, mat4 model, mat4 previous)
+{
+    if (visibility == NULL || material == NULL || mesh == NULL) return;
+    if (mesh->geometry.format >= LETO_MAX_VERTEX_FORMATS) return;
+
+    leto_draw_command_t command = {0};
+    if (!LetoGetSubmeshCommand(mesh, submesh, lod, &command)) return;
+    if (!Reserve_(visibility, visibility->count + 1)) return;
+
+    const size_t index = visibility->count++;
+    visibility->commands[index] = command;
+    visibility->formats[index] = mesh->geometry.format;
+    visibility->draws[index] = (leto_visibility_draw_t){
+        .triangle_count = command.index_count / 3,
+        .first_index = command.first_index,
+        .base_vertex = command.base_vertex,
+        .material = material->slot};
+
+    leto_instance_t *instance = &visibility->instances[index];
+    LetoSetInstanceTransform(instance, mesh, model);
+    instance->material = material->slot;
+    instance->motion = 0;
+    if (previous == NULL) return;
+
+    mat4 world;
+    glm_mat4_mul(previous, (vec4 *)mesh->dequantize, world);
+    instance->motion = AddMotion_(visibility, world);
+}
+
+size_t LetoDrawVisibility(leto_visibility_t *visibility,
+                          leto_program_function_t function,
+                          void *argument)
+{
+    if (visibility == NULL || visibility->count == 0) return 0;
+    if (!Upload_(visibility))
+    {
+        visibility->count = visibility->motion_count = 0;
+        return 0;
+    }
+
+    BindUpload_(visibility);
+    LetoBindBuffer(GL_DRAW_INDIRECT_BUFFER, visibility->upload.buffer);
+    LetoUseProgram(visibility->geometry_program);
+    if (function != NULL)
+        function(visibility->geometry_program, argument);
+
+    for (uint32_t i = 0; i < LETO_MAX_VERTEX_FORMATS; i++)
+    {
+        if (visibility->format_count[i] == 0) continue;
+        LetoBindGeometry(i);
+        const size_t command =
+            (size_t)visibility->upload.offset +
+            visibility->command_offset +
+            visibility->format_first[i] * sizeof(leto_draw_command_t);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    (const void *)command,
+                                    (int)visibility->format_count[i], 0);
+    }
+
+    visibility->drawn = true;
+    return visibility->count;
+}
+
+void LetoShadeVisibility(leto_visibility_t *visibility,
+                         unsigned int buffer,
+                         leto_program_function_t function,
+                         void *argument)
+{
+    if (visibility == NULL) return;
+    if (!visibility->drawn)
+    {
+        visibility->count = visibility->motion_count = 0;
+        return;
+    }
+
+    const unsigned int program = visibility->shade_program;
+    const int *uniforms = visibility->uniforms;
+    BindUpload_(visibility);
+    LetoUseProgram(program);
+    if (function != NULL) function(program, argument);
+    LetoSetDepthTest(false);
+    LetoBindTextureUnit(LETO_VISIBILITY_TEXTURE_UNIT, buffer);
+    LetoBindVertexArray(visibility->vertex_array);
+
+    for (uint32_t i = 0; i < LETO_MAX_VERTEX_FORMATS; i++)
+    {
+        if (visibility->format_count[i] == 0) continue;
+
+        uint32_t stride = 0;
+        const leto_mesh_attribute_t *attributes =
+            LetoGetVertexFormat(i, &stride);
+        if (attributes == NULL) continue;
+        LetoBindGeometryStorage(i, LETO_VISIBILITY_VERTEX_BINDING,
+                                LETO_VISIBILITY_INDEX_BINDING);
+
+        // Each attribute as its format, components, and offset.
+        unsigned int layout[LETO_MESH_ATTRIBUTES][3];
+        for (size_t j = 0; j < LETO_MESH_ATTRIBUTES; j++)
+        {
+            layout[j][0] = attributes[j].format;
+            layout[j][1] = attributes[j].components;
+            layout[j][2] = attributes[j].offset;
+        }
+        const unsigned int range[2] = {visibility->format_first[i],
+                                       visibility->format_count[i]};
+        glProgramUniform1ui(program, uniforms[STRIDE_UNIFORM], stride);
+        glProgramUniform3uiv(program, uniforms[ATTRIBUTES_UNIFORM],
+                             LETO_MESH_ATTRIBUTES, &layout[0][0]);
+        glProgramUniform2uiv(program, uniforms[RANGE_UNIFORM], 1, range);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    visibility->count = visibility->motion_count = 0;
+    visibility->drawn = false;
+}
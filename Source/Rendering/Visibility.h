@@ -0,0 +1,232 @@
+/**
+ * @file Visibility.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides Leto's visibility buffer. Geometry is drawn once with
+ * nothing but depth and a 32-bit ID per pixel, naming the triangle that
+ * covers it; a full-screen pass then fetches that triangle's vertices,
+ * interpolates them itself, and shades every pixel exactly once. Small
+ * triangles cost the geometry pass next to nothing, where a forward pass
+ * would shade each of them in whole 2x2 quads.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__VISIBILITY_H
+#define LETO__VISIBILITY_H
+
+// The engine's command buffers, for the program function.
+#include <Rendering/Commands.h>
+// The engine's render queue, for instance and motion data.
+#include <Rendering/Queue.h>
+
+/**
+ * @brief The shader storage binding point the visibility draw records are
+ * bound to; "layout(std430, binding = 13)".
+ */
+#define LETO_VISIBILITY_DRAW_BINDING 13
+
+/**
+ * @brief The shader storage binding points the arena's vertices and
+ * indices are bound to while shading.
+ */
+#define LETO_VISIBILITY_VERTEX_BINDING 14
+#define LETO_VISIBILITY_INDEX_BINDING 15
+
+/**
+ * @brief The texture unit the visibility buffer is bound to while
+ * shading. The buffer is a single-channel 32-bit unsigned integer
+ * texture, holding zero wherever nothing was drawn.
+ */
+#define LETO_VISIBILITY_TEXTURE_UNIT 6
+
+/**
+ * @brief A single draw as the visibility shaders see it. This is laid out
+ * to match std430, and is exactly 32 bytes long. IDs are a running count
+ * of triangles over every draw of the frame, so neither the draw nor the
+ * triangle within it has a fixed share of the 32 bits.
+ */
+typedef struct leto_visibility_draw
+{
+    /**
+     * @brief The ID of the draw's first triangle. Draws of one vertex
+     * format are contiguous, and their IDs rise with their index.
+     */
+    uint32_t first_triangle;
+    /**
+     * @brief The amount of triangles of the draw.
+     */
+    uint32_t triangle_count;
+    /**
+     * @brief The draw's first index within its arena's index buffer.
+     */
+    uint32_t first_index;
+    /**
+     * @brief The first vertex of the draw's mesh within its arena.
+     */
+    int32_t base_vertex;
+    /**
+     * @brief The material slot of the draw. Its instance has the same
+     * index in the instance buffer as the draw itself.
+     */
+    uint32_t material;
+    /**
+     * @brief Padding to a 16-byte multiple.
+     */
+    uint32_t _[3];
+} leto_visibility_draw_t;
+
+/**
+ * @brief A visibility buffer renderer. This struct should only be modified
+ * through the functions below.
+ */
+typedef struct leto_visibility
+{
+    /**
+     * @brief The OpenGL IDs of the geometry and shading programs.
+     */
+    unsigned int geometry_program, shade_program;
+    /**
+     * @brief The locations of the shading program's uniforms.
+     */
+    int uniforms[3];
+    /**
+     * @brief The OpenGL ID of the empty vertex array the shading pass is
+     * drawn with.
+     */
+    unsigned int vertex_array;
+    /**
+     * @brief Every draw submitted this frame, in the order it was
+     * submitted; its record, indirect command, instance, and format.
+     */
+    leto_visibility_draw_t *draws;
+    leto_draw_command_t *commands;
+    leto_instance_t *instances;
+    uint32_t *formats;
+    /**
+     * @brief The amount of draws submitted, and the amount there's room
+     * for.
+     */
+    size_t count, capacity;
+    /**
+     * @brief The previous matrices of the draws submitted as moving, the
+     * amount of them, and the amount there's room for.
+     */
+    leto_motion_t *motions;
+    size_t motion_count, motion_capacity;
+    /**
+     * @brief The first draw of each vertex format once they're sorted,
+     * and the amount of them; every format's draws follow the last's.
+     */
+    uint32_t format_first[LETO_MAX_VERTEX_FORMATS];
+    uint32_t format_count[LETO_MAX_VERTEX_FORMATS];
+    /**
+     * @brief Where the frame's draws went in @ref ring, and the offsets
+     * of its motions, records, and commands within that.
+     */
+    leto_ring_allocation_t upload;
+    size_t motion_offset, draw_offset, command_offset;
+    /**
+     * @brief Whether the frame's draws have been drawn, and can be
+     * shaded.
+     */
+    bool drawn;
+    /**
+     * @brief The ring each frame's draws are written into.
+     */
+    leto_ring_buffer_t ring;
+    /**
+     * @brief The frame the ring was last moved on in.
+     */
+    uint64_t frame;
+} leto_visibility_t;
+
+/**
+ * CreateVisibility
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create a visibility buffer renderer, loading the "visibility"
+ * and "shade" programs. This must be called after the OpenGL context is
+ * current.
+ *
+ * @param visibility The renderer to initialize.
+ * @param capacity The amount of draws to make room for up front. The
+ * renderer grows past this if it has to.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateVisibility(leto_visibility_t *visibility, size_t capacity);
+
+/**
+ * DestroyVisibility
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a renderer owns.
+ *
+ * @param visibility The renderer to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyVisibility(leto_visibility_t *visibility);
+
+/**
+ * SubmitVisibility
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Submit a submesh to be drawn into the visibility buffer this
+ * frame. Only opaque geometry belongs here; nothing is blended, and no
+ * alpha test is done.
+ *
+ * @param visibility The renderer.
+ * @param material The material to shade with.
+ * @param mesh The mesh to draw. This must stay valid until the frame is
+ * shaded.
+ * @param submesh The submesh to draw.
+ * @param lod The level of detail to draw.
+ * @param model The object-to-world matrix, without the mesh's
+ * dequantization.
+ * @param previous Last frame's object-to-world matrix, the same way, or
+ * NULL if the draw hasn't moved.
+ * @return void -- Nothing.
+ */
+void LetoSubmitVisibility(leto_visibility_t *visibility,
+                          const leto_material_t *material,
+                          const leto_mesh_t *mesh, size_t submesh,
+                          size_t lod, mat4 model, mat4 previous);
+
+/**
+ * DrawVisibility
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Draw every submitted draw into the bound framebuffer, whose
+ * first color attachment should be an R32UI texture cleared to zero; one
+ * multi-draw indirect call per vertex format.
+ *
+ * @param visibility The renderer.
+ * @param function Called with the geometry program before anything's
+ * drawn, so it can be given its camera, or NULL.
+ * @param argument What the function is given.
+ * @return size_t -- The amount of draws made.
+ */
+size_t LetoDrawVisibility(leto_visibility_t *visibility,
+                          leto_program_function_t function,
+                          void *argument);
+
+/**
+ * ShadeVisibility
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Shade every pixel of the visibility buffer drawn this frame into
+ * the bound framebuffer; color to the first attachment, and velocity, as
+ * the forward pass writes it, to the second. Pixels nothing was drawn
+ * over are left alone, and depth testing is turned off. The renderer is
+ * empty afterwards.
+ *
+ * @param visibility The renderer.
+ * @param buffer The OpenGL ID of the visibility buffer.
+ * @param function Called with the shading program before anything's
+ * shaded, so it can be given its camera and lights, or NULL.
+ * @param argument What the function is given.
+ * @return void -- Nothing.
+ */
+void LetoShadeVisibility(leto_visibility_t *visibility,
+                         unsigned int buffer,
+                         leto_program_function_t function,
+                         void *argument);
+
+#endif // LETO__VISIBILITY_H
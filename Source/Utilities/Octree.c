@@ -0,0 +1,582 @@
+/**
+ * @file Octree.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements Leto's loose octree. Nodes are made on demand in
+ * blocks of eight and given back once their branch empties, so the tree
+ * only ever covers where things actually are.
+ * @implements Octree.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Octree.h"        // Public interface parent
+#include <Output/Errors.h> // Error reporting
+
+#include <math.h>   // Standard math functions
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The amount of nodes and objects an octree starts with room for.
+ */
+#define INITIAL_CAPACITY 64
+
+/**
+ * @brief The deepest a traversal stack can get; each level leaves at most
+ * seven siblings behind.
+ */
+#define STACK_SIZE (7 * LETO_OCTREE_MAX_DEPTH + 8)
+
+/**
+ * @brief The shapes the tree can be queried with.
+ */
+typedef enum query_kind
+{
+    query_frustum,
+    query_sphere,
+    query_box,
+    query_ray
+} query_kind_t;
+
+/**
+ * @brief How much of a box a query's shape covers.
+ */
+typedef enum overlap
+{
+    overlap_none,
+    overlap_partial,
+    overlap_full
+} overlap_t;
+
+/**
+ * @brief A query's shape, in whichever form it's tested fastest.
+ */
+typedef struct query
+{
+    /**
+     * @brief The kind of shape.
+     */
+    query_kind_t kind;
+    /**
+     * @brief The frustum, for frustum queries.
+     */
+    const leto_frustum_t *frustum;
+    /**
+     * @brief The center of a sphere or box, or the origin of a ray.
+     */
+    float center[3];
+    /**
+     * @brief The half-size of a box, or the inverse direction of a ray.
+     */
+    float extent[3];
+    /**
+     * @brief The radius of a sphere, or the length of a ray.
+     */
+    float radius;
+} query_t;
+
+/**
+ * Grow
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Make sure an array has room for the given amount of elements,
+ * doubling it if not.
+ *
+ * @param array The array to grow.
+ * @param capacity The array's capacity, updated if it grows.
+ * @param needed The amount of elements needed.
+ * @param size The size of an element.
+ * @return void -- Nothing.
+ */
+static void Grow_(void **array, size_t *capacity, size_t needed,
+                  size_t size)
+{
+    if (needed <= *capacity) return;
+
+    size_t new_capacity = *capacity;
+    while (new_capacity < needed) new_capacity *= 2;
+    void *grown = realloc(*array, new_capacity * size);
+    if (grown == NULL)
+    {
+        LetoReportError(true, failed_allocation, LETO_FILE_CONTEXT);
+        return;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+}
+
+/**
+ * AllocateChildren
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give a node its eight children, reusing a freed block if there
+ * is one.
+ *
+ * @param octree The octree.
+ * @param parent The node to split.
+ * @return void -- Nothing.
+ */
+static void AllocateChildren_(leto_octree_t *octree, uint32_t parent)
+{
+    uint32_t first = octree->free_nodes;
+    if (first != LETO_OCTREE_NONE)
+        octree->free_nodes = octree->nodes[first].parent;
+    else
+    {
+        Grow_((void **)&octree->nodes, &octree->node_capacity,
+              octree->node_count + 8, sizeof(leto_octree_node_t));
+        first = (uint32_t)octree->node_count;
+        octree->node_count += 8;
+    }
+
+    const leto_octree_node_t *node = &octree->nodes[parent];
+    const float half_size = node->half_size * 0.5f;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        leto_octree_node_t *child = &octree->nodes[first + i];
+        for (size_t a = 0; a < 3; a++)
+            child->center[a] = node->center[a] +
+                               ((i >> a) & 1 ? half_size : -half_size);
+        child->half_size = half_size;
+        child->children = LETO_OCTREE_NONE;
+        child->parent = parent;
+        child->objects = LETO_OCTREE_NONE;
+        child->count = 0;
+    }
+    octree->nodes[parent].children = first;
+}
+
+/**
+ * FreeChildren
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give back a node's (empty) children and all of their
+ * descendants.
+ *
+ * @param octree The octree.
+ * @param parent The node whose branch to free.
+ * @return void -- Nothing.
+ */
+static void FreeChildren_(leto_octree_t *octree, uint32_t parent)
+{
+    const uint32_t first = octree->nodes[parent].children;
+    if (first == LETO_OCTREE_NONE) return;
+
+    for (uint32_t i = 0; i < 8; i++) FreeChildren_(octree, first + i);
+    octree->nodes[first].parent = octree->free_nodes;
+    octree->free_nodes = first;
+    octree->nodes[parent].children = LETO_OCTREE_NONE;
+}
+
+/**
+ * LargestExtent
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the largest half-size of a box.
+ *
+ * @param extent The half-size of the box along each axis.
+ * @return float -- The largest of the three.
+ */
+static float LargestExtent_(const float *extent)
+{
+    return fmaxf(fabsf(extent[0]),
+                 fmaxf(fabsf(extent[1]), fabsf(extent[2])));
+}
+
+/**
+ * InCell
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether a point is within a node's cell.
+ *
+ * @param node The node.
+ * @param point The point.
+ * @return bool -- True if the point is in the cell.
+ */
+static bool InCell_(const leto_octree_node_t *node, const float *point)
+{
+    for (size_t a = 0; a < 3; a++)
+        if (fabsf(point[a] - node->center[a]) > node->half_size)
+            return false;
+    return true;
+}
+
+/**
+ * CanDescend
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether an object of the given size belongs further down
+ * than the given node.
+ *
+ * @param octree The octree.
+ * @param node The node.
+ * @param size The largest half-size of the object.
+ * @return bool -- True if one of the node's children could hold it.
+ */
+static bool CanDescend_(const leto_octree_t *octree,
+                        const leto_octree_node_t *node, float size)
+{
+    // Halving is exact, so the deepest cells are exactly this size.
+    const float smallest =
+        ldexpf(octree->nodes[0].half_size, -LETO_OCTREE_MAX_DEPTH);
+    return node->half_size > smallest && size <= node->half_size * 0.5f;
+}
+
+/**
+ * PickNode
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find (making it if needed) the node an object belongs in; the
+ * deepest whose cell holds its center and whose loose bounds hold its
+ * box.
+ *
+ * @param octree The octree.
+ * @param center The center of the object.
+ * @param size The largest half-size of the object.
+ * @return uint32_t -- The index of the node.
+ */
+static uint32_t PickNode_(leto_octree_t *octree, const float *center,
+                          float size)
+{
+    uint32_t node = 0;
+    if (!InCell_(&octree->nodes[0], center)) return node;
+
+    while (CanDescend_(octree, &octree->nodes[node], size))
+    {
+        if (octree->nodes[node].children == LETO_OCTREE_NONE)
+            AllocateChildren_(octree, node);
+
+        const leto_octree_node_t *current = &octree->nodes[node];
+        uint32_t octant = 0;
+        for (size_t a = 0; a < 3; a++)
+            octant |= (uint32_t)(center[a] >= current->center[a]) << a;
+        node = current->children + octant;
+    }
+    return node;
+}
+
+/**
+ * Link
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Put an object in a node, counting it in every ancestor.
+ *
+ * @param octree The octree.
+ * @param handle The object.
+ * @param node The node.
+ * @return void -- Nothing.
+ */
+static void Link_(leto_octree_t *octree, uint32_t handle, uint32_t node)
+{
+    leto_octree_object_t *object = &octree->objects[handle];
+    object->node = node;
+    object->previous = LETO_OCTREE_NONE;
+    object->next = octree->nodes[node].objects;
+    if (object->next != LETO_OCTREE_NONE)
+        octree->objects[object->next].previous = handle;
+    octree->nodes[node].objects = handle;
+
+    for (; node != LETO_OCTREE_NONE; node = octree->nodes[node].parent)
+        octree->nodes[node].count++;
+}
+
+/**
+ * Unlink
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take an object out of its node, and free the largest branch that
+ * leaves empty.
+ *
+ * @param octree The octree.
+ * @param handle The object.
+ * @return void -- Nothing.
+ */
+static void Unlink_(leto_octree_t *octree, uint32_t handle)
+{
+    leto_octree_object_t *object = &octree->objects[handle];
+    uint32_t node = object->node;
+
+    if (object->previous != LETO_OCTREE_NONE)
+        octree->objects[object->previous].next = object->next;
+    else octree->nodes[node].objects = object->next;
+    if (object->next != LETO_OCTREE_NONE)
+        octree->objects[object->next].previous = object->previous;
+    object->node = LETO_OCTREE_NONE;
+
+    uint32_t empty = LETO_OCTREE_NONE;
+    for (; node != LETO_OCTREE_NONE; node = octree->nodes[node].parent)
+        if (--octree->nodes[node].count == 0) empty = node;
+    if (empty != LETO_OCTREE_NONE) FreeChildren_(octree, empty);
+}
+
+/**
+ * TestBox
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check how much of a box a query's shape covers.
+ *
+ * @param query The query.
+ * @param center The center of the box.
+ * @param extent The half-size of the box along each axis.
+ * @return overlap_t -- Whether the box is outside, crossing, or entirely
+ * inside the shape.
+ */
+static overlap_t TestBox_(const query_t *query, const float *center,
+                          const float *extent)
+{
+    overlap_t overlap = overlap_full;
+    switch (query->kind)
+    {
+        case query_frustum:
+            for (size_t p = 0; p < 6; p++)
+            {
+                const float *plane = query->frustum->planes[p];
+                float distance = plane[3], radius = 0.0f;
+                for (size_t a = 0; a < 3; a++)
+                {
+                    distance += plane[a] * center[a];
+                    radius += fabsf(plane[a]) * extent[a];
+                }
+                if (distance + radius < 0.0f) return overlap_none;
+                if (distance - radius < 0.0f) overlap = overlap_partial;
+            }
+            return overlap;
+        case query_sphere:
+        {
+            float nearest = 0.0f, farthest = 0.0f;
+            for (size_t a = 0; a < 3; a++)
+            {
+                const float offset = fabsf(query->center[a] - center[a]);
+                const float outside = fmaxf(offset - extent[a], 0.0f);
+                nearest += outside * outside;
+                farthest += (offset + extent[a]) * (offset + extent[a]);
+            }
+            const float squared = query->radius * query->radius;
+            if (nearest > squared) return overlap_none;
+            return farthest <= squared ? overlap_full : overlap_partial;
+        }
+        case query_box:
+            for (size_t a = 0; a < 3; a++)
+            {
+                const float offset = fabsf(query->center[a] - center[a]);
+                if (offset > query->extent[a] + extent[a])
+                    return overlap_none;
+                if (offset + extent[a] > query->extent[a])
+                    overlap = overlap_partial;
+            }
+            return overlap;
+        case query_ray:
+        {
+            // The slab test; zero direction components give infinities,
+            // which fminf and fmaxf handle as they should.
+            float nearest = 0.0f, farthest = query->radius;
+            for (size_t a = 0; a < 3; a++)
+            {
+                const float low = (center[a] - extent[a] -
+                                   query->center[a]) * query->extent[a];
+                const float high = (center[a] + extent[a] -
+                                    query->center[a]) * query->extent[a];
+                nearest = fmaxf(nearest, fminf(low, high));
+                farthest = fminf(farthest, fmaxf(low, high));
+            }
+            return nearest <= farthest ? overlap_partial : overlap_none;
+        }
+        default: break;
+    }
+    return overlap_none;
+}
+
+/**
+ * Query
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Walk the tree, collecting every object a query's shape touches.
+ * Branches entirely inside the shape are collected without testing.
+ *
+ * @param octree The octree.
+ * @param query The query.
+ * @param results Filled with the data of every object found.
+ * @param capacity The amount of results there is room for.
+ * @return size_t -- The amount of objects found.
+ */
+static size_t Query_(const leto_octree_t *octree, const query_t *query,
+                     uint32_t *results, size_t capacity)
+{
+    if (octree == NULL || octree->nodes == NULL) return 0;
+
+    uint32_t stack[STACK_SIZE];
+    bool inside[STACK_SIZE];
+    size_t depth = 0, found = 0;
+    stack[depth] = 0;
+    inside[depth++] = false;
+
+    while (depth != 0)
+    {
+        const uint32_t index = stack[--depth];
+        bool covered = inside[depth];
+        const leto_octree_node_t *node = &octree->nodes[index];
+        if (node->count == 0) continue;
+
+        // The root is never tested as a whole, since it also holds
+        // whatever lies outside the world.
+        if (!covered && index != 0)
+        {
+            const float loose = node->half_size * 2.0f;
+            const float extent[3] = {loose, loose, loose};
+            overlap_t overlap = TestBox_(query, node->center, extent);
+            if (overlap == overlap_none) continue;
+            covered = overlap == overlap_full;
+        }
+
+        for (uint32_t handle = node->objects; handle != LETO_OCTREE_NONE;
+             handle = octree->objects[handle].next)
+        {
+            const leto_octree_object_t *object = &octree->objects[handle];
+            if (!covered &&
+                TestBox_(query, object->center, object->extent) ==
+                    overlap_none)
+                continue;
+            if (found < capacity) results[found] = object->data;
+            found++;
+        }
+
+        if (node->children == LETO_OCTREE_NONE) continue;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            stack[depth] = node->children + i;
+            inside[depth++] = covered;
+        }
+    }
+    return found;
+}
+
+bool LetoCreateOctree(leto_octree_t *octree, vec3 center, float half_size)
+{
+    if (octree == NULL || half_size <= 0.0f) return false;
+    memset(octree, 0, sizeof(leto_octree_t));
+
+    octree->nodes = malloc(INITIAL_CAPACITY * sizeof(leto_octree_node_t));
+    octree->objects =
+        malloc(INITIAL_CAPACITY * sizeof(leto_octree_object_t));
+    if (octree->nodes == NULL || octree->objects == NULL)
+    {
+        LetoReportError(false, failed_allocation, LETO_FILE_CONTEXT);
+        LetoDestroyOctree(octree);
+        return false;
+    }
+    octree->node_capacity = octree->object_capacity = INITIAL_CAPACITY;
+    octree->free_nodes = octree->free_objects = LETO_OCTREE_NONE;
+
+    octree->nodes[0] = (leto_octree_node_t){
+        .center = {center[0], center[1], center[2]},
+        .half_size = half_size,
+        .children = LETO_OCTREE_NONE,
+        .parent = LETO_OCTREE_NONE,
+        .objects = LETO_OCTREE_NONE};
+    octree->node_count = 1;
+    return true;
+}
+
+void LetoDestroyOctree(leto_octree_t *octree)
+{
+    if (octree == NULL) return;
+    free(octree->nodes);
+    free(octree->objects);
+    memset(octree, 0, sizeof(leto_octree_t));
+}
+
+uint32_t LetoInsertOctreeObject(leto_octree_t *octree, vec3 center,
+                                vec3 extent, uint32_t data)
+{
+    if (octree == NULL || octree->nodes == NULL) return LETO_OCTREE_NONE;
+
+    uint32_t handle = octree->free_objects;
+    if (handle != LETO_OCTREE_NONE)
+        octree->free_objects = octree->objects[handle].next;
+    else
+    {
+        Grow_((void **)&octree->objects, &octree->object_capacity,
+              octree->object_count + 1, sizeof(leto_octree_object_t));
+        handle = (uint32_t)octree->object_count++;
+    }
+
+    leto_octree_object_t *object = &octree->objects[handle];
+    for (size_t a = 0; a < 3; a++)
+    {
+        object->center[a] = center[a];
+        object->extent[a] = fabsf(extent[a]);
+    }
+    object->data = data;
+
+    Link_(octree, handle,
+          PickNode_(octree, center, LargestExtent_(extent)));
+    return handle;
+}
+
+void LetoUpdateOctreeObject(leto_octree_t *octree, uint32_t handle,
+                            vec3 center, vec3 extent)
+{
+    if (octree == NULL || handle >= octree->object_count) return;
+    leto_octree_object_t *object = &octree->objects[handle];
+    if (object->node == LETO_OCTREE_NONE) return;
+
+    for (size_t a = 0; a < 3; a++)
+    {
+        object->center[a] = center[a];
+        object->extent[a] = fabsf(extent[a]);
+    }
+
+    // Most movement stays within a cell, and needs nothing more.
+    const float size = LargestExtent_(extent);
+    const leto_octree_node_t *node = &octree->nodes[object->node];
+    const bool in_cell = object->node == 0
+                             ? !InCell_(node, center) ||
+                                   !CanDescend_(octree, node, size)
+                             : InCell_(node, center) &&
+                                   size <= node->half_size &&
+                                   !CanDescend_(octree, node, size);
+    if (in_cell) return;
+
+    Unlink_(octree, handle);
+    Link_(octree, handle, PickNode_(octree, center, size));
+}
+
+void LetoRemoveOctreeObject(leto_octree_t *octree, uint32_t handle)
+{
+    if (octree == NULL || handle >= octree->object_count) return;
+    if (octree->objects[handle].node == LETO_OCTREE_NONE) return;
+
+    Unlink_(octree, handle);
+    octree->objects[handle].next = octree->free_objects;
+    octree->free_objects = handle;
+}
+
+size_t LetoQueryOctreeFrustum(const leto_octree_t *octree,
+                              const leto_frustum_t *frustum,
+                              uint32_t *results, size_t capacity)
+{
+    if (frustum == NULL) return 0;
+    query_t query = {.kind = query_frustum, .frustum = frustum};
+    return Query_(octree, &query, results, capacity);
+}
+
+size_t LetoQueryOctreeSphere(const leto_octree_t *octree, vec3 center,
+                             float radius, uint32_t *results,
+                             size_t capacity)
+{
+    query_t query = {.kind = query_sphere, .radius = radius};
+    glm_vec3_copy(center, query.center);
+    return Query_(octree, &query, results, capacity);
+}
+
+size_t LetoQueryOctreeBox(const leto_octree_t *octree, vec3 center,
+                          vec3 extent, uint32_t *results, size_t capacity)
+{
+    query_t query = {.kind = query_box};
+    glm_vec3_copy(center, query.center);
+    for (size_t a = 0; a < 3; a++) query.extent[a] = fabsf(extent[a]);
+    return Query_(octree, &query, results, capacity);
+}
+
+size_t LetoQueryOctreeRay(const leto_octree_t *octree, vec3 origin,
+                          vec3 direction, float max_distance,
+                          uint32_t *results, size_t capacity)
+{
+    query_t query = {.kind = query_ray, .radius = max_distance};
+    glm_vec3_copy(origin, query.center);
+    for (size_t a = 0; a < 3; a++)
+        query.extent[a] = 1.0f / direction[a];
+    return Query_(octree, &query, results, capacity);
+}
@@ -0,0 +1,274 @@
+/**
+ * @file Octree.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides a loose octree, Leto's spatial index over the world.
+ * Every node's bounds are twice the size of its cell, so an object lives
+ * in exactly one node picked from its center and size alone; moving an
+ * object is usually just an overwrite, and never a rebuild.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__OCTREE_H
+#define LETO__OCTREE_H
+
+// The engine's frustum type.
+#include <Rendering/Culling.h>
+
+/**
+ * @brief The deepest level of the tree. The smallest cells are the root's
+ * size over two to this power.
+ */
+#define LETO_OCTREE_MAX_DEPTH 10
+
+/**
+ * @brief The value of an octree handle or index that refers to nothing.
+ */
+#define LETO_OCTREE_NONE UINT32_MAX
+
+/**
+ * @brief A node of the tree. Nodes live in one flat array, and the eight
+ * children of a node are always next to each other.
+ */
+typedef struct leto_octree_node
+{
+    /**
+     * @brief The center of the node's cell.
+     */
+    float center[3];
+    /**
+     * @brief Half the size of the node's cell. The node's loose bounds
+     * reach twice as far.
+     */
+    float half_size;
+    /**
+     * @brief The index of the first of the node's children, or @ref
+     * LETO_OCTREE_NONE for a leaf.
+     */
+    uint32_t children;
+    /**
+     * @brief The index of the node's parent, or @ref LETO_OCTREE_NONE for
+     * the root.
+     */
+    uint32_t parent;
+    /**
+     * @brief The first object held directly by the node.
+     */
+    uint32_t objects;
+    /**
+     * @brief The amount of objects held by the node and its descendants.
+     */
+    uint32_t count;
+} leto_octree_node_t;
+
+/**
+ * @brief An object in the tree.
+ */
+typedef struct leto_octree_object
+{
+    /**
+     * @brief The center of the object's box.
+     */
+    float center[3];
+    /**
+     * @brief The half-size of the object's box along each axis.
+     */
+    float extent[3];
+    /**
+     * @brief The node holding the object, or @ref LETO_OCTREE_NONE if the
+     * slot is free.
+     */
+    uint32_t node;
+    /**
+     * @brief The next object in the same node, or the next free slot.
+     */
+    uint32_t next;
+    /**
+     * @brief The previous object in the same node.
+     */
+    uint32_t previous;
+    /**
+     * @brief The value queries report for this object.
+     */
+    uint32_t data;
+} leto_octree_object_t;
+
+/**
+ * @brief A loose octree. This struct should only be modified through the
+ * functions below.
+ */
+typedef struct leto_octree
+{
+    /**
+     * @brief Every node; the root is always the first.
+     */
+    leto_octree_node_t *nodes;
+    /**
+     * @brief The amount of nodes in use, including freed blocks.
+     */
+    size_t node_count;
+    /**
+     * @brief The amount of nodes @ref nodes has room for.
+     */
+    size_t node_capacity;
+    /**
+     * @brief The first of a list of freed blocks of eight nodes, linked
+     * through their first node's parent.
+     */
+    uint32_t free_nodes;
+    /**
+     * @brief Every object slot, indexed by handle.
+     */
+    leto_octree_object_t *objects;
+    /**
+     * @brief The amount of object slots in use, including freed ones.
+     */
+    size_t object_count;
+    /**
+     * @brief The amount of object slots @ref objects has room for.
+     */
+    size_t object_capacity;
+    /**
+     * @brief The first of a list of freed object slots.
+     */
+    uint32_t free_objects;
+} leto_octree_t;
+
+/**
+ * CreateOctree
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Create an empty octree covering the given cube. Objects outside
+ * of it can still be added, but they all land in the root.
+ *
+ * @param octree The octree to initialize.
+ * @param center The center of the world.
+ * @param half_size Half the size of the world along each axis.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateOctree(leto_octree_t *octree, vec3 center, float half_size);
+
+/**
+ * DestroyOctree
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything an octree owns.
+ *
+ * @param octree The octree to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyOctree(leto_octree_t *octree);
+
+/**
+ * InsertOctreeObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add an object to an octree.
+ *
+ * @param octree The octree to add to.
+ * @param center The center of the object's box.
+ * @param extent The half-size of the object's box along each axis.
+ * @param data The value queries report for the object; usually an index
+ * into the caller's own arrays.
+ * @return uint32_t -- A handle to the object.
+ */
+uint32_t LetoInsertOctreeObject(leto_octree_t *octree, vec3 center,
+                                vec3 extent, uint32_t data);
+
+/**
+ * UpdateOctreeObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move or resize an object. Objects that stay within their node's
+ * cell are updated in place; the rest are moved to their new node.
+ *
+ * @param octree The octree holding the object.
+ * @param handle The handle of the object.
+ * @param center The new center of the object's box.
+ * @param extent The new half-size of the object's box along each axis.
+ * @return void -- Nothing.
+ */
+void LetoUpdateOctreeObject(leto_octree_t *octree, uint32_t handle,
+                            vec3 center, vec3 extent);
+
+/**
+ * RemoveOctreeObject
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Remove an object. Branches left empty are given back.
+ *
+ * @param octree The octree holding the object.
+ * @param handle The handle of the object. This is invalid afterwards.
+ * @return void -- Nothing.
+ */
+void LetoRemoveOctreeObject(leto_octree_t *octree, uint32_t handle);
+
+/**
+ * QueryOctreeFrustum
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find every object whose box is at least partially inside every
+ * plane of a frustum.
+ *
+ * @param octree The octree to search.
+ * @param frustum The frustum to search within.
+ * @param results Filled with the data of every object found.
+ * @param capacity The amount of results there is room for.
+ * @return size_t -- The amount of objects found. This may be more than
+ * @ref capacity, in which case the rest weren't written.
+ */
+size_t LetoQueryOctreeFrustum(const leto_octree_t *octree,
+                              const leto_frustum_t *frustum,
+                              uint32_t *results, size_t capacity);
+
+/**
+ * QueryOctreeSphere
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find every object whose box touches a sphere.
+ *
+ * @param octree The octree to search.
+ * @param center The center of the sphere.
+ * @param radius The radius of the sphere.
+ * @param results Filled with the data of every object found.
+ * @param capacity The amount of results there is room for.
+ * @return size_t -- The amount of objects found. This may be more than
+ * @ref capacity, in which case the rest weren't written.
+ */
+size_t LetoQueryOctreeSphere(const leto_octree_t *octree, vec3 center,
+                             float radius, uint32_t *results,
+                             size_t capacity);
+
+/**
+ * QueryOctreeBox
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find every object whose box overlaps an axis-aligned box.
+ *
+ * @param octree The octree to search.
+ * @param center The center of the box.
+ * @param extent The half-size of the box along each axis.
+ * @param results Filled with the data of every object found.
+ * @param capacity The amount of results there is room for.
+ * @return size_t -- The amount of objects found. This may be more than
+ * @ref capacity, in which case the rest weren't written.
+ */
+size_t LetoQueryOctreeBox(const leto_octree_t *octree, vec3 center,
+                          vec3 extent, uint32_t *results, size_t capacity);
+
+/**
+ * QueryOctreeRay
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find every object whose box is crossed by a ray. Results are
+ * not sorted by distance; this finds candidates for a finer test.
+ *
+ * @param octree The octree to search.
+ * @param origin The start of the ray.
+ * @param direction The direction of the ray. This needn't be normalized;
+ * distances are measured in multiples of it.
+ * @param max_distance How far along the ray to search.
+ * @param results Filled with the data of every object found.
+ * @param capacity The amount of results there is room for.
+ * @return size_t -- The amount of objects found. This may be more than
+ * @ref capacity, in which case the rest weren't written.
+ */
+size_t LetoQueryOctreeRay(const leto_octree_t *octree, vec3 origin,
+                          vec3 direction, float max_distance,
+                          uint32_t *results, size_t capacity);
+
+#endif // LETO__OCTREE_H
@@ -0,0 +1,384 @@
+/**
+ * @file Simd.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides the handful of vector operations Leto's CPU-side
+ * passes are written in, over the widest float vector the build targets;
+ * eight lanes on AVX2, four on SSE2 and NEON, and one anywhere else.
+ * Everything here is inlined, so code written against it compiles to the
+ * same instructions as the intrinsics themselves.
+ * @date 2026-10-19
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__SIMD_H
+#define LETO__SIMD_H
+
+// Platform detection macros.
+#include <Diagnostic/Platform.h>
+// Standard math functions.
+#include <math.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+
+#if defined(__AVX2__)
+    // AVX2 intrinsics.
+    #include <immintrin.h>
+#elif defined(LETO_X86_64) || defined(__SSE2__)
+    // SSE2 intrinsics.
+    #include <emmintrin.h>
+#elif defined(LETO_ARM_X64)
+    // NEON intrinsics.
+    #include <arm_neon.h>
+#endif
+
+/**
+ * @brief The alignment of anything loaded or stored as a whole vector,
+ * enough for the widest vector any build uses.
+ */
+#define LETO_SIMD_ALIGNMENT 32
+
+#if defined(__AVX2__)
+    /**
+     * @brief The amount of floats in a vector.
+     */
+    #define LETO_SIMD_WIDTH 8
+/**
+ * @brief A vector of floats.
+ */
+typedef __m256 leto_simd_t;
+/**
+ * @brief The result of comparing two vectors; every bit of a lane is set
+ * where the comparison held.
+ */
+typedef __m256 leto_simd_mask_t;
+#elif defined(LETO_X86_64) || defined(__SSE2__)
+    #define LETO_SIMD_WIDTH 4
+typedef __m128 leto_simd_t;
+typedef __m128 leto_simd_mask_t;
+#elif defined(LETO_ARM_X64)
+    #define LETO_SIMD_WIDTH 4
+typedef float32x4_t leto_simd_t;
+typedef uint32x4_t leto_simd_mask_t;
+#else
+    #define LETO_SIMD_WIDTH 1
+typedef float leto_simd_t;
+typedef bool leto_simd_mask_t;
+#endif
+
+// Broadcasting, the lane indices, aligned loads and stores, arithmetic,
+// comparisons, masks, lane selection, and a mask as one bit per lane.
+#if defined(__AVX2__)
+static inline leto_simd_t LetoSimdSet(float value)
+{
+    return _mm256_set1_ps(value);
+}
+
+static inline leto_simd_t LetoSimdRamp(void)
+{
+    return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+}
+
+static inline leto_simd_t LetoSimdLoad(const float *address)
+{
+    return _mm256_load_ps(address);
+}
+
+static inline void LetoSimdStore(float *address, leto_simd_t value)
+{
+    _mm256_store_ps(address, value);
+}
+
+static inline leto_simd_t LetoSimdAdd(leto_simd_t a, leto_simd_t b)
+{
+    return _mm256_add_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdSub(leto_simd_t a, leto_simd_t b)
+{
+    return _mm256_sub_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdMul(leto_simd_t a, leto_simd_t b)
+{
+    return _mm256_mul_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdMin(leto_simd_t a, leto_simd_t b)
+{
+    return _mm256_min_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdMax(leto_simd_t a, leto_simd_t b)
+{
+    return _mm256_max_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdSqrt(leto_simd_t a)
+{
+    return _mm256_sqrt_ps(a);
+}
+
+static inline leto_simd_mask_t LetoSimdAtLeast(leto_simd_t a,
+                                               leto_simd_t b)
+{
+    return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+}
+
+static inline leto_simd_mask_t LetoSimdAtMost(leto_simd_t a,
+                                              leto_simd_t b)
+{
+    return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+}
+
+static inline leto_simd_mask_t LetoSimdAnd(leto_simd_mask_t a,
+                                           leto_simd_mask_t b)
+{
+    return _mm256_and_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdSelect(leto_simd_mask_t mask,
+                                         leto_simd_t a, leto_simd_t b)
+{
+    return _mm256_blendv_ps(b, a, mask);
+}
+
+static inline unsigned int LetoSimdBits(leto_simd_mask_t mask)
+{
+    return (unsigned int)_mm256_movemask_ps(mask);
+}
+#elif defined(LETO_X86_64) || defined(__SSE2__)
+static inline leto_simd_t LetoSimdSet(float value)
+{
+    return _mm_set1_ps(value);
+}
+
+static inline leto_simd_t LetoSimdRamp(void)
+{
+    return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+}
+
+static inline leto_simd_t LetoSimdLoad(const float *address)
+{
+    return _mm_load_ps(address);
+}
+
+static inline void LetoSimdStore(float *address, leto_simd_t value)
+{
+    _mm_store_ps(address, value);
+}
+
+static inline leto_simd_t LetoSimdAdd(leto_simd_t a, leto_simd_t b)
+{
+    return _mm_add_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdSub(leto_simd_t a, leto_simd_t b)
+{
+    return _mm_sub_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdMul(leto_simd_t a, leto_simd_t b)
+{
+    return _mm_mul_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdMin(leto_simd_t a, leto_simd_t b)
+{
+    return _mm_min_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdMax(leto_simd_t a, leto_simd_t b)
+{
+    return _mm_max_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdSqrt(leto_simd_t a)
+{
+    return _mm_sqrt_ps(a);
+}
+
+static inline leto_simd_mask_t LetoSimdAtLeast(leto_simd_t a,
+                                               leto_simd_t b)
+{
+    return _mm_cmpge_ps(a, b);
+}
+
+static inline leto_simd_mask_t LetoSimdAtMost(leto_simd_t a,
+                                              leto_simd_t b)
+{
+    return _mm_cmple_ps(a, b);
+}
+
+static inline leto_simd_mask_t LetoSimdAnd(leto_simd_mask_t a,
+                                           leto_simd_mask_t b)
+{
+    return _mm_and_ps(a, b);
+}
+
+static inline leto_simd_t LetoSimdSelect(leto_simd_mask_t mask,
+                                         leto_simd_t a, leto_simd_t b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline unsigned int LetoSimdBits(leto_simd_mask_t mask)
+{
+    return (unsigned int)_mm_movemask_ps(mask);
+}
+#elif defined(LETO_ARM_X64)
+static inline leto_simd_t LetoSimdSet(float value)
+{
+    return vdupq_n_f32(value);
+}
+
+static inline leto_simd_t LetoSimdRamp(void)
+{
+    const float ramp[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    return vld1q_f32(ramp);
+}
+
+static inline leto_simd_t LetoSimdLoad(const float *address)
+{
+    return vld1q_f32(address);
+}
+
+static inline void LetoSimdStore(float *address, leto_simd_t value)
+{
+    vst1q_f32(address, value);
+}
+
+static inline leto_simd_t LetoSimdAdd(leto_simd_t a, leto_simd_t b)
+{
+    return vaddq_f32(a, b);
+}
+
+static inline leto_simd_t LetoSimdSub(leto_simd_t a, leto_simd_t b)
+{
+    return vsubq_f32(a, b);
+}
+
+static inline leto_simd_t LetoSimdMul(leto_simd_t a, leto_simd_t b)
+{
+    return vmulq_f32(a, b);
+}
+
+static inline leto_simd_t LetoSimdMin(leto_simd_t a, leto_simd_t b)
+{
+    return vminq_f32(a, b);
+}
+
+static inline leto_simd_t LetoSimdMax(leto_simd_t a, leto_simd_t b)
+{
+    return vmaxq_f32(a, b);
+}
+
+static inline leto_simd_t LetoSimdSqrt(leto_simd_t a)
+{
+    return vsqrtq_f32(a);
+}
+
+static inline leto_simd_mask_t LetoSimdAtLeast(leto_simd_t a,
+                                               leto_simd_t b)
+{
+    return vcgeq_f32(a, b);
+}
+
+static inline leto_simd_mask_t LetoSimdAtMost(leto_simd_t a,
+                                              leto_simd_t b)
+{
+    return vcleq_f32(a, b);
+}
+
+static inline leto_simd_mask_t LetoSimdAnd(leto_simd_mask_t a,
+                                           leto_simd_mask_t b)
+{
+    return vandq_u32(a, b);
+}
+
+static inline leto_simd_t LetoSimdSelect(leto_simd_mask_t mask,
+                                         leto_simd_t a, leto_simd_t b)
+{
+    return vbslq_f32(mask, a, b);
+}
+
+static inline unsigned int LetoSimdBits(leto_simd_mask_t mask)
+{
+    const uint32_t lane_bits[4] = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(mask, vld1q_u32(lane_bits)));
+}
+#else
+static inline leto_simd_t LetoSimdSet(float value) { return value; }
+
+static inline leto_simd_t LetoSimdRamp(void) { return 0.0f; }
+
+static inline leto_simd_t LetoSimdLoad(const float *address)
+{
+    return *address;
+}
+
+static inline void LetoSimdStore(float *address, leto_simd_t value)
+{
+    *address = value;
+}
+
+static inline leto_simd_t LetoSimdAdd(leto_simd_t a, leto_simd_t b)
+{
+    return a + b;
+}
+
+static inline leto_simd_t LetoSimdSub(leto_simd_t a, leto_simd_t b)
+{
+    return a - b;
+}
+
+static inline leto_simd_t LetoSimdMul(leto_simd_t a, leto_simd_t b)
+{
+    return a * b;
+}
+
+static inline leto_simd_t LetoSimdMin(leto_simd_t a, leto_simd_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline leto_simd_t LetoSimdMax(leto_simd_t a, leto_simd_t b)
+{
+    return a > b ? a : b;
+}
+
+static inline leto_simd_t LetoSimdSqrt(leto_simd_t a) { return sqrtf(a); }
+
+static inline leto_simd_mask_t LetoSimdAtLeast(leto_simd_t a,
+                                               leto_simd_t b)
+{
+    return a >= b;
+}
+
+static inline leto_simd_mask_t LetoSimdAtMost(leto_simd_t a,
+                                              leto_simd_t b)
+{
+    return a <= b;
+}
+
+static inline leto_simd_mask_t LetoSimdAnd(leto_simd_mask_t a,
+                                           leto_simd_mask_t b)
+{
+    return a && b;
+}
+
+static inline leto_simd_t LetoSimdSelect(leto_simd_mask_t mask,
+                                         leto_simd_t a, leto_simd_t b)
+{
+    return mask ? a : b;
+}
+
+static inline unsigned int LetoSimdBits(leto_simd_mask_t mask)
+{
+    return mask;
+}
+#endif
+
+#endif // LETO__SIMD_H
@@ -0,0 +1,386 @@
+/**
+ * @file Threads.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the threading layer on top of pthreads or Win32. The
+ * worker pool runs one batch at a time; jobs are claimed with an atomic
+ * counter, and the lock is only taken to start and finish a batch.
+ * @implements Threads.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Threads.h" // Public interface parent
+
+#if defined(LETO_WINDOWS)
+    #include <windows.h> // Win32 threads and interlocked operations
+#else
+    #include <pthread.h> // POSIX threads
+    #include <string.h>  // Standard memory utilities
+    #include <unistd.h>  // POSIX system configuration
+#endif
+
+#if defined(LETO_WINDOWS)
+typedef SRWLOCK lock_t;
+typedef CONDITION_VARIABLE condition_t;
+#else
+typedef pthread_mutex_t lock_t;
+typedef pthread_cond_t condition_t;
+#endif
+
+/**
+ * @brief The worker pool. Everything besides the job counter is guarded
+ * by the lock.
+ */
+static struct
+{
+    /**
+     * @brief The lock, the condition workers wait on for a batch, and the
+     * condition the caller waits on for workers to finish.
+     */
+    lock_t lock;
+    condition_t wake, done;
+    /**
+     * @brief The pool's threads, and the amount of them running.
+     */
+    leto_thread_t threads[LETO_MAX_WORKERS - 1];
+    size_t thread_count;
+    /**
+     * @brief Whether the pool's been started, is being stopped, and is
+     * running a batch.
+     */
+    bool started, stopping, busy;
+    /**
+     * @brief The batch's number, counted up with each one, and the number
+     * of the last batch before the threads started.
+     */
+    size_t generation, first_generation;
+    /**
+     * @brief The amount of workers inside the current batch.
+     */
+    size_t active;
+    /**
+     * @brief The current batch; its function, jobs, the size of a job,
+     * and the amount of them.
+     */
+    leto_thread_function_t function;
+    unsigned char *jobs;
+    size_t stride, count;
+    /**
+     * @brief The next job of the batch to claim.
+     */
+    volatile size_t next;
+} pool = {
+#if defined(LETO_WINDOWS)
+    .lock = SRWLOCK_INIT,
+    .wake = CONDITION_VARIABLE_INIT,
+    .done = CONDITION_VARIABLE_INIT,
+#else
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+#endif
+};
+
+/**
+ * Lock
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Take the pool's lock.
+ *
+ * @return void -- Nothing.
+ */
+static void Lock_(void)
+{
+#if defined(LETO_WINDOWS)
+    AcquireSRWLockExclusive(&pool.lock);
+#else
+    pthread_mutex_lock(&pool.lock);
+#endif
+}
+
+/**
+ * Unlock
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give the pool's lock back.
+ *
+ * @return void -- Nothing.
+ */
+static void Unlock_(void)
+{
+#if defined(LETO_WINDOWS)
+    ReleaseSRWLockExclusive(&pool.lock);
+#else
+    pthread_mutex_unlock(&pool.lock);
+#endif
+}
+
+/**
+ * Wait
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Wait on one of the pool's conditions, with its lock held.
+ *
+ * @param condition The condition.
+ * @return void -- Nothing.
+ */
+static void Wait_(condition_t *condition)
+{
+#if defined(LETO_WINDOWS)
+    SleepConditionVariableSRW(condition, &pool.lock, INFINITE, 0);
+#else
+    pthread_cond_wait(condition, &pool.lock);
+#endif
+}
+
+/**
+ * Broadcast
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Wake everything waiting on one of the pool's conditions.
+ *
+ * @param condition The condition.
+ * @return void -- Nothing.
+ */
+static void Broadcast_(condition_t *condition)
+{
+#if defined(LETO_WINDOWS)
+    WakeAllConditionVariable(condition);
+#else
+    pthread_cond_broadcast(condition);
+#endif
+}
+
+#if defined(LETO_WINDOWS)
+/**
+ * ThreadEntry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Adapt a Leto thread function to the Win32 signature.
+ *
+ * @param argument The thread handle the function was started with.
+ * @return DWORD -- Always 0.
+ */
+static DWORD WINAPI ThreadEntry_(LPVOID argument)
+{
+    leto_thread_t *thread = (leto_thread_t *)argument;
+    thread->function(thread->argument);
+    return 0;
+}
+#else
+/**
+ * ThreadEntry
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Adapt a Leto thread function to the pthreads signature.
+ *
+ * @param argument The thread handle the function was started with.
+ * @return void* -- Always NULL.
+ */
+static void *ThreadEntry_(void *argument)
+{
+    leto_thread_t *thread = (leto_thread_t *)argument;
+    thread->function(thread->argument);
+    return NULL;
+}
+#endif
+
+bool LetoCreateThread(leto_thread_t *thread,
+                      leto_thread_function_t function, void *argument)
+{
+    if (thread == NULL || function == NULL) return false;
+    thread->function = function;
+    thread->argument = argument;
+
+#if defined(LETO_WINDOWS)
+    thread->_ = CreateThread(NULL, 0, ThreadEntry_, thread, 0, NULL);
+    return thread->_ != NULL;
+#else
+    pthread_t handle;
+    if (pthread_create(&handle, NULL, ThreadEntry_, thread) != 0)
+        return false;
+    // pthread_t is an integer or a pointer depending on the platform;
+    // either way it fits.
+    _Static_assert(sizeof(pthread_t) <= sizeof(void *),
+                   "pthread_t must fit in a pointer.");
+    thread->_ = NULL;
+    memcpy(&thread->_, &handle, sizeof(pthread_t));
+    return true;
+#endif
+}
+
+void LetoJoinThread(leto_thread_t *thread)
+{
+    if (thread == NULL) return;
+
+#if defined(LETO_WINDOWS)
+    if (thread->_ == NULL) return;
+    WaitForSingleObject(thread->_, INFINITE);
+    CloseHandle(thread->_);
+#else
+    pthread_t handle;
+    memcpy(&handle, &thread->_, sizeof(pthread_t));
+    pthread_join(handle, NULL);
+#endif
+    thread->_ = NULL;
+}
+
+/**
+ * TakeJobs
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Claim and run jobs of the current batch until none are left.
+ *
+ * @return void -- Nothing.
+ */
+static void TakeJobs_(void)
+{
+    for (;;)
+    {
+        size_t index = LetoAtomicAdd(&pool.next, 1);
+        if (index >= pool.count) return;
+        pool.function(pool.jobs + index * pool.stride);
+    }
+}
+
+/**
+ * Worker
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Run a thread of the pool; wait for a batch, help with it, and
+ * go back to waiting, until the pool's stopped.
+ *
+ * @param argument Unused.
+ * @return void -- Nothing.
+ */
+static void Worker_(void *argument)
+{
+    (void)argument;
+    Lock_();
+    size_t seen = pool.first_generation;
+    for (;;)
+    {
+        while (!pool.stopping && pool.generation == seen)
+            Wait_(&pool.wake);
+        if (pool.stopping) break;
+        seen = pool.generation;
+
+        pool.active++;
+        Unlock_();
+        TakeJobs_();
+        Lock_();
+        if (--pool.active == 0) Broadcast_(&pool.done);
+    }
+    Unlock_();
+}
+
+/**
+ * StartWorkers
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Start the pool's threads, one fewer than there are processors,
+ * since the caller works too. This must be called with the lock held.
+ *
+ * @return void -- Nothing.
+ */
+static void StartWorkers_(void)
+{
+    size_t wanted = LetoGetProcessorCount();
+    if (wanted > LETO_MAX_WORKERS) wanted = LETO_MAX_WORKERS;
+
+    pool.started = true;
+    pool.first_generation = pool.generation;
+    pool.thread_count = 0;
+    // Should a thread fail to start, the pool just makes do without it.
+    for (size_t i = 1; i < wanted; i++)
+        if (LetoCreateThread(&pool.threads[pool.thread_count], Worker_,
+                             NULL))
+            pool.thread_count++;
+}
+
+void LetoRunJobs(leto_thread_function_t function, void *jobs,
+                 size_t stride, size_t count)
+{
+    if (function == NULL || jobs == NULL || count == 0) return;
+    unsigned char *first = jobs;
+
+    Lock_();
+    if (!pool.started) StartWorkers_();
+    if (pool.busy || pool.thread_count == 0 || count == 1)
+    {
+        Unlock_();
+        for (size_t i = 0; i < count; i++) function(first + i * stride);
+        return;
+    }
+
+    // A worker can still be on its way out of the last batch; the batch
+    // mustn't change under it.
+    while (pool.active > 0) Wait_(&pool.done);
+    pool.busy = true;
+    pool.function = function;
+    pool.jobs = first;
+    pool.stride = stride;
+    pool.count = count;
+    pool.next = 0;
+    pool.generation++;
+    Broadcast_(&pool.wake);
+    Unlock_();
+
+    // Once nothing's left to claim and no worker is inside the batch,
+    // every job has finished.
+    TakeJobs_();
+    Lock_();
+    while (pool.active > 0) Wait_(&pool.done);
+    pool.busy = false;
+    Unlock_();
+}
+
+size_t LetoGetWorkerCount(void)
+{
+    Lock_();
+    if (!pool.started) StartWorkers_();
+    const size_t count = pool.thread_count + 1;
+    Unlock_();
+    return count;
+}
+
+void LetoStopWorkers(void)
+{
+    Lock_();
+    if (!pool.started)
+    {
+        Unlock_();
+        return;
+    }
+    pool.stopping = true;
+    Broadcast_(&pool.wake);
+    Unlock_();
+
+    for (size_t i = 0; i < pool.thread_count; i++)
+        LetoJoinThread(&pool.threads[i]);
+
+    Lock_();
+    pool.stopping = false;
+    pool.started = false;
+    pool.thread_count = 0;
+    Unlock_();
+}
+
+size_t LetoGetProcessorCount(void)
+{
+#if defined(LETO_WINDOWS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+#endif
+}
+
+size_t LetoAtomicAdd(volatile size_t *value, size_t amount)
+{
+#if defined(LETO_WINDOWS) && defined(_WIN64)
+    return (size_t)InterlockedExchangeAdd64((volatile LONG64 *)value,
+                                            (LONG64)amount);
+#elif defined(LETO_WINDOWS)
+    return (size_t)InterlockedExchangeAdd((volatile LONG *)value,
+                                          (LONG)amount);
+#else
+    return __atomic_fetch_add(value, amount, __ATOMIC_ACQ_REL);
+#endif
+}
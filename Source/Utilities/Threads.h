@@ -0,0 +1,141 @@
+/**
+ * @file Threads.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides a thin, platform-independent threading layer; threads,
+ * a persistent pool of workers to spread short jobs over, and the handful
+ * of atomic operations needed to share work between them. This has no
+ * dependencies on the rest of the engine, so the offline tools can use
+ * it too.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__THREADS_H
+#define LETO__THREADS_H
+
+// Platform detection macros.
+#include <Diagnostic/Platform.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size type.
+#include <stddef.h>
+
+/**
+ * @brief The most threads a batch of jobs is spread over, the calling
+ * thread included.
+ */
+#define LETO_MAX_WORKERS 8
+
+/**
+ * @brief The signature of a function run on its own thread, or of a job
+ * run by the worker pool.
+ */
+typedef void (*leto_thread_function_t)(void *argument);
+
+/**
+ * @brief A handle to a running thread. The contents are platform-specific
+ * and should not be touched.
+ */
+typedef struct leto_thread
+{
+    /**
+     * @brief The underlying handle; a pthread_t or a HANDLE.
+     */
+    void *_;
+    /**
+     * @brief The function the thread runs.
+     */
+    leto_thread_function_t function;
+    /**
+     * @brief The argument the function is given.
+     */
+    void *argument;
+} leto_thread_t;
+
+/**
+ * CreateThread
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Start running a function on a new thread.
+ *
+ * @param thread The thread handle to fill. This must stay valid (and not
+ * move) until the thread is joined.
+ * @param function The function to run.
+ * @param argument The argument to pass to the function.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoCreateThread(leto_thread_t *thread,
+                      leto_thread_function_t function, void *argument);
+
+/**
+ * JoinThread
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Wait for a thread to finish and release its handle.
+ *
+ * @param thread The thread to join.
+ * @return void -- Nothing.
+ */
+void LetoJoinThread(leto_thread_t *thread);
+
+/**
+ * GetProcessorCount
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the amount of logical processors available to the process.
+ *
+ * @return size_t -- The processor count, at least 1.
+ */
+size_t LetoGetProcessorCount(void);
+
+/**
+ * RunJobs
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Run a function over every element of an array of jobs, spread
+ * over the worker pool and the calling thread, and wait for every one to
+ * finish. The pool is started the first time it's needed. Should a batch
+ * already be running, as when a job runs jobs of its own, the new batch
+ * is run entirely on the calling thread.
+ *
+ * @param function The function to run; it's given a pointer to a job.
+ * @param jobs The first job.
+ * @param stride The size of a job, in bytes.
+ * @param count The amount of jobs.
+ * @return void -- Nothing.
+ */
+void LetoRunJobs(leto_thread_function_t function, void *jobs,
+                 size_t stride, size_t count);
+
+/**
+ * GetWorkerCount
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the amount of threads a batch of jobs is spread over, the
+ * calling thread included, starting the pool if it hasn't been.
+ *
+ * @return size_t -- The amount of threads, from 1 to @ref
+ * LETO_MAX_WORKERS.
+ */
+size_t LetoGetWorkerCount(void);
+
+/**
+ * StopWorkers
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Stop and join every thread of the worker pool. The pool starts
+ * again if more jobs are run.
+ *
+ * @return void -- Nothing.
+ */
+void LetoStopWorkers(void);
+
+/**
+ * AtomicAdd
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Atomically add to a value shared between threads.
+ *
+ * @param value The value to add to.
+ * @param amount The amount to add.
+ * @return size_t -- The value from before the addition.
+ */
+size_t LetoAtomicAdd(volatile size_t *value, size_t amount);
+
+#endif // LETO__THREADS_H
@@ -0,0 +1,146 @@
+/**
+ * @file Occlusion.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief A headless test of the software occlusion culler. One quad is
+ * drawn in front of the camera, and boxes behind, in front of, and
+ * beside it are tested against it, singly and as a culled list. This is
+ * built once per vector path, and every build must agree.
+ * @date 2026-10-19
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include <Rendering/Occlusion.h> // Software occlusion culling
+#include <Utilities/Simd.h>      // Vector operations
+#include <Utilities/Threads.h>   // Threading
+
+#include <CGLM/cam.h> // GLM camera functions (lookat, etc.)
+
+#include <stdio.h> // Standard I/O
+
+/**
+ * @brief The occluder; a four-by-four quad five units down the view,
+ * wound counter-clockwise towards the camera.
+ */
+static const float quad_positions[] = {-2.0f, -2.0f, -5.0f, 2.0f,
+                                       -2.0f, -5.0f, 2.0f,  2.0f,
+                                       -5.0f, -2.0f, 2.0f,  -5.0f};
+static const uint32_t quad_indices[] = {0, 1, 2, 0, 2, 3};
+
+/**
+ * @brief A box to test, and whether it should be hidden by the quad.
+ */
+typedef struct test_box
+{
+    /**
+     * @brief What the box is, for failure messages.
+     */
+    const char *name;
+    /**
+     * @brief The center and half-size of the box.
+     */
+    vec3 center, extent;
+    /**
+     * @brief Whether the quad should hide the box.
+     */
+    bool hidden;
+} test_box_t;
+
+/**
+ * @brief Every box tested. Their indices in the bounds set are their
+ * indices here.
+ */
+static test_box_t boxes[] = {
+    {"behind", {0.0f, 0.0f, -10.0f}, {0.5f, 0.5f, 0.5f}, true},
+    {"in front of", {0.0f, 0.0f, -3.0f}, {0.5f, 0.5f, 0.5f}, false},
+    {"beside", {6.0f, 0.0f, -10.0f}, {0.5f, 0.5f, 0.5f}, false},
+    {"far behind", {-1.0f, 1.0f, -20.0f}, {1.0f, 1.0f, 1.0f}, true},
+    {"straddling", {4.0f, 0.0f, -10.0f}, {0.5f, 0.5f, 0.5f}, false}};
+
+/**
+ * @brief The amount of boxes tested.
+ */
+#define BOX_COUNT (sizeof(boxes) / sizeof(test_box_t))
+
+int main(void)
+{
+    printf("Testing occlusion with %d-wide vectors.\n", LETO_SIMD_WIDTH);
+
+    mat4 projection, view, view_projection;
+    glm_perspective(glm_rad(90.0f), 1.0f, 0.1f, 100.0f, projection);
+    glm_lookat((vec3){0.0f, 0.0f, 0.0f}, (vec3){0.0f, 0.0f, -1.0f},
+               (vec3){0.0f, 1.0f, 0.0f}, view);
+    glm_mat4_mul(projection, view, view_projection);
+
+    leto_occlusion_t occlusion;
+    leto_bounds_t bounds;
+    if (!LetoCreateOcclusion(&occlusion, 64, 64) ||
+        !LetoCreateBounds(&bounds, BOX_COUNT))
+    {
+        fprintf(stderr, "Failed to create the culler.\n");
+        return 1;
+    }
+
+    mat4 model = GLM_MAT4_IDENTITY_INIT;
+    LetoBeginOcclusion(&occlusion, view_projection);
+    LetoAddOccluder(&occlusion, quad_positions, 4, quad_indices, 6,
+                    model);
+    LetoRasterizeOcclusion(&occlusion);
+
+    int failures = 0;
+    size_t hidden_count = 0;
+    for (size_t i = 0; i < BOX_COUNT; i++)
+    {
+        test_box_t *box = &boxes[i];
+        LetoAddBounds(&bounds, box->center, box->extent);
+        if (box->hidden) hidden_count++;
+
+        const bool visible =
+            LetoTestOcclusion(&occlusion, box->center, box->extent);
+        if (visible == box->hidden)
+        {
+            fprintf(stderr, "The box %s the quad was %s.\n", box->name,
+                    visible ? "visible" : "hidden");
+            failures++;
+        }
+    }
+
+    // Every box is inside the frustum, so culling the list leaves exactly
+    // the visible ones, in order.
+    leto_frustum_t frustum;
+    LetoExtractFrustum(&frustum, view_projection);
+    uint32_t visible[BOX_COUNT];
+    size_t count = LetoCullBounds(&bounds, &frustum, visible);
+    if (count != BOX_COUNT)
+    {
+        fprintf(stderr, "Frustum culling kept %zu of %zu boxes.\n", count,
+                BOX_COUNT);
+        failures++;
+    }
+    count = LetoCullOccluded(&occlusion, &bounds, visible, count);
+    if (count != BOX_COUNT - hidden_count)
+    {
+        fprintf(stderr, "Occlusion culling kept %zu boxes, not %zu.\n",
+                count, BOX_COUNT - hidden_count);
+        failures++;
+    }
+    for (size_t i = 0, box = 0; i < count; i++, box++)
+    {
+        while (box < BOX_COUNT && boxes[box].hidden) box++;
+        if (box < BOX_COUNT && visible[i] == box) continue;
+        fprintf(stderr, "Occlusion culling kept box %u out of order.\n",
+                visible[i]);
+        failures++;
+        break;
+    }
+
+    LetoDestroyBounds(&bounds);
+    LetoDestroyOcclusion(&occlusion);
+    LetoStopWorkers();
+
+    if (failures != 0) fprintf(stderr, "%d failures.\n", failures);
+    else printf("Every test passed.\n");
+    return failures != 0;
+}
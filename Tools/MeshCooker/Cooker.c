@@ -0,0 +1,97 @@
+/**
+ * @file Cooker.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the cooker's shared utilities; allocation, file
+ * reading, and building up meshes.
+ * @implements Cooker.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cooker.h" // Public interface parent
+
+#include <stdio.h>  // Standard I/O
+#include <stdlib.h> // Standard memory allocation
+
+void *LetoCookerAllocate(void *pointer, size_t size)
+{
+    void *allocation = realloc(pointer, size == 0 ? 1 : size);
+    if (allocation == NULL)
+    {
+        fprintf(stderr, "error: out of memory (%zu bytes)\n", size);
+        abort();
+    }
+    return allocation;
+}
+
+char *LetoReadWholeFile(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return NULL;
+
+    long length = -1;
+    if (fseek(file, 0L, SEEK_END) == 0) length = ftell(file);
+    if (length < 0 || fseek(file, 0L, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    char *buffer = LetoCookerAllocate(NULL, (size_t)length + 1);
+    if (fread(buffer, 1, (size_t)length, file) != (size_t)length)
+    {
+        free(buffer);
+        fclose(file);
+        return NULL;
+    }
+    buffer[length] = '\0';
+    fclose(file);
+
+    if (size != NULL) *size = (size_t)length;
+    return buffer;
+}
+
+uint32_t LetoAppendVertex(leto_cooker_mesh_t *mesh,
+                          const leto_cooker_vertex_t *vertex)
+{
+    if (mesh->vertex_count == mesh->vertex_capacity)
+    {
+        mesh->vertex_capacity =
+            mesh->vertex_capacity == 0 ? 1024 : mesh->vertex_capacity * 2;
+        mesh->vertices = LetoCookerAllocate(
+            mesh->vertices,
+            mesh->vertex_capacity * sizeof(leto_cooker_vertex_t));
+    }
+    mesh->vertices[mesh->vertex_count] = *vertex;
+    return (uint32_t)mesh->vertex_count++;
+}
+
+void LetoAppendTriangle(leto_cooker_mesh_t *mesh, uint32_t a, uint32_t b,
+                        uint32_t c, uint32_t material)
+{
+    if (mesh->index_count + 3 > mesh->index_capacity)
+    {
+        mesh->index_capacity =
+            mesh->index_capacity == 0 ? 3072 : mesh->index_capacity * 2;
+        mesh->indices = LetoCookerAllocate(
+            mesh->indices, mesh->index_capacity * sizeof(uint32_t));
+        mesh->materials = LetoCookerAllocate(
+            mesh->materials, mesh->index_capacity / 3 * sizeof(uint32_t));
+    }
+    mesh->materials[mesh->index_count / 3] = material;
+    mesh->indices[mesh->index_count++] = a;
+    mesh->indices[mesh->index_count++] = b;
+    mesh->indices[mesh->index_count++] = c;
+}
+
+void LetoDestroyCookerMesh(leto_cooker_mesh_t *mesh)
+{
+    free(mesh->vertices);
+    free(mesh->indices);
+    free(mesh->materials);
+    free(mesh->submeshes);
+    *mesh = (leto_cooker_mesh_t){0};
+}
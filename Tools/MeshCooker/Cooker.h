@@ -0,0 +1,304 @@
+/**
+ * @file Cooker.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides the stages of Leto's offline mesh cooker; importing,
+ * welding, optimizing, and writing meshes in the engine's binary format.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__COOKER_H
+#define LETO__COOKER_H
+
+// The binary mesh format.
+#include <Input/MeshFormat.h>
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size type.
+#include <stddef.h>
+
+/**
+ * @brief The default size of the post-transform cache the index order is
+ * optimized for. Most hardware does at least this well.
+ */
+#define LETO_COOKER_CACHE_SIZE 16
+
+/**
+ * @brief How much worse than a cluster's overall cache efficiency a
+ * sub-cluster may be before it's split off for overdraw sorting.
+ */
+#define LETO_COOKER_OVERDRAW_THRESHOLD 1.05f
+
+/**
+ * @brief A full-precision vertex, as imported.
+ */
+typedef struct leto_cooker_vertex
+{
+    /**
+     * @brief The position of the vertex.
+     */
+    float position[3];
+    /**
+     * @brief The normal of the vertex.
+     */
+    float normal[3];
+    /**
+     * @brief The texture coordinates of the vertex.
+     */
+    float texture_coordinates[2];
+} leto_cooker_vertex_t;
+
+/**
+ * @brief A mesh being cooked.
+ */
+typedef struct leto_cooker_mesh
+{
+    /**
+     * @brief The vertex array.
+     */
+    leto_cooker_vertex_t *vertices;
+    /**
+     * @brief The amount of vertices in @ref vertices.
+     */
+    size_t vertex_count;
+    /**
+     * @brief The allocated length of @ref vertices.
+     */
+    size_t vertex_capacity;
+    /**
+     * @brief The triangle list, three indices a triangle.
+     */
+    uint32_t *indices;
+    /**
+     * @brief The amount of indices in @ref indices.
+     */
+    size_t index_count;
+    /**
+     * @brief The allocated length of @ref indices.
+     */
+    size_t index_capacity;
+    /**
+     * @brief The material of each triangle. Once the mesh is grouped,
+     * this is NULL and @ref submeshes is used instead.
+     */
+    uint32_t *materials;
+    /**
+     * @brief Whether the source provided normals. If not, they're
+     * generated after welding.
+     */
+    bool has_normals;
+    /**
+     * @brief The submeshes, each a contiguous range of @ref indices.
+     */
+    leto_mesh_submesh_t *submeshes;
+    /**
+     * @brief The amount of submeshes in @ref submeshes.
+     */
+    size_t submesh_count;
+    /**
+     * @brief The amount of levels of detail every submesh has.
+     */
+    size_t lod_count;
+    /**
+     * @brief The largest object-space error of each level of detail,
+     * across every submesh.
+     */
+    float lod_errors[LETO_MESH_MAX_LODS];
+} leto_cooker_mesh_t;
+
+/**
+ * CookerAllocate
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Allocate (or reallocate) memory, aborting the cooker on failure.
+ *
+ * @param pointer The pointer to reallocate, or NULL.
+ * @param size The size to allocate, in bytes.
+ * @return void* -- The allocation.
+ */
+void *LetoCookerAllocate(void *pointer, size_t size);
+
+/**
+ * ReadWholeFile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Read an entire file into a NUL-terminated buffer.
+ *
+ * @param path The path of the file.
+ * @param size Filled with the size of the file.
+ * @return char* -- The contents, or NULL on failure. Free this.
+ */
+char *LetoReadWholeFile(const char *path, size_t *size);
+
+/**
+ * AppendVertex
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Append a vertex to a mesh.
+ *
+ * @param mesh The mesh to append to.
+ * @param vertex The vertex to append.
+ * @return uint32_t -- The index of the new vertex.
+ */
+uint32_t LetoAppendVertex(leto_cooker_mesh_t *mesh,
+                          const leto_cooker_vertex_t *vertex);
+
+/**
+ * AppendTriangle
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Append a triangle to a mesh.
+ *
+ * @param mesh The mesh to append to.
+ * @param a The first index.
+ * @param b The second index.
+ * @param c The third index.
+ * @param material The material of the triangle.
+ * @return void -- Nothing.
+ */
+void LetoAppendTriangle(leto_cooker_mesh_t *mesh, uint32_t a, uint32_t b,
+                        uint32_t c, uint32_t material);
+
+/**
+ * DestroyCookerMesh
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free everything a mesh owns.
+ *
+ * @param mesh The mesh to destroy.
+ * @return void -- Nothing.
+ */
+void LetoDestroyCookerMesh(leto_cooker_mesh_t *mesh);
+
+/**
+ * ImportObj
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Import a Wavefront OBJ file. Polygons are triangulated as fans,
+ * and each "usemtl" starts a new material.
+ *
+ * @param mesh The mesh to fill.
+ * @param path The path of the file.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoImportObj(leto_cooker_mesh_t *mesh, const char *path);
+
+/**
+ * ImportGltf
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Import a glTF 2.0 file, either JSON (.gltf) or binary (.glb).
+ * Buffers may be embedded as data URIs, held in the GLB binary chunk, or
+ * sit next to the file. Every mesh in the default scene is flattened into
+ * one, with node transforms applied.
+ *
+ * @param mesh The mesh to fill.
+ * @param path The path of the file.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoImportGltf(leto_cooker_mesh_t *mesh, const char *path);
+
+/**
+ * WeldVertices
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Merge bitwise-identical vertices, rewriting the indices. If the
+ * mesh has no normals, smooth normals are generated afterwards.
+ *
+ * @param mesh The mesh to weld.
+ * @return void -- Nothing.
+ */
+void LetoWeldVertices(leto_cooker_mesh_t *mesh);
+
+/**
+ * GroupSubmeshes
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Sort the triangles by material, keeping their order otherwise,
+ * and build the submesh table.
+ *
+ * @param mesh The mesh to group.
+ * @return void -- Nothing.
+ */
+void LetoGroupSubmeshes(leto_cooker_mesh_t *mesh);
+
+/**
+ * Simplify
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Simplify a triangle list by quadric error metric edge collapse
+ * (Garland and Heckbert 1997), without moving or creating vertices. Open
+ * borders and attribute seams are only ever collapsed along themselves.
+ *
+ * @param mesh The mesh whose vertices the list indexes.
+ * @param indices The triangle list to simplify.
+ * @param index_count The amount of indices.
+ * @param target_count The amount of indices to work towards. This may
+ * not be reached if the mesh runs out of collapses.
+ * @param output Filled with the simplified list; this must have room for
+ * @ref index_count indices.
+ * @param error Filled with the largest distance, in object space, any
+ * collapse moved the surface.
+ * @return size_t -- The amount of indices in the simplified list.
+ */
+size_t LetoSimplify(const leto_cooker_mesh_t *mesh,
+                    const uint32_t *indices, size_t index_count,
+                    size_t target_count, uint32_t *output, float *error);
+
+/**
+ * GenerateLods
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Build levels of detail for every submesh, each simplified from
+ * the last to half its triangles, and append them to the index buffer.
+ * Levels that can't be meaningfully reduced repeat the one before.
+ *
+ * @param mesh The grouped mesh to build levels for.
+ * @param lod_count The amount of levels wanted, including the original.
+ * @return void -- Nothing.
+ */
+void LetoGenerateLods(leto_cooker_mesh_t *mesh, size_t lod_count);
+
+/**
+ * OptimizeVertexCache
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Reorder the triangles of every submesh for post-transform cache
+ * locality with Tipsify (Sander et al. 2007), then reorder the clusters
+ * it produces to reduce overdraw.
+ *
+ * @param mesh The mesh to optimize.
+ * @param cache_size The cache size to optimize for.
+ * @return void -- Nothing.
+ */
+void LetoOptimizeVertexCache(leto_cooker_mesh_t *mesh, size_t cache_size);
+
+/**
+ * OptimizeVertexFetch
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Reorder the vertices in the order the index stream first uses
+ * them, so fetches walk memory linearly. Unused vertices are dropped.
+ *
+ * @param mesh The mesh to optimize.
+ * @return void -- Nothing.
+ */
+void LetoOptimizeVertexFetch(leto_cooker_mesh_t *mesh);
+
+/**
+ * AverageCacheMissRatio
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Simulate a FIFO post-transform cache over the index stream.
+ *
+ * @param indices The index stream.
+ * @param index_count The amount of indices.
+ * @param vertex_count The amount of vertices referenced.
+ * @param cache_size The size of the simulated cache.
+ * @return float -- The average amount of cache misses per triangle.
+ */
+float LetoAverageCacheMissRatio(const uint32_t *indices,
+                                size_t index_count, size_t vertex_count,
+                                size_t cache_size);
+
+/**
+ * WriteMesh
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Quantize a mesh and write it in the binary mesh format.
+ *
+ * @param mesh The mesh to write.
+ * @param path The path of the output file.
+ * @return bool -- True for success, false for failure.
+ */
+bool LetoWriteMesh(const leto_cooker_mesh_t *mesh, const char *path);
+
+#endif // LETO__COOKER_H
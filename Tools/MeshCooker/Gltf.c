@@ -0,0 +1,671 @@
+/**
+ * @file Gltf.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the glTF 2.0 importer. Only triangle primitives and
+ * their positions, normals, and first set of texture coordinates are
+ * read; everything else in the file is ignored.
+ * @implements Cooker.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cooker.h" // Public interface parent
+#include "Json.h"   // JSON parsing
+
+#include <CGLM/affine.h> // GLM transformations
+#include <CGLM/mat3.h>   // GLM 3x3 matrices
+#include <CGLM/quat.h>   // GLM quaternions
+
+#include <math.h>   // Standard math functions
+#include <stdio.h>  // Standard I/O
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard string utilities
+
+/**
+ * @brief The first four bytes of a binary glTF file, "glTF".
+ */
+#define GLB_MAGIC 0x46546C67u
+
+/**
+ * @brief The type of a GLB chunk holding the JSON document, "JSON".
+ */
+#define GLB_JSON_CHUNK 0x4E4F534Au
+
+/**
+ * @brief The type of a GLB chunk holding the binary buffer, "BIN\0".
+ */
+#define GLB_BINARY_CHUNK 0x004E4942u
+
+/**
+ * @brief How deep the node hierarchy may go before we give up on it.
+ */
+#define MAX_NODE_DEPTH 64
+
+/**
+ * @brief The glTF component types.
+ */
+typedef enum component_type
+{
+    component_byte = 5120,
+    component_unsigned_byte = 5121,
+    component_short = 5122,
+    component_unsigned_short = 5123,
+    component_unsigned_int = 5125,
+    component_float = 5126
+} component_type_t;
+
+/**
+ * @brief A buffer referenced by the document.
+ */
+typedef struct gltf_buffer
+{
+    /**
+     * @brief The contents of the buffer.
+     */
+    const unsigned char *data;
+    /**
+     * @brief The size of the buffer in bytes.
+     */
+    size_t size;
+    /**
+     * @brief Whether @ref data was allocated for this buffer, rather than
+     * pointing into the GLB.
+     */
+    bool owned;
+} gltf_buffer_t;
+
+/**
+ * @brief Everything needed while walking a document.
+ */
+typedef struct gltf
+{
+    /**
+     * @brief The parsed document.
+     */
+    leto_json_value_t root;
+    /**
+     * @brief The document's buffers.
+     */
+    gltf_buffer_t *buffers;
+    /**
+     * @brief The amount of entries in @ref buffers.
+     */
+    size_t buffer_count;
+    /**
+     * @brief The mesh being filled.
+     */
+    leto_cooker_mesh_t *mesh;
+} gltf_t;
+
+/**
+ * ReadLittle32
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Read a little-endian 32-bit integer.
+ *
+ * @param bytes The bytes to read.
+ * @return uint32_t -- The integer.
+ */
+static uint32_t ReadLittle32_(const unsigned char *bytes)
+{
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+/**
+ * DecodeBase64
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Decode base64 text, stopping at the first padding character.
+ *
+ * @param text The base64 text.
+ * @param size Filled with the size of the decoded data.
+ * @return unsigned char* -- The decoded data, or NULL if the text is
+ * malformed. Free this.
+ */
+static unsigned char *DecodeBase64_(const char *text, size_t *size)
+{
+    size_t length = strlen(text);
+    unsigned char *output = LetoCookerAllocate(NULL, length / 4 * 3 + 3);
+
+    uint32_t accumulator = 0;
+    size_t bits = 0, written = 0;
+    for (size_t i = 0; i < length && text[i] != '='; i++)
+    {
+        const char character = text[i];
+        uint32_t value;
+        if (character >= 'A' && character <= 'Z') value = character - 'A';
+        else if (character >= 'a' && character <= 'z')
+            value = character - 'a' + 26;
+        else if (character >= '0' && character <= '9')
+            value = character - '0' + 52;
+        else if (character == '+') value = 62;
+        else if (character == '/') value = 63;
+        else
+        {
+            free(output);
+            return NULL;
+        }
+
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            output[written++] = (unsigned char)(accumulator >> bits);
+        }
+    }
+
+    *size = written;
+    return output;
+}
+
+/**
+ * LoadBuffers
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Resolve every buffer of the document.
+ *
+ * @param gltf The document.
+ * @param path The path of the document, for resolving relative URIs.
+ * @param binary The GLB binary chunk, or NULL.
+ * @param binary_size The size of the binary chunk.
+ * @return bool -- True if every buffer was found.
+ */
+static bool LoadBuffers_(gltf_t *gltf, const char *path,
+                         const unsigned char *binary, size_t binary_size)
+{
+    const leto_json_value_t *buffers =
+        LetoJsonMember(&gltf->root, "buffers");
+    if (buffers == NULL) return true;
+
+    gltf->buffer_count = buffers->count;
+    gltf->buffers = LetoCookerAllocate(
+        NULL, buffers->count * sizeof(gltf_buffer_t));
+    memset(gltf->buffers, 0, buffers->count * sizeof(gltf_buffer_t));
+
+    for (size_t i = 0; i < buffers->count; i++)
+    {
+        gltf_buffer_t *buffer = &gltf->buffers[i];
+        const leto_json_value_t *uri =
+            LetoJsonMember(LetoJsonElement(buffers, i), "uri");
+
+        if (uri == NULL || uri->type != json_string)
+        {
+            // Only the first buffer of a GLB may leave its URI out.
+            if (i != 0 || binary == NULL) return false;
+            buffer->data = binary;
+            buffer->size = binary_size;
+            continue;
+        }
+
+        buffer->owned = true;
+        if (strncmp(uri->string, "data:", 5) == 0)
+        {
+            const char *payload = strstr(uri->string, ";base64,");
+            if (payload == NULL) return false;
+            buffer->data = DecodeBase64_(payload + 8, &buffer->size);
+        }
+        else
+        {
+            // Relative to the directory the document sits in.
+            const char *slash = strrchr(path, '/');
+            const char *backslash = strrchr(path, '\\');
+            if (backslash != NULL && (slash == NULL || backslash > slash))
+                slash = backslash;
+            size_t directory =
+                slash == NULL ? 0 : (size_t)(slash - path) + 1;
+
+            char *full = LetoCookerAllocate(
+                NULL, directory + strlen(uri->string) + 1);
+            memcpy(full, path, directory);
+            strcpy(full + directory, uri->string);
+            buffer->data = (unsigned char *)LetoReadWholeFile(
+                full, &buffer->size);
+            free(full);
+        }
+        if (buffer->data == NULL) return false;
+    }
+
+    return true;
+}
+
+/**
+ * ReadAccessor
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Read an accessor into floats, converting (and denormalizing)
+ * integer components as needed.
+ *
+ * @param gltf The document.
+ * @param index The index of the accessor.
+ * @param components The amount of components to read per element.
+ * @param count Filled with the amount of elements.
+ * @return float* -- The elements, or NULL on failure. Free this.
+ */
+static float *ReadAccessor_(const gltf_t *gltf, size_t index,
+                            size_t components, size_t *count)
+{
+    const leto_json_value_t *accessor = LetoJsonElement(
+        LetoJsonMember(&gltf->root, "accessors"), index);
+    if (accessor == NULL || LetoJsonMember(accessor, "sparse") != NULL)
+        return NULL;
+
+    const leto_json_value_t *view = LetoJsonElement(
+        LetoJsonMember(&gltf->root, "bufferViews"),
+        (size_t)LetoJsonNumber(LetoJsonMember(accessor, "bufferView"),
+                               -1));
+    size_t buffer_index =
+        (size_t)LetoJsonNumber(LetoJsonMember(view, "buffer"), -1);
+    if (view == NULL || buffer_index >= gltf->buffer_count) return NULL;
+    const gltf_buffer_t *buffer = &gltf->buffers[buffer_index];
+
+    const int type =
+        (int)LetoJsonNumber(LetoJsonMember(accessor, "componentType"), 0);
+    size_t size = 0;
+    switch (type)
+    {
+        case component_byte:
+        case component_unsigned_byte:
+            size = 1;
+            break;
+        case component_short:
+        case component_unsigned_short:
+            size = 2;
+            break;
+        case component_unsigned_int:
+        case component_float:
+            size = 4;
+            break;
+        default: return NULL;
+    }
+
+    *count = (size_t)LetoJsonNumber(LetoJsonMember(accessor, "count"), 0);
+    const bool normalized =
+        LetoJsonNumber(LetoJsonMember(accessor, "normalized"), 0) != 0;
+    size_t offset =
+        (size_t)LetoJsonNumber(LetoJsonMember(view, "byteOffset"), 0) +
+        (size_t)LetoJsonNumber(LetoJsonMember(accessor, "byteOffset"), 0);
+    size_t stride = (size_t)LetoJsonNumber(
+        LetoJsonMember(view, "byteStride"), (double)(size * components));
+
+    if (*count == 0) return NULL;
+    size_t last = offset + stride * (*count - 1) + size * components;
+    if (last > buffer->size) return NULL;
+
+    float *output =
+        LetoCookerAllocate(NULL, *count * components * sizeof(float));
+    for (size_t i = 0; i < *count; i++)
+    {
+        const unsigned char *element = buffer->data + offset + stride * i;
+        for (size_t c = 0; c < components; c++)
+        {
+            const unsigned char *bytes = element + c * size;
+            float value = 0;
+            switch (type)
+            {
+                case component_byte:
+                    value = (float)(int8_t)bytes[0];
+                    if (normalized) value = fmaxf(value / 127.0f, -1.0f);
+                    break;
+                case component_unsigned_byte:
+                    value = (float)bytes[0];
+                    if (normalized) value /= 255.0f;
+                    break;
+                case component_short:
+                    value = (float)(int16_t)(bytes[0] | (bytes[1] << 8));
+                    if (normalized) value = fmaxf(value / 32767.0f, -1.0f);
+                    break;
+                case component_unsigned_short:
+                    value = (float)(uint16_t)(bytes[0] | (bytes[1] << 8));
+                    if (normalized) value /= 65535.0f;
+                    break;
+                case component_unsigned_int:
+                    value = (float)ReadLittle32_(bytes);
+                    break;
+                default:
+                {
+                    uint32_t bits = ReadLittle32_(bytes);
+                    memcpy(&value, &bits, sizeof(float));
+                }
+                break;
+            }
+            output[i * components + c] = value;
+        }
+    }
+
+    return output;
+}
+
+/**
+ * ReadIndices
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Read an index accessor as integers.
+ *
+ * @param gltf The document.
+ * @param index The index of the accessor.
+ * @param count Filled with the amount of indices.
+ * @return uint32_t* -- The indices, or NULL on failure. Free this.
+ */
+static uint32_t *ReadIndices_(const gltf_t *gltf, size_t index,
+                              size_t *count)
+{
+    // Indices never exceed 2^24, so they survive the trip through float.
+    float *values = ReadAccessor_(gltf, index, 1, count);
+    if (values == NULL) return NULL;
+
+    uint32_t *indices =
+        LetoCookerAllocate(NULL, *count * sizeof(uint32_t));
+    for (size_t i = 0; i < *count; i++) indices[i] = (uint32_t)values[i];
+    free(values);
+    return indices;
+}
+
+/**
+ * ImportPrimitive
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Append a triangle primitive to the mesh, transformed into the
+ * scene's space.
+ *
+ * @param gltf The document.
+ * @param primitive The primitive.
+ * @param transform The world transform of the node instancing the mesh.
+ * @return bool -- False if the primitive is malformed.
+ */
+static bool ImportPrimitive_(gltf_t *gltf,
+                             const leto_json_value_t *primitive,
+                             mat4 transform)
+{
+    // Anything but plain triangle lists (4) is skipped.
+    if (LetoJsonNumber(LetoJsonMember(primitive, "mode"), 4) != 4)
+        return true;
+
+    const leto_json_value_t *attributes =
+        LetoJsonMember(primitive, "attributes");
+    const leto_json_value_t *position =
+        LetoJsonMember(attributes, "POSITION");
+    const leto_json_value_t *normal = LetoJsonMember(attributes, "NORMAL");
+    const leto_json_value_t *coordinates =
+        LetoJsonMember(attributes, "TEXCOORD_0");
+    const leto_json_value_t *indices =
+        LetoJsonMember(primitive, "indices");
+    if (position == NULL) return false;
+
+    size_t vertex_count = 0, normal_count = 0, coordinate_count = 0;
+    float *positions = ReadAccessor_(
+        gltf, (size_t)LetoJsonNumber(position, -1), 3, &vertex_count);
+    float *normals =
+        normal == NULL ? NULL
+                       : ReadAccessor_(gltf,
+                                       (size_t)LetoJsonNumber(normal, -1),
+                                       3, &normal_count);
+    float *uvs = coordinates == NULL
+                     ? NULL
+                     : ReadAccessor_(
+                           gltf, (size_t)LetoJsonNumber(coordinates, -1),
+                           2, &coordinate_count);
+    if (normal_count != vertex_count)
+    {
+        free(normals);
+        normals = NULL;
+        gltf->mesh->has_normals = false;
+    }
+    if (coordinate_count != vertex_count)
+    {
+        free(uvs);
+        uvs = NULL;
+    }
+    if (positions == NULL)
+    {
+        free(normals);
+        free(uvs);
+        return false;
+    }
+
+    // Normals go through the inverse transpose, and mirroring transforms
+    // flip the winding.
+    mat3 normal_matrix;
+    glm_mat4_pick3(transform, normal_matrix);
+    const bool mirrored = glm_mat3_det(normal_matrix) < 0.0f;
+    glm_mat3_inv(normal_matrix, normal_matrix);
+    glm_mat3_transpose(normal_matrix);
+
+    const uint32_t base = (uint32_t)gltf->mesh->vertex_count;
+    for (size_t i = 0; i < vertex_count; i++)
+    {
+        leto_cooker_vertex_t vertex = {0};
+        glm_mat4_mulv3(transform, &positions[i * 3], 1.0f,
+                       vertex.position);
+        if (normals != NULL)
+        {
+            glm_mat3_mulv(normal_matrix, &normals[i * 3], vertex.normal);
+            glm_vec3_normalize(vertex.normal);
+        }
+        if (uvs != NULL)
+        {
+            // glTF puts the origin at the top left; OpenGL, bottom left.
+            vertex.texture_coordinates[0] = uvs[i * 2];
+            vertex.texture_coordinates[1] = 1.0f - uvs[i * 2 + 1];
+        }
+        LetoAppendVertex(gltf->mesh, &vertex);
+    }
+    free(positions);
+    free(normals);
+    free(uvs);
+
+    size_t index_count = vertex_count;
+    uint32_t *triangle_indices = NULL;
+    if (indices != NULL)
+    {
+        triangle_indices = ReadIndices_(
+            gltf, (size_t)LetoJsonNumber(indices, -1), &index_count);
+        if (triangle_indices == NULL) return false;
+    }
+
+    const uint32_t material = (uint32_t)LetoJsonNumber(
+        LetoJsonMember(primitive, "material"), 0);
+    for (size_t i = 0; i + 2 < index_count; i += 3)
+    {
+        uint32_t corners[3];
+        for (size_t c = 0; c < 3; c++)
+            corners[c] = triangle_indices == NULL
+                             ? (uint32_t)(i + c)
+                             : triangle_indices[i + c];
+        if (corners[0] >= vertex_count || corners[1] >= vertex_count ||
+            corners[2] >= vertex_count)
+            continue;
+
+        if (mirrored)
+            LetoAppendTriangle(gltf->mesh, base + corners[0],
+                               base + corners[2], base + corners[1],
+                               material);
+        else
+            LetoAppendTriangle(gltf->mesh, base + corners[0],
+                               base + corners[1], base + corners[2],
+                               material);
+    }
+    free(triangle_indices);
+
+    return true;
+}
+
+/**
+ * ImportNode
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Import a node's mesh, then its children, accumulating their
+ * transforms.
+ *
+ * @param gltf The document.
+ * @param index The index of the node.
+ * @param parent The world transform of the node's parent.
+ * @param depth The depth of the node in the hierarchy.
+ * @return bool -- False if anything in the subtree is malformed.
+ */
+static bool ImportNode_(gltf_t *gltf, size_t index, mat4 parent,
+                        size_t depth)
+{
+    const leto_json_value_t *node =
+        LetoJsonElement(LetoJsonMember(&gltf->root, "nodes"), index);
+    if (node == NULL || depth > MAX_NODE_DEPTH) return false;
+
+    mat4 local = GLM_MAT4_IDENTITY_INIT;
+    const leto_json_value_t *matrix = LetoJsonMember(node, "matrix");
+    if (matrix != NULL && matrix->count == 16)
+    {
+        // glTF matrices are column-major, same as GLM's.
+        for (size_t i = 0; i < 16; i++)
+            local[i / 4][i % 4] =
+                (float)LetoJsonNumber(LetoJsonElement(matrix, i), 0);
+    }
+    else
+    {
+        const leto_json_value_t *translation =
+            LetoJsonMember(node, "translation");
+        const leto_json_value_t *rotation =
+            LetoJsonMember(node, "rotation");
+        const leto_json_value_t *scale = LetoJsonMember(node, "scale");
+
+        vec3 t, s;
+        versor r;
+        for (size_t i = 0; i < 3; i++)
+        {
+            t[i] = (float)LetoJsonNumber(
+                LetoJsonElement(translation, i), 0);
+            s[i] = (float)LetoJsonNumber(LetoJsonElement(scale, i), 1);
+        }
+        // Both glTF and GLM store quaternions as x, y, z, w.
+        for (size_t i = 0; i < 4; i++)
+            r[i] = (float)LetoJsonNumber(LetoJsonElement(rotation, i),
+                                         i == 3 ? 1 : 0);
+
+        mat4 rotate;
+        glm_translate(local, t);
+        glm_quat_mat4(r, rotate);
+        glm_mat4_mul(local, rotate, local);
+        glm_scale(local, s);
+    }
+
+    mat4 world;
+    glm_mat4_mul(parent, local, world);
+
+    const leto_json_value_t *mesh = LetoJsonElement(
+        LetoJsonMember(&gltf->root, "meshes"),
+        (size_t)LetoJsonNumber(LetoJsonMember(node, "mesh"), -1));
+    const leto_json_value_t *primitives =
+        LetoJsonMember(mesh, "primitives");
+    for (size_t i = 0; primitives != NULL && i < primitives->count; i++)
+        if (!ImportPrimitive_(gltf, &primitives->children[i], world))
+            return false;
+
+    const leto_json_value_t *children = LetoJsonMember(node, "children");
+    for (size_t i = 0; children != NULL && i < children->count; i++)
+    {
+        size_t child =
+            (size_t)LetoJsonNumber(&children->children[i], -1);
+        if (!ImportNode_(gltf, child, world, depth + 1)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * ImportScene
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Import every node of the default scene. Documents without
+ * scenes get every mesh imported untransformed.
+ *
+ * @param gltf The document.
+ * @return bool -- False if anything is malformed.
+ */
+static bool ImportScene_(gltf_t *gltf)
+{
+    mat4 identity = GLM_MAT4_IDENTITY_INIT;
+    const leto_json_value_t *scenes =
+        LetoJsonMember(&gltf->root, "scenes");
+    const leto_json_value_t *scene = LetoJsonElement(
+        scenes,
+        (size_t)LetoJsonNumber(LetoJsonMember(&gltf->root, "scene"), 0));
+
+    if (scene == NULL)
+    {
+        const leto_json_value_t *meshes =
+            LetoJsonMember(&gltf->root, "meshes");
+        for (size_t i = 0; meshes != NULL && i < meshes->count; i++)
+        {
+            const leto_json_value_t *primitives =
+                LetoJsonMember(&meshes->children[i], "primitives");
+            for (size_t j = 0; primitives != NULL && j < primitives->count;
+                 j++)
+                if (!ImportPrimitive_(gltf, &primitives->children[j],
+                                      identity))
+                    return false;
+        }
+        return true;
+    }
+
+    const leto_json_value_t *nodes = LetoJsonMember(scene, "nodes");
+    for (size_t i = 0; nodes != NULL && i < nodes->count; i++)
+        if (!ImportNode_(gltf,
+                         (size_t)LetoJsonNumber(&nodes->children[i], -1),
+                         identity, 0))
+            return false;
+    return true;
+}
+
+bool LetoImportGltf(leto_cooker_mesh_t *mesh, const char *path)
+{
+    size_t size = 0;
+    char *contents = LetoReadWholeFile(path, &size);
+    if (contents == NULL) return false;
+
+    const unsigned char *bytes = (const unsigned char *)contents;
+    const char *json = contents;
+    size_t json_size = size;
+    const unsigned char *binary = NULL;
+    size_t binary_size = 0;
+    char *json_copy = NULL;
+
+    if (size >= 20 && ReadLittle32_(bytes) == GLB_MAGIC)
+    {
+        // Header (magic, version, length), then the JSON chunk, then
+        // (optionally) the binary chunk.
+        json_size = ReadLittle32_(bytes + 12);
+        if (ReadLittle32_(bytes + 4) != 2 ||
+            ReadLittle32_(bytes + 16) != GLB_JSON_CHUNK ||
+            json_size > size - 20)
+        {
+            free(contents);
+            return false;
+        }
+
+        size_t binary_offset = 20 + json_size;
+        if (binary_offset + 8 <= size &&
+            ReadLittle32_(bytes + binary_offset + 4) == GLB_BINARY_CHUNK)
+        {
+            binary_size = ReadLittle32_(bytes + binary_offset);
+            binary = bytes + binary_offset + 8;
+            if (binary_size > size - binary_offset - 8)
+                binary_size = size - binary_offset - 8;
+        }
+
+        // The parser relies on a NUL past the end of the document.
+        json_copy = LetoCookerAllocate(NULL, json_size + 1);
+        memcpy(json_copy, bytes + 20, json_size);
+        json_copy[json_size] = '\0';
+        json = json_copy;
+    }
+
+    gltf_t gltf = {.mesh = mesh};
+    mesh->has_normals = true;
+    bool success = LetoParseJson(&gltf.root, json, json_size) &&
+                   LoadBuffers_(&gltf, path, binary, binary_size) &&
+                   ImportScene_(&gltf);
+
+    for (size_t i = 0; i < gltf.buffer_count; i++)
+        if (gltf.buffers[i].owned) free((void *)gltf.buffers[i].data);
+    free(gltf.buffers);
+    LetoDestroyJson(&gltf.root);
+    free(json_copy);
+    free(contents);
+
+    return success && mesh->index_count > 0;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file Json.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the cooker's JSON parser.
+ * @implements Json.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Json.h"   // Public interface parent
+#include "Cooker.h" // Cooker allocation
+
+#include <stdlib.h> // Standard number parsing
+#include <string.h> // Standard string utilities
+
+/**
+ * @brief How deep arrays and objects may nest before a document is
+ * considered malformed.
+ */
+#define MAX_DEPTH 64
+
+/**
+ * @brief The state of a single parse.
+ */
+typedef struct parser
+{
+    /**
+     * @brief The next unread character.
+     */
+    const char *cursor;
+    /**
+     * @brief One past the last character of the document.
+     */
+    const char *end;
+} parser_t;
+
+static bool ParseValue_(parser_t *parser, leto_json_value_t *value,
+                        size_t depth);
+
+/**
+ * SkipWhitespace
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Move the cursor past any whitespace.
+ *
+ * @param parser The parser.
+ * @return bool -- False if the end of the document was reached.
+ */
+static bool SkipWhitespace_(parser_t *parser)
+{
+    while (parser->cursor < parser->end &&
+           (*parser->cursor == ' ' || *parser->cursor == '\t' ||
+            *parser->cursor == '\n' || *parser->cursor == '\r'))
+        parser->cursor++;
+    return parser->cursor < parser->end;
+}
+
+/**
+ * Expect
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Consume the given character if it comes next.
+ *
+ * @param parser The parser.
+ * @param character The expected character.
+ * @return bool -- True if the character was consumed.
+ */
+static bool Expect_(parser_t *parser, char character)
+{
+    if (!SkipWhitespace_(parser) || *parser->cursor != character)
+        return false;
+    parser->cursor++;
+    return true;
+}
+
+/**
+ * EncodeUtf8
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Write a code point as UTF-8.
+ *
+ * @param output Where to write; must have room for four bytes.
+ * @param code The code point.
+ * @return size_t -- The amount of bytes written.
+ */
+static size_t EncodeUtf8_(char *output, unsigned long code)
+{
+    if (code < 0x80)
+    {
+        output[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800)
+    {
+        output[0] = (char)(0xC0 | (code >> 6));
+        output[1] = (char)(0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000)
+    {
+        output[0] = (char)(0xE0 | (code >> 12));
+        output[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        output[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+    output[0] = (char)(0xF0 | (code >> 18));
+    output[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    output[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    output[3] = (char)(0x80 | (code & 0x3F));
+    return 4;
+}
+
+/**
+ * ParseHex
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Parse the four hex digits of a \\u escape.
+ *
+ * @param parser The parser, positioned at the first digit.
+ * @param code Filled with the value.
+ * @return bool -- False if the digits are malformed.
+ */
+static bool ParseHex_(parser_t *parser, unsigned long *code)
+{
+    if (parser->end - parser->cursor < 4) return false;
+
+    char digits[5] = {0};
+    memcpy(digits, parser->cursor, 4);
+    char *end = NULL;
+    *code = strtoul(digits, &end, 16);
+    parser->cursor += 4;
+    return end == digits + 4;
+}
+
+/**
+ * ParseString
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Parse a string literal, escapes and all.
+ *
+ * @param parser The parser, positioned at the opening quote.
+ * @param string Filled with the allocated, unescaped string.
+ * @return bool -- False if the string is malformed.
+ */
+static bool ParseString_(parser_t *parser, char **string)
+{
+    if (!Expect_(parser, '"')) return false;
+
+    // Unescaping never makes a string longer, so the span up to the
+    // closing quote is always enough room.
+    const char *start = parser->cursor;
+    while (parser->cursor < parser->end && *parser->cursor != '"')
+        parser->cursor += *parser->cursor == '\\' ? 2 : 1;
+    if (parser->cursor >= parser->end) return false;
+    const char *close = parser->cursor;
+
+    char *output = LetoCookerAllocate(NULL, (size_t)(close - start) + 1);
+    size_t length = 0;
+    parser->cursor = start;
+    while (parser->cursor < close)
+    {
+        char character = *parser->cursor++;
+        if (character != '\\')
+        {
+            output[length++] = character;
+            continue;
+        }
+
+        character = *parser->cursor++;
+        switch (character)
+        {
+            case 'b':
+                output[length++] = '\b';
+                break;
+            case 'f':
+                output[length++] = '\f';
+                break;
+            case 'n':
+                output[length++] = '\n';
+                break;
+            case 'r':
+                output[length++] = '\r';
+                break;
+            case 't':
+                output[length++] = '\t';
+                break;
+            case 'u':
+            {
+                unsigned long code = 0, low = 0;
+                if (!ParseHex_(parser, &code)) break;
+                // Combine surrogate pairs into a single code point.
+                if (code >= 0xD800 && code < 0xDC00 &&
+                    close - parser->cursor >= 6 &&
+                    parser->cursor[0] == '\\' &&
+                    parser->cursor[1] == 'u')
+                {
+                    parser->cursor += 2;
+                    if (ParseHex_(parser, &low))
+                        code = 0x10000 + ((code - 0xD800) << 10) +
+                               (low - 0xDC00);
+                }
+                length += EncodeUtf8_(output + length, code);
+            }
+            break;
+            default: output[length++] = character; break;
+        }
+    }
+    output[length] = '\0';
+
+    parser->cursor = close + 1;
+    *string = output;
+    return true;
+}
+
+/**
+ * ParseContainer
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Parse the contents of an array or object.
+ *
+ * @param parser The parser, positioned past the opening bracket.
+ * @param value The array or object to fill.
+ * @param depth The nesting depth of the container.
+ * @return bool -- False if the container is malformed.
+ */
+static bool ParseContainer_(parser_t *parser, leto_json_value_t *value,
+                            size_t depth)
+{
+    const bool object = value->type == json_object;
+    const char close = object ? '}' : ']';
+    if (Expect_(parser, close)) return true;
+
+    size_t capacity = 0;
+    do
+    {
+        if (value->count == capacity)
+        {
+            capacity = capacity == 0 ? 8 : capacity * 2;
+            value->children = LetoCookerAllocate(
+                value->children, capacity * sizeof(leto_json_value_t));
+        }
+
+        leto_json_value_t *child = &value->children[value->count++];
+        *child = (leto_json_value_t){0};
+        if (object && (!SkipWhitespace_(parser) ||
+                       !ParseString_(parser, &child->key) ||
+                       !Expect_(parser, ':')))
+            return false;
+        if (!ParseValue_(parser, child, depth + 1)) return false;
+    } while (Expect_(parser, ','));
+
+    return Expect_(parser, close);
+}
+
+/**
+ * ParseValue
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Parse any JSON value.
+ *
+ * @param parser The parser.
+ * @param value The value to fill.
+ * @param depth The nesting depth of the value.
+ * @return bool -- False if the value is malformed.
+ */
+static bool ParseValue_(parser_t *parser, leto_json_value_t *value,
+                        size_t depth)
+{
+    if (depth > MAX_DEPTH || !SkipWhitespace_(parser)) return false;
+
+    const size_t remaining = (size_t)(parser->end - parser->cursor);
+    switch (*parser->cursor)
+    {
+        case '{':
+            parser->cursor++;
+            value->type = json_object;
+            return ParseContainer_(parser, value, depth);
+        case '[':
+            parser->cursor++;
+            value->type = json_array;
+            return ParseContainer_(parser, value, depth);
+        case '"':
+            value->type = json_string;
+            return ParseString_(parser, &value->string);
+        case 't':
+            if (remaining < 4 || strncmp(parser->cursor, "true", 4) != 0)
+                return false;
+            parser->cursor += 4;
+            value->type = json_boolean;
+            value->number = 1;
+            return true;
+        case 'f':
+            if (remaining < 5 || strncmp(parser->cursor, "false", 5) != 0)
+                return false;
+            parser->cursor += 5;
+            value->type = json_boolean;
+            return true;
+        case 'n':
+            if (remaining < 4 || strncmp(parser->cursor, "null", 4) != 0)
+                return false;
+            parser->cursor += 4;
+            value->type = json_null;
+            return true;
+        default:
+        {
+            // The document is always NUL-terminated by the file reader,
+            // so strtod can't run off the end.
+            char *end = NULL;
+            value->number = strtod(parser->cursor, &end);
+            if (end == parser->cursor) return false;
+            parser->cursor = end;
+            value->type = json_number;
+            return true;
+        }
+    }
+}
+
+bool LetoParseJson(leto_json_value_t *root, const char *text,
+                   size_t length)
+{
+    parser_t parser = {text, text + length};
+    *root = (leto_json_value_t){0};
+    if (ParseValue_(&parser, root, 0)) return true;
+
+    LetoDestroyJson(root);
+    return false;
+}
+
+void LetoDestroyJson(leto_json_value_t *value)
+{
+    if (value == NULL) return;
+
+    for (size_t i = 0; i < value->count; i++)
+        LetoDestroyJson(&value->children[i]);
+    free(value->children);
+    free(value->key);
+    free(value->string);
+    *value = (leto_json_value_t){0};
+}
+
+const leto_json_value_t *LetoJsonMember(const leto_json_value_t *object,
+                                        const char *key)
+{
+    if (object == NULL || object->type != json_object) return NULL;
+
+    for (size_t i = 0; i < object->count; i++)
+        if (strcmp(object->children[i].key, key) == 0)
+            return &object->children[i];
+    return NULL;
+}
+
+const leto_json_value_t *LetoJsonElement(const leto_json_value_t *array,
+                                         size_t index)
+{
+    if (array == NULL || array->type != json_array) return NULL;
+    if (index >= array->count) return NULL;
+    return &array->children[index];
+}
+
+double LetoJsonNumber(const leto_json_value_t *value, double fallback)
+{
+    if (value == NULL) return fallback;
+    if (value->type != json_number && value->type != json_boolean)
+        return fallback;
+    return value->number;
+}
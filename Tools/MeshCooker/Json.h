@@ -0,0 +1,124 @@
+/**
+ * @file Json.h
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Provides a small JSON parser for the glTF importer. The whole
+ * document is parsed into a tree up front; glTF files are small enough
+ * that this never matters.
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#ifndef LETO__JSON_H
+#define LETO__JSON_H
+
+// Standard boolean definitions.
+#include <stdbool.h>
+// Standard size type.
+#include <stddef.h>
+
+/**
+ * @brief The types a JSON value can take.
+ */
+typedef enum leto_json_type
+{
+    json_null,
+    json_boolean,
+    json_number,
+    json_string,
+    json_array,
+    json_object
+} leto_json_type_t;
+
+/**
+ * @brief A single JSON value, and (for arrays and objects) its children.
+ */
+typedef struct leto_json_value
+{
+    /**
+     * @brief The type of the value.
+     */
+    leto_json_type_t type;
+    /**
+     * @brief The key of the value, if it's a member of an object.
+     */
+    char *key;
+    /**
+     * @brief The contents of a string value.
+     */
+    char *string;
+    /**
+     * @brief The value of a number, or 1/0 for a boolean.
+     */
+    double number;
+    /**
+     * @brief The elements of an array, or the members of an object.
+     */
+    struct leto_json_value *children;
+    /**
+     * @brief The amount of entries in @ref children.
+     */
+    size_t count;
+} leto_json_value_t;
+
+/**
+ * ParseJson
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Parse a JSON document.
+ *
+ * @param root The value to fill with the document's root.
+ * @param text The document.
+ * @param length The length of the document, in bytes.
+ * @return bool -- True for success, false if the document is malformed.
+ */
+bool LetoParseJson(leto_json_value_t *root, const char *text,
+                   size_t length);
+
+/**
+ * DestroyJson
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Free a parsed JSON tree.
+ *
+ * @param value The root of the tree.
+ * @return void -- Nothing.
+ */
+void LetoDestroyJson(leto_json_value_t *value);
+
+/**
+ * JsonMember
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find a member of an object.
+ *
+ * @param object The object to search. This may be NULL.
+ * @param key The key to look for.
+ * @return const leto_json_value_t* -- The member, or NULL.
+ */
+const leto_json_value_t *LetoJsonMember(const leto_json_value_t *object,
+                                        const char *key);
+
+/**
+ * JsonElement
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get an element of an array.
+ *
+ * @param array The array. This may be NULL.
+ * @param index The index of the element.
+ * @return const leto_json_value_t* -- The element, or NULL.
+ */
+const leto_json_value_t *LetoJsonElement(const leto_json_value_t *array,
+                                         size_t index);
+
+/**
+ * JsonNumber
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the value of a number, or a fallback if it's missing.
+ *
+ * @param value The value. This may be NULL.
+ * @param fallback The value to return if this isn't a number.
+ * @return double -- The number.
+ */
+double LetoJsonNumber(const leto_json_value_t *value, double fallback);
+
+#endif // LETO__JSON_H
@@ -0,0 +1,260 @@
+/**
+ * @file Main.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief The entry point of Leto's offline mesh cooker. Every input file
+ * is imported, welded, grouped by material, simplified into levels of
+ * detail, optimized for the vertex cache, overdraw, and vertex fetch,
+ * then written in the engine's binary mesh format. Files are spread over
+ * as many threads as there are cores.
+ *
+ * Usage: MeshCooker [-o directory] [-j threads] [-c cache size]
+ * [-l levels of detail] files...
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cooker.h"            // Cooker stages
+#include <Utilities/Threads.h> // Threading
+
+#include <ctype.h>  // Standard character classification
+#include <stdio.h>  // Standard I/O
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard string utilities
+
+/**
+ * @brief Everything the worker threads share.
+ */
+typedef struct cooker
+{
+    /**
+     * @brief The input file paths.
+     */
+    char **inputs;
+    /**
+     * @brief The amount of input files.
+     */
+    size_t input_count;
+    /**
+     * @brief The directory output files are written to.
+     */
+    const char *output_directory;
+    /**
+     * @brief The cache size to optimize for.
+     */
+    size_t cache_size;
+    /**
+     * @brief The amount of levels of detail to generate.
+     */
+    size_t lod_count;
+    /**
+     * @brief The index of the next file to claim.
+     */
+    volatile size_t next;
+    /**
+     * @brief The amount of files that failed to cook.
+     */
+    volatile size_t failures;
+} cooker_t;
+
+/**
+ * HasExtension
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check, ignoring case, whether a path ends with an extension.
+ *
+ * @param path The path.
+ * @param extension The extension, dot included.
+ * @return bool -- True if the path has the extension.
+ */
+static bool HasExtension_(const char *path, const char *extension)
+{
+    size_t length = strlen(path), extension_length = strlen(extension);
+    if (length < extension_length) return false;
+
+    path += length - extension_length;
+    for (size_t i = 0; i < extension_length; i++)
+        if (tolower((unsigned char)path[i]) != extension[i]) return false;
+    return true;
+}
+
+/**
+ * OutputPath
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Build the output path of an input file; its name, without
+ * directories or extension, in the output directory.
+ *
+ * @param directory The output directory.
+ * @param input The input path.
+ * @return char* -- The output path. Free this.
+ */
+static char *OutputPath_(const char *directory, const char *input)
+{
+    const char *name = input;
+    for (const char *c = input; *c != '\0'; c++)
+        if (*c == '/' || *c == '\\') name = c + 1;
+    const char *dot = strrchr(name, '.');
+    size_t name_length =
+        dot == NULL ? strlen(name) : (size_t)(dot - name);
+
+    size_t size = strlen(directory) + name_length + sizeof("/.mesh");
+    char *path = LetoCookerAllocate(NULL, size);
+    snprintf(path, size, "%s/%.*s.mesh", directory, (int)name_length,
+             name);
+    return path;
+}
+
+/**
+ * CookFile
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Run a single file through the whole pipeline.
+ *
+ * @param cooker The cooker's settings.
+ * @param input The input path.
+ * @return bool -- True for success, false for failure.
+ */
+static bool CookFile_(const cooker_t *cooker, const char *input)
+{
+    leto_cooker_mesh_t mesh = {0};
+    bool imported = false;
+    if (HasExtension_(input, ".obj"))
+        imported = LetoImportObj(&mesh, input);
+    else if (HasExtension_(input, ".gltf") || HasExtension_(input, ".glb"))
+        imported = LetoImportGltf(&mesh, input);
+    else
+    {
+        fprintf(stderr, "error: %s: unknown file type\n", input);
+        return false;
+    }
+    if (!imported)
+    {
+        fprintf(stderr, "error: %s: failed to import\n", input);
+        LetoDestroyCookerMesh(&mesh);
+        return false;
+    }
+
+    LetoWeldVertices(&mesh);
+    LetoGroupSubmeshes(&mesh);
+    LetoGenerateLods(&mesh, cooker->lod_count);
+    const float before =
+        LetoAverageCacheMissRatio(mesh.indices, mesh.index_count,
+                                  mesh.vertex_count, cooker->cache_size);
+
+    LetoOptimizeVertexCache(&mesh, cooker->cache_size);
+    LetoOptimizeVertexFetch(&mesh);
+    const float after =
+        LetoAverageCacheMissRatio(mesh.indices, mesh.index_count,
+                                  mesh.vertex_count, cooker->cache_size);
+
+    char *output = OutputPath_(cooker->output_directory, input);
+    bool written = LetoWriteMesh(&mesh, output);
+    if (written)
+        printf("%s -> %s: %zu vertices, %zu triangles, %zu submeshes, "
+               "ACMR %.3f -> %.3f\n",
+               input, output, mesh.vertex_count, mesh.index_count / 3,
+               mesh.submesh_count, before, after);
+    else fprintf(stderr, "error: %s: failed to write\n", output);
+
+    free(output);
+    LetoDestroyCookerMesh(&mesh);
+    return written;
+}
+
+/**
+ * Worker
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Claim and cook files until there are none left.
+ *
+ * @param argument The shared @ref cooker_t.
+ * @return void -- Nothing.
+ */
+static void Worker_(void *argument)
+{
+    cooker_t *cooker = argument;
+    for (;;)
+    {
+        size_t index = LetoAtomicAdd(&cooker->next, 1);
+        if (index >= cooker->input_count) return;
+        if (!CookFile_(cooker, cooker->inputs[index]))
+            LetoAtomicAdd(&cooker->failures, 1);
+    }
+}
+
+/**
+ * OptionValue
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the value of a single-letter option, given either joined to
+ * it ("-j4") or as the next argument ("-j 4").
+ *
+ * @param argc The amount of arguments.
+ * @param argv The arguments.
+ * @param index The index of the argument to check. This is moved past
+ * the value if it was the next argument.
+ * @param option The option, like "-j".
+ * @return const char* -- The value, or NULL if the argument isn't the
+ * option or has no value.
+ */
+static const char *OptionValue_(int argc, char **argv, int *index,
+                                const char *option)
+{
+    const size_t length = strlen(option);
+    const char *argument = argv[*index];
+    if (strncmp(argument, option, length) != 0) return NULL;
+    if (argument[length] != '\0') return argument + length;
+    if (*index + 1 >= argc) return NULL;
+    return argv[++*index];
+}
+
+int main(int argc, char **argv)
+{
+    cooker_t cooker = {.output_directory = ".",
+                       .cache_size = LETO_COOKER_CACHE_SIZE,
+                       .lod_count = LETO_MESH_MAX_LODS};
+    size_t thread_count = LetoGetProcessorCount();
+
+    cooker.inputs =
+        LetoCookerAllocate(NULL, (size_t)argc * sizeof(char *));
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value;
+        if ((value = OptionValue_(argc, argv, &i, "-o")) != NULL)
+            cooker.output_directory = value;
+        else if ((value = OptionValue_(argc, argv, &i, "-j")) != NULL)
+            thread_count = strtoul(value, NULL, 10);
+        else if ((value = OptionValue_(argc, argv, &i, "-c")) != NULL)
+            cooker.cache_size = strtoul(value, NULL, 10);
+        else if ((value = OptionValue_(argc, argv, &i, "-l")) != NULL)
+            cooker.lod_count = strtoul(value, NULL, 10);
+        else cooker.inputs[cooker.input_count++] = argv[i];
+    }
+
+    if (cooker.input_count == 0 || cooker.cache_size < 3 ||
+        cooker.lod_count < 1 || cooker.lod_count > LETO_MESH_MAX_LODS)
+    {
+        fprintf(stderr, "usage: %s [-o directory] [-j threads] "
+                        "[-c cache size] [-l levels of detail] "
+                        "files...\n",
+                argv[0]);
+        free(cooker.inputs);
+        return EXIT_FAILURE;
+    }
+
+    if (thread_count == 0) thread_count = 1;
+    if (thread_count > cooker.input_count)
+        thread_count = cooker.input_count;
+
+    // The main thread works too, so one fewer thread is started.
+    leto_thread_t *threads =
+        LetoCookerAllocate(NULL, thread_count * sizeof(leto_thread_t));
+    size_t started = 0;
+    for (size_t i = 1; i < thread_count; i++)
+        if (LetoCreateThread(&threads[started], Worker_, &cooker))
+            started++;
+    Worker_(&cooker);
+    for (size_t i = 0; i < started; i++) LetoJoinThread(&threads[i]);
+
+    free(threads);
+    free(cooker.inputs);
+    return cooker.failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
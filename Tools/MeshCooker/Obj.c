@@ -0,0 +1,226 @@
+/**
+ * @file Obj.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the Wavefront OBJ importer. Only geometry is read;
+ * material libraries are left to the engine's own material definitions.
+ * @implements Cooker.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cooker.h" // Public interface parent
+
+#include <stdio.h>  // Standard I/O
+#include <stdlib.h> // Standard number parsing
+#include <string.h> // Standard string utilities
+
+/**
+ * @brief The largest polygon the importer will triangulate.
+ */
+#define MAX_POLYGON_CORNERS 64
+
+/**
+ * @brief A growable array of floats, used for each attribute pool.
+ */
+typedef struct float_pool
+{
+    /**
+     * @brief The values.
+     */
+    float *values;
+    /**
+     * @brief The amount of values.
+     */
+    size_t count;
+    /**
+     * @brief The allocated length of @ref values.
+     */
+    size_t capacity;
+} float_pool_t;
+
+/**
+ * ParseFloats
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Parse up to the given amount of floats from a line and push them
+ * onto a pool. Missing values are pushed as 0.
+ *
+ * @param pool The pool to push onto.
+ * @param line The text following the keyword.
+ * @param count The amount of values to push.
+ * @return void -- Nothing.
+ */
+static void ParseFloats_(float_pool_t *pool, const char *line,
+                         size_t count)
+{
+    if (pool->count + count > pool->capacity)
+    {
+        pool->capacity = pool->capacity == 0 ? 4096 : pool->capacity * 2;
+        pool->values = LetoCookerAllocate(
+            pool->values, pool->capacity * sizeof(float));
+    }
+
+    char *end = NULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        pool->values[pool->count++] = strtof(line, &end);
+        line = end;
+    }
+}
+
+/**
+ * ResolveIndex
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Turn a one-based, possibly negative OBJ index into a zero-based
+ * one.
+ *
+ * @param index The index as written.
+ * @param count The amount of elements defined so far.
+ * @return long -- The resolved index, or -1 if it's out of range.
+ */
+static long ResolveIndex_(long index, size_t count)
+{
+    long resolved = index < 0 ? (long)count + index : index - 1;
+    return resolved >= 0 && (size_t)resolved < count ? resolved : -1;
+}
+
+/**
+ * ParseCorner
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Parse a single "v/vt/vn" face corner into a vertex.
+ *
+ * @param cursor The text cursor; moved past the corner.
+ * @param pools The position, texture coordinate, and normal pools.
+ * @param vertex The vertex to fill.
+ * @param has_normal Set to false if the corner has no normal.
+ * @return bool -- False if there was no corner to parse.
+ */
+static bool ParseCorner_(const char **cursor, const float_pool_t *pools,
+                         leto_cooker_vertex_t *vertex, bool *has_normal)
+{
+    const char *text = *cursor;
+    while (*text == ' ' || *text == '\t') text++;
+    if (*text == '\0' || *text == '\n' || *text == '\r') return false;
+
+    long indices[3] = {0, 0, 0};
+    char *end = NULL;
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (*text != '/')
+        {
+            indices[i] = strtol(text, &end, 10);
+            text = end;
+        }
+        if (*text != '/') break;
+        text++;
+    }
+    while (*text != '\0' && *text != ' ' && *text != '\t' &&
+           *text != '\n' && *text != '\r')
+        text++;
+    *cursor = text;
+
+    *vertex = (leto_cooker_vertex_t){0};
+    long position = ResolveIndex_(indices[0], pools[0].count / 3);
+    if (position < 0) return false;
+    memcpy(vertex->position, &pools[0].values[position * 3],
+           sizeof(float) * 3);
+
+    long coordinates = ResolveIndex_(indices[1], pools[1].count / 2);
+    if (indices[1] != 0 && coordinates >= 0)
+    {
+        // OBJ puts the origin at the bottom left, same as OpenGL.
+        vertex->texture_coordinates[0] = pools[1].values[coordinates * 2];
+        vertex->texture_coordinates[1] =
+            pools[1].values[coordinates * 2 + 1];
+    }
+
+    long normal = ResolveIndex_(indices[2], pools[2].count / 3);
+    if (indices[2] != 0 && normal >= 0)
+        memcpy(vertex->normal, &pools[2].values[normal * 3],
+               sizeof(float) * 3);
+    else *has_normal = false;
+
+    return true;
+}
+
+/**
+ * FindMaterial
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the index of a material name, by order of first use.
+ *
+ * @param names The names seen so far.
+ * @param count The amount of names seen so far; bumped if this is new.
+ * @param name The name to look up, terminated by the end of the line.
+ * @return uint32_t -- The material's index.
+ */
+static uint32_t FindMaterial_(char ***names, size_t *count,
+                              const char *name)
+{
+    size_t length = strcspn(name, "\r\n");
+    for (size_t i = 0; i < *count; i++)
+        if (strlen((*names)[i]) == length &&
+            strncmp((*names)[i], name, length) == 0)
+            return (uint32_t)i;
+
+    *names = LetoCookerAllocate(*names, (*count + 1) * sizeof(char *));
+    (*names)[*count] = LetoCookerAllocate(NULL, length + 1);
+    memcpy((*names)[*count], name, length);
+    (*names)[*count][length] = '\0';
+    return (uint32_t)(*count)++;
+}
+
+bool LetoImportObj(leto_cooker_mesh_t *mesh, const char *path)
+{
+    char *contents = LetoReadWholeFile(path, NULL);
+    if (contents == NULL) return false;
+
+    // Positions, texture coordinates, and normals.
+    float_pool_t pools[3] = {{0}, {0}, {0}};
+    char **material_names = NULL;
+    size_t material_count = 0;
+    uint32_t material = 0;
+    bool has_normals = true;
+
+    for (char *line = contents; *line != '\0';)
+    {
+        char *next = line + strcspn(line, "\n");
+        if (*next == '\n') *next++ = '\0';
+        while (*line == ' ' || *line == '\t') line++;
+
+        if (strncmp(line, "v ", 2) == 0)
+            ParseFloats_(&pools[0], line + 2, 3);
+        else if (strncmp(line, "vt ", 3) == 0)
+            ParseFloats_(&pools[1], line + 3, 2);
+        else if (strncmp(line, "vn ", 3) == 0)
+            ParseFloats_(&pools[2], line + 3, 3);
+        else if (strncmp(line, "usemtl ", 7) == 0)
+            material =
+                FindMaterial_(&material_names, &material_count, line + 7);
+        else if (strncmp(line, "f ", 2) == 0)
+        {
+            uint32_t corners[MAX_POLYGON_CORNERS];
+            size_t corner_count = 0;
+            const char *cursor = line + 2;
+            leto_cooker_vertex_t vertex;
+            while (corner_count < MAX_POLYGON_CORNERS &&
+                   ParseCorner_(&cursor, pools, &vertex, &has_normals))
+                corners[corner_count++] = LetoAppendVertex(mesh, &vertex);
+
+            for (size_t i = 2; i < corner_count; i++)
+                LetoAppendTriangle(mesh, corners[0], corners[i - 1],
+                                   corners[i], material);
+        }
+
+        line = next;
+    }
+
+    for (size_t i = 0; i < material_count; i++) free(material_names[i]);
+    free(material_names);
+    for (size_t i = 0; i < 3; i++) free(pools[i].values);
+    free(contents);
+
+    mesh->has_normals = has_normals && mesh->index_count > 0;
+    return mesh->index_count > 0;
+}
@@ -0,0 +1,644 @@
+/**
+ * @file Optimize.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements the cooker's optimization passes; vertex welding,
+ * normal generation, material grouping, Tipsify vertex cache ordering
+ * with overdraw-aware cluster sorting, and vertex fetch reordering.
+ * @implements Cooker.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cooker.h" // Public interface parent
+
+#include <math.h>   // Standard math functions
+#include <stdlib.h> // Standard memory allocation and sorting
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The value marking an empty slot or a missing vertex.
+ */
+#define NONE UINT32_MAX
+
+/**
+ * @brief A cluster of triangles, as sorted for overdraw.
+ */
+typedef struct cluster
+{
+    /**
+     * @brief The first triangle of the cluster.
+     */
+    size_t first;
+    /**
+     * @brief One past the last triangle of the cluster.
+     */
+    size_t last;
+    /**
+     * @brief How far the cluster faces out of the mesh. Clusters facing
+     * further out are drawn first, since they're likelier to occlude.
+     */
+    float sort_key;
+} cluster_t;
+
+/**
+ * HashBytes
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Hash a block of memory with 32-bit FNV-1a.
+ *
+ * @param data The memory to hash.
+ * @param size The size of the memory.
+ * @return uint32_t -- The hash.
+ */
+static uint32_t HashBytes_(const void *data, size_t size)
+{
+    const unsigned char *bytes = data;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * TableSize
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get a power-of-two hash table size at most half full with the
+ * given amount of entries.
+ *
+ * @param count The amount of entries.
+ * @return size_t -- The table size.
+ */
+static size_t TableSize_(size_t count)
+{
+    size_t size = 16;
+    while (size < count * 2) size *= 2;
+    return size;
+}
+
+/**
+ * GenerateNormals
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Give every vertex the area-weighted average normal of the faces
+ * around its position. Vertices sharing a position share a normal, even
+ * across texture seams.
+ *
+ * @param mesh The mesh to generate normals for.
+ * @return void -- Nothing.
+ */
+static void GenerateNormals_(leto_cooker_mesh_t *mesh)
+{
+    const size_t table_size = TableSize_(mesh->vertex_count);
+    uint32_t *table =
+        LetoCookerAllocate(NULL, table_size * sizeof(uint32_t));
+    uint32_t *representative =
+        LetoCookerAllocate(NULL, mesh->vertex_count * sizeof(uint32_t));
+    float *sums =
+        LetoCookerAllocate(NULL, mesh->vertex_count * 3 * sizeof(float));
+    memset(table, 0xFF, table_size * sizeof(uint32_t));
+    memset(sums, 0, mesh->vertex_count * 3 * sizeof(float));
+
+    for (size_t v = 0; v < mesh->vertex_count; v++)
+    {
+        const float *position = mesh->vertices[v].position;
+        size_t slot = HashBytes_(position, sizeof(float) * 3) &
+                      (table_size - 1);
+        while (table[slot] != NONE &&
+               memcmp(mesh->vertices[table[slot]].position, position,
+                      sizeof(float) * 3) != 0)
+            slot = (slot + 1) & (table_size - 1);
+        if (table[slot] == NONE) table[slot] = (uint32_t)v;
+        representative[v] = table[slot];
+    }
+
+    for (size_t i = 0; i < mesh->index_count; i += 3)
+    {
+        const float *a = mesh->vertices[mesh->indices[i]].position;
+        const float *b = mesh->vertices[mesh->indices[i + 1]].position;
+        const float *c = mesh->vertices[mesh->indices[i + 2]].position;
+        const float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        const float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        // The cross product's length is twice the area, which is exactly
+        // the weighting we want.
+        const float normal[3] = {ab[1] * ac[2] - ab[2] * ac[1],
+                                 ab[2] * ac[0] - ab[0] * ac[2],
+                                 ab[0] * ac[1] - ab[1] * ac[0]};
+
+        for (size_t c = 0; c < 3; c++)
+        {
+            float *sum = &sums[representative[mesh->indices[i + c]] * 3];
+            for (size_t k = 0; k < 3; k++) sum[k] += normal[k];
+        }
+    }
+
+    for (size_t v = 0; v < mesh->vertex_count; v++)
+    {
+        const float *sum = &sums[representative[v] * 3];
+        float length =
+            sqrtf(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+        for (size_t k = 0; k < 3; k++)
+            mesh->vertices[v].normal[k] =
+                length > 0.0f ? sum[k] / length : (k == 2 ? 1.0f : 0.0f);
+    }
+
+    free(sums);
+    free(representative);
+    free(table);
+    mesh->has_normals = true;
+}
+
+void LetoWeldVertices(leto_cooker_mesh_t *mesh)
+{
+    if (mesh->vertex_count == 0) return;
+
+    // Negative zero would otherwise hash differently from zero.
+    const size_t floats = sizeof(leto_cooker_vertex_t) / sizeof(float);
+    for (size_t v = 0; v < mesh->vertex_count; v++)
+    {
+        float *values = (float *)&mesh->vertices[v];
+        for (size_t k = 0; k < floats; k++)
+            if (values[k] == 0.0f) values[k] = 0.0f;
+    }
+
+    const size_t table_size = TableSize_(mesh->vertex_count);
+    uint32_t *table =
+        LetoCookerAllocate(NULL, table_size * sizeof(uint32_t));
+    uint32_t *remap =
+        LetoCookerAllocate(NULL, mesh->vertex_count * sizeof(uint32_t));
+    memset(table, 0xFF, table_size * sizeof(uint32_t));
+
+    // Unique vertices are compacted in place; the write cursor never
+    // passes the read cursor, so nothing unread is overwritten.
+    size_t unique = 0;
+    for (size_t v = 0; v < mesh->vertex_count; v++)
+    {
+        const leto_cooker_vertex_t vertex = mesh->vertices[v];
+        size_t slot = HashBytes_(&vertex, sizeof(vertex)) &
+                      (table_size - 1);
+        while (table[slot] != NONE &&
+               memcmp(&mesh->vertices[table[slot]], &vertex,
+                      sizeof(vertex)) != 0)
+            slot = (slot + 1) & (table_size - 1);
+
+        if (table[slot] == NONE)
+        {
+            mesh->vertices[unique] = vertex;
+            table[slot] = (uint32_t)unique++;
+        }
+        remap[v] = table[slot];
+    }
+
+    for (size_t i = 0; i < mesh->index_count; i++)
+        mesh->indices[i] = remap[mesh->indices[i]];
+    mesh->vertex_count = unique;
+
+    free(remap);
+    free(table);
+    if (!mesh->has_normals) GenerateNormals_(mesh);
+}
+
+/**
+ * CompareKeys
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Compare two 64-bit keys, for @ref qsort.
+ *
+ * @param first The first key.
+ * @param second The second key.
+ * @return int -- Less than, equal to, or greater than zero.
+ */
+static int CompareKeys_(const void *first, const void *second)
+{
+    uint64_t a = *(const uint64_t *)first, b = *(const uint64_t *)second;
+    return (a > b) - (a < b);
+}
+
+void LetoGroupSubmeshes(leto_cooker_mesh_t *mesh)
+{
+    const size_t triangle_count = mesh->index_count / 3;
+
+    // Material in the high half, original position in the low, so the
+    // sort is stable.
+    uint64_t *keys =
+        LetoCookerAllocate(NULL, triangle_count * sizeof(uint64_t));
+    for (size_t t = 0; t < triangle_count; t++)
+        keys[t] = ((uint64_t)mesh->materials[t] << 32) | t;
+    qsort(keys, triangle_count, sizeof(uint64_t), CompareKeys_);
+
+    uint32_t *indices =
+        LetoCookerAllocate(NULL, mesh->index_count * sizeof(uint32_t));
+    free(mesh->submeshes);
+    mesh->submeshes = NULL;
+    mesh->submesh_count = 0;
+
+    for (size_t t = 0; t < triangle_count; t++)
+    {
+        const uint32_t source = (uint32_t)keys[t];
+        const uint32_t material = (uint32_t)(keys[t] >> 32);
+        memcpy(&indices[t * 3], &mesh->indices[source * 3],
+               sizeof(uint32_t) * 3);
+
+        if (mesh->submesh_count == 0 ||
+            mesh->submeshes[mesh->submesh_count - 1].material != material)
+        {
+            mesh->submeshes = LetoCookerAllocate(
+                mesh->submeshes,
+                (mesh->submesh_count + 1) * sizeof(leto_mesh_submesh_t));
+            mesh->submeshes[mesh->submesh_count++] = (leto_mesh_submesh_t){
+                .material = material,
+                .lods[0] = {.first_index = (uint32_t)(t * 3)}};
+        }
+        mesh->submeshes[mesh->submesh_count - 1].lods[0].index_count += 3;
+    }
+
+    free(mesh->indices);
+    free(mesh->materials);
+    mesh->indices = indices;
+    mesh->index_capacity = mesh->index_count;
+    mesh->materials = NULL;
+    free(keys);
+}
+
+/**
+ * Tipsify
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Reorder a triangle list for the post-transform cache. The
+ * algorithm fans around one vertex at a time, choosing as the next fan
+ * center a vertex that will still be in the cache once all its remaining
+ * triangles are emitted. When there is none, it backtracks through recent
+ * vertices (a dead end); every dead end starts a new cluster.
+ *
+ * @param indices The triangle list to reorder.
+ * @param index_count The amount of indices.
+ * @param vertex_count The amount of vertices referenced.
+ * @param cache_size The cache size to optimize for.
+ * @param output Filled with the reordered triangle list.
+ * @param clusters Filled with the first triangle of each cluster.
+ * @return size_t -- The amount of clusters.
+ */
+static size_t Tipsify_(const uint32_t *indices, size_t index_count,
+                       size_t vertex_count, size_t cache_size,
+                       uint32_t *output, size_t *clusters)
+{
+    const size_t triangle_count = index_count / 3;
+    uint32_t *live =
+        LetoCookerAllocate(NULL, vertex_count * sizeof(uint32_t));
+    uint32_t *offsets =
+        LetoCookerAllocate(NULL, (vertex_count + 1) * sizeof(uint32_t));
+    uint32_t *adjacency =
+        LetoCookerAllocate(NULL, index_count * sizeof(uint32_t));
+    uint32_t *cache_time =
+        LetoCookerAllocate(NULL, vertex_count * sizeof(uint32_t));
+    uint32_t *dead_ends =
+        LetoCookerAllocate(NULL, index_count * sizeof(uint32_t));
+    uint32_t *candidates =
+        LetoCookerAllocate(NULL, index_count * sizeof(uint32_t));
+    bool *emitted = LetoCookerAllocate(NULL, triangle_count);
+    memset(live, 0, vertex_count * sizeof(uint32_t));
+    memset(cache_time, 0, vertex_count * sizeof(uint32_t));
+    memset(emitted, 0, triangle_count);
+
+    // Build the vertex-triangle adjacency as a compressed list.
+    for (size_t i = 0; i < index_count; i++) live[indices[i]]++;
+    offsets[0] = 0;
+    for (size_t v = 0; v < vertex_count; v++)
+        offsets[v + 1] = offsets[v] + live[v];
+    for (size_t i = 0; i < index_count; i++)
+        adjacency[offsets[indices[i]]++] = (uint32_t)(i / 3);
+    for (size_t v = vertex_count; v > 0; v--) offsets[v] = offsets[v - 1];
+    offsets[0] = 0;
+
+    uint32_t time = (uint32_t)cache_size + 1;
+    size_t dead_end_count = 0, cursor = 0, written = 0, cluster_count = 0;
+    uint32_t fan = index_count > 0 ? indices[0] : NONE;
+    clusters[cluster_count++] = 0;
+
+    while (fan != NONE)
+    {
+        size_t candidate_count = 0;
+        for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; a++)
+        {
+            const uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = true;
+
+            for (size_t c = 0; c < 3; c++)
+            {
+                const uint32_t v = indices[triangle * 3 + c];
+                output[written++] = v;
+                dead_ends[dead_end_count++] = v;
+                candidates[candidate_count++] = v;
+                live[v]--;
+                if (time - cache_time[v] > cache_size)
+                    cache_time[v] = time++;
+            }
+        }
+
+        // Prefer the candidate that's been in the cache longest, so long
+        // as fanning around it won't push it out.
+        uint32_t next = NONE;
+        long best = -1;
+        for (size_t i = 0; i < candidate_count; i++)
+        {
+            const uint32_t v = candidates[i];
+            if (live[v] == 0) continue;
+
+            long priority = 0;
+            if (time - cache_time[v] + 2 * live[v] <= cache_size)
+                priority = (long)(time - cache_time[v]);
+            if (priority > best)
+            {
+                best = priority;
+                next = v;
+            }
+        }
+
+        if (next == NONE)
+        {
+            while (dead_end_count > 0 && next == NONE)
+            {
+                const uint32_t v = dead_ends[--dead_end_count];
+                if (live[v] > 0) next = v;
+            }
+            while (next == NONE && cursor < vertex_count)
+            {
+                if (live[cursor] > 0) next = (uint32_t)cursor;
+                cursor++;
+            }
+            if (next != NONE) clusters[cluster_count++] = written / 3;
+        }
+        fan = next;
+    }
+
+    free(emitted);
+    free(candidates);
+    free(dead_ends);
+    free(cache_time);
+    free(adjacency);
+    free(offsets);
+    free(live);
+    return cluster_count;
+}
+
+/**
+ * CountMisses
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Feed one triangle through a simulated FIFO cache.
+ *
+ * @param triangle The triangle's three indices.
+ * @param cache_time When each vertex entered the cache.
+ * @param time The cache's clock.
+ * @param cache_size The size of the cache.
+ * @return size_t -- The amount of vertices that missed.
+ */
+static size_t CountMisses_(const uint32_t *triangle, uint32_t *cache_time,
+                           uint32_t *time, size_t cache_size)
+{
+    size_t misses = 0;
+    for (size_t c = 0; c < 3; c++)
+    {
+        if (*time - cache_time[triangle[c]] <= cache_size) continue;
+        cache_time[triangle[c]] = (*time)++;
+        misses++;
+    }
+    return misses;
+}
+
+/**
+ * CompareClusters
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Compare two clusters by descending sort key, for @ref qsort.
+ *
+ * @param first The first cluster.
+ * @param second The second cluster.
+ * @return int -- Less than, equal to, or greater than zero.
+ */
+static int CompareClusters_(const void *first, const void *second)
+{
+    const cluster_t *a = first, *b = second;
+    if (a->sort_key != b->sort_key)
+        return a->sort_key > b->sort_key ? -1 : 1;
+    return (a->first > b->first) - (a->first < b->first);
+}
+
+/**
+ * OptimizeOverdraw
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Split Tipsify's clusters wherever doing so barely hurts cache
+ * efficiency, then sort them so that clusters facing away from the
+ * mesh's center (and so likelier to occlude the rest) are drawn first.
+ *
+ * @param mesh The mesh the triangles belong to.
+ * @param indices The cache-optimized triangle list; reordered in place.
+ * @param index_count The amount of indices.
+ * @param hard The first triangle of each of Tipsify's clusters.
+ * @param hard_count The amount of Tipsify clusters.
+ * @param cache_size The cache size the list was optimized for.
+ * @return void -- Nothing.
+ */
+static void OptimizeOverdraw_(const leto_cooker_mesh_t *mesh,
+                              uint32_t *indices, size_t index_count,
+                              const size_t *hard, size_t hard_count,
+                              size_t cache_size)
+{
+    const size_t triangle_count = index_count / 3;
+    cluster_t *clusters =
+        LetoCookerAllocate(NULL, triangle_count * sizeof(cluster_t));
+    uint32_t *cache_time =
+        LetoCookerAllocate(NULL, mesh->vertex_count * sizeof(uint32_t));
+    memset(cache_time, 0, mesh->vertex_count * sizeof(uint32_t));
+    uint32_t time = (uint32_t)cache_size + 1;
+    size_t cluster_count = 0;
+
+    for (size_t h = 0; h < hard_count; h++)
+    {
+        const size_t first = hard[h];
+        const size_t last = h + 1 < hard_count ? hard[h + 1]
+                                               : triangle_count;
+        if (first >= last) continue;
+
+        // The cluster's overall efficiency, starting from a cold cache.
+        time += (uint32_t)cache_size + 1;
+        size_t misses = 0;
+        for (size_t t = first; t < last; t++)
+            misses += CountMisses_(&indices[t * 3], cache_time, &time,
+                                   cache_size);
+        const float target = LETO_COOKER_OVERDRAW_THRESHOLD *
+                             (float)misses / (float)(last - first);
+
+        // Cut wherever the running efficiency is already near that.
+        time += (uint32_t)cache_size + 1;
+        size_t start = first;
+        misses = 0;
+        for (size_t t = first; t < last; t++)
+        {
+            misses += CountMisses_(&indices[t * 3], cache_time, &time,
+                                   cache_size);
+            if (t + 1 < last &&
+                (float)misses / (float)(t + 1 - start) <= target)
+            {
+                clusters[cluster_count++] = (cluster_t){start, t + 1, 0};
+                start = t + 1;
+                misses = 0;
+                time += (uint32_t)cache_size + 1;
+            }
+        }
+        clusters[cluster_count++] = (cluster_t){start, last, 0};
+    }
+
+    // The area-weighted centroid of the whole list.
+    double center[3] = {0, 0, 0}, total_area = 0;
+    float *areas =
+        LetoCookerAllocate(NULL, triangle_count * sizeof(float));
+    float *normals =
+        LetoCookerAllocate(NULL, triangle_count * 3 * sizeof(float));
+    float *centroids =
+        LetoCookerAllocate(NULL, triangle_count * 3 * sizeof(float));
+    for (size_t t = 0; t < triangle_count; t++)
+    {
+        const float *a = mesh->vertices[indices[t * 3]].position;
+        const float *b = mesh->vertices[indices[t * 3 + 1]].position;
+        const float *c = mesh->vertices[indices[t * 3 + 2]].position;
+        const float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        const float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        float *normal = &normals[t * 3];
+        normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+        normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+        normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+        areas[t] = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] +
+                         normal[2] * normal[2]);
+
+        for (size_t k = 0; k < 3; k++)
+        {
+            centroids[t * 3 + k] = (a[k] + b[k] + c[k]) / 3.0f;
+            center[k] += centroids[t * 3 + k] * areas[t];
+        }
+        total_area += areas[t];
+    }
+    for (size_t k = 0; k < 3; k++)
+        center[k] = total_area > 0 ? center[k] / total_area : 0;
+
+    for (size_t i = 0; i < cluster_count; i++)
+    {
+        float centroid[3] = {0, 0, 0}, normal[3] = {0, 0, 0}, area = 0;
+        for (size_t t = clusters[i].first; t < clusters[i].last; t++)
+        {
+            for (size_t k = 0; k < 3; k++)
+            {
+                centroid[k] += centroids[t * 3 + k] * areas[t];
+                normal[k] += normals[t * 3 + k];
+            }
+            area += areas[t];
+        }
+
+        float length = sqrtf(normal[0] * normal[0] +
+                             normal[1] * normal[1] +
+                             normal[2] * normal[2]);
+        if (area <= 0.0f || length <= 0.0f) continue;
+        for (size_t k = 0; k < 3; k++)
+            clusters[i].sort_key += ((centroid[k] / area) -
+                                     (float)center[k]) *
+                                    (normal[k] / length);
+    }
+
+    qsort(clusters, cluster_count, sizeof(cluster_t), CompareClusters_);
+
+    uint32_t *sorted =
+        LetoCookerAllocate(NULL, index_count * sizeof(uint32_t));
+    size_t written = 0;
+    for (size_t i = 0; i < cluster_count; i++)
+    {
+        size_t count = (clusters[i].last - clusters[i].first) * 3;
+        memcpy(&sorted[written], &indices[clusters[i].first * 3],
+               count * sizeof(uint32_t));
+        written += count;
+    }
+    memcpy(indices, sorted, index_count * sizeof(uint32_t));
+
+    free(sorted);
+    free(centroids);
+    free(normals);
+    free(areas);
+    free(cache_time);
+    free(clusters);
+}
+
+void LetoOptimizeVertexCache(leto_cooker_mesh_t *mesh, size_t cache_size)
+{
+    uint32_t *output =
+        LetoCookerAllocate(NULL, mesh->index_count * sizeof(uint32_t));
+    size_t *clusters = LetoCookerAllocate(
+        NULL, (mesh->index_count / 3 + 1) * sizeof(size_t));
+
+    for (size_t s = 0; s < mesh->submesh_count; s++)
+        for (size_t l = 0; l < LETO_MESH_MAX_LODS; l++)
+        {
+            const leto_mesh_range_t *range = &mesh->submeshes[s].lods[l];
+            if (range->index_count == 0) continue;
+            // Levels that repeat the one before are already done.
+            if (l > 0 && range->first_index ==
+                             mesh->submeshes[s].lods[l - 1].first_index)
+                continue;
+
+            uint32_t *indices = &mesh->indices[range->first_index];
+            size_t cluster_count =
+                Tipsify_(indices, range->index_count, mesh->vertex_count,
+                         cache_size, output, clusters);
+            memcpy(indices, output,
+                   range->index_count * sizeof(uint32_t));
+            OptimizeOverdraw_(mesh, indices, range->index_count, clusters,
+                              cluster_count, cache_size);
+        }
+
+    free(clusters);
+    free(output);
+}
+
+void LetoOptimizeVertexFetch(leto_cooker_mesh_t *mesh)
+{
+    uint32_t *remap =
+        LetoCookerAllocate(NULL, mesh->vertex_count * sizeof(uint32_t));
+    memset(remap, 0xFF, mesh->vertex_count * sizeof(uint32_t));
+    leto_cooker_vertex_t *vertices = LetoCookerAllocate(
+        NULL, mesh->vertex_count * sizeof(leto_cooker_vertex_t));
+
+    size_t used = 0;
+    for (size_t i = 0; i < mesh->index_count; i++)
+    {
+        const uint32_t v = mesh->indices[i];
+        if (remap[v] == NONE)
+        {
+            vertices[used] = mesh->vertices[v];
+            remap[v] = (uint32_t)used++;
+        }
+        mesh->indices[i] = remap[v];
+    }
+
+    free(mesh->vertices);
+    mesh->vertices = vertices;
+    mesh->vertex_count = used;
+    mesh->vertex_capacity = used;
+    free(remap);
+}
+
+float LetoAverageCacheMissRatio(const uint32_t *indices,
+                                size_t index_count, size_t vertex_count,
+                                size_t cache_size)
+{
+    if (index_count < 3) return 0.0f;
+
+    uint32_t *cache_time =
+        LetoCookerAllocate(NULL, vertex_count * sizeof(uint32_t));
+    memset(cache_time, 0, vertex_count * sizeof(uint32_t));
+    uint32_t time = (uint32_t)cache_size + 1;
+
+    size_t misses = 0;
+    for (size_t i = 0; i + 2 < index_count; i += 3)
+        misses += CountMisses_(&indices[i], cache_time, &time, cache_size);
+
+    free(cache_time);
+    return (float)misses / (float)(index_count / 3);
+}
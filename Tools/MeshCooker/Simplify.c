@@ -0,0 +1,975 @@
+/**
+ * @file Simplify.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements level of detail generation by quadric error metric
+ * edge collapse (Garland and Heckbert 1997). Collapses are half-edge
+ * collapses, moving one vertex onto a neighbor, so no new vertices (or
+ * attributes) are ever made.
+ *
+ * Vertices sharing a position but not attributes are seams. Positions
+ * are classified every pass; interior positions may collapse anywhere,
+ * positions on an open border only along that border, and positions on
+ * a seam only along that seam, carrying both sides with them. Everything
+ * else stays put, so neither UV nor normal seams ever tear.
+ * @implements Cooker.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cooker.h" // Public interface parent
+
+#include <math.h>   // Standard math functions
+#include <stdlib.h> // Standard memory allocation and sorting
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief The value marking an empty slot or a missing vertex.
+ */
+#define NONE UINT32_MAX
+
+/**
+ * @brief The value marking an empty slot in an edge set.
+ */
+#define EMPTY_EDGE UINT64_MAX
+
+/**
+ * @brief How much more open borders weigh than surfaces, so that the
+ * silhouette of open meshes holds up.
+ */
+#define BORDER_WEIGHT 10.0
+
+/**
+ * @brief The share of the remaining reduction attempted per pass. Lower
+ * is slower, but picks collapses from a fresher cost ordering.
+ */
+#define PASS_SHARE 0.5
+
+/**
+ * @brief The most distinct neighbors a position may have and still move.
+ */
+#define RING_SIZE 64
+
+/**
+ * @brief The ways a position may move.
+ */
+typedef enum vertex_kind
+{
+    /**
+     * @brief An interior position with one set of attributes.
+     */
+    kind_manifold,
+    /**
+     * @brief A position on a single open border.
+     */
+    kind_border,
+    /**
+     * @brief A position on a single seam; two sets of attributes.
+     */
+    kind_seam,
+    /**
+     * @brief Anything else; corners, junctions, and non-manifold mess.
+     */
+    kind_locked
+} vertex_kind_t;
+
+/**
+ * @brief A symmetric 4x4 error quadric, plus the weight it was built
+ * with so errors can be normalized back into distances.
+ */
+typedef struct quadric
+{
+    double xx, xy, xz, xw, yy, yz, yw, zz, zw, ww;
+    double weight;
+} quadric_t;
+
+/**
+ * @brief A candidate collapse of one position onto a neighbor.
+ */
+typedef struct collapse
+{
+    /**
+     * @brief The wedge (vertex) being removed.
+     */
+    uint32_t from;
+    /**
+     * @brief The wedge it's merged into.
+     */
+    uint32_t to;
+    /**
+     * @brief The squared distance error the collapse introduces.
+     */
+    double cost;
+} collapse_t;
+
+/**
+ * @brief A set of directed edges.
+ */
+typedef struct edge_set
+{
+    /**
+     * @brief The edges, as (from << 32) | to.
+     */
+    uint64_t *keys;
+    /**
+     * @brief The size of @ref keys, a power of two.
+     */
+    size_t size;
+} edge_set_t;
+
+/**
+ * @brief The state of a simplification.
+ */
+typedef struct simplifier
+{
+    /**
+     * @brief The mesh whose vertices are being used.
+     */
+    const leto_cooker_mesh_t *mesh;
+    /**
+     * @brief The first wedge of each vertex's position.
+     */
+    uint32_t *position;
+    /**
+     * @brief The quadric of each position, indexed by first wedge.
+     */
+    quadric_t *quadrics;
+    /**
+     * @brief The kind of each position, indexed by first wedge.
+     */
+    uint8_t *kinds;
+    /**
+     * @brief Whether a position has been touched this pass.
+     */
+    bool *touched;
+    /**
+     * @brief Where each wedge is merged to this pass, or itself.
+     */
+    uint32_t *remap;
+    /**
+     * @brief Edges between wedges.
+     */
+    edge_set_t wedge_edges;
+    /**
+     * @brief Edges between positions.
+     */
+    edge_set_t position_edges;
+    /**
+     * @brief The triangles around each position, compressed.
+     */
+    uint32_t *adjacency;
+    /**
+     * @brief The start of each position's triangles in @ref adjacency.
+     */
+    uint32_t *offsets;
+} simplifier_t;
+
+/**
+ * HashEdge
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Mix an edge key into a table slot.
+ *
+ * @param key The edge key.
+ * @param size The size of the table.
+ * @return size_t -- The first slot to probe.
+ */
+static size_t HashEdge_(uint64_t key, size_t size)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return (size_t)key & (size - 1);
+}
+
+/**
+ * InsertEdge
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add a directed edge to a set.
+ *
+ * @param set The set.
+ * @param from The start of the edge.
+ * @param to The end of the edge.
+ * @return void -- Nothing.
+ */
+static void InsertEdge_(edge_set_t *set, uint32_t from, uint32_t to)
+{
+    const uint64_t key = ((uint64_t)from << 32) | to;
+    size_t slot = HashEdge_(key, set->size);
+    while (set->keys[slot] != EMPTY_EDGE && set->keys[slot] != key)
+        slot = (slot + 1) & (set->size - 1);
+    set->keys[slot] = key;
+}
+
+/**
+ * HasEdge
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether a set contains a directed edge.
+ *
+ * @param set The set.
+ * @param from The start of the edge.
+ * @param to The end of the edge.
+ * @return bool -- True if the edge is in the set.
+ */
+static bool HasEdge_(const edge_set_t *set, uint32_t from, uint32_t to)
+{
+    const uint64_t key = ((uint64_t)from << 32) | to;
+    size_t slot = HashEdge_(key, set->size);
+    while (set->keys[slot] != EMPTY_EDGE)
+    {
+        if (set->keys[slot] == key) return true;
+        slot = (slot + 1) & (set->size - 1);
+    }
+    return false;
+}
+
+/**
+ * AddPlane
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add the quadric of a plane to another quadric.
+ *
+ * @param quadric The quadric to add to.
+ * @param normal The unit normal of the plane.
+ * @param point A point on the plane.
+ * @param weight The weight of the plane.
+ * @return void -- Nothing.
+ */
+static void AddPlane_(quadric_t *quadric, const double *normal,
+                      const float *point, double weight)
+{
+    const double a = normal[0], b = normal[1], c = normal[2];
+    const double d = -(a * point[0] + b * point[1] + c * point[2]);
+
+    quadric->xx += weight * a * a;
+    quadric->xy += weight * a * b;
+    quadric->xz += weight * a * c;
+    quadric->xw += weight * a * d;
+    quadric->yy += weight * b * b;
+    quadric->yz += weight * b * c;
+    quadric->yw += weight * b * d;
+    quadric->zz += weight * c * c;
+    quadric->zw += weight * c * d;
+    quadric->ww += weight * d * d;
+    quadric->weight += weight;
+}
+
+/**
+ * MergeQuadrics
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Add one quadric to another.
+ *
+ * @param to The quadric to add to.
+ * @param from The quadric to add.
+ * @return void -- Nothing.
+ */
+static void MergeQuadrics_(quadric_t *to, const quadric_t *from)
+{
+    double *a = (double *)to;
+    const double *b = (const double *)from;
+    for (size_t i = 0; i < sizeof(quadric_t) / sizeof(double); i++)
+        a[i] += b[i];
+}
+
+/**
+ * EvaluateQuadric
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the weighted mean squared distance from a point to the
+ * planes of a quadric.
+ *
+ * @param quadric The quadric.
+ * @param point The point.
+ * @return double -- The error.
+ */
+static double EvaluateQuadric_(const quadric_t *quadric,
+                               const float *point)
+{
+    const double x = point[0], y = point[1], z = point[2];
+    const double error =
+        quadric->xx * x * x + quadric->yy * y * y + quadric->zz * z * z +
+        2 * (quadric->xy * x * y + quadric->xz * x * z +
+             quadric->yz * y * z) +
+        2 * (quadric->xw * x + quadric->yw * y + quadric->zw * z) +
+        quadric->ww;
+    return quadric->weight > 0 ? fabs(error) / quadric->weight : 0;
+}
+
+/**
+ * TriangleNormal
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Get the (area-scaled) normal of a triangle.
+ *
+ * @param a The first corner.
+ * @param b The second corner.
+ * @param c The third corner.
+ * @param normal Filled with the normal, whose length is twice the area.
+ * @return void -- Nothing.
+ */
+static void TriangleNormal_(const float *a, const float *b, const float *c,
+                            double *normal)
+{
+    const double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const double ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+    normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+    normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+}
+
+/**
+ * Normalize
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Normalize a vector in place.
+ *
+ * @param vector The vector.
+ * @return double -- The original length of the vector.
+ */
+static double Normalize_(double *vector)
+{
+    const double length =
+        sqrt(vector[0] * vector[0] + vector[1] * vector[1] +
+             vector[2] * vector[2]);
+    if (length > 0)
+        for (size_t k = 0; k < 3; k++) vector[k] /= length;
+    return length;
+}
+
+/**
+ * BuildPositions
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the first wedge of every vertex's position.
+ *
+ * @param simplifier The simplifier.
+ * @return void -- Nothing.
+ */
+static void BuildPositions_(simplifier_t *simplifier)
+{
+    const leto_cooker_mesh_t *mesh = simplifier->mesh;
+    size_t table_size = 16;
+    while (table_size < mesh->vertex_count * 2) table_size *= 2;
+    uint32_t *table =
+        LetoCookerAllocate(NULL, table_size * sizeof(uint32_t));
+    memset(table, 0xFF, table_size * sizeof(uint32_t));
+
+    for (size_t v = 0; v < mesh->vertex_count; v++)
+    {
+        const float *position = mesh->vertices[v].position;
+        uint32_t hash = 2166136261u;
+        const unsigned char *bytes = (const unsigned char *)position;
+        for (size_t i = 0; i < sizeof(float) * 3; i++)
+            hash = (hash ^ bytes[i]) * 16777619u;
+
+        size_t slot = hash & (table_size - 1);
+        while (table[slot] != NONE &&
+               memcmp(mesh->vertices[table[slot]].position, position,
+                      sizeof(float) * 3) != 0)
+            slot = (slot + 1) & (table_size - 1);
+        if (table[slot] == NONE) table[slot] = (uint32_t)v;
+        simplifier->position[v] = table[slot];
+    }
+
+    free(table);
+}
+
+/**
+ * BuildTopology
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Rebuild the edge sets and position adjacency of the current
+ * triangle list.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The current triangle list.
+ * @param index_count The amount of indices.
+ * @return void -- Nothing.
+ */
+static void BuildTopology_(simplifier_t *simplifier,
+                           const uint32_t *indices, size_t index_count)
+{
+    const size_t vertex_count = simplifier->mesh->vertex_count;
+    edge_set_t *sets[2] = {&simplifier->wedge_edges,
+                           &simplifier->position_edges};
+    for (size_t s = 0; s < 2; s++)
+        memset(sets[s]->keys, 0xFF, sets[s]->size * sizeof(uint64_t));
+
+    memset(simplifier->offsets, 0, (vertex_count + 1) * sizeof(uint32_t));
+    for (size_t i = 0; i < index_count; i++)
+    {
+        const uint32_t a = indices[i];
+        const uint32_t b = indices[i - i % 3 + (i + 1) % 3];
+        InsertEdge_(&simplifier->wedge_edges, a, b);
+        InsertEdge_(&simplifier->position_edges, simplifier->position[a],
+                    simplifier->position[b]);
+        simplifier->offsets[simplifier->position[a] + 1]++;
+    }
+
+    for (size_t v = 0; v < vertex_count; v++)
+        simplifier->offsets[v + 1] += simplifier->offsets[v];
+    for (size_t i = 0; i < index_count; i++)
+        simplifier->adjacency[simplifier->offsets
+                                  [simplifier->position[indices[i]]]++] =
+            (uint32_t)(i / 3);
+    for (size_t v = vertex_count; v > 0; v--)
+        simplifier->offsets[v] = simplifier->offsets[v - 1];
+    simplifier->offsets[0] = 0;
+}
+
+/**
+ * ClassifyPositions
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Work out how every position used by the triangle list may move.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The current triangle list.
+ * @param index_count The amount of indices.
+ * @return void -- Nothing.
+ */
+static void ClassifyPositions_(simplifier_t *simplifier,
+                               const uint32_t *indices, size_t index_count)
+{
+    const size_t vertex_count = simplifier->mesh->vertex_count;
+    const uint32_t *position = simplifier->position;
+
+    // Per position; border edges out and in, wedges in use, and wedges
+    // sitting on exactly one seam. Per wedge; seam edges out and in.
+    uint32_t *counts =
+        LetoCookerAllocate(NULL, vertex_count * 6 * sizeof(uint32_t));
+    memset(counts, 0, vertex_count * 6 * sizeof(uint32_t));
+    uint32_t *border_out = counts, *border_in = counts + vertex_count;
+    uint32_t *wedges = counts + vertex_count * 2;
+    uint32_t *seam_wedges = counts + vertex_count * 3;
+    uint32_t *seam_out = counts + vertex_count * 4;
+    uint32_t *seam_in = counts + vertex_count * 5;
+    bool *seen = LetoCookerAllocate(NULL, vertex_count);
+    memset(seen, 0, vertex_count);
+
+    for (size_t i = 0; i < index_count; i++)
+    {
+        const uint32_t a = indices[i];
+        const uint32_t b = indices[i - i % 3 + (i + 1) % 3];
+        if (!seen[a])
+        {
+            seen[a] = true;
+            wedges[position[a]]++;
+        }
+
+        if (!HasEdge_(&simplifier->position_edges, position[b],
+                      position[a]))
+        {
+            border_out[position[a]]++;
+            border_in[position[b]]++;
+        }
+        else if (!HasEdge_(&simplifier->wedge_edges, b, a))
+        {
+            seam_out[a]++;
+            seam_in[b]++;
+        }
+    }
+
+    for (size_t v = 0; v < vertex_count; v++)
+        if (seen[v] && seam_out[v] == 1 && seam_in[v] == 1)
+            seam_wedges[position[v]]++;
+
+    for (size_t v = 0; v < vertex_count; v++)
+    {
+        simplifier->kinds[v] = kind_locked;
+        if (position[v] != v || !seen[v]) continue;
+        const bool border = border_out[v] != 0 || border_in[v] != 0;
+
+        if (wedges[v] == 1 && !border)
+            simplifier->kinds[v] = kind_manifold;
+        else if (wedges[v] == 1 && border_out[v] == 1 && border_in[v] == 1)
+            simplifier->kinds[v] = kind_border;
+        else if (wedges[v] == 2 && seam_wedges[v] == 2 && !border)
+            simplifier->kinds[v] = kind_seam;
+    }
+
+    free(seen);
+    free(counts);
+}
+
+/**
+ * BuildQuadrics
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Accumulate the plane of every triangle into the quadrics of its
+ * positions, plus perpendicular planes along open borders.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The original triangle list.
+ * @param index_count The amount of indices.
+ * @return void -- Nothing.
+ */
+static void BuildQuadrics_(simplifier_t *simplifier,
+                           const uint32_t *indices, size_t index_count)
+{
+    const leto_cooker_vertex_t *vertices = simplifier->mesh->vertices;
+    const uint32_t *position = simplifier->position;
+
+    for (size_t i = 0; i < index_count; i += 3)
+    {
+        double normal[3];
+        const float *corners[3];
+        for (size_t c = 0; c < 3; c++)
+            corners[c] = vertices[indices[i + c]].position;
+        TriangleNormal_(corners[0], corners[1], corners[2], normal);
+        const double area = Normalize_(normal) * 0.5;
+        if (area <= 0) continue;
+
+        for (size_t c = 0; c < 3; c++)
+        {
+            const uint32_t a = position[indices[i + c]];
+            const uint32_t b = position[indices[i + (c + 1) % 3]];
+            AddPlane_(&simplifier->quadrics[a], normal, corners[c], area);
+            if (HasEdge_(&simplifier->position_edges, b, a)) continue;
+
+            // An open edge; hold it in place with a plane through it,
+            // perpendicular to the surface.
+            const float *next = corners[(c + 1) % 3];
+            double edge[3] = {next[0] - corners[c][0],
+                              next[1] - corners[c][1],
+                              next[2] - corners[c][2]};
+            const double length = Normalize_(edge);
+            double plane[3] = {edge[1] * normal[2] - edge[2] * normal[1],
+                               edge[2] * normal[0] - edge[0] * normal[2],
+                               edge[0] * normal[1] - edge[1] * normal[0]};
+            Normalize_(plane);
+            const double weight = length * length * BORDER_WEIGHT;
+            AddPlane_(&simplifier->quadrics[a], plane, corners[c], weight);
+            AddPlane_(&simplifier->quadrics[b], plane, corners[c], weight);
+        }
+    }
+}
+
+/**
+ * CanCollapse
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether the kinds of two positions allow collapsing the
+ * edge between two of their wedges, from the first onto the second.
+ *
+ * @param simplifier The simplifier.
+ * @param from The wedge being removed.
+ * @param to The wedge it would merge into.
+ * @return bool -- True if the collapse keeps borders and seams intact.
+ */
+static bool CanCollapse_(const simplifier_t *simplifier, uint32_t from,
+                         uint32_t to)
+{
+    const uint32_t a = simplifier->position[from];
+    const uint32_t b = simplifier->position[to];
+    const vertex_kind_t kind = simplifier->kinds[a];
+
+    if (kind == kind_manifold) return true;
+    if (kind == kind_border)
+        return simplifier->kinds[b] != kind_manifold &&
+               (!HasEdge_(&simplifier->position_edges, a, b) ||
+                !HasEdge_(&simplifier->position_edges, b, a));
+    if (kind == kind_seam)
+        return (simplifier->kinds[b] == kind_seam ||
+                simplifier->kinds[b] == kind_locked) &&
+               (!HasEdge_(&simplifier->wedge_edges, from, to) ||
+                !HasEdge_(&simplifier->wedge_edges, to, from));
+    return false;
+}
+
+/**
+ * FlipsTriangles
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check whether moving a position onto another would turn any of
+ * the triangles around it over.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The current triangle list.
+ * @param from The position being moved.
+ * @param to The position it moves onto.
+ * @return bool -- True if any surviving triangle flips.
+ */
+static bool FlipsTriangles_(const simplifier_t *simplifier,
+                            const uint32_t *indices, uint32_t from,
+                            uint32_t to)
+{
+    const leto_cooker_vertex_t *vertices = simplifier->mesh->vertices;
+    const float *target = vertices[to].position;
+
+    for (uint32_t i = simplifier->offsets[from];
+         i < simplifier->offsets[from + 1]; i++)
+    {
+        const uint32_t *triangle = &indices[simplifier->adjacency[i] * 3];
+        const float *before[3], *after[3];
+        bool collapses = false;
+        for (size_t c = 0; c < 3; c++)
+        {
+            const uint32_t p = simplifier->position[triangle[c]];
+            if (p == to) collapses = true;
+            before[c] = vertices[triangle[c]].position;
+            after[c] = p == from ? target : before[c];
+        }
+        if (collapses) continue;
+
+        double old_normal[3], new_normal[3];
+        TriangleNormal_(before[0], before[1], before[2], old_normal);
+        TriangleNormal_(after[0], after[1], after[2], new_normal);
+        if (old_normal[0] * new_normal[0] + old_normal[1] * new_normal[1] +
+                old_normal[2] * new_normal[2] <=
+            0)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * GatherRing
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Collect the distinct positions around a position.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The current triangle list.
+ * @param center The position to gather around.
+ * @param ring Filled with the positions, at most @ref RING_SIZE.
+ * @return size_t -- The amount of positions, or SIZE_MAX if the ring
+ * was too large to gather.
+ */
+static size_t GatherRing_(const simplifier_t *simplifier,
+                          const uint32_t *indices, uint32_t center,
+                          uint32_t *ring)
+{
+    size_t count = 0;
+    for (uint32_t i = simplifier->offsets[center];
+         i < simplifier->offsets[center + 1]; i++)
+        for (size_t c = 0; c < 3; c++)
+        {
+            const uint32_t p = simplifier->position
+                [indices[simplifier->adjacency[i] * 3 + c]];
+            if (p == center) continue;
+
+            size_t k = 0;
+            while (k < count && ring[k] != p) k++;
+            if (k < count) continue;
+            if (count == RING_SIZE) return SIZE_MAX;
+            ring[count++] = p;
+        }
+    return count;
+}
+
+/**
+ * KeepsManifold
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Check the link condition of an edge; its ends may only share
+ * the neighbors across the triangles on the edge itself, or collapsing
+ * it would pinch the surface.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The current triangle list.
+ * @param from The position being moved.
+ * @param to The position it moves onto.
+ * @return bool -- True if the collapse keeps the surface manifold.
+ */
+static bool KeepsManifold_(const simplifier_t *simplifier,
+                           const uint32_t *indices, uint32_t from,
+                           uint32_t to)
+{
+    uint32_t from_ring[RING_SIZE], to_ring[RING_SIZE];
+    const size_t from_count =
+        GatherRing_(simplifier, indices, from, from_ring);
+    const size_t to_count = GatherRing_(simplifier, indices, to, to_ring);
+    if (from_count == SIZE_MAX || to_count == SIZE_MAX) return false;
+
+    size_t shared = 0;
+    for (size_t i = 0; i < from_count; i++)
+        for (size_t j = 0; j < to_count; j++)
+            shared += from_ring[i] == to_ring[j];
+
+    const bool open = !HasEdge_(&simplifier->position_edges, from, to) ||
+                      !HasEdge_(&simplifier->position_edges, to, from);
+    return shared == (open ? 1u : 2u);
+}
+
+/**
+ * PartnerWedge
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Find the wedge at a position that shares a triangle with the
+ * given wedge. This is how the far side of a seam finds where to go.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The current triangle list.
+ * @param wedge The wedge looking for a partner.
+ * @param target The position the partner must sit at.
+ * @return uint32_t -- The partner wedge, or NONE.
+ */
+static uint32_t PartnerWedge_(const simplifier_t *simplifier,
+                              const uint32_t *indices, uint32_t wedge,
+                              uint32_t target)
+{
+    const uint32_t from = simplifier->position[wedge];
+    for (uint32_t i = simplifier->offsets[from];
+         i < simplifier->offsets[from + 1]; i++)
+    {
+        const uint32_t *triangle = &indices[simplifier->adjacency[i] * 3];
+        if (triangle[0] != wedge && triangle[1] != wedge &&
+            triangle[2] != wedge)
+            continue;
+        for (size_t c = 0; c < 3; c++)
+            if (simplifier->position[triangle[c]] == target)
+                return triangle[c];
+    }
+    return NONE;
+}
+
+/**
+ * CompareCollapses
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Compare two collapses by ascending cost, for @ref qsort.
+ *
+ * @param first The first collapse.
+ * @param second The second collapse.
+ * @return int -- Less than, equal to, or greater than zero.
+ */
+static int CompareCollapses_(const void *first, const void *second)
+{
+    const collapse_t *a = first, *b = second;
+    if (a->cost != b->cost) return a->cost < b->cost ? -1 : 1;
+    return (a->from > b->from) - (a->from < b->from);
+}
+
+/**
+ * RunPass
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Run a single pass of collapses; pick the cheapest collapse of
+ * every position, then perform as many of them (cheapest first) as don't
+ * interfere with each other.
+ *
+ * @param simplifier The simplifier.
+ * @param indices The current triangle list; rewritten in place.
+ * @param index_count The amount of indices.
+ * @param target_count The index count being worked towards.
+ * @param error The largest error introduced so far; updated.
+ * @return size_t -- The new index count.
+ */
+static size_t RunPass_(simplifier_t *simplifier, uint32_t *indices,
+                       size_t index_count, size_t target_count,
+                       double *error)
+{
+    const size_t vertex_count = simplifier->mesh->vertex_count;
+    const leto_cooker_vertex_t *vertices = simplifier->mesh->vertices;
+    const uint32_t *position = simplifier->position;
+
+    BuildTopology_(simplifier, indices, index_count);
+    ClassifyPositions_(simplifier, indices, index_count);
+
+    // The cheapest collapse of every position.
+    collapse_t *best =
+        LetoCookerAllocate(NULL, vertex_count * sizeof(collapse_t));
+    for (size_t v = 0; v < vertex_count; v++)
+        best[v] = (collapse_t){NONE, NONE, INFINITY};
+    for (size_t i = 0; i < index_count; i++)
+    {
+        const uint32_t a = indices[i];
+        const uint32_t b = indices[i - i % 3 + (i + 1) % 3];
+        const uint32_t ends[2][2] = {{a, b}, {b, a}};
+        for (size_t d = 0; d < 2; d++)
+        {
+            const uint32_t from = ends[d][0], to = ends[d][1];
+            if (position[from] == position[to]) continue;
+            if (!CanCollapse_(simplifier, from, to)) continue;
+
+            const double cost =
+                EvaluateQuadric_(&simplifier->quadrics[position[from]],
+                                 vertices[to].position);
+            if (cost < best[position[from]].cost)
+                best[position[from]] = (collapse_t){from, to, cost};
+        }
+    }
+
+    size_t candidate_count = 0;
+    for (size_t v = 0; v < vertex_count; v++)
+        if (best[v].from != NONE) best[candidate_count++] = best[v];
+    qsort(best, candidate_count, sizeof(collapse_t), CompareCollapses_);
+
+    // Each collapse takes about two triangles with it.
+    const size_t goal =
+        (size_t)((double)(index_count - target_count) / 6.0 * PASS_SHARE) +
+        1;
+    for (size_t v = 0; v < vertex_count; v++) simplifier->remap[v] = v;
+
+    size_t performed = 0;
+    for (size_t i = 0; i < candidate_count && performed < goal; i++)
+    {
+        const collapse_t *collapse = &best[i];
+        const uint32_t from = position[collapse->from];
+        const uint32_t to = position[collapse->to];
+        if (simplifier->touched[from] || simplifier->touched[to]) continue;
+        if (!KeepsManifold_(simplifier, indices, from, to) ||
+            FlipsTriangles_(simplifier, indices, from, to))
+            continue;
+
+        // Seams take their other side with them.
+        uint32_t partner_from = NONE, partner_to = NONE;
+        if (simplifier->kinds[from] == kind_seam)
+        {
+            for (uint32_t j = simplifier->offsets[from];
+                 j < simplifier->offsets[from + 1] && partner_from == NONE;
+                 j++)
+                for (size_t c = 0; c < 3; c++)
+                {
+                    const uint32_t w =
+                        indices[simplifier->adjacency[j] * 3 + c];
+                    if (position[w] == from && w != collapse->from)
+                        partner_from = w;
+                }
+            if (partner_from != NONE)
+                partner_to =
+                    PartnerWedge_(simplifier, indices, partner_from, to);
+            if (partner_to == NONE) continue;
+        }
+
+        simplifier->remap[collapse->from] = collapse->to;
+        if (partner_from != NONE)
+            simplifier->remap[partner_from] = partner_to;
+        MergeQuadrics_(&simplifier->quadrics[to],
+                       &simplifier->quadrics[from]);
+        if (collapse->cost > *error) *error = collapse->cost;
+
+        // Everything around the moved position has changed shape, so
+        // none of it may move again this pass.
+        simplifier->touched[from] = simplifier->touched[to] = true;
+        for (uint32_t j = simplifier->offsets[from];
+             j < simplifier->offsets[from + 1]; j++)
+            for (size_t c = 0; c < 3; c++)
+                simplifier->touched
+                    [position[indices[simplifier->adjacency[j] * 3 + c]]] =
+                    true;
+        performed++;
+    }
+    memset(simplifier->touched, 0, vertex_count);
+    free(best);
+
+    // Rewrite the list, dropping whatever collapsed to nothing.
+    size_t written = 0;
+    for (size_t i = 0; i < index_count; i += 3)
+    {
+        const uint32_t a = simplifier->remap[indices[i]];
+        const uint32_t b = simplifier->remap[indices[i + 1]];
+        const uint32_t c = simplifier->remap[indices[i + 2]];
+        if (position[a] == position[b] || position[b] == position[c] ||
+            position[a] == position[c])
+            continue;
+        indices[written++] = a;
+        indices[written++] = b;
+        indices[written++] = c;
+    }
+    return performed == 0 ? index_count : written;
+}
+
+size_t LetoSimplify(const leto_cooker_mesh_t *mesh,
+                    const uint32_t *indices, size_t index_count,
+                    size_t target_count, uint32_t *output, float *error)
+{
+    memcpy(output, indices, index_count * sizeof(uint32_t));
+    *error = 0.0f;
+    if (index_count <= target_count) return index_count;
+
+    const size_t vertex_count = mesh->vertex_count;
+    simplifier_t simplifier = {.mesh = mesh};
+    simplifier.position =
+        LetoCookerAllocate(NULL, vertex_count * sizeof(uint32_t));
+    simplifier.quadrics =
+        LetoCookerAllocate(NULL, vertex_count * sizeof(quadric_t));
+    simplifier.kinds = LetoCookerAllocate(NULL, vertex_count);
+    simplifier.touched = LetoCookerAllocate(NULL, vertex_count);
+    simplifier.remap =
+        LetoCookerAllocate(NULL, vertex_count * sizeof(uint32_t));
+    simplifier.adjacency =
+        LetoCookerAllocate(NULL, index_count * sizeof(uint32_t));
+    simplifier.offsets =
+        LetoCookerAllocate(NULL, (vertex_count + 1) * sizeof(uint32_t));
+    memset(simplifier.quadrics, 0, vertex_count * sizeof(quadric_t));
+    memset(simplifier.touched, 0, vertex_count);
+
+    size_t set_size = 16;
+    while (set_size < index_count * 2) set_size *= 2;
+    edge_set_t *sets[2] = {&simplifier.wedge_edges,
+                           &simplifier.position_edges};
+    for (size_t s = 0; s < 2; s++)
+    {
+        sets[s]->size = set_size;
+        sets[s]->keys =
+            LetoCookerAllocate(NULL, set_size * sizeof(uint64_t));
+    }
+
+    BuildPositions_(&simplifier);
+    BuildTopology_(&simplifier, output, index_count);
+    BuildQuadrics_(&simplifier, output, index_count);
+
+    double worst = 0;
+    size_t count = index_count;
+    while (count > target_count)
+    {
+        size_t next = RunPass_(&simplifier, output, count, target_count,
+                               &worst);
+        if (next == count) break;
+        count = next;
+    }
+    *error = (float)sqrt(worst);
+
+    for (size_t s = 0; s < 2; s++) free(sets[s]->keys);
+    free(simplifier.offsets);
+    free(simplifier.adjacency);
+    free(simplifier.remap);
+    free(simplifier.touched);
+    free(simplifier.kinds);
+    free(simplifier.quadrics);
+    free(simplifier.position);
+    return count;
+}
+
+void LetoGenerateLods(leto_cooker_mesh_t *mesh, size_t lod_count)
+{
+    if (lod_count > LETO_MESH_MAX_LODS) lod_count = LETO_MESH_MAX_LODS;
+    if (lod_count < 1) lod_count = 1;
+    memset(mesh->lod_errors, 0, sizeof(mesh->lod_errors));
+    mesh->lod_count = lod_count;
+
+    uint32_t *scratch =
+        LetoCookerAllocate(NULL, mesh->index_count * sizeof(uint32_t));
+    for (size_t s = 0; s < mesh->submesh_count; s++)
+    {
+        leto_mesh_submesh_t *submesh = &mesh->submeshes[s];
+        for (size_t l = 1; l < lod_count; l++)
+        {
+            // Each level is built from the last, halving it again.
+            const leto_mesh_range_t previous = submesh->lods[l - 1];
+            const size_t target =
+                (submesh->lods[0].index_count >> l) / 3 * 3;
+
+            float error = 0.0f;
+            size_t count = LetoSimplify(
+                mesh, &mesh->indices[previous.first_index],
+                previous.index_count, target, scratch, &error);
+
+            // Levels that barely shrink just reuse the one before.
+            if (count == 0 || count * 10 > previous.index_count * 9)
+            {
+                submesh->lods[l] = previous;
+                if (mesh->lod_errors[l - 1] > mesh->lod_errors[l])
+                    mesh->lod_errors[l] = mesh->lod_errors[l - 1];
+                continue;
+            }
+
+            // New levels go on the end of the index buffer.
+            if (mesh->index_count + count > mesh->index_capacity)
+            {
+                mesh->index_capacity = mesh->index_count + count;
+                mesh->indices = LetoCookerAllocate(
+                    mesh->indices,
+                    mesh->index_capacity * sizeof(uint32_t));
+            }
+            memcpy(&mesh->indices[mesh->index_count], scratch,
+                   count * sizeof(uint32_t));
+            submesh->lods[l] = (leto_mesh_range_t){
+                (uint32_t)mesh->index_count, (uint32_t)count};
+            mesh->index_count += count;
+
+            // Errors accumulate, since each level builds on the last.
+            error += mesh->lod_errors[l - 1];
+            if (error > mesh->lod_errors[l]) mesh->lod_errors[l] = error;
+        }
+    }
+    free(scratch);
+}
@@ -0,0 +1,250 @@
+/**
+ * @file Writer.c
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Implements quantizing meshes and writing them in the binary
+ * mesh format. Every platform Leto supports is little-endian, so the
+ * format's structures are written as-is.
+ * @implements Cooker.h
+ * @date 2026-10-18
+ *
+ * @copyright (c) 2024 - the Leto Team
+ * This source code is under the AGPL v3.0. For information on what that
+ * entails, please see the attached @file LICENSE.md file.
+ */
+
+#include "Cooker.h" // Public interface parent
+
+#include <math.h>   // Standard math functions
+#include <stdio.h>  // Standard I/O
+#include <stdlib.h> // Standard memory allocation
+#include <string.h> // Standard memory utilities
+
+/**
+ * @brief A quantized vertex, exactly as it's written. This is the layout
+ * described by the header's attribute table.
+ */
+typedef struct packed_vertex
+{
+    /**
+     * @brief The position, normalized to the bounding box. The fourth
+     * value pads the normal to a 4-byte boundary.
+     */
+    uint16_t position[4];
+    /**
+     * @brief The octahedral-encoded normal.
+     */
+    int16_t normal[2];
+    /**
+     * @brief The texture coordinates as half floats.
+     */
+    uint16_t texture_coordinates[2];
+} packed_vertex_t;
+
+_Static_assert(sizeof(packed_vertex_t) == 16,
+               "A packed vertex must be 16 bytes.");
+
+/**
+ * FloatToHalf
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Convert a float to a half float, rounding to nearest even.
+ *
+ * @param value The float to convert.
+ * @return uint16_t -- The bits of the half float.
+ */
+static uint16_t FloatToHalf_(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(float));
+
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const uint32_t raw_exponent = (bits >> 23) & 0xFF;
+    int32_t exponent = (int32_t)raw_exponent - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN keep their class.
+    if (raw_exponent == 0xFF)
+        return (uint16_t)(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+    if (exponent >= 31) return (uint16_t)(sign | 0x7C00);
+
+    if (exponent <= 0)
+    {
+        // Too small even for a subnormal.
+        if (exponent < -10) return (uint16_t)sign;
+
+        mantissa |= 0x800000;
+        const uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1)))
+            half++;
+        return (uint16_t)(sign | half);
+    }
+
+    // Rounding may carry into the exponent, which is exactly right.
+    uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+    return (uint16_t)half;
+}
+
+/**
+ * EncodeOctahedral
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Fold a unit vector onto an octahedron and flatten it to two
+ * normalized 16-bit values.
+ *
+ * @param normal The unit vector.
+ * @param output Filled with the encoded vector.
+ * @return void -- Nothing.
+ */
+static void EncodeOctahedral_(const float *normal, int16_t *output)
+{
+    const float length =
+        fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+    float x = length > 0.0f ? normal[0] / length : 0.0f;
+    float y = length > 0.0f ? normal[1] / length : 0.0f;
+
+    // The lower hemisphere is folded over the diagonals. Zero counts as
+    // positive, matching the decoder.
+    if (normal[2] < 0.0f)
+    {
+        const float folded_x = (1.0f - fabsf(y)) * (x >= 0.0f ? 1 : -1);
+        const float folded_y = (1.0f - fabsf(x)) * (y >= 0.0f ? 1 : -1);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    output[0] = (int16_t)lroundf(fminf(fmaxf(x, -1.0f), 1.0f) * 32767.0f);
+    output[1] = (int16_t)lroundf(fminf(fmaxf(y, -1.0f), 1.0f) * 32767.0f);
+}
+
+/**
+ * Align
+ * @author Israfiel (https://github.com/israfiel-a)
+ * @brief Round an offset up to a multiple of a power of two.
+ *
+ * @param offset The offset.
+ * @param alignment The alignment.
+ * @return size_t -- The aligned offset.
+ */
+static size_t Align_(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+bool LetoWriteMesh(const leto_cooker_mesh_t *mesh, const char *path)
+{
+    if (mesh->vertex_count == 0 || mesh->submesh_count == 0) return false;
+
+    leto_mesh_header_t header = {
+        .magic = LETO_MESH_MAGIC,
+        .version = LETO_MESH_VERSION,
+        .vertex_stride = sizeof(packed_vertex_t),
+        .vertex_count = (uint32_t)mesh->vertex_count,
+        .index_count = (uint32_t)mesh->index_count,
+        .index_size = mesh->vertex_count <= 65536 ? 2 : 4,
+        .lod_count = 1,
+        .submesh_count = (uint16_t)mesh->submesh_count,
+        .attributes = {{attribute_unorm16, 3, 0},
+                       {attribute_octahedral, 2, 8},
+                       {attribute_half, 2, 12},
+                       {attribute_none, 0, 0}}};
+
+    if (mesh->lod_count > 1)
+    {
+        header.lod_count = (uint8_t)mesh->lod_count;
+        memcpy(header.lod_errors, mesh->lod_errors,
+               sizeof(header.lod_errors));
+    }
+
+    for (size_t k = 0; k < 3; k++)
+    {
+        header.minimum[k] = header.maximum[k] =
+            mesh->vertices[0].position[k];
+        for (size_t v = 1; v < mesh->vertex_count; v++)
+        {
+            header.minimum[k] =
+                fminf(header.minimum[k], mesh->vertices[v].position[k]);
+            header.maximum[k] =
+                fmaxf(header.maximum[k], mesh->vertices[v].position[k]);
+        }
+        header.sphere[k] = (header.minimum[k] + header.maximum[k]) * 0.5f;
+    }
+    for (size_t v = 0; v < mesh->vertex_count; v++)
+    {
+        const float *position = mesh->vertices[v].position;
+        float distance = 0;
+        for (size_t k = 0; k < 3; k++)
+            distance += (position[k] - header.sphere[k]) *
+                        (position[k] - header.sphere[k]);
+        header.sphere[3] = fmaxf(header.sphere[3], sqrtf(distance));
+    }
+
+    const size_t table_size =
+        mesh->submesh_count * sizeof(leto_mesh_submesh_t);
+    header.vertex_offset = (uint32_t)Align_(
+        sizeof(leto_mesh_header_t) + table_size,
+        LETO_MESH_VERTEX_ALIGNMENT);
+    header.index_offset = header.vertex_offset +
+                          header.vertex_count * header.vertex_stride;
+
+    packed_vertex_t *vertices =
+        LetoCookerAllocate(NULL, mesh->vertex_count * sizeof(*vertices));
+    for (size_t v = 0; v < mesh->vertex_count; v++)
+    {
+        const leto_cooker_vertex_t *source = &mesh->vertices[v];
+        packed_vertex_t *packed = &vertices[v];
+        packed->position[3] = 0;
+        for (size_t k = 0; k < 3; k++)
+        {
+            // A flat axis is scaled by one, as the loader expects.
+            float extent = header.maximum[k] - header.minimum[k];
+            if (extent <= 0.0f) extent = 1.0f;
+            const float normalized =
+                (source->position[k] - header.minimum[k]) / extent;
+            packed->position[k] = (uint16_t)lroundf(normalized * 65535.0f);
+        }
+        EncodeOctahedral_(source->normal, packed->normal);
+        packed->texture_coordinates[0] =
+            FloatToHalf_(source->texture_coordinates[0]);
+        packed->texture_coordinates[1] =
+            FloatToHalf_(source->texture_coordinates[1]);
+    }
+
+    // Small meshes get 16-bit indices.
+    const void *indices = mesh->indices;
+    uint16_t *narrow = NULL;
+    if (header.index_size == 2)
+    {
+        narrow = LetoCookerAllocate(NULL,
+                                    mesh->index_count * sizeof(uint16_t));
+        for (size_t i = 0; i < mesh->index_count; i++)
+            narrow[i] = (uint16_t)mesh->indices[i];
+        indices = narrow;
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        free(narrow);
+        free(vertices);
+        return false;
+    }
+
+    static const unsigned char padding[LETO_MESH_VERTEX_ALIGNMENT] = {0};
+    const size_t padding_size =
+        header.vertex_offset - sizeof(header) - table_size;
+    bool success =
+        fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(mesh->submeshes, table_size, 1, file) == 1 &&
+        fwrite(padding, 1, padding_size, file) == padding_size &&
+        fwrite(vertices, sizeof(*vertices), mesh->vertex_count, file) ==
+            mesh->vertex_count &&
+        fwrite(indices, header.index_size, mesh->index_count, file) ==
+            mesh->index_count;
+
+    free(narrow);
+    free(vertices);
+    return fclose(file) == 0 && success;
+}